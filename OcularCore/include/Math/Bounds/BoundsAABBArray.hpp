@@ -0,0 +1,136 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef __H__OCULAR_MATH_BOUNDS_AABB_ARRAY__H__
+#define __H__OCULAR_MATH_BOUNDS_AABB_ARRAY__H__
+
+#include "Math/Bounds/BoundsAABB.hpp"
+
+#include <cstdint>
+#include <vector>
+
+//------------------------------------------------------------------------------------------
+
+/**
+ * \addtogroup Ocular
+ * @{
+ */
+namespace Ocular
+{
+    /**
+     * \addtogroup Math
+     * @{
+     */
+    namespace Math
+    {
+        /**
+         * \class BoundsAABBArray
+         *
+         * Structure-of-arrays storage for a list of AABBs, each stored as a center and extents.
+         *
+         * Unlike a std::vector<BoundsAABB>, each component of every AABB is stored contiguously,
+         * so that the AABBs can be transformed and culled (see Frustum::contains) four at a time.
+         * This allows flat lists of objects that do not require a scene tree (UI, particles, lights, etc.)
+         * to be culled in a single pass.
+         */
+        class BoundsAABBArray
+        {
+        public:
+
+            /**
+             * \param[in] size Initial number of AABBs. Each is empty (zero center and extents).
+             */
+            BoundsAABBArray(uint32_t size = 0);
+            ~BoundsAABBArray();
+
+            //------------------------------------------------------------
+            // Size
+            //------------------------------------------------------------
+
+            /**
+             * Resizes the array. Any AABBs added are empty (zero center and extents).
+             * \param[in] size
+             */
+            void resize(uint32_t size);
+
+            /**
+             * \return The number of AABBs in the array.
+             */
+            uint32_t getSize() const;
+
+            //------------------------------------------------------------
+            // Element Access
+            //------------------------------------------------------------
+
+            /**
+             * \param[in] index
+             * \param[in] bounds
+             */
+            void set(uint32_t index, BoundsAABB const& bounds);
+
+            /**
+             * \param[in] index
+             * \return The AABB stored at the specified index.
+             */
+            BoundsAABB get(uint32_t index) const;
+
+            float const* getCenterX() const;
+            float const* getCenterY() const;
+            float const* getCenterZ() const;
+            float const* getExtentsX() const;
+            float const* getExtentsY() const;
+            float const* getExtentsZ() const;
+
+            //------------------------------------------------------------
+            // Transformation
+            //------------------------------------------------------------
+
+            /**
+             * Transforms each of the specified AABBs by its own matrix using Arvo's method: the
+             * center is transformed as a point, and each world extent is the sum of the absolute
+             * matrix row multiplied by the local extents.
+             *
+             * \param[in]  matrices Column-major matrices, one per AABB. The matrix of the AABB at index i begins at (matrices + (i * 16)).
+             * \param[in]  indices  Indices of the AABBs to transform.
+             * \param[in]  count    Number of indices.
+             * \param[out] result   Receives each transformed AABB at the same index. Must be at least as large as this array, and may be this array.
+             */
+            void transform(float const* matrices, uint32_t const* indices, uint32_t count, BoundsAABBArray& result) const;
+
+        protected:
+
+        private:
+
+            std::vector<float> m_CenterX;
+            std::vector<float> m_CenterY;
+            std::vector<float> m_CenterZ;
+            std::vector<float> m_ExtentsX;
+            std::vector<float> m_ExtentsY;
+            std::vector<float> m_ExtentsZ;
+        };
+    }
+    /**
+     * @} End of Doxygen Groups
+     */
+}
+/**
+ * @} End of Doxygen Groups
+ */
+
+//------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
@@ -0,0 +1,127 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef __H__OCULAR_MATH_BOUNDS_SPHERE_ARRAY__H__
+#define __H__OCULAR_MATH_BOUNDS_SPHERE_ARRAY__H__
+
+#include "Math/Bounds/BoundsSphere.hpp"
+
+#include <cstdint>
+#include <vector>
+
+//------------------------------------------------------------------------------------------
+
+/**
+ * \addtogroup Ocular
+ * @{
+ */
+namespace Ocular
+{
+    /**
+     * \addtogroup Math
+     * @{
+     */
+    namespace Math
+    {
+        /**
+         * \class BoundsSphereArray
+         *
+         * Structure-of-arrays storage for a list of bounding spheres.
+         * See BoundsAABBArray for details.
+         */
+        class BoundsSphereArray
+        {
+        public:
+
+            /**
+             * \param[in] size Initial number of spheres. Each is empty (zero center and radius).
+             */
+            BoundsSphereArray(uint32_t size = 0);
+            ~BoundsSphereArray();
+
+            //------------------------------------------------------------
+            // Size
+            //------------------------------------------------------------
+
+            /**
+             * Resizes the array. Any spheres added are empty (zero center and radius).
+             * \param[in] size
+             */
+            void resize(uint32_t size);
+
+            /**
+             * \return The number of spheres in the array.
+             */
+            uint32_t getSize() const;
+
+            //------------------------------------------------------------
+            // Element Access
+            //------------------------------------------------------------
+
+            /**
+             * \param[in] index
+             * \param[in] bounds
+             */
+            void set(uint32_t index, BoundsSphere const& bounds);
+
+            /**
+             * \param[in] index
+             * \return The sphere stored at the specified index.
+             */
+            BoundsSphere get(uint32_t index) const;
+
+            float const* getCenterX() const;
+            float const* getCenterY() const;
+            float const* getCenterZ() const;
+            float const* getRadius() const;
+
+            //------------------------------------------------------------
+            // Transformation
+            //------------------------------------------------------------
+
+            /**
+             * Transforms each of the specified spheres by its own matrix. The center is transformed as
+             * a point, and the radius is scaled by the longest of the matrix's scaled axes.
+             *
+             * \param[in]  matrices Column-major matrices, one per sphere. The matrix of the sphere at index i begins at (matrices + (i * 16)).
+             * \param[in]  indices  Indices of the spheres to transform.
+             * \param[in]  count    Number of indices.
+             * \param[out] result   Receives each transformed sphere at the same index. Must be at least as large as this array, and may be this array.
+             */
+            void transform(float const* matrices, uint32_t const* indices, uint32_t count, BoundsSphereArray& result) const;
+
+        protected:
+
+        private:
+
+            std::vector<float> m_CenterX;
+            std::vector<float> m_CenterY;
+            std::vector<float> m_CenterZ;
+            std::vector<float> m_Radius;
+        };
+    }
+    /**
+     * @} End of Doxygen Groups
+     */
+}
+/**
+ * @} End of Doxygen Groups
+ */
+
+//------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
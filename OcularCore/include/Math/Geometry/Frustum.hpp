@@ -21,6 +21,7 @@
 #include "Math/Matrix4x4.hpp"
 #include "Math/Geometry/Plane.hpp"
 #include <array>
+#include <vector>
 
 //------------------------------------------------------------------------------------------
 
@@ -39,6 +40,8 @@ namespace Ocular
         class BoundsAABB;
         class BoundsOBB;
         class BoundsSphere;
+        class BoundsAABBArray;
+        class BoundsSphereArray;
 
         /**
          * \class Frustum
@@ -132,18 +135,30 @@ namespace Ocular
             /**
              * Tests to determine if the frustum contains the specified bounding sphere.
              *
-             * \param[in] bounds
+             * If the result is Inside, then the bounds are located entirely within the frustum. <br/>
+             * If the result is Intersects, then the bounds cross one or more of the frustum planes. <br/>
+             * If the result is Outside, then the bounds are located entirely outside of at least one plane.
+             *
+             * \param[in]  bounds
+             * \param[out] result Detailed intersection result.
+             *
              * \return TRUE if bounds is inside or intersects.
              */
-            bool contains(BoundsSphere const& bounds) const;
+            bool contains(BoundsSphere const& bounds, IntersectionType* result = nullptr) const;
             
             /**
              * Tests to determine if the frustum contains the specified AABB.
              *
-             * \param[in] bounds
+             * If the result is Inside, then the bounds are located entirely within the frustum. <br/>
+             * If the result is Intersects, then the bounds cross one or more of the frustum planes. <br/>
+             * If the result is Outside, then the bounds are located entirely outside of at least one plane.
+             *
+             * \param[in]  bounds
+             * \param[out] result Detailed intersection result.
+             *
              * \return TRUE if bounds is inside or intersects.
              */
-            bool contains(BoundsAABB const& bounds) const;
+            bool contains(BoundsAABB const& bounds, IntersectionType* result = nullptr) const;
             
             /**
              * Tests to determine if the frustum contains the specified OBB.
@@ -153,6 +168,35 @@ namespace Ocular
              */
             bool contains(BoundsOBB const& bounds) const;
 
+            /**
+             * Tests every AABB of the array against the frustum in a single pass, four at a time.
+             * Equivalent to calling contains(BoundsAABB) on each AABB.
+             *
+             * The results are bit masks with one bit per AABB: the AABB at index i is
+             * represented by bit (i % 32) of element (i / 32).
+             *
+             * \param[in]  bounds
+             * \param[out] visible Bits are set for each AABB that is inside or intersects the frustum.
+             * \param[out] inside  Optional. Bits are set for each AABB that is entirely inside the frustum.
+             *
+             * \return The number of visible AABBs.
+             */
+            uint32_t contains(BoundsAABBArray const& bounds, std::vector<uint32_t>& visible, std::vector<uint32_t>* inside = nullptr) const;
+
+            /**
+             * Tests every sphere of the array against the frustum in a single pass, four at a time.
+             * Equivalent to calling contains(BoundsSphere) on each sphere.
+             *
+             * See contains(BoundsAABBArray) for the layout of the bit masks.
+             *
+             * \param[in]  bounds
+             * \param[out] visible Bits are set for each sphere that is inside or intersects the frustum.
+             * \param[out] inside  Optional. Bits are set for each sphere that is entirely inside the frustum.
+             *
+             * \return The number of visible spheres.
+             */
+            uint32_t contains(BoundsSphereArray const& bounds, std::vector<uint32_t>& visible, std::vector<uint32_t>* inside = nullptr) const;
+
             //------------------------------------------------------------
             // Property Retrieval
             //------------------------------------------------------------
@@ -199,6 +243,15 @@ namespace Ocular
              */
             Plane const& getFarPlane() const;
 
+            /**
+             * Converts the six planes into (normal, distance) form so that the signed distance to a
+             * point is simply dot(normal, point) + distance. Planes are ordered as they are tested
+             * in contains (near, far, left, right, top, bottom).
+             *
+             * \param[out] planes
+             */
+            void getPlaneEquations(float planes[6][4]) const;
+
             /**
              * \return The field-of-view. If an orthographic projection, returns 0
              */
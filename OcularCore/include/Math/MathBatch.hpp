@@ -0,0 +1,145 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef __H__OCULAR_ENGINE_MATH_BATCH__H__
+#define __H__OCULAR_ENGINE_MATH_BATCH__H__
+
+#include "Math/Vector3.hpp"
+#include "Math/Vector4.hpp"
+
+#include <cstdint>
+
+//------------------------------------------------------------------------------------------
+
+/**
+ * \addtogroup Ocular
+ * @{
+ */
+namespace Ocular
+{
+    /**
+     * \addtogroup Math
+     * @{
+     */
+    namespace Math
+    {
+        class Matrix4x4;
+        class Quaternion;
+
+        //----------------------------------------------------------------------------------
+        // Batch Functions
+        //
+        // Each function operates on an entire array at once, using the SIMD kernels when
+        // they are available for the build. The results may alias the inputs.
+        //----------------------------------------------------------------------------------
+
+        /**
+         * Transforms each point by the matrix, as if the point had a w-component of 1.
+         * Equivalent to (matrix * points[i]) for each point.
+         *
+         * \param[in]  matrix
+         * \param[in]  points
+         * \param[out] results
+         * \param[in]  count   Number of points
+         */
+        void TransformPoints(Matrix4x4 const& matrix, Vector3f const* points, Vector3f* results, uint32_t count);
+
+        /**
+         * Transforms each direction by the matrix, as if the direction had a w-component of 0.
+         * The translation of the matrix is ignored.
+         *
+         * \param[in]  matrix
+         * \param[in]  directions
+         * \param[out] results
+         * \param[in]  count      Number of directions
+         */
+        void TransformDirections(Matrix4x4 const& matrix, Vector3f const* directions, Vector3f* results, uint32_t count);
+
+        /**
+         * Transforms each vector by the matrix. Equivalent to (matrix * vectors[i]) for each vector.
+         *
+         * \param[in]  matrix
+         * \param[in]  vectors
+         * \param[out] results
+         * \param[in]  count   Number of vectors
+         */
+        void TransformVectors(Matrix4x4 const& matrix, Vector4f const* vectors, Vector4f* results, uint32_t count);
+
+        /**
+         * Multiplies each pair of matrices (lhs[i] * rhs[i]).
+         *
+         * \param[in]  lhs
+         * \param[in]  rhs
+         * \param[out] results
+         * \param[in]  count   Number of matrix pairs
+         */
+        void MultiplyMatrices(Matrix4x4 const* lhs, Matrix4x4 const* rhs, Matrix4x4* results, uint32_t count);
+
+        /**
+         * Multiplies a single matrix by each of the matrices in an array (lhs * rhs[i]).
+         *
+         * \param[in]  lhs
+         * \param[in]  rhs
+         * \param[out] results
+         * \param[in]  count   Number of matrices in rhs
+         */
+        void MultiplyMatrices(Matrix4x4 const& lhs, Matrix4x4 const* rhs, Matrix4x4* results, uint32_t count);
+
+        /**
+         * Normalizes each quaternion in place. Equivalent to calling Quaternion::normalize on each.
+         *
+         * \param[in,out] quaternions
+         * \param[in]     count       Number of quaternions
+         */
+        void NormalizeQuaternions(Quaternion* quaternions, uint32_t count);
+
+        /**
+         * Calculates the minimum and maximum xyz-components of a set of points.
+         * If there are no points, then the min and max are left unmodified.
+         *
+         * \param[in]  points
+         * \param[in]  count  Number of points
+         * \param[in]  stride Distance, in bytes, between consecutive points (such as sizeof(Vertex)). If 0, the points are tightly packed.
+         * \param[out] min
+         * \param[out] max
+         */
+        void CalculateMinMax(Vector4f const* points, uint32_t count, uint32_t stride, Vector3f& min, Vector3f& max);
+
+        /**
+         * Calculates the minimum and maximum xyz-components of a set of points after they have each 
+         * been transformed by the matrix. If there are no points, then the min and max are left unmodified.
+         *
+         * \param[in]  matrix
+         * \param[in]  points
+         * \param[in]  count  Number of points
+         * \param[in]  stride Distance, in bytes, between consecutive points (such as sizeof(Vertex)). If 0, the points are tightly packed.
+         * \param[out] min
+         * \param[out] max
+         */
+        void CalculateMinMax(Matrix4x4 const& matrix, Vector4f const* points, uint32_t count, uint32_t stride, Vector3f& min, Vector3f& max);
+    }
+    /**
+     * @} End of Doxygen Groups
+     */
+}
+/**
+ * @} End of Doxygen Groups
+ */
+
+//------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
@@ -284,7 +284,7 @@ namespace Ocular
 
         private:
 
-            Matrix3x3_Internal* m_Internal;
+            float m_Data[9];    ///< Inline storage of the internal matrix, so that no Matrix3x3 ever allocates
         };
 
         bool operator==(Matrix3x3 const& lhs, Matrix3x3 const& rhs);
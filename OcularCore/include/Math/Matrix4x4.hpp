@@ -357,7 +357,7 @@ namespace Ocular
 
         private:
 
-            Matrix4x4_Internal* m_Internal;
+            float m_Data[16];    ///< Inline storage of the internal matrix, so that no Matrix4x4 ever allocates
         };
 
         bool operator==(Matrix4x4 const& lhs, Matrix4x4 const& rhs);
@@ -74,6 +74,17 @@ namespace Ocular
              */
             static uint64_t calculate(uint32_t x, uint32_t y, uint32_t z);
 
+            /**
+             * Recovers the three integer components that were interleaved to form the Morton Code.
+             * This is the inverse of calculate(uint32_t, uint32_t, uint32_t).
+             *
+             * \param[in]  code
+             * \param[out] x
+             * \param[out] y
+             * \param[out] z
+             */
+            static void decode(uint64_t code, uint32_t& x, uint32_t& y, uint32_t& z);
+
             /**
              * Calculates a collection of Morton Codes for a number of vectors.
              *
@@ -91,6 +102,33 @@ namespace Ocular
              */
             static void calculate(std::vector<Vector3<float>> const& vectors, std::vector<uint64_t>& mortonCodes, bool areInRange = false, bool sortCodes = true);
 
+            /**
+             * Calculates and sorts the Morton Codes for a collection of points stored as separate component arrays.
+             *
+             * Unless they are already in range, all points are mapped to [0,1] using a single uniform
+             * scale so that the relative spacing along each axis is preserved. Both the calculation and
+             * the sort (see sort) are split across all available threads.
+             *
+             * \param[in]  x           Array of count x-components.
+             * \param[in]  y           Array of count y-components.
+             * \param[in]  z           Array of count z-components.
+             * \param[in]  count       Number of points.
+             * \param[out] mortonCodes Filled with the Morton Codes in ascending order.
+             * \param[out] order       Filled with the index of the point that produced each Morton Code.
+             * \param[in]  areInRange  If true, the input values are already on the range [0,1].
+             */
+            static void calculate(float const* x, float const* y, float const* z, uint32_t count, std::vector<uint64_t>& mortonCodes, std::vector<uint32_t>& order, bool areInRange = false);
+
+            /**
+             * Sorts the Morton Codes in ascending order using a parallel radix sort, and applies the
+             * same permutation to the associated values. The sort is stable, so the values of
+             * duplicate codes retain their relative order.
+             *
+             * \param[in,out] mortonCodes
+             * \param[in,out] values      Value (typically an index) associated with each code. Must be the same size as mortonCodes.
+             */
+            static void sort(std::vector<uint64_t>& mortonCodes, std::vector<uint32_t>& values);
+
         protected:
 
             /**
@@ -282,7 +282,7 @@ namespace Ocular
 
         protected:
 
-            Quaternion_Internal* m_Internal;
+            float m_Data[4];    ///< Inline storage of the internal quaternion, so that no Quaternion ever allocates
 
         private:
 
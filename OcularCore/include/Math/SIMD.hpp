@@ -0,0 +1,266 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef __H__OCULAR_ENGINE_MATH_SIMD__H__
+#define __H__OCULAR_ENGINE_MATH_SIMD__H__
+
+#include <cstdint>
+
+//------------------------------------------------------------------------------------------
+// Instruction set selection. Defining OCULAR_DISABLE_SIMD forces the scalar implementations.
+
+#if !defined(OCULAR_DISABLE_SIMD) && (defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1)))
+#define OCULAR_SIMD_SSE
+#include <xmmintrin.h>
+#endif
+
+#if defined(OCULAR_SIMD_SSE) && defined(__AVX__)
+#define OCULAR_SIMD_AVX
+#include <immintrin.h>
+#endif
+
+// PDEP/PEXT are only available as 64-bit instructions. MSVC has no BMI2 define, but every AVX2 target supports it.
+
+#if defined(OCULAR_SIMD_SSE) && (defined(__BMI2__) || defined(__AVX2__)) && (defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64))
+#define OCULAR_SIMD_BMI2
+#include <immintrin.h>
+#endif
+
+//------------------------------------------------------------------------------------------
+
+/**
+ * \addtogroup Ocular
+ * @{
+ */
+namespace Ocular
+{
+    /**
+     * \addtogroup Math
+     * @{
+     */
+    namespace Math
+    {
+        /**
+         * \addtogroup SIMD
+         * @{
+         */
+        namespace SIMD
+        {
+            /**
+             * Kernels operating on raw, column-major 4x4 matrices and 4-component vectors.
+             *
+             * The SSE (or AVX, when enabled for the build) implementation is selected at compile
+             * time, and the scalar implementation is used on all other targets. Only unaligned
+             * loads and stores are performed, and every input is read before the result is
+             * written, so the result may alias either input.
+             */
+
+            /**
+             * Multiplies two column-major matrices (lhs * rhs).
+             *
+             * \param[in]  lhs
+             * \param[in]  rhs
+             * \param[out] result
+             */
+            inline void MultiplyMatrix(float const* lhs, float const* rhs, float* result)
+            {
+#if defined(OCULAR_SIMD_AVX)
+                // Each 256-bit register holds two columns of the result
+
+                const __m256 l0 = _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(lhs));
+                const __m256 l1 = _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(lhs + 4));
+                const __m256 l2 = _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(lhs + 8));
+                const __m256 l3 = _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(lhs + 12));
+
+                const __m256 r01 = _mm256_loadu_ps(rhs);
+                const __m256 r23 = _mm256_loadu_ps(rhs + 8);
+
+                __m256 c01 = _mm256_mul_ps(l0, _mm256_shuffle_ps(r01, r01, _MM_SHUFFLE(0, 0, 0, 0)));
+                c01 = _mm256_add_ps(c01, _mm256_mul_ps(l1, _mm256_shuffle_ps(r01, r01, _MM_SHUFFLE(1, 1, 1, 1))));
+                c01 = _mm256_add_ps(c01, _mm256_mul_ps(l2, _mm256_shuffle_ps(r01, r01, _MM_SHUFFLE(2, 2, 2, 2))));
+                c01 = _mm256_add_ps(c01, _mm256_mul_ps(l3, _mm256_shuffle_ps(r01, r01, _MM_SHUFFLE(3, 3, 3, 3))));
+
+                __m256 c23 = _mm256_mul_ps(l0, _mm256_shuffle_ps(r23, r23, _MM_SHUFFLE(0, 0, 0, 0)));
+                c23 = _mm256_add_ps(c23, _mm256_mul_ps(l1, _mm256_shuffle_ps(r23, r23, _MM_SHUFFLE(1, 1, 1, 1))));
+                c23 = _mm256_add_ps(c23, _mm256_mul_ps(l2, _mm256_shuffle_ps(r23, r23, _MM_SHUFFLE(2, 2, 2, 2))));
+                c23 = _mm256_add_ps(c23, _mm256_mul_ps(l3, _mm256_shuffle_ps(r23, r23, _MM_SHUFFLE(3, 3, 3, 3))));
+
+                _mm256_storeu_ps(result, c01);
+                _mm256_storeu_ps(result + 8, c23);
+#elif defined(OCULAR_SIMD_SSE)
+                const __m128 l0 = _mm_loadu_ps(lhs);
+                const __m128 l1 = _mm_loadu_ps(lhs + 4);
+                const __m128 l2 = _mm_loadu_ps(lhs + 8);
+                const __m128 l3 = _mm_loadu_ps(lhs + 12);
+
+                for(uint32_t col = 0; col < 4; col++)
+                {
+                    float const* r = rhs + (col * 4);
+
+                    __m128 column = _mm_mul_ps(l0, _mm_set1_ps(r[0]));
+                    column = _mm_add_ps(column, _mm_mul_ps(l1, _mm_set1_ps(r[1])));
+                    column = _mm_add_ps(column, _mm_mul_ps(l2, _mm_set1_ps(r[2])));
+                    column = _mm_add_ps(column, _mm_mul_ps(l3, _mm_set1_ps(r[3])));
+
+                    _mm_storeu_ps(result + (col * 4), column);
+                }
+#else
+                float values[16];
+
+                for(uint32_t col = 0; col < 4; col++)
+                {
+                    float const* r = rhs + (col * 4);
+
+                    for(uint32_t row = 0; row < 4; row++)
+                    {
+                        values[(col * 4) + row] = (lhs[row] * r[0]) + (lhs[row + 4] * r[1]) + (lhs[row + 8] * r[2]) + (lhs[row + 12] * r[3]);
+                    }
+                }
+
+                for(uint32_t i = 0; i < 16; i++)
+                {
+                    result[i] = values[i];
+                }
+#endif
+            }
+
+            /**
+             * Multiplies a column-major matrix by an affine (bottom row of 0, 0, 0, 1) column-major matrix.
+             * The bottom row of the affine matrix is never read.
+             *
+             * \param[in]  lhs
+             * \param[in]  rhs    Affine matrix
+             * \param[out] result
+             */
+            inline void MultiplyAffineMatrix(float const* lhs, float const* rhs, float* result)
+            {
+#if defined(OCULAR_SIMD_SSE)
+                const __m128 l0 = _mm_loadu_ps(lhs);
+                const __m128 l1 = _mm_loadu_ps(lhs + 4);
+                const __m128 l2 = _mm_loadu_ps(lhs + 8);
+                const __m128 l3 = _mm_loadu_ps(lhs + 12);
+
+                for(uint32_t col = 0; col < 3; col++)
+                {
+                    float const* r = rhs + (col * 4);
+
+                    __m128 column = _mm_mul_ps(l0, _mm_set1_ps(r[0]));
+                    column = _mm_add_ps(column, _mm_mul_ps(l1, _mm_set1_ps(r[1])));
+                    column = _mm_add_ps(column, _mm_mul_ps(l2, _mm_set1_ps(r[2])));
+
+                    _mm_storeu_ps(result + (col * 4), column);
+                }
+
+                __m128 column = _mm_mul_ps(l0, _mm_set1_ps(rhs[12]));
+                column = _mm_add_ps(column, _mm_mul_ps(l1, _mm_set1_ps(rhs[13])));
+                column = _mm_add_ps(column, _mm_mul_ps(l2, _mm_set1_ps(rhs[14])));
+                column = _mm_add_ps(column, l3);
+
+                _mm_storeu_ps(result + 12, column);
+#else
+                float values[16];
+
+                for(uint32_t col = 0; col < 4; col++)
+                {
+                    float const* r = rhs + (col * 4);
+
+                    for(uint32_t row = 0; row < 4; row++)
+                    {
+                        values[(col * 4) + row] = (lhs[row] * r[0]) + (lhs[row + 4] * r[1]) + (lhs[row + 8] * r[2]) + ((col == 3) ? lhs[row + 12] : 0.0f);
+                    }
+                }
+
+                for(uint32_t i = 0; i < 16; i++)
+                {
+                    result[i] = values[i];
+                }
+#endif
+            }
+
+            /**
+             * Transforms a 4-component vector by a column-major matrix (matrix * vector).
+             *
+             * \param[in]  matrix
+             * \param[in]  vector
+             * \param[out] result
+             */
+            inline void TransformVector(float const* matrix, float const* vector, float* result)
+            {
+#if defined(OCULAR_SIMD_SSE)
+                __m128 value = _mm_mul_ps(_mm_loadu_ps(matrix), _mm_set1_ps(vector[0]));
+                value = _mm_add_ps(value, _mm_mul_ps(_mm_loadu_ps(matrix + 4), _mm_set1_ps(vector[1])));
+                value = _mm_add_ps(value, _mm_mul_ps(_mm_loadu_ps(matrix + 8), _mm_set1_ps(vector[2])));
+                value = _mm_add_ps(value, _mm_mul_ps(_mm_loadu_ps(matrix + 12), _mm_set1_ps(vector[3])));
+
+                _mm_storeu_ps(result, value);
+#else
+                float values[4];
+
+                for(uint32_t row = 0; row < 4; row++)
+                {
+                    values[row] = (matrix[row] * vector[0]) + (matrix[row + 4] * vector[1]) + (matrix[row + 8] * vector[2]) + (matrix[row + 12] * vector[3]);
+                }
+
+                for(uint32_t i = 0; i < 4; i++)
+                {
+                    result[i] = values[i];
+                }
+#endif
+            }
+
+#if defined(OCULAR_SIMD_SSE)
+            /**
+             * Loads four column-major matrices so that each register holds a single element of all four.
+             * The element at column c and row r of the matrices is stored in elements[(c * 4) + r].
+             *
+             * \param[in]  matrices Pointers to each of the four matrices
+             * \param[out] elements
+             */
+            inline void LoadTransposed(float const* const* matrices, __m128* elements)
+            {
+                for(uint32_t col = 0; col < 4; col++)
+                {
+                    __m128 r0 = _mm_loadu_ps(matrices[0] + (col * 4));
+                    __m128 r1 = _mm_loadu_ps(matrices[1] + (col * 4));
+                    __m128 r2 = _mm_loadu_ps(matrices[2] + (col * 4));
+                    __m128 r3 = _mm_loadu_ps(matrices[3] + (col * 4));
+
+                    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+                    elements[(col * 4)]     = r0;
+                    elements[(col * 4) + 1] = r1;
+                    elements[(col * 4) + 2] = r2;
+                    elements[(col * 4) + 3] = r3;
+                }
+            }
+#endif
+        }
+        /**
+         * @} End of Doxygen Groups
+         */
+    }
+    /**
+     * @} End of Doxygen Groups
+     */
+}
+/**
+ * @} End of Doxygen Groups
+ */
+
+//------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
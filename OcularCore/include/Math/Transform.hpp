@@ -71,6 +71,11 @@ namespace Ocular
 
             uint32_t getDirtyFlags(bool clearFlags = true);
 
+            /**
+             * \return TRUE if any dirty flags are set. Unlike getDirtyFlags, the flags are never cleared.
+             */
+            bool isDirty() const;
+
             /**
              *
              */
@@ -19,6 +19,7 @@
 #define __H__OCULAR_CORE_RENDERER__H__
 
 #include "Math/Matrix4x4.hpp"
+#include "Graphics/Shader/Uniform/UniformPerObject.hpp"
 #include <vector>
 
 //------------------------------------------------------------------------------------------
@@ -64,14 +65,31 @@ namespace Ocular
             void sort(std::vector<SceneObject*>& objects);
 
             /**
+             * Computes the per-object uniform data of every object for the current view in a single batch.
              *
+             * The model and normal matrices are cached by each object (see SceneObject::getModelUniformData),
+             * so only the model-view and model-view-projection matrices are built here, using SSE.
+             * The data is stored in the same order as the objects, so this must be called after sort.
+             */
+            void updateUniforms(std::vector<SceneObject*> const& objects);
+
+            /**
+             * Builds and binds the uniform data of a single object for the current view.
+             * If the object is NULL, a default uniform buffer (identity model matrix, etc.) is bound.
              */
             void bindUniforms(SceneObject* object);
 
+            /**
+             * Binds previously built uniform data (see updateUniforms).
+             */
+            void bindUniforms(Graphics::UniformPerObject const& data);
+
             //------------------------------------------------------------
 
             Graphics::UniformBuffer* m_UniformBufferPerObject;
 
+            std::vector<Graphics::UniformPerObject> m_ObjectUniforms;    ///< Uniform data of each object passed to the last call to updateUniforms
+
             Math::Matrix4x4 m_CurrViewMatrix;
             Math::Matrix4x4 m_CurrProjMatrix;
 
@@ -0,0 +1,292 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef __H__OCULAR_CORE_SCENE_ACELL_SCENE_TREE__H__
+#define __H__OCULAR_CORE_SCENE_ACELL_SCENE_TREE__H__
+
+#include "ISceneTree.hpp"
+#include "SceneObject.hpp"
+
+#include <vector>
+#include <utility>
+#include <unordered_map>
+
+//------------------------------------------------------------------------------------------
+
+/**
+ * \addtogroup Ocular
+ * @{
+ */
+namespace Ocular
+{
+    /**
+     * \addtogroup Core
+     * @{
+     */
+    namespace Core
+    {
+        /**
+         * \class ACellSceneTree
+         *
+         * Base class for SceneTrees that partition space into cells, rather than partitioning
+         * the objects themselves (as a BVH does). Each object is stored in exactly one cell, which
+         * is determined solely by the object's own bounds (see getCell).
+         *
+         * As no other object has to be considered when placing an object, adding, moving and removing 
+         * an object are all constant-time operations: an object is simply swapped out of it's old
+         * cell and appended to it's new one. This makes cell-based trees well suited to scenes in
+         * which a large number of (small) objects move every frame.
+         *
+         * Cells are stored sparsely in a hash map keyed by a 64-bit code whose meaning is defined by
+         * the implementation. Cells are created when their first object is added, and are destroyed
+         * when their last object is removed.
+         */
+        class ACellSceneTree : public ISceneTree
+        {
+        public:
+
+            ACellSceneTree();
+            virtual ~ACellSceneTree();
+
+            //------------------------------------------------------------
+            // Inherited Methods
+            //------------------------------------------------------------
+
+            virtual void restructure() override;
+            virtual void destroy() override;
+            virtual bool containsObject(SceneObject* object, bool checkNewObjects) const override;
+            virtual void addObject(SceneObject* object) override;
+            virtual void addObjects(std::vector<SceneObject*> const& objects) override;
+            virtual bool removeObject(SceneObject* object) override;
+            virtual void removeObjects(std::vector<SceneObject*> const& objects) override;
+            virtual void getAllObjects(std::vector<SceneObject*>& objects) const override;
+            virtual void getAllVisibleObjects(Math::Frustum const& frustum, std::vector<SceneObject*>& objects, FrustumHints* hints = nullptr) const override;
+            virtual void getAllVisibleObjects(std::vector<Math::Frustum> const& frustums, std::vector<std::vector<SceneObject*>>& objects, std::vector<FrustumHints*> const& hints = std::vector<FrustumHints*>()) const override;
+            virtual void getAllVisibleObjects(Math::Frustum const& frustum, OcclusionBuffer const& occlusion, std::vector<SceneObject*>& objects, FrustumHints* hints = nullptr) const override;
+            virtual void getIntersections(Math::Ray const& ray, std::vector<std::pair<SceneObject*, float>>& objects) const override;
+            virtual bool getIntersection(Math::Ray const& ray, RayQueryMode mode, std::pair<SceneObject*, float>& result, float maxDistance = FLT_MAX) const override;
+            virtual void getIntersections(std::vector<Math::Ray> const& rays, RayQueryMode mode, std::vector<std::pair<SceneObject*, float>>& results, std::vector<float> const& maxDistances = std::vector<float>()) const override;
+            virtual void getIntersections(Math::BoundsSphere const& bounds, std::vector<SceneObject*>& objects) const override;
+            virtual void getIntersections(Math::BoundsAABB const& bounds, std::vector<SceneObject*>& objects) const override;
+            virtual void getIntersections(Math::BoundsOBB const& bounds, std::vector<SceneObject*>& objects) const override;
+            virtual void getNearestObjects(Math::Vector3f const& point, uint32_t count, std::vector<std::pair<SceneObject*, float>>& objects, float maxDistance = FLT_MAX) const override;
+            virtual void getNearestObjects(std::vector<Math::Vector3f> const& points, uint32_t count, std::vector<std::vector<std::pair<SceneObject*, float>>>& objects, float maxDistance = FLT_MAX) const override;
+            virtual void getObjectsInRadius(Math::Vector3f const& point, float radius, std::vector<std::pair<SceneObject*, float>>& objects) const override;
+            virtual void getOverlappingPairs(std::vector<std::pair<SceneObject*, SceneObject*>>& pairs) const override;
+            virtual void getOverlappingPairs(ISceneTree const* other, std::vector<std::pair<SceneObject*, SceneObject*>>& pairs) const override;
+            virtual void setDirty(UUID const& uuid) override;
+
+        protected:
+
+            /**
+             * An object stored within a cell, along with it's world bounds as of the last time it was placed.
+             */
+            struct CellObject
+            {
+                float boundsMin[3];       ///< Minimum point of the object's AABB
+                float boundsMax[3];       ///< Maximum point of the object's AABB
+                SceneObject* object;
+            };
+
+            /**
+             * Location of an object within the tree.
+             */
+            struct ObjectLocation
+            {
+                uint64_t cell;            ///< Code of the cell the object is stored in, or PendingCell if it is waiting to be added
+                uint32_t index;           ///< Index of the object within the cell (or within m_NewObjects)
+            };
+
+            static const uint64_t PendingCell = 0xFFFFFFFFFFFFFFFF;    ///< Cell code of objects that are waiting to be added to the tree
+
+            //------------------------------------------------------------
+            // Cell Methods
+            //------------------------------------------------------------
+
+            /**
+             * Returns the code of the cell that an object with the specified bounds belongs in.
+             *
+             * \param[in] boundsMin Minimum point of the object's AABB
+             * \param[in] boundsMax Maximum point of the object's AABB
+             */
+            virtual uint64_t getCell(float const boundsMin[3], float const boundsMax[3]) const = 0;
+
+            /**
+             * Called after a cell receives it's first object.
+             * \param[in] cell
+             */
+            virtual void onCellCreated(uint64_t cell);
+
+            /**
+             * Called after a cell loses it's last object, and has been removed.
+             * Not called when the entire tree is destroyed; implementations that track their own 
+             * cell state should instead also override destroy.
+             *
+             * \param[in] cell
+             */
+            virtual void onCellDestroyed(uint64_t cell);
+
+            /**
+             * Retrieves the current world bounds of the object and places it in the appropriate cell.
+             * If the object is already in the tree, it is moved out of it's old cell if necessary.
+             *
+             * \param[in] object
+             */
+            void placeObject(SceneObject* object);
+
+            /**
+             * Removes the object at the specified location from it's cell, destroying the cell if it is left empty.
+             * The location of the object itself is not modified.
+             *
+             * \param[in] location
+             */
+            void removeFromCell(ObjectLocation const& location);
+
+            //------------------------------------------------------------
+            // Traversal Methods
+            //------------------------------------------------------------
+
+            /**
+             * Finds all active SceneObjects that are inside of or intersect the specified frustum.
+             *
+             * \param[in]  frustum Frustum to test against.
+             * \param[out] objects All discovered SceneObjects that intersect.
+             */
+            virtual void findVisible(Math::Frustum const& frustum, std::vector<SceneObject*>& objects) const = 0;
+
+            /**
+             * Finds all SceneObjects that intersect the specified ray, and their distances along the ray.
+             * No order is guaranteed.
+             *
+             * \param[in]  ray
+             * \param[out] objects
+             */
+            virtual void findIntersections(Math::Ray const& ray, std::vector<std::pair<SceneObject*, float>>& objects) const = 0;
+
+            /**
+             * Finds either the closest or any SceneObject that intersects the specified ray within the maximum distance.
+             * See ISceneTree::getIntersection.
+             *
+             * \param[in]  ray
+             * \param[in]  mode
+             * \param[in]  maxDistance
+             * \param[out] result      Only modified if an intersection is found.
+             *
+             * \return TRUE if an intersection was found.
+             */
+            virtual bool findIntersection(Math::Ray const& ray, RayQueryMode mode, float maxDistance, std::pair<SceneObject*, float>& result) const = 0;
+
+            /**
+             * Finds the (count) SceneObjects nearest to the specified point and within the maximum distance.
+             * See ISceneTree::getNearestObjects.
+             *
+             * \param[in]  point
+             * \param[in]  count
+             * \param[in]  maxDistance
+             * \param[out] objects     Must be empty. Filled with the nearest objects sorted from nearest to furthest.
+             */
+            virtual void findNearestObjects(Math::Vector3f const& point, uint32_t count, float maxDistance, std::vector<std::pair<SceneObject*, float>>& objects) const = 0;
+
+            virtual void findIntersections(Math::BoundsSphere const& bounds, std::vector<SceneObject*>& objects) const = 0;
+            virtual void findIntersections(Math::BoundsAABB const& bounds, std::vector<SceneObject*>& objects) const = 0;
+            virtual void findIntersections(Math::BoundsOBB const& bounds, std::vector<SceneObject*>& objects) const = 0;
+
+            /**
+             * Finds all overlapping pairs by querying (with findIntersections) either this tree, or the other tree,
+             * with the stored bounds of each object in this tree. Objects are queried concurrently.
+             *
+             * \param[in]  other Tree to query. If NULL, this tree is queried and each pair is only reported once.
+             * \param[out] pairs All discovered pairs. The first object of each pair is from this tree.
+             */
+            void findOverlappingPairs(ISceneTree const* other, std::vector<std::pair<SceneObject*, SceneObject*>>& pairs) const;
+
+            //------------------------------------------------------------
+            // Query Helpers
+            //------------------------------------------------------------
+
+            /**
+             * Converts each plane of the frustum into the form (nx, ny, nz, d), such that a point is
+             * outside of the plane if (n dot point + d) > 0.
+             */
+            static void ExtractFrustumPlanes(Math::Frustum const& frustum, float planes[6][4]);
+
+            /**
+             * Classifies the bounds against the frustum planes set in the mask.
+             * Planes that the bounds are entirely inside of are removed from the mask.
+             *
+             * \return Outside if the bounds are outside of any plane; Inside if the mask is left empty; otherwise Intersects.
+             */
+            static Math::IntersectionType ClassifyFrustum(float const planes[6][4], float const boundsMin[3], float const boundsMax[3], uint32_t& mask);
+
+            /**
+             * Converts a ray into the form used by IntersectsRay.
+             */
+            static void PrepareRay(Math::Ray const& ray, float origin[3], float invDir[3], bool parallel[3]);
+
+            /**
+             * Slab test of a ray against the bounds. Equivalent to Ray::intersects(BoundsAABB, Point3f, float).
+             *
+             * \param[out] distance Distance along the ray to the point of entry (0 if the origin is inside)
+             */
+            static bool IntersectsRay(float const origin[3], float const invDir[3], bool const parallel[3], float const boundsMin[3], float const boundsMax[3], float& distance);
+
+            /**
+             * Squared distance from a point to the nearest point of the bounds (0 if the point is inside).
+             */
+            static float DistanceSquared(float const point[3], float const boundsMin[3], float const boundsMax[3]);
+
+            /**
+             * Constructs a BoundsAABB from the minimum and maximum points.
+             */
+            static Math::BoundsAABB ToBounds(float const boundsMin[3], float const boundsMax[3]);
+
+            /**
+             * Adds an object to a max-heap of the (count) nearest objects, keyed by squared distance.
+             * If the heap is full, the object replaces the furthest if it is nearer.
+             */
+            static void InsertNearest(std::vector<std::pair<SceneObject*, float>>& nearest, uint32_t count, SceneObject* object, float distanceSq);
+
+            /**
+             * Sorts a heap built with InsertNearest from nearest to furthest, and converts the squared distances to distances.
+             */
+            static void SortNearest(std::vector<std::pair<SceneObject*, float>>& nearest);
+
+            //------------------------------------------------------------
+            // Variables
+            //------------------------------------------------------------
+
+            std::unordered_map<uint64_t, std::vector<CellObject>> m_Cells;    ///< All non-empty cells, keyed by their code
+
+            std::unordered_map<SceneObject*, ObjectLocation> m_Locations;     ///< Location of every object in the tree (including those waiting to be added)
+            std::unordered_map<uint64_t, SceneObject*> m_UUIDs;               ///< Objects in the tree keyed by the 64-bit hash of their UUID. Used by setDirty.
+
+            std::vector<SceneObject*> m_DirtyObjects;                         ///< Objects that have moved since the last restructure
+
+        private:
+        };
+    }
+    /**
+     * @} End of Doxygen Groups
+     */
+}
+/**
+ * @} End of Doxygen Groups
+ */
+
+//------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
@@ -136,6 +136,17 @@ namespace Ocular
              */
             virtual void buildBounds(Math::BoundsSphere* sphere, Math::BoundsAABB* aabb, Math::BoundsOBB* obb, Math::Matrix4x4 const& matrix = Math::Matrix4x4());
 
+            /**
+             * Called by the Scene once per camera, prior to rendering, with the projected size of the
+             * parent SceneObject's bounding sphere. Renderables with multiple levels of detail should
+             * select the level to be rendered for the current camera.
+             *
+             * \param[in] screenSize Projected diameter of the bounding sphere as a fraction of the viewport height.
+             *
+             * \return If return FALSE, the renderable is too small to be rendered and is culled. By default, returns TRUE.
+             */
+            virtual bool updateLOD(float screenSize);
+
             //------------------------------------------------------------
             // Getters and Setters
             //------------------------------------------------------------
@@ -0,0 +1,82 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef __H__OCULAR_CORE_SCENE_BVH_LINEAR_NODE__H__
+#define __H__OCULAR_CORE_SCENE_BVH_LINEAR_NODE__H__
+
+#include <cstdint>
+
+//------------------------------------------------------------------------------------------
+
+/**
+ * \addtogroup Ocular
+ * @{
+ */
+namespace Ocular
+{
+    /**
+     * \addtogroup Core
+     * @{
+     */
+    namespace Core
+    {
+        /**
+         * \struct BVHLinearNode
+         *
+         * Compact, pointer-free representation of a single BVHSceneNode.
+         *
+         * Linear nodes are stored contiguously in depth-first (pre-order) order. This means
+         * that the left child of an internal node is always located directly after it, and
+         * that every node in a subtree is located in the range [index, skip).
+         *
+         * Traversal is performed front-to-back over the node array: if a node passes a test
+         * the traversal continues at (index + 1), otherwise it jumps ahead to the skip index.
+         * No stack or parent pointers are required.
+         *
+         * The objects owned by the leaves are stored in a separate array in the same (leaf) order,
+         * so the objects of any subtree are also contiguous: [object, nodes[skip].object).
+         *
+         * Each node is 32 bytes, so two nodes fit within a single 64-byte cache line.
+         */
+        struct BVHLinearNode
+        {
+            float    boundsMin[3];    ///< Minimum point of the node's AABB
+            uint32_t skip;            ///< Index of the first node that is not a descendant of this node
+            float    boundsMax[3];    ///< Maximum point of the node's AABB
+            uint32_t object;          ///< Index of the first object (in leaf order) owned by this subtree
+
+            /**
+             * \param[in] index Index of this node within the linear node array.
+             * \return TRUE if this node is a leaf (has no descendants).
+             */
+            bool isLeaf(uint32_t const index) const
+            {
+                return (skip == (index + 1));
+            }
+        };
+    }
+    /**
+     * @} End of Doxygen Groups
+     */
+}
+/**
+ * @} End of Doxygen Groups
+ */
+
+//------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
@@ -0,0 +1,124 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef __H__OCULAR_CORE_SCENE_BVH_SAH_SCENE_TREE__H__
+#define __H__OCULAR_CORE_SCENE_BVH_SAH_SCENE_TREE__H__
+
+#include "BVHSceneTree.hpp"
+
+//------------------------------------------------------------------------------------------
+
+/**
+ * \addtogroup Ocular
+ * @{
+ */
+namespace Ocular
+{
+    /**
+     * \addtogroup Core
+     * @{
+     */
+    namespace Core
+    {
+        /**
+         * \class BVHSAHSceneTree
+         *
+         * Bounding Volume Hierarchy Scene Tree that is constructed using a binned Surface Area Heuristic (SAH).
+         *
+         * The Morton-ordered construction of the BVHSceneTree is very fast, but splits purely on the position
+         * of object centers. This produces poor trees for scenes with clustered objects or objects of widely
+         * varying sizes. The SAH construction instead selects each split by estimating the cost of querying
+         * the resulting children, which produces a higher quality tree at the expense of a slower build.
+         *
+         * As such, this tree is intended primarily for static objects where the build time is amortized.
+         * All queries, incremental updates, and rotations are shared with the BVHSceneTree.
+         *
+         * The tree is built top-down. At each node the object centers are placed into a fixed number of bins 
+         * along each axis, and the split between bins with the lowest cost is chosen. Large nodes are binned 
+         * in parallel, and the children of large nodes are built in parallel.
+         *
+         * Source:
+         *
+         *     Ingo Wald
+         *     On fast Construction of SAH-based Bounding Volume Hierarchies
+         *     http://www.sci.utah.edu/~wald/Publications/2007/ParallelBVHBuild/fastbuild.pdf
+         */
+        class BVHSAHSceneTree : public BVHSceneTree
+        {
+        public:
+
+            BVHSAHSceneTree();
+            virtual ~BVHSAHSceneTree();
+
+            virtual SceneTreeType getType() const override;
+
+        protected:
+
+            /**
+             * Working data shared by all nodes during a single build.
+             */
+            struct BuildData
+            {
+                std::vector<Math::BoundsAABB> bounds;     ///< World bounds of each object in m_AllObjects
+                std::vector<Math::Vector3f>   centers;    ///< Center of the bounds of each object in m_AllObjects
+                std::vector<uint32_t>         indices;    ///< Object indices, partitioned in-place as the tree is built
+                std::vector<BVHSceneNode*>    leaves;     ///< Leaf node created for each object in m_AllObjects
+            };
+
+            /**
+             * Builds the tree from the collection of objects stored in m_AllObjects using the binned SAH.
+             */
+            virtual void build() override;
+
+            /**
+             * Fits the bounds of the specified node to the objects in the range, splits the range,
+             * and recursively builds the node's children.
+             *
+             * \param[in] node  Node that owns the range. Must have at least two objects.
+             * \param[in] data  
+             * \param[in] first Index of the first object in data.indices owned by the node.
+             * \param[in] last  Index one past the last object in data.indices owned by the node.
+             */
+            void buildNode(BVHSceneNode* node, BuildData& data, uint32_t first, uint32_t last) const;
+
+            /**
+             * Finds the lowest cost split of the specified range, and partitions the range around it.
+             *
+             * \param[in] data
+             * \param[in] first
+             * \param[in] last
+             * \param[in] centerMin Minimum point of the bounds containing all object centers in the range.
+             * \param[in] centerMax Maximum point of the bounds containing all object centers in the range.
+             *
+             * \return Index of the first object in the right half of the partitioned range.
+             */
+            uint32_t partition(BuildData& data, uint32_t first, uint32_t last, Math::Vector3f const& centerMin, Math::Vector3f const& centerMax) const;
+
+        private:
+        };
+    }
+    /**
+     * @} End of Doxygen Groups
+     */
+}
+/**
+ * @} End of Doxygen Groups
+ */
+
+//------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
@@ -60,6 +60,8 @@ namespace Ocular
             BVHSceneNode* right;             ///< The 'right' child node (null if this is a leaf).
 
             SceneObject* object;             ///< The object attached to this node (null unless this is a leaf).
+            uint32_t linearIndex;            ///< Index of the attached object within the flattened object array as of the last flatten (leaf only).
+            uint32_t nodeIndex;              ///< Index of this node within the flattened node array as of the last flatten.
 
         protected:
 
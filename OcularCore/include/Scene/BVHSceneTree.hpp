@@ -21,9 +21,11 @@
 #include "ISceneTree.hpp"
 #include "SceneObject.hpp"
 #include "BVHSceneNode.hpp"
+#include "BVHLinearNode.hpp"
 
 #include <vector>
 #include <utility>
+#include <unordered_map>
 
 //------------------------------------------------------------------------------------------
 
@@ -39,6 +41,8 @@ namespace Ocular
      */
     namespace Core
     {
+        class File;
+
         /**
          * \class BVHSceneTree
          *
@@ -62,6 +66,15 @@ namespace Ocular
          * of a internal node contains both of it's children. The bounds of the root then must
          * encompass all objects within the entire scene.
          *
+         * The tree is constructed and modified using individually allocated BVHSceneNodes, but
+         * all queries are performed against a flattened copy of the tree (see BVHLinearNode).
+         * Whenever the structure of the node tree changes, it is flattened into a contiguous
+         * depth-first array which is then traversed without any pointer chasing.
+         *
+         * As the flattened tree contains no pointers, it may be saved to disk and later loaded
+         * in place of a rebuild (see save and load). This is primarily intended for the static
+         * tree of a Scene, which is otherwise rebuilt from scratch every time the Scene is loaded.
+         *
          * The implementation of this tree is based on several sources:
          *
          *     Tero Karras, NVIDIA Research
@@ -77,7 +90,7 @@ namespace Ocular
          */
         class BVHSceneTree : public ISceneTree
         {
-            typedef std::pair<uint64_t, SceneObject*> MortonPair;  ///< Pairing of morton codes and associated scene object
+            typedef std::pair<uint64_t, uint32_t> MortonPair;  ///< Pairing of morton codes and the index of the associated scene object in m_AllObjects
 
         public:
 
@@ -96,15 +109,61 @@ namespace Ocular
             virtual bool removeObject(SceneObject* object) override;
             virtual void removeObjects(std::vector<SceneObject*> const& objects) override;
             virtual void getAllObjects(std::vector<SceneObject*>& objects) const override;
-            virtual void getAllVisibleObjects(Math::Frustum const& frustum, std::vector<SceneObject*>& objects) const override;
+            virtual void getAllVisibleObjects(Math::Frustum const& frustum, std::vector<SceneObject*>& objects, FrustumHints* hints = nullptr) const override;
+            virtual void getAllVisibleObjects(std::vector<Math::Frustum> const& frustums, std::vector<std::vector<SceneObject*>>& objects, std::vector<FrustumHints*> const& hints = std::vector<FrustumHints*>()) const override;
+            virtual void getAllVisibleObjects(Math::Frustum const& frustum, OcclusionBuffer const& occlusion, std::vector<SceneObject*>& objects, FrustumHints* hints = nullptr) const override;
             virtual void getIntersections(Math::Ray const& ray, std::vector<std::pair<SceneObject*, float>>& objects) const override;
+            virtual bool getIntersection(Math::Ray const& ray, RayQueryMode mode, std::pair<SceneObject*, float>& result, float maxDistance = FLT_MAX) const override;
+            virtual void getIntersections(std::vector<Math::Ray> const& rays, RayQueryMode mode, std::vector<std::pair<SceneObject*, float>>& results, std::vector<float> const& maxDistances = std::vector<float>()) const override;
             virtual void getIntersections(Math::BoundsSphere const& bounds, std::vector<SceneObject*>& objects) const override;
             virtual void getIntersections(Math::BoundsAABB const& bounds, std::vector<SceneObject*>& objects) const override;
             virtual void getIntersections(Math::BoundsOBB const& bounds, std::vector<SceneObject*>& objects) const override;
+            virtual void getNearestObjects(Math::Vector3f const& point, uint32_t count, std::vector<std::pair<SceneObject*, float>>& objects, float maxDistance = FLT_MAX) const override;
+            virtual void getNearestObjects(std::vector<Math::Vector3f> const& points, uint32_t count, std::vector<std::vector<std::pair<SceneObject*, float>>>& objects, float maxDistance = FLT_MAX) const override;
+            virtual void getObjectsInRadius(Math::Vector3f const& point, float radius, std::vector<std::pair<SceneObject*, float>>& objects) const override;
+            virtual void getOverlappingPairs(std::vector<std::pair<SceneObject*, SceneObject*>>& pairs) const override;
+            virtual void getOverlappingPairs(ISceneTree const* other, std::vector<std::pair<SceneObject*, SceneObject*>>& pairs) const override;
             virtual void setDirty(UUID const& uuid) override;
 
             virtual SceneTreeType getType() const override;
 
+            /**
+             * Returns the Surface Area Heuristic (SAH) cost of the tree as of the last time it was restructured.
+             *
+             * This is the sum of the surface areas of all nodes relative to the surface area of the root,
+             * and is proportional to the expected number of nodes visited by a random query. A lower cost 
+             * indicates a higher quality tree. May be used to compare different construction methods.
+             */
+            float getCost() const;
+
+            /**
+             * Writes the flattened tree to the specified file.
+             *
+             * Only the linear nodes and the UUIDs of the objects that they own are written, so the
+             * tree must be restructured prior to saving. Objects are not serialized as part of the tree.
+             *
+             * \param[in] file
+             * \return TRUE if the tree was successfully saved. Returns FALSE if the tree is dirty or the file could not be written.
+             */
+            virtual bool save(File const& file) const;
+
+            /**
+             * Loads a flattened tree previously written with save.
+             *
+             * The tree must not yet have been restructured, and the objects that it has been given must exactly
+             * match those in the saved tree. Each object must also still fit within the bounds of it's saved leaf.
+             * If all of these are true, the tree is ready for queries without being built.
+             *
+             * The file is memory-mapped and validated in place, so the nodes are only copied once the tree is accepted.
+             *
+             * The node tree is restored from the loaded nodes (see unflatten), so any later modification of
+             * the tree is refit, inserted or removed exactly as it would be for a tree that was built.
+             *
+             * \param[in] file
+             * \return TRUE if the tree was loaded. If FALSE, the tree is unmodified and should be restructured as normal.
+             */
+            virtual bool load(File const& file);
+
         protected:
 
             /**
@@ -125,11 +184,20 @@ namespace Ocular
 
             /**
              * Updates all dirty nodes (leafs) whose objects have either moved or rotated.
+             *
+             * The bounds along the path of each dirty leaf are refit, and then tree rotations
+             * are applied along those same paths to maintain the quality of the tree.
+             * If the topology is unchanged, the refit bounds are written directly into the
+             * flattened nodes (see refitLinearNodes).
              */
             void updateDirtyNodes();
 
             /**
              * Checks to see if the tree needs to be rebuilt.
+             *
+             * A rebuild is needed if there is no existing tree to update, if a significant number of
+             * new objects are waiting to be inserted, or if the cost of the tree has grown too far
+             * beyond what it was after the last rebuild.
              */
             bool rebuildNeeded() const;
 
@@ -139,10 +207,29 @@ namespace Ocular
             void destroyNode(BVHSceneNode* node) const;
 
             /**
-             * Inserts a single new object into the tree.
+             * Inserts a single new object into the tree, and refits the bounds along it's path.
+             *
              * \param[in] object
+             * \return The new leaf node that owns the object.
+             */
+            BVHSceneNode* insertObject(SceneObject* object);
+
+            /**
+             * Refits the bounds of the specified node, and then of each of it's ancestors
+             * until one is reached whose bounds are unaffected.
+             *
+             * \param[in] node
+             */
+            void refitPath(BVHSceneNode* node) const;
+
+            /**
+             * Performs the single rotation (swapping a child with one of it's grandchildren) 
+             * that most reduces the surface area of the node's children, if any.
+             *
+             * \param[in] node
+             * \return TRUE if a rotation was performed.
              */
-            void insertObject(SceneObject* object);
+            bool rotateNode(BVHSceneNode* node) const;
 
             //------------------------------------------------------------
             // Traversal Methods
@@ -158,6 +245,17 @@ namespace Ocular
              */
             BVHSceneNode* findParent(BVHSceneNode* node, SceneObject* object) const;
 
+            /**
+             * Finds the leaf node that owns the specified object in the tree.
+             *
+             * The leaf is looked up by the object's UUID in constant time. A full traversal (see findParent)
+             * is only performed if the UUID of the object has changed since it was added to the tree.
+             *
+             * \param[in] object The object to find.
+             * \return The leaf node, or NULL if the object is not in the tree.
+             */
+            BVHSceneNode* findLeaf(SceneObject* object);
+
             /**
              * Finds the node with the nearest morton code to the one specified.
              * 
@@ -169,48 +267,157 @@ namespace Ocular
             BVHSceneNode* findNearest(BVHSceneNode* node, uint64_t const& morton) const;
 
             /**
-             * 
-             * \param[in]  node    Current node.
+             * Finds all active SceneObjects that are inside of or intersect the specified frustum.
+             *
+             * Planes that a node is entirely inside of are not tested against it's descendants,
+             * and the objects of a node entirely inside of the frustum are added without further testing.
+             *
+             * The plane that last culled each node is stored in the hints of the view, and is tested first
+             * when the node is next visited. Without hints, the plane that culled the previous node is used.
+             *
              * \param[in]  frustum Frustum to test against.
              * \param[out] objects All discovered SceneObjects that intersect.
+             * \param[in]  hints   Per-node plane hints of the view. May be NULL.
+             */
+            virtual void findVisible(Math::Frustum const& frustum, std::vector<SceneObject*>& objects, FrustumHints* hints) const;
+
+            /**
+             * Finds all active SceneObjects that are inside of or intersect each of the specified frustums.
+             *
+             * Each node carries a bitmask of the views that it must still be tested against, and a
+             * bitmask of the views that it is entirely inside of. A node is only tested once per view,
+             * and is skipped entirely once it is either inside or outside of every view.
+             *
+             * \param[in]  frustums  Frustums to test against.
+             * \param[in]  first     Index of the first frustum to test. Up to 32 frustums are tested, beginning with this one.
+             * \param[out] objects   Discovered SceneObjects for each frustum.
+             * \param[in]  hints     Per-node plane hints of each frustum. Either empty, or one (possibly NULL) for each frustum.
+             */
+            virtual void findVisible(std::vector<Math::Frustum> const& frustums, uint32_t first, std::vector<std::vector<SceneObject*>>& objects, std::vector<FrustumHints*> const& hints) const;
+
+            /**
+             * Finds all active SceneObjects that are inside of or intersect the specified frustum, 
+             * and that are not hidden behind the occluders of the occlusion buffer.
+             *
+             * Each node that passes the frustum test is also tested against the occlusion buffer,
+             * and the entire subtree is skipped if it is occluded.
+             *
+             * \param[in]  frustum   Frustum to test against.
+             * \param[in]  occlusion Rasterized occlusion buffer of the same view.
+             * \param[out] objects   All discovered SceneObjects that are visible.
+             * \param[in]  hints     Per-node plane hints of the view. May be NULL.
              */
-            void findVisible(BVHSceneNode* node, Math::Frustum const& frustum, std::vector<SceneObject*>& objects) const;
+            virtual void findVisible(Math::Frustum const& frustum, OcclusionBuffer const& occlusion, std::vector<SceneObject*>& objects, FrustumHints* hints) const;
 
             /**
-             * Recursively finds all SceneObjects that intersect with the specified ray. The results are unordered.
+             * Finds all SceneObjects that intersect with the specified ray. The results are unordered.
              *
-             * \param[in]  node    Current node.
              * \param[in]  ray     Ray to test against.
              * \param[out] objects All discovered SceneObjects that intersect and their intersection points.
              */
-            void findIntersections(BVHSceneNode* node, Math::Ray const& ray, std::vector<std::pair<SceneObject*, float>>& objects) const;
+            virtual void findIntersections(Math::Ray const& ray, std::vector<std::pair<SceneObject*, float>>& objects) const;
+
+            /**
+             * Finds a single SceneObject that intersects with the specified ray.
+             *
+             * At each internal node, the child nearest to the ray origin is visited first and any child
+             * further away than the current result is skipped entirely.
+             *
+             * \param[in]  ray         Ray to test against.
+             * \param[in]  mode        Closest or any intersection.
+             * \param[in]  maxDistance Intersections further along the ray are ignored.
+             * \param[out] result      The discovered SceneObject and it's distance. Only modified if an intersection is found.
+             *
+             * \return TRUE if an intersection was found.
+             */
+            virtual bool findIntersection(Math::Ray const& ray, RayQueryMode mode, float maxDistance, std::pair<SceneObject*, float>& result) const;
+
+            /**
+             * Finds the SceneObjects nearest to the specified point.
+             *
+             * Nodes are visited best-first, in order of their distance from the point, using a priority queue.
+             * The search terminates once the nearest remaining node is further away than the furthest
+             * of the (count) objects discovered so far.
+             *
+             * \param[in]  point       Point to search from.
+             * \param[in]  count       Maximum number of objects to find.
+             * \param[in]  maxDistance Objects further from the point are ignored.
+             * \param[out] objects     The discovered SceneObjects and their distances, ordered from nearest to furthest. Must be empty.
+             */
+            virtual void findNearestObjects(Math::Vector3f const& point, uint32_t count, float maxDistance, std::vector<std::pair<SceneObject*, float>>& objects) const;
 
             /**
-             * Recursively finds all SceneObjects that intersect with the specified bounds.
+             * Finds all SceneObjects that intersect with the specified bounds.
              *
-             * \param[in]  node    Current node.
              * \param[in]  bounds  Bounds to test against.
              * \param[out] objects All discovered SceneObjects that intersect.
              */
-            void findIntersections(BVHSceneNode* node, Math::BoundsSphere const& bounds, std::vector<SceneObject*>& objects) const;
+            virtual void findIntersections(Math::BoundsSphere const& bounds, std::vector<SceneObject*>& objects) const;
 
             /**
-             * Recursively finds all SceneObjects that intersect with the specified bounds.
+             * Finds all SceneObjects that intersect with the specified bounds.
              *
-             * \param[in]  node    Current node.
              * \param[in]  bounds  Bounds to test against.
              * \param[out] objects All discovered SceneObjects that intersect.
              */
-            void findIntersections(BVHSceneNode* node, Math::BoundsAABB const& bounds, std::vector<SceneObject*>& objects) const;
+            virtual void findIntersections(Math::BoundsAABB const& bounds, std::vector<SceneObject*>& objects) const;
 
             /**
-             * Recursively finds all SceneObjects that intersect with the specified bounds.
+             * Finds all SceneObjects that intersect with the specified bounds.
              *
-             * \param[in]  node    Current node.
              * \param[in]  bounds  Bounds to test against.
              * \param[out] objects All discovered SceneObjects that intersect.
              */
-            void findIntersections(BVHSceneNode* node, Math::BoundsOBB const& bounds, std::vector<SceneObject*>& objects) const;
+            virtual void findIntersections(Math::BoundsOBB const& bounds, std::vector<SceneObject*>& objects) const;
+
+            /**
+             * Finds all overlapping pairs by querying (with findIntersections) either this tree, or the other tree, 
+             * with the bounds of each object in this tree. Used when the linear nodes can not be traversed 
+             * simultaneously with those of the other tree. Objects are queried concurrently.
+             *
+             * \param[in]  other Tree to query. If NULL, this tree is queried and each pair is only reported once.
+             * \param[out] pairs All discovered pairs. The first object of each pair is from this tree.
+             */
+            void findOverlappingPairs(ISceneTree const* other, std::vector<std::pair<SceneObject*, SceneObject*>>& pairs) const;
+
+            /**
+             * Retrieves the bounds that each linear object is stored with in the tree.
+             * \param[out] bounds Bounds of each object, in the same order as m_LinearObjects.
+             */
+            virtual void getLeafBounds(std::vector<Math::BoundsAABB>& bounds) const;
+
+            /**
+             * Creates a BoundsAABB from the bounds of a linear node.
+             * \param[in] node
+             */
+            Math::BoundsAABB getLinearBounds(BVHLinearNode const& node) const;
+
+            /**
+             * Converts the six frustum planes into (normal, distance) form so that the signed distance
+             * to a point is simply dot(normal, point) + distance. Planes are ordered as they are tested
+             * in Frustum::contains (near, far, left, right, top, bottom).
+             *
+             * \param[in]  frustum
+             * \param[out] planes
+             */
+            static void ExtractFrustumPlanes(Math::Frustum const& frustum, float planes[6][4]);
+
+            /**
+             * Adds an object to a bounded max-heap of the (count) nearest objects discovered by a nearest object query.
+             * If the heap is full, the object replaces the furthest object only if it is nearer.
+             *
+             * \param[in,out] nearest    Max-heap of objects and their squared distances.
+             * \param[in]     count      Maximum size of the heap.
+             * \param[in]     object
+             * \param[in]     distanceSq Squared distance to the object.
+             */
+            static void InsertNearest(std::vector<std::pair<SceneObject*, float>>& nearest, uint32_t count, SceneObject* object, float distanceSq);
+
+            /**
+             * Converts a heap built by InsertNearest into a list ordered from nearest to furthest,
+             * with the squared distances replaced by actual distances.
+             */
+            static void SortNearest(std::vector<std::pair<SceneObject*, float>>& nearest);
 
             //------------------------------------------------------------
             // Build Methods
@@ -218,31 +425,43 @@ namespace Ocular
             
             /**
              * Builds the tree from the collection of objects stored in m_AllObjects.
+             * The construction is split across all available threads (see ThreadManager::parallelFor).
+             *
+             * Implementations must set m_Root and register every leaf in m_Leaves.
+             */
+            virtual void build();
+
+            /**
+             * Retrieves the world bounds of every object in m_AllObjects.
+             * \param[out] bounds Container to be filled with the bounds, in the same order as m_AllObjects.
              */
-            void build();
+            void gatherBounds(std::vector<Math::BoundsAABB>& bounds) const;
 
             /**
              * Calculates and sorts the Morton Codes for all objects in the tree.
-             * \param[out] pairs Container to be filled with the sorted Morton Codes and their associated SceneObject
+             *
+             * \param[in]  bounds Bounds of all objects, in the same order as m_AllObjects.
+             * \param[out] pairs  Container to be filled with the sorted Morton Codes and their associated object index
              */
-            void createMortonPairs(std::vector<MortonPair>& pairs) const;
+            void createMortonPairs(std::vector<Math::BoundsAABB> const& bounds, std::vector<MortonPair>& pairs) const;
 
             /**
-             * Recursively generates the tree in a top-down manner beginning at the root.
+             * Generates the complete tree from the sorted Morton Codes. All internal nodes are emitted 
+             * independently of each other, and thus in parallel.
              *
-             * \param[in] parent The node calling this recursive sequence.
-             * \param[in] pairs  Sorted list of morton code/scene object pairings.
-             * \param[in] first  First node in the current split
-             * \param[in] last   Last node in the current split (inclusive)
+             * The node container is filled such that the N-1 internal nodes are at [0, N-1) and the
+             * N leaf nodes are at [N-1, 2N-1). The first internal node is the root of the tree.
              *
-             * \return Pointer to the root node of the newly generated tree.
+             * \param[in]  pairs   Sorted list of morton code/object index pairings.
+             * \param[out] nodes   All nodes of the generated tree.
+             * \param[out] parents Index of the parent of each node in the node container.
              */
-            BVHSceneNode* generateTree(BVHSceneNode* parent, std::vector<MortonPair> const& pairs, uint32_t first, uint32_t last) const;
+            void generateTree(std::vector<MortonPair> const& pairs, std::vector<BVHSceneNode*>& nodes, std::vector<uint32_t>& parents) const;
 
             /**
              * Finds the index to split the remaining objects to fit the tree.
              *
-             * \param[in] pairs Sorted list of morton code/scene object pairings.
+             * \param[in] pairs Sorted list of morton code/object index pairings.
              * \param[in] first Index of first object remaining to be added to the tree
              * \param[in] last  Index of the last object remaining to be added to the tree
              * 
@@ -250,20 +469,87 @@ namespace Ocular
              */
             uint32_t findSplit(std::vector<MortonPair> const& pairs, uint32_t first, uint32_t last) const;
 
+            /**
+             * Fits the bounds of all nodes generated by generateTree in parallel, from the leaves up to the root.
+             *
+             * \param[in] bounds  Bounds of all objects, in the same order as m_AllObjects.
+             * \param[in] pairs   Sorted list of morton code/object index pairings.
+             * \param[in] nodes   All nodes of the generated tree.
+             * \param[in] parents Index of the parent of each node in the node container.
+             */
+            void fitTreeBounds(std::vector<Math::BoundsAABB> const& bounds, std::vector<MortonPair> const& pairs, std::vector<BVHSceneNode*> const& nodes, std::vector<uint32_t> const& parents) const;
+
             /**
              * Adjusts the bounds of the specified node to fit over it's children.
              * \param[in] node Node to adjust the bounds of.
              */
             void fitNodeBounds(BVHSceneNode* node) const;
 
-        private:
+            /**
+             * Flattens the node tree into the linear node and object arrays used by all queries.
+             * Must be called whenever the structure or bounds of the node tree are modified.
+             *
+             * Implementations must also calculate the cost of the tree (see getCost).
+             */
+            virtual void flatten();
+
+            /**
+             * Recursively appends the specified node and all of it's children to the linear arrays.
+             * \param[in] node
+             */
+            void flattenNode(BVHSceneNode* node);
+
+            /**
+             * Restores the node tree from the linear node and object arrays. This is the reverse of flatten,
+             * and is used when a tree has been loaded (see load). The cost of the tree is not modified.
+             */
+            void unflatten();
+
+            /**
+             * Recursively creates the node at the specified linear index and all of it's children.
+             *
+             * \param[in] index  Index of the linear node.
+             * \param[in] parent Parent of the new node, or NULL for the root.
+             *
+             * \return The new node.
+             */
+            BVHSceneNode* unflattenNode(uint32_t index, BVHSceneNode* parent);
+
+            /**
+             * Writes the refit bounds of the nodes along the path of each leaf into the existing flattened
+             * nodes, and updates the cost of the tree. Only valid while the topology of the node tree
+             * is unchanged since the last flatten.
+             *
+             * \param[in] leaves
+             * \return FALSE if the flattened nodes can not be updated in place, in which case the tree must be flattened.
+             */
+            virtual bool refitLinearNodes(std::vector<BVHSceneNode*> const& leaves);
+
+            //------------------------------------------------------------
+            // Variables
+            //------------------------------------------------------------
 
             bool m_IsDirty;                            ///< Dirty flag indicating if the tree needs to be updated
+            bool m_IsTopologyChanged;                  ///< Set when nodes have been inserted, removed or rotated since the last flatten
                               
             BVHSceneNode* m_Root;                      ///< Root scene node of the tree.
             
             std::vector<BVHSceneNode*> m_DirtyNodes;   ///< Container of all dirty nodes that need to be updated
             std::vector<SceneObject*>  m_AllObjects;   ///< Convenience container for tree reconstruction. Prevents the need of a full-traversal.
+
+            std::unordered_map<SceneObject*, uint32_t> m_ObjectIndices;     ///< Index of each object within m_AllObjects
+            std::unordered_map<SceneObject*, uint32_t> m_NewObjectIndices;  ///< Index of each object within m_NewObjects
+
+            std::unordered_map<uint64_t, BVHSceneNode*> m_Leaves;  ///< Leaf nodes keyed by the 64-bit hash of their object's UUID
+
+            float m_Cost;                              ///< Surface area cost of the tree as of the last flatten (see getCost)
+            float m_BuildCost;                         ///< Surface area cost of the tree immediately after the last full rebuild
+            float m_NodeArea;                          ///< Sum of the (half) surface areas of all linear nodes, from which m_Cost is calculated
+
+            std::vector<BVHLinearNode> m_LinearNodes;    ///< Depth-first flattened copy of the node tree. Used by all queries.
+            std::vector<SceneObject*>  m_LinearObjects;  ///< Objects owned by the linear leaf nodes, in leaf order.
+
+        private:
         };
     }
     /**
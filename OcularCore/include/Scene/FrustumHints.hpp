@@ -0,0 +1,68 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#ifndef __H__OCULAR_CORE_SCENE_FRUSTUM_HINTS__H__
+#define __H__OCULAR_CORE_SCENE_FRUSTUM_HINTS__H__
+
+#include <vector>
+#include <cstdint>
+
+//------------------------------------------------------------------------------------------
+
+/**
+ * \addtogroup Ocular
+ * @{
+ */
+namespace Ocular
+{
+    /**
+     * \addtogroup Core
+     * @{
+     */
+    namespace Core
+    {
+        /**
+         * \struct FrustumHints
+         *
+         * The frustum plane that last culled each node of a scene tree for a single view.
+         *
+         * As a view changes very little from one frame to the next, a node is most likely to be culled
+         * by the same plane that culled it on the previous frame, and so that plane is tested first.
+         * The hints are owned by the view (see VisibilityCache) rather than the tree, so that the tree is
+         * never modified by a query and each view keeps it's own hints.
+         *
+         * The hints are indexed by the linear node index of the tree. If the number of nodes
+         * changes, the tree resets them. Otherwise stale hints only affect the order in which the
+         * planes are tested, and never the result of the query.
+         */
+        struct FrustumHints
+        {
+            std::vector<uint8_t> planes;          ///< Index [0, 5] of the plane that last culled each node
+        };
+    }
+    /**
+     * @} End of Doxygen Groups
+     */
+}
+/**
+ * @} End of Doxygen Groups
+ */
+
+//------------------------------------------------------------------------------------------
+
+#endif
@@ -20,6 +20,8 @@
 
 #include "SceneNode.hpp"
 #include "SceneTreeType.hpp"
+#include "RayQueryMode.hpp"
+#include "FrustumHints.hpp"
 #include "UUID.hpp"
 
 #include "Math/Bounds/Ray.hpp"
@@ -30,6 +32,7 @@
 
 #include <vector>
 #include <memory>
+#include <cfloat>
 
 //------------------------------------------------------------------------------------------
 
@@ -45,6 +48,8 @@ namespace Ocular
      */
     namespace Core
     {
+        class OcclusionBuffer;
+
         /**
          * \class ISceneTree
          */
@@ -131,8 +136,39 @@ namespace Ocular
              *
              * \param[in]  frustum Viewing frustum to check visibility against.
              * \param[out] objects List of all visible objects in the scene tree.
+             * \param[in]  hints   Optional per-node plane hints of the view, carried over from the previous query with it.
+             */
+            virtual void getAllVisibleObjects(Math::Frustum const& frustum, std::vector<SceneObject*>& objects, FrustumHints* hints = nullptr) const = 0;
+
+            /**
+             * Returns a flat list of all visible objects for each of the specified frustums.
+             * No order is guaranteed for the returned objects.
+             *
+             * This is equivalent to calling getAllVisibleObjects once for each frustum, but the tree is 
+             * only traversed a single time for all of them. Should be used whenever there are multiple
+             * views of the same scene (multiple cameras, shadow views, etc.).
+             *
+             * \param[in]  frustums Viewing frustums to check visibility against.
+             * \param[out] objects  List of visible objects for each frustum. Resized to at least the number of frustums; any
+             *                      objects already in the lists are kept and the visible objects are appended after them
+             *                      (so that the results of multiple trees may be gathered into the same lists).
+             * \param[in]  hints    Optional per-node plane hints of each view. If not empty, there must be one (possibly NULL) for each frustum.
              */
-            virtual void getAllVisibleObjects(Math::Frustum const& frustum, std::vector<SceneObject*>& objects) const = 0;
+            virtual void getAllVisibleObjects(std::vector<Math::Frustum> const& frustums, std::vector<std::vector<SceneObject*>>& objects, std::vector<FrustumHints*> const& hints = std::vector<FrustumHints*>()) const = 0;
+
+            /**
+             * Returns a flat list of all objects in the scene tree that are within the frustum and
+             * are not hidden behind the occluders rasterized into the occlusion buffer.
+             * No order is guaranteed for the returned objects.
+             *
+             * Where the tree structure allows, entire subtrees are rejected at once when their bounds are occluded.
+             *
+             * \param[in]  frustum   Viewing frustum to check visibility against.
+             * \param[in]  occlusion Buffer that has been cleared with the view of the frustum, and rasterized.
+             * \param[out] objects   List of all visible objects in the scene tree.
+             * \param[in]  hints     Optional per-node plane hints of the view, carried over from the previous query with it.
+             */
+            virtual void getAllVisibleObjects(Math::Frustum const& frustum, OcclusionBuffer const& occlusion, std::vector<SceneObject*>& objects, FrustumHints* hints = nullptr) const = 0;
 
             /**
              * Returns a list of all scene objects that intersect with the specified ray. 
@@ -147,6 +183,33 @@ namespace Ocular
              */
             virtual void getIntersections(Math::Ray const& ray, std::vector<std::pair<SceneObject*, float>>& objects) const = 0;
 
+            /**
+             * Returns a single scene object that intersects with the specified ray.
+             *
+             * Unlike getIntersections, the tree is traversed front-to-back and the query terminates
+             * as soon as the result is known. This should be preferred when only a single
+             * object is of interest (picking, line-of-sight, etc.).
+             *
+             * \param[in]  ray
+             * \param[in]  mode        Whether the closest intersection, or any intersection, is returned.
+             * \param[out] result      The intersected object and it's distance along the ray. Object is NULL if there was no intersection.
+             * \param[in]  maxDistance Intersections further along the ray than this distance are ignored.
+             *
+             * \return TRUE if an intersection was found.
+             */
+            virtual bool getIntersection(Math::Ray const& ray, RayQueryMode mode, std::pair<SceneObject*, float>& result, float maxDistance = FLT_MAX) const = 0;
+
+            /**
+             * Performs a single-result ray query (see getIntersection) for each of the specified rays.
+             * Large batches of rays are traced concurrently.
+             *
+             * \param[in]  rays
+             * \param[in]  mode         Whether the closest intersection, or any intersection, is returned for each ray.
+             * \param[out] results      The result of each ray. Resized to match the number of rays. Object is NULL if there was no intersection.
+             * \param[in]  maxDistances Optional maximum distance of each ray. If empty, the rays are unbounded.
+             */
+            virtual void getIntersections(std::vector<Math::Ray> const& rays, RayQueryMode mode, std::vector<std::pair<SceneObject*, float>>& results, std::vector<float> const& maxDistances = std::vector<float>()) const = 0;
+
             /**
              * Returns a list of all scene objects that intersect with the sphere.
              * An intersection occurs if a SceneObject either partially intersects or is entirely contained within the bounds.
@@ -174,6 +237,61 @@ namespace Ocular
              */
             virtual void getIntersections(Math::BoundsOBB const& bounds, std::vector<SceneObject*>& objects) const = 0;
 
+            /**
+             * Returns the scene objects nearest to the specified point, ordered from nearest to furthest.
+             * The distance to an object is the distance from the point to the nearest point of it's bounds.
+             *
+             * \param[in]  point
+             * \param[in]  count       Maximum number of objects to return.
+             * \param[out] objects     The nearest objects and their distances from the point.
+             * \param[in]  maxDistance Objects further from the point than this distance are ignored.
+             */
+            virtual void getNearestObjects(Math::Vector3f const& point, uint32_t count, std::vector<std::pair<SceneObject*, float>>& objects, float maxDistance = FLT_MAX) const = 0;
+
+            /**
+             * Performs a nearest object query (see getNearestObjects) for each of the specified points.
+             * Large batches of points are processed concurrently.
+             *
+             * \param[in]  points
+             * \param[in]  count       Maximum number of objects to return for each point.
+             * \param[out] objects     The nearest objects of each point. Resized to match the number of points.
+             * \param[in]  maxDistance Objects further from a point than this distance are ignored.
+             */
+            virtual void getNearestObjects(std::vector<Math::Vector3f> const& points, uint32_t count, std::vector<std::vector<std::pair<SceneObject*, float>>>& objects, float maxDistance = FLT_MAX) const = 0;
+
+            /**
+             * Returns all scene objects within the specified distance of a point, ordered from nearest to furthest.
+             * The distance to an object is the distance from the point to the nearest point of it's bounds.
+             *
+             * \param[in]  point
+             * \param[in]  radius
+             * \param[out] objects All objects within the radius and their distances from the point.
+             */
+            virtual void getObjectsInRadius(Math::Vector3f const& point, float radius, std::vector<std::pair<SceneObject*, float>>& objects) const = 0;
+
+            /**
+             * Returns every pair of scene objects in the tree whose bounds overlap.
+             * Each pair is returned exactly once, in no particular order.
+             *
+             * Only objects that were in the tree as of the last restructure are considered.
+             * Large trees are split into independent subtrees which are processed concurrently.
+             *
+             * \param[out] pairs All overlapping pairs.
+             */
+            virtual void getOverlappingPairs(std::vector<std::pair<SceneObject*, SceneObject*>>& pairs) const = 0;
+
+            /**
+             * Returns every pair of scene objects, one from this tree and one from the other tree, whose bounds overlap.
+             * If the other tree is this tree, this is equivalent to getOverlappingPairs(pairs).
+             *
+             * Only objects that were in either tree as of their last restructure are considered.
+             * Large trees are split into independent subtrees which are processed concurrently.
+             *
+             * \param[in]  other
+             * \param[out] pairs All overlapping pairs. The first object of each pair is from this tree, and the second from the other.
+             */
+            virtual void getOverlappingPairs(ISceneTree const* other, std::vector<std::pair<SceneObject*, SceneObject*>>& pairs) const = 0;
+
             /**
              * Returns the type of SceneTree this implementation is.
              */
@@ -21,6 +21,7 @@
 #include "Scene/Light/LightSource.hpp"
 #include "Scene/Light/GPULight.hpp"
 #include "Math/Geometry/Frustum.hpp"
+#include "Math/Bounds/BoundsSphereArray.hpp"
 
 #include <vector>
 #include <unordered_map>
@@ -131,6 +132,10 @@ namespace Ocular
 
             GPULight m_GPUAmbientLight;
 
+            Math::BoundsSphereArray m_CullSpheres;   // Bounding spheres of the point lights and spotlights being culled
+            std::vector<LightSource*> m_CullLights;  // Light represented by each sphere in m_CullSpheres
+            std::vector<uint32_t> m_CullMask;        // Visibility bit mask filled by Frustum::contains
+
         private:
         };
     }
@@ -0,0 +1,167 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef __H__OCULAR_CORE_SCENE_LOOSE_OCTREE_SCENE_TREE__H__
+#define __H__OCULAR_CORE_SCENE_LOOSE_OCTREE_SCENE_TREE__H__
+
+#include "ACellSceneTree.hpp"
+
+//------------------------------------------------------------------------------------------
+
+/**
+ * \addtogroup Ocular
+ * @{
+ */
+namespace Ocular
+{
+    /**
+     * \addtogroup Core
+     * @{
+     */
+    namespace Core
+    {
+        /**
+         * \class LooseOctreeSceneTree
+         *
+         * Implementation of a loose Octree Scene Tree.
+         *
+         * The world is a cube centered on the origin that is recursively split into eight equally
+         * sized cells. The bounds of each cell are then loosened by half of the cell's size in every
+         * direction, so that neighbouring cells overlap. An object is stored in the deepest cell that
+         * contains it's center and whose loose bounds are large enough to hold it's extents. Thus an
+         * object's cell depends only on it's own size and position, and never has to be split across
+         * cells.
+         *
+         * Cells are identified by their locational code: a leading 1 bit followed by the morton code
+         * of the cell's coordinates at it's depth. The parent of a cell is simply it's code shifted
+         * right by 3 bits. Only cells that contain objects (and their ancestors) exist.
+         *
+         * Objects that are larger than half of the world, or whose centers lie outside of the world,
+         * are stored in the root cell which is never culled.
+         *
+         * Source:
+         *
+         *     Thatcher Ulrich
+         *     Loose Octrees, Game Programming Gems
+         */
+        class LooseOctreeSceneTree : public ACellSceneTree
+        {
+        public:
+
+            /**
+             * \param[in] worldSize Length of each side of the world cube.
+             * \param[in] maxDepth  Maximum depth of a cell below the root. Clamped to 20.
+             */
+            LooseOctreeSceneTree(float worldSize = 8192.0f, uint32_t maxDepth = 10);
+            virtual ~LooseOctreeSceneTree();
+
+            virtual void destroy() override;
+            virtual SceneTreeType getType() const override;
+
+        protected:
+
+            /**
+             * Position of a cell, used during traversal.
+             */
+            struct CellPosition
+            {
+                uint64_t code;            ///< Locational code
+                uint32_t depth;           ///< Depth below the root
+                uint32_t coords[3];       ///< Integer coordinates of the cell at it's depth
+            };
+
+            //------------------------------------------------------------
+            // Cell Methods
+            //------------------------------------------------------------
+
+            virtual uint64_t getCell(float const boundsMin[3], float const boundsMax[3]) const override;
+            virtual void onCellCreated(uint64_t cell) override;
+            virtual void onCellDestroyed(uint64_t cell) override;
+
+            /**
+             * Calculates the loose bounds of the cell at the specified position.
+             * The root cell is unbounded, and is given bounds of (-FLT_MAX, FLT_MAX).
+             */
+            void getLooseBounds(CellPosition const& position, float boundsMin[3], float boundsMax[3]) const;
+
+            /**
+             * Returns the position of the specified child of a cell.
+             *
+             * \param[in] position
+             * \param[in] child    Lowest 3 bits of the child's locational code
+             */
+            CellPosition getChild(CellPosition const& position, uint32_t child) const;
+
+            /**
+             * Returns the bitmask of the existing children of the specified cell.
+             * Each child is represented by the bit (1 << (child code & 7)).
+             */
+            uint32_t getChildren(uint64_t cell) const;
+
+            /**
+             * Returns the objects of the specified cell, or NULL if the cell has no objects.
+             */
+            std::vector<CellObject> const* getObjects(uint64_t cell) const;
+
+            //------------------------------------------------------------
+            // Traversal Methods
+            //------------------------------------------------------------
+
+            virtual void findVisible(Math::Frustum const& frustum, std::vector<SceneObject*>& objects) const override;
+            virtual void findIntersections(Math::Ray const& ray, std::vector<std::pair<SceneObject*, float>>& objects) const override;
+            virtual bool findIntersection(Math::Ray const& ray, RayQueryMode mode, float maxDistance, std::pair<SceneObject*, float>& result) const override;
+            virtual void findNearestObjects(Math::Vector3f const& point, uint32_t count, float maxDistance, std::vector<std::pair<SceneObject*, float>>& objects) const override;
+            virtual void findIntersections(Math::BoundsSphere const& bounds, std::vector<SceneObject*>& objects) const override;
+            virtual void findIntersections(Math::BoundsAABB const& bounds, std::vector<SceneObject*>& objects) const override;
+            virtual void findIntersections(Math::BoundsOBB const& bounds, std::vector<SceneObject*>& objects) const override;
+
+            /**
+             * Generic depth-first traversal used by the bounds queries.
+             *
+             * The test is invoked with the loose bounds of each existing cell (other than the root), and
+             * with the bounds of each object in the cells that pass. Only the children of cells that
+             * pass are traversed. Every object that passes is appended to the collection.
+             */
+            template<typename Test>
+            void findIntersecting(Test const& test, std::vector<SceneObject*>& objects) const;
+
+            //------------------------------------------------------------
+            // Variables
+            //------------------------------------------------------------
+
+            float m_WorldSize;                                  ///< Length of each side of the world cube
+            float m_WorldMin;                                   ///< Minimum coordinate of the world cube on each axis
+            uint32_t m_MaxDepth;                                ///< Maximum depth of a cell below the root
+
+            uint64_t m_AxisBits[3];                             ///< Bit within the lowest 3 bits of a locational code that corresponds to each axis
+
+            std::unordered_map<uint64_t, uint32_t> m_Branches;  ///< Bitmask of the existing children of each cell that has any (see getChildren)
+
+        private:
+        };
+    }
+    /**
+     * @} End of Doxygen Groups
+     */
+}
+/**
+ * @} End of Doxygen Groups
+ */
+
+//------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
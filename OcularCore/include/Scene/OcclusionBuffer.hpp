@@ -0,0 +1,240 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#ifndef __H__OCULAR_CORE_SCENE_OCCLUSION_BUFFER__H__
+#define __H__OCULAR_CORE_SCENE_OCCLUSION_BUFFER__H__
+
+#include "Math/Matrix4x4.hpp"
+#include "Math/Bounds/BoundsAABB.hpp"
+
+#include <vector>
+#include <cstdint>
+
+//------------------------------------------------------------------------------------------
+
+/**
+ * \addtogroup Ocular
+ * @{
+ */
+namespace Ocular
+{
+    /**
+     * \addtogroup Core
+     * @{
+     */
+    namespace Core
+    {
+        class SceneObject;
+
+        /**
+         * \class OcclusionBuffer
+         *
+         * Low-resolution depth buffer that is rasterized entirely on the CPU, and used to
+         * determine if bounds are hidden behind a set of occluders (large walls, buildings, terrain, etc.).
+         *
+         * Usage each frame is as follows:
+         *
+         *     buffer.clear(projectionMatrix * viewMatrix);
+         *     buffer.addOccluder(object);   // for each occluder
+         *     buffer.rasterize();
+         *     
+         *     if(!buffer.isOccluded(bounds)) { ... render ... }
+         *
+         * The stored depth is the normalized device depth (z / w), so the buffer is independent of
+         * whether the projection maps depth to [-1, 1] or [0, 1]. Rasterization is split into bands
+         * of tile rows across the worker threads, with each row filled four pixels at a time using SSE
+         * (or one at a time when SSE is unavailable or OCULAR_DISABLE_SIMD is defined).
+         * Once rasterized, the maximum depth of each 8x8 tile is recorded so that most queries
+         * can be resolved without visiting individual pixels.
+         *
+         * Tests are conservative: bounds are only reported as occluded if every pixel that they
+         * may cover holds an occluder that is strictly nearer than the nearest point of the bounds.
+         */
+        class OcclusionBuffer
+        {
+        public:
+
+            static const uint32_t TileSize = 8;    ///< Width and height, in pixels, of a single hierarchical depth tile
+
+            /**
+             * \param[in] width  Horizontal resolution. Rounded up to a multiple of TileSize.
+             * \param[in] height Vertical resolution. Rounded up to a multiple of TileSize.
+             */
+            OcclusionBuffer(uint32_t width = 256, uint32_t height = 128);
+            ~OcclusionBuffer();
+
+            /**
+             * Resizes the buffer. This also clears the buffer and all pending occluders.
+             *
+             * \param[in] width  Horizontal resolution. Rounded up to a multiple of TileSize.
+             * \param[in] height Vertical resolution. Rounded up to a multiple of TileSize.
+             */
+            void setResolution(uint32_t width, uint32_t height);
+
+            uint32_t getWidth() const;
+            uint32_t getHeight() const;
+
+            /**
+             * Clears the depth and all pending occluders, and sets the matrix that occluders and
+             * tested bounds are projected with. Must be called prior to adding the occluders of a new view.
+             *
+             * \param[in] viewProjection Combined (projection * view) matrix of the view.
+             */
+            void clear(Math::Matrix4x4 const& viewProjection);
+
+            /**
+             * Adds the triangles of an indexed mesh to be rasterized.
+             *
+             * \param[in] vertices    Vertex positions, in model space.
+             * \param[in] indices     Three indices per triangle.
+             * \param[in] modelMatrix Transforms the vertices into world space.
+             */
+            void addOccluder(std::vector<Math::Vector3f> const& vertices, std::vector<uint32_t> const& indices, Math::Matrix4x4 const& modelMatrix);
+
+            /**
+             * Adds the triangles of every submesh of the object's MeshRenderable to be rasterized.
+             *
+             * \param[in] object
+             * \return FALSE if the object does not have a MeshRenderable with a valid mesh.
+             */
+            bool addOccluder(SceneObject* object);
+
+            /**
+             * Rasterizes all added occluders into the buffer, and builds the per-tile maximum depth.
+             * Must be called after all occluders have been added, and prior to any occlusion tests.
+             */
+            void rasterize();
+
+            /**
+             * \param[in] boundsMin Minimum point of the world AABB to test.
+             * \param[in] boundsMax Maximum point of the world AABB to test.
+             *
+             * \return TRUE if the bounds are entirely hidden behind the rasterized occluders.
+             */
+            bool isOccluded(float const boundsMin[3], float const boundsMax[3]) const;
+
+            /**
+             * \param[in] bounds World AABB to test.
+             * \return TRUE if the bounds are entirely hidden behind the rasterized occluders.
+             */
+            bool isOccluded(Math::BoundsAABB const& bounds) const;
+
+            /**
+             * \param[in] x
+             * \param[in] y
+             *
+             * \return The rasterized depth of the pixel, or FLT_MAX if no occluder covers it.
+             */
+            float getDepth(uint32_t x, uint32_t y) const;
+
+            /**
+             * \return The number of triangles added since the last clear (after clipping against the near plane).
+             */
+            uint32_t getNumTriangles() const;
+
+        protected:
+
+            /**
+             * A screen-space triangle prepared for rasterization.
+             *
+             * The edge and depth functions are all planes over the screen, evaluated as (a * x) + (b * y) + c.
+             * A pixel is covered if all three edge functions are non-negative at it's center.
+             */
+            struct Triangle
+            {
+                float edges[3][3];        ///< (a, b, c) of each edge function
+                float depth[3];           ///< (a, b, c) of the depth function
+                int32_t minX;             ///< First covered column
+                int32_t maxX;             ///< Last covered column
+                int32_t minY;             ///< First covered row
+                int32_t maxY;             ///< Last covered row
+            };
+
+            /**
+             * Builds the triangles of the transformed vertices (in m_ClipVertices), clipping against the near plane.
+             * \param[in] indices Three indices per triangle.
+             */
+            void addTriangles(std::vector<uint32_t> const& indices);
+
+            /**
+             * Clips a triangle in clip space against the near plane (w = NearW) and adds the result.
+             * \param[in] vertices Three clip space vertices (x, y, z, w).
+             */
+            void clipTriangle(float const vertices[3][4]);
+
+            /**
+             * Projects a triangle that is entirely in front of the near plane, and adds it if it covers any pixels.
+             * \param[in] vertices Three clip space vertices (x, y, z, w).
+             */
+            void setupTriangle(float const* vertices[3]);
+
+            /**
+             * Rasterizes every triangle that overlaps the rows [firstRow, lastRow).
+             *
+             * \param[in] firstRow
+             * \param[in] lastRow
+             */
+            void rasterizeRows(uint32_t firstRow, uint32_t lastRow);
+
+            /**
+             * Records the maximum depth of each tile in the tile rows [firstTileRow, lastTileRow).
+             *
+             * \param[in] firstTileRow
+             * \param[in] lastTileRow
+             */
+            void buildTiles(uint32_t firstTileRow, uint32_t lastTileRow);
+
+            /**
+             * \param[in] minX    First column to test.
+             * \param[in] maxX    Last column to test.
+             * \param[in] minY    First row to test.
+             * \param[in] maxY    Last row to test.
+             * \param[in] depth   Nearest depth of the bounds being tested.
+             *
+             * \return TRUE if every pixel in the range holds a depth nearer than the specified depth.
+             */
+            bool isRangeOccluded(int32_t minX, int32_t maxX, int32_t minY, int32_t maxY, float depth) const;
+
+        private:
+
+            uint32_t m_Width;
+            uint32_t m_Height;
+            uint32_t m_TilesX;
+            uint32_t m_TilesY;
+
+            float m_ViewProjection[16];           ///< Column-major view-projection matrix
+
+            std::vector<float> m_Depth;           ///< Per-pixel depth, row-major
+            std::vector<float> m_TileDepth;       ///< Maximum depth of each tile, row-major
+            std::vector<float> m_ClipVertices;    ///< Scratch storage for the transformed vertices of an occluder (4 floats each)
+            std::vector<Triangle> m_Triangles;    ///< Triangles pending rasterization
+
+            bool m_IsEmpty;                       ///< TRUE if nothing has been rasterized since the last clear
+        };
+    }
+    /**
+     * @} End of Doxygen Groups
+     */
+}
+/**
+ * @} End of Doxygen Groups
+ */
+
+//------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
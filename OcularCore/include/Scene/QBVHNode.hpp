@@ -0,0 +1,76 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef __H__OCULAR_CORE_SCENE_QBVH_NODE__H__
+#define __H__OCULAR_CORE_SCENE_QBVH_NODE__H__
+
+#include <cstdint>
+
+//------------------------------------------------------------------------------------------
+
+/**
+ * \addtogroup Ocular
+ * @{
+ */
+namespace Ocular
+{
+    /**
+     * \addtogroup Core
+     * @{
+     */
+    namespace Core
+    {
+        /**
+         * \struct QBVHNode
+         *
+         * Node of a 4-wide Bounding Volume Hierarchy (see QBVHSceneTree).
+         *
+         * Unlike the BVHLinearNode, a QBVHNode does not store it's own bounds but instead
+         * the bounds of each of it's (up to) four children. The bounds are stored in
+         * structure-of-arrays form so that all four children may be tested at once
+         * using a single sequence of SIMD instructions.
+         *
+         * Each child is either another QBVHNode (index into the node array) or a leaf
+         * (flagged with LeafFlag, index into the object array). Children are packed to the
+         * front of the node, so only the first numChildren entries are valid.
+         */
+        struct QBVHNode
+        {
+            static const uint32_t LeafFlag = 0x80000000;    ///< Set on a child that refers to an object rather than a node
+
+            float boundsMinX[4];      ///< Minimum x-component of each child's bounds
+            float boundsMinY[4];      ///< Minimum y-component of each child's bounds
+            float boundsMinZ[4];      ///< Minimum z-component of each child's bounds
+            float boundsMaxX[4];      ///< Maximum x-component of each child's bounds
+            float boundsMaxY[4];      ///< Maximum y-component of each child's bounds
+            float boundsMaxZ[4];      ///< Maximum z-component of each child's bounds
+
+            uint32_t children[4];     ///< Node index, or object index if the LeafFlag is set
+            uint32_t numChildren;     ///< Number of valid children [1, 4]
+        };
+    }
+    /**
+     * @} End of Doxygen Groups
+     */
+}
+/**
+ * @} End of Doxygen Groups
+ */
+
+//------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
@@ -21,6 +21,7 @@
 #include "Scene/ARenderable.hpp"
 
 #include <vector>
+#include <utility>
 
 //------------------------------------------------------------------------------------------
 
@@ -61,6 +62,10 @@ namespace Ocular
          * 
          * Specifying NULL as a Material is valid for this renderable and it disables rendering of 
          * any associated SubMeshes. 
+         *
+         * Lower levels of detail may be added with addLOD. The level rendered for each camera is selected
+         * by the Scene from the projected size of the parent SceneObject (see ARenderable::updateLOD).
+         * Every level is rendered with the same Materials.
          */
         class MeshRenderable : public ARenderable
         {
@@ -86,6 +91,14 @@ namespace Ocular
 
             virtual void buildBounds(Math::BoundsSphere* sphere, Math::BoundsAABB* aabb, Math::BoundsOBB* obb, Math::Matrix4x4 const& matrix = Math::Matrix4x4()) override;
 
+            /**
+             * Selects the level of detail to render from the projected size.
+             *
+             * \param[in] screenSize
+             * \return FALSE if the projected size is below the cull screen size.
+             */
+            virtual bool updateLOD(float screenSize) override;
+
             /**
              * \return The highest render priority of all Materials in the MeshRenderable
              */
@@ -112,6 +125,75 @@ namespace Ocular
              * \return Pointer to the rendered Mesh. May be NULL.
              */
             Graphics::Mesh* getMesh() const;
+
+            //------------------------------------------------------------
+            // Level of Detail Methods
+            //------------------------------------------------------------
+
+            /**
+             * Adds a lower level of detail.
+             *
+             * The Mesh set with setMesh is always level 0, and is rendered while the projected size is at least 
+             * the screen size of level 1. Every other level is rendered while the projected size is below it's own 
+             * screen size but at least that of the next level. Levels are ordered from largest screen size to smallest.
+             *
+             * The bounds of the SceneObject are always built from the level 0 Mesh.
+             *
+             * \param[in] mesh       Pointer to the Mesh resource.
+             * \param[in] screenSize Projected diameter, as a fraction of the viewport height, below which this level is used.
+             *
+             * \return The level assigned to the Mesh.
+             */
+            uint32_t addLOD(Graphics::Mesh* mesh, float screenSize);
+
+            /**
+             * Adds a lower level of detail. See addLOD(Graphics::Mesh*, float).
+             *
+             * \param[in] name       The mapping-name of the Mesh resource.
+             * \param[in] screenSize Projected diameter, as a fraction of the viewport height, below which this level is used.
+             *
+             * \return FALSE if the Mesh resource was not found.
+             */
+            bool addLOD(std::string const& name, float screenSize);
+
+            /**
+             * Removes a lower level of detail. Level 0 can not be removed.
+             * \param[in] level
+             */
+            void removeLOD(uint32_t level);
+
+            /**
+             * \return The number of levels of detail, including level 0.
+             */
+            uint32_t getNumLODs() const;
+
+            /**
+             * \param[in] level
+             * \return The Mesh rendered at the specified level. May be NULL.
+             */
+            Graphics::Mesh* getLODMesh(uint32_t level) const;
+
+            /**
+             * \param[in] level
+             * \return The screen size below which the specified level is used. FLT_MAX for level 0.
+             */
+            float getLODScreenSize(uint32_t level) const;
+
+            /**
+             * \return The level selected by the last call to updateLOD.
+             */
+            uint32_t getCurrentLOD() const;
+
+            /**
+             * Sets the projected size below which the renderable is not rendered at all. Default: 0.
+             * \param[in] screenSize Projected diameter, as a fraction of the viewport height.
+             */
+            void setCullScreenSize(float screenSize);
+
+            /**
+             * \return The projected size below which the renderable is not rendered.
+             */
+            float getCullScreenSize() const;
             
             //------------------------------------------------------------
             // Material Methods
@@ -192,6 +274,10 @@ namespace Ocular
             Graphics::Mesh* m_Mesh;
             std::vector<Graphics::Material*> m_Materials;
 
+            std::vector<std::pair<Graphics::Mesh*, float>> m_LODs;    ///< Levels 1+ and their screen sizes, from the largest screen size to the smallest
+            uint32_t m_CurrentLOD;
+            float m_CullScreenSize;
+
         private:
         };
     }
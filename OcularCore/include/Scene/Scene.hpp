@@ -19,6 +19,7 @@
 #define __H__OCULAR_CORE_SCENE__H__
 
 #include "SceneTreeType.hpp"
+#include "VisibilityCache.hpp"
 #include "UUID.hpp"
 
 #include "Math/Geometry/Frustum.hpp"
@@ -27,6 +28,7 @@
 #include <list>
 #include <queue>
 #include <functional>
+#include <unordered_map>
 
 //------------------------------------------------------------------------------------------
 
@@ -49,9 +51,12 @@ namespace Ocular
     {
         class SceneManager;
         class ISceneTree;
+        class File;
         class SceneObject;
         class ARoutine;
         class Renderer;
+        class Camera;
+        class OcclusionBuffer;
 
         /**
          * \class Scene
@@ -147,6 +152,11 @@ namespace Ocular
             void getVisibleSceneObjects(std::vector<SceneObject*>& objects, Math::Frustum const& frustum);
 
             /**
+             * Sets the type of SceneTree used for static objects. Must be set prior to initialization.
+             *
+             * As the static tree is rarely rebuilt, a higher quality (but slower to construct) tree 
+             * such as SceneTreeType::BoundingVolumeHierarchySAHCPU is often preferred.
+             *
              * \param[in] type
              */
             void setStaticTreeType(SceneTreeType type);
@@ -157,6 +167,12 @@ namespace Ocular
             SceneTreeType const& getStaticTreeType() const;
 
             /**
+             * Sets the type of SceneTree used for dynamic objects. Must be set prior to initialization.
+             *
+             * Scenes in which a large number of small objects move every frame are often better served by
+             * a cell-based tree (SceneTreeType::OctTreeCPU or SceneTreeType::UniformGridCPU), as moving
+             * an object within them is a constant-time operation.
+             *
              * \param[in] type
              */
             void setDynamicTreeType(SceneTreeType type);
@@ -176,6 +192,66 @@ namespace Ocular
              */
             std::string const& getRendererType() const;
 
+            /**
+             * Restructures the static tree and saves it to the specified file.
+             *
+             * Only supported if the static tree is a BVHSceneTree (see BVHSceneTree::save).
+             *
+             * \param[in] file
+             * \return TRUE if the static tree was saved.
+             */
+            bool saveStaticTree(File const& file);
+
+            /**
+             * Loads the static tree from a file previously written by saveStaticTree.
+             *
+             * Must be called after all static objects have been added to the Scene, but prior to the first update.
+             * If successful, the static tree does not need to be built. Otherwise it is built as normal on the next update.
+             *
+             * \param[in] file
+             * \return TRUE if the static tree was loaded.
+             */
+            bool loadStaticTree(File const& file);
+
+            /**
+             * Enables or disables occlusion culling. Disabled by default.
+             *
+             * When enabled, the occluders (see SceneObject::setOccluder) within view of each camera are rasterized
+             * on the CPU into a low-resolution depth buffer prior to rendering. Any SceneTree nodes and objects 
+             * that are entirely hidden behind the occluders are then not passed on to the Renderer.
+             *
+             * As each camera requires it's own depth buffer, the cameras are no longer culled in a single pass.
+             *
+             * \param[in] enabled
+             */
+            void setOcclusionCulling(bool enabled);
+
+            /**
+             * \return TRUE if occlusion culling is enabled.
+             */
+            bool isOcclusionCullingEnabled() const;
+
+            /**
+             * \return The buffer used for occlusion culling (may be used to change it's resolution), or NULL if occlusion culling is disabled.
+             */
+            OcclusionBuffer* getOcclusionBuffer() const;
+
+            /**
+             * Sets the minimum projected size, in pixels, of a visible object's bounding sphere.
+             * Any objects that appear smaller than this are not passed on to the Renderer.
+             * Cameras without a viewport are not affected, as the pixel size of an object can not be known.
+             *
+             * The same projected size is used to select the level of detail of each renderable (see ARenderable::updateLOD).
+             *
+             * \param[in] pixels Minimum diameter in pixels. Set to 0 (the default) to disable small object culling.
+             */
+            void setSmallObjectCulling(float pixels);
+
+            /**
+             * \return The minimum projected diameter, in pixels, of rendered objects.
+             */
+            float getSmallObjectCulling() const;
+
         protected:
 
             Scene();
@@ -185,6 +261,37 @@ namespace Ocular
             void updateRoutines();
             void sortRoutines();
 
+            /**
+             * Rasterizes the occluders within view of the camera, and then retrieves all objects 
+             * from both SceneTrees that are within the frustum and not hidden behind the occluders.
+             *
+             * \param[in]  camera
+             * \param[in]  frustum Frustum of the camera.
+             * \param[out] objects
+             */
+            void getUnoccludedObjects(Camera* camera, Math::Frustum const& frustum, std::vector<SceneObject*>& objects);
+
+            /**
+             * Brings the visibility cache of the camera up to date without culling the entire Scene, if possible.
+             *
+             * This is possible if the camera has not moved and no objects have been added or removed since the previous
+             * frame. Any objects that have moved since the previous frame are individually retested against the frustum.
+             * With occlusion culling, no objects may have moved (as they may be occluders).
+             *
+             * \param[in] camera
+             * \return TRUE if the cache is up to date. Otherwise it must be refilled.
+             */
+            bool updateVisibilityCache(Camera* camera);
+
+            /**
+             * Removes any objects that have changed since the previous frame from the cached visible set,
+             * and then adds back those that are still active, within the Scene, and within the frustum.
+             *
+             * \param[in]  frustum
+             * \param[out] objects
+             */
+            void updateChangedObjects(Math::Frustum const& frustum, std::vector<SceneObject*>& objects);
+
             ISceneTree* getStaticTree() const;
             ISceneTree* getDynamicTree() const;
 
@@ -208,6 +315,22 @@ namespace Ocular
              */
             void objectParentChanged(SceneObject* object, SceneObject* oldParent);
 
+            /**
+             * Alerts when the SceneObject has become, or is no longer, an occluder.
+             * This happens when the SceneObject::SetOccluder() method is called.
+             *
+             * \param[in] object
+             */
+            void objectOccluderChanged(SceneObject* object);
+
+            /**
+             * Alerts when the SceneObject has been activated or deactivated.
+             * This happens when the SceneObject::SetActive() method is called.
+             *
+             * \param[in] object
+             */
+            void objectActiveChanged(SceneObject* object);
+
             /**
              * Alerts when a new routine has been created and added to a SceneObject.
              * \param[in] routine
@@ -243,6 +366,16 @@ namespace Ocular
             std::vector<ARoutine*> m_Routines;
             bool m_RoutinesAreDirty;
 
+            OcclusionBuffer* m_OcclusionBuffer;     ///< Only allocated while occlusion culling is enabled
+            std::vector<SceneObject*> m_Occluders;
+
+            float m_MinScreenPixels;
+
+            std::unordered_map<Camera*, VisibilityCache> m_VisibilityCaches;
+            std::vector<UUID> m_ChangedObjects;     ///< Objects that have moved or changed activeness since the previous frame
+            uint64_t m_Revision;                    ///< Incremented whenever objects are added or removed, or change in a way not tracked by m_ChangedObjects
+            uint64_t m_RenderFrame;
+
         };
     }
     /**
@@ -20,7 +20,9 @@
 
 #include "Scene.hpp"
 #include "SceneObject.hpp"
+#include "TransformSystem.hpp"
 #include "SceneTreeType.hpp"
+#include "RayQueryMode.hpp"
 #include "Renderer/Renderer.hpp"
 #include "ComponentFactory.hpp"
 #include "FileIO/File.hpp"
@@ -237,6 +239,32 @@ namespace Ocular
              */
             void getIntersections(Math::Ray const& ray, std::vector<std::pair<SceneObject*, float>>& objects) const;
 
+            /**
+             * Returns a single scene object that intersects with the specified ray.
+             *
+             * This is considerably faster than getIntersections when only a single object is of
+             * interest, such as when picking the object nearest to the camera or testing line-of-sight.
+             *
+             * \param[in]  ray
+             * \param[in]  mode        Whether the closest intersection, or any intersection, is returned.
+             * \param[out] result      The intersected object and it's distance along the ray. Object is NULL if there was no intersection.
+             * \param[in]  maxDistance Intersections further along the ray than this distance are ignored.
+             *
+             * \return TRUE if an intersection was found.
+             */
+            bool getIntersection(Math::Ray const& ray, RayQueryMode mode, std::pair<SceneObject*, float>& result, float maxDistance = FLT_MAX) const;
+
+            /**
+             * Performs a single-result ray query (see getIntersection) for each of the specified rays.
+             * Large batches of rays are traced concurrently.
+             *
+             * \param[in]  rays
+             * \param[in]  mode         Whether the closest intersection, or any intersection, is returned for each ray.
+             * \param[out] results      The result of each ray. Object is NULL if there was no intersection.
+             * \param[in]  maxDistances Optional maximum distance of each ray. If empty, the rays are unbounded.
+             */
+            void getIntersections(std::vector<Math::Ray> const& rays, RayQueryMode mode, std::vector<std::pair<SceneObject*, float>>& results, std::vector<float> const& maxDistances = std::vector<float>()) const;
+
             /**
              * Returns a list of all scene objects that intersect with the sphere.
              * An intersection occurs if a SceneObject either partially intersects or is entirely contained within the bounds.
@@ -264,6 +292,18 @@ namespace Ocular
              */
             void getIntersections(Math::BoundsOBB const& bounds, std::vector<SceneObject*>& objects) const;
 
+            /**
+             * Returns every pair of scene objects whose bounds overlap, and of which at least one is dynamic.
+             * Pairs of static objects are not returned, as they never begin or stop overlapping.
+             *
+             * The dynamic tree is tested against itself and against the static tree using a simultaneous
+             * traversal of both trees, rather than by querying the bounds of each object individually.
+             * Each pair is returned once. When one object is static, it is always the second of the pair.
+             *
+             * \param[out] pairs
+             */
+            void getOverlappingPairs(std::vector<std::pair<SceneObject*, SceneObject*>>& pairs) const;
+
             //------------------------------------------------------------------------------
             // Scene Methods
 
@@ -290,6 +330,9 @@ namespace Ocular
              * If any changes to that Scene need to be saved prior to unloading, then the
              * saveScene method should be called prior to loadScene.
              *
+             * If a static tree was saved alongside the Scene (see saveScene), and it is not older than the
+             * Scene file, it is loaded in place of building the static tree.
+             *
              * \param[in] file
              * \return TRUE if loaded successfully
              */
@@ -298,6 +341,8 @@ namespace Ocular
             /**
              * Attempts to save the Scene to the specified .oscene file.
              *
+             * The built static tree is also saved, when supported, to a .obvh file of the same name and directory.
+             *
              * \param[in] file
              * \return TRUE if saved successfully
              */
@@ -328,6 +373,11 @@ namespace Ocular
              */
             ComponentFactory<Renderer>& getRendererFactory();
 
+            /**
+             * \return The storage of the local and world matrices of every SceneObject.
+             */
+            TransformSystem& getTransformSystem();
+
         protected:
 
             void loadPersistentObjects();
@@ -346,9 +396,18 @@ namespace Ocular
             /**
              * Tells the current Scene to update and restructure it's SceneTrees. Also calls the various update methods
              * for all active SceneObjects.
+             *
+             * Afterwards, all world matrices and bounds that are still out of date are rebuilt in a single batch
+             * (see updateBounds).
              */
             void update();
 
+            /**
+             * Rebuilds all out of date world matrices and bounds (see TransformSystem::update), and then
+             * passes the new bounds to each moved SceneObject and notifies the SceneTrees once per object.
+             */
+            void updateBounds();
+
             /**
              * Tells the current Scene to retrieve all visible SceneObjects and perform envoke their render methods.
              */
@@ -372,6 +431,12 @@ namespace Ocular
              */
             void objectStaticChanged(SceneObject* object);
 
+            /**
+             * Called when a SceneObject's SetOccluder method is envoked.
+             * \param[in] object
+             */
+            void objectOccluderChanged(SceneObject* object);
+
             /**
              * Called when a SceneObject adds a new ARoutine instance.
              * \param[in] routine
@@ -403,6 +468,8 @@ namespace Ocular
             ComponentFactory<ARenderable> m_RenderableFactory;
             ComponentFactory<SceneObject> m_SceneObjectFactory;
             ComponentFactory<Renderer>    m_RendererFactory;
+
+            TransformSystem m_TransformSystem;
         };
     }
     /**
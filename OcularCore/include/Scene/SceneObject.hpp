@@ -212,6 +212,23 @@ namespace Ocular
              */
             bool isStatic() const;
 
+            /**
+             * Sets whether this object is an occluder. When occlusion culling is enabled for the Scene,
+             * the mesh of each occluder within view is rasterized into a low-resolution depth buffer,
+             * and any objects that are entirely hidden behind them are not rendered.
+             *
+             * Occluders should be large, simple meshes that hide much of the scene (walls, buildings, terrain).
+             * The object must have a MeshRenderable to have any effect.
+             *
+             * \param[in] isOccluder
+             */
+            void setOccluder(bool isOccluder);
+
+            /**
+             * \return TRUE if the object is an occluder.
+             */
+            bool isOccluder() const;
+
             /**
              * Sets whether this object should persist inbetween scenes.
              *
@@ -230,10 +247,25 @@ namespace Ocular
             bool isPersistent() const;
 
             /**
+             * Returns the complete per-object uniform data for the specified view.
+             * The model and normal matrices are cached (see getModelUniformData).
              *
+             * \param[in] viewMatrix
+             * \param[in] projMatrix
              */
             Graphics::UniformPerObject const& getUniformData(Math::Matrix4x4 const& viewMatrix, Math::Matrix4x4 const& projMatrix);
 
+            /**
+             * Fills in the view independent part of the uniform data (the model and normal matrices).
+             *
+             * Both are cached across frames, and are only rebuilt after the world matrix has changed.
+             * The view dependent matrices are left untouched, so that they may be computed for all
+             * visible objects in a single batch (see Renderer::updateUniforms).
+             *
+             * \param[out] data
+             */
+            void getModelUniformData(Graphics::UniformPerObject& data);
+
             //------------------------------------------------------------
             // Movement and Rotation Methods
             //------------------------------------------------------------
@@ -330,7 +362,19 @@ namespace Ocular
             Math::Transform const& getTransform() const;
 
             /**
+             * Returns the model matrix of this object.
+             *
+             * The world matrix (local = FALSE) is cached within the TransformSystem, and is only rebuilt when
+             * this object or one of it's ancestors is moved, rotated, scaled, or reparented. As a result, retrieving
+             * it is typically a copy instead of a multiplication of the entire parent chain.
+             *
+             * Any matrices still out of date at the end of SceneManager::update are rebuilt in a single batch.
+             *
+             * \note If the transform of an object with children is modified directly via getTransform(),
+             *       onVariableModified("m_Transform") must be called for the children to be updated.
              *
+             * \param[in] local If TRUE, returns the matrix relative to the parent (local space).
+             *                  If FALSE, returns the matrix relative to the world (world space).
              */
             virtual Math::Matrix4x4 getModelMatrix(bool local = true) const;
 
@@ -676,8 +720,12 @@ namespace Ocular
             void forceBoundsRebuild();
 
             /**
-             * Updates the bounds due to the selected actions (translation, rotation, and/or scaling).
-             * This is typically called automatically whenever needed.
+             * Updates the world bounds due to the selected actions (translation, rotation, and/or scaling).
+             *
+             * Moving an object only flags it's bounds as dirty. The bounds of every moved object are then
+             * transformed in a single batch (see TransformSystem::update) at the end of SceneManager::update,
+             * which calls this method once per moved object before notifying the SceneTrees. It is also called
+             * whenever the world bounds of a dirty object are requested in the meantime.
              *
              * \param[in] dirtyFlags Actions that caused the bounds to be dirty and require a rebuild. See Math::Transform::DirtyFlags
              */
@@ -712,6 +760,30 @@ namespace Ocular
             void getModelMatrix(Math::Matrix4x4& matrix);
             void removeChild(std::vector<SceneObject*>::iterator& child);
 
+            /**
+             * Flags the cached world matrix, bounds and uniform data of this object, and all of it's descendants, as requiring a rebuild.
+             * Descendants of an already invalid object are also already invalid, so the propagation stops there.
+             *
+             * Is const as it only modifies the cached matrices, bounds and uniform data.
+             */
+            void invalidateWorldMatrix() const;
+
+            /**
+             * Copies the local transform into the TransformSystem, and invalidates the world matrices.
+             */
+            void syncTransform() const;
+
+            /**
+             * Copies the current parent into the TransformSystem, and invalidates the world matrices.
+             */
+            void syncTransformParent();
+
+            /**
+             * Applies any changes made to the local transform to the TransformSystem, and flags the
+             * cached matrices and bounds of this object and it's descendants as dirty.
+             */
+            void updateTransform();
+
             //------------------------------------------------------------
 
             SceneObject* m_Parent;
@@ -722,6 +794,10 @@ namespace Ocular
             Graphics::UniformPerObject m_UniformData;
             Math::Transform m_Transform;
 
+            uint32_t m_TransformHandle;                ///< Handle of the cached local and world matrices within the TransformSystem
+            mutable bool m_IsBoundsDirty;              ///< If true, the world bounds must be retrieved again (see updateBounds)
+            mutable bool m_IsUniformDirty;             ///< If true, the cached model and normal matrices must be rebuilt (see getModelUniformData)
+
 			Math::BoundsSphere m_BoundsSphereLocal;
 			Math::BoundsAABB   m_BoundsAABBLocal;
 			Math::BoundsOBB    m_BoundsOBBLocal;
@@ -733,6 +809,7 @@ namespace Ocular
             bool m_IsActive;           ///< If active, an object's Routines will be invoked. Default: true.
             bool m_IsVisible;          ///< If visible, an object's Renderables will be invoked. Default: false.
             bool m_ForcedVisible;      ///< If true, the object will be forced visible and the Renderable will always be invoked irregardless of any frustum, cull, etc. tests. Default: false.
+            bool m_IsOccluder;         ///< If true, the object's mesh is rasterized to hide the objects behind it when occlusion culling is enabled. Default: false.
             bool m_Persists;           ///< If true, this object (and children) will persist inbetween scenes. When a new scene is created, it will automatically be added to it.
 
             std::vector<ARoutine*> m_Routines;
@@ -36,14 +36,17 @@ namespace Ocular
     {
         enum class SceneTreeType : uint32_t
         {
-            BoundingVolumeHierarchyCPU = 0x00,    ///< CPU-based implementation of a BVH tree. See BVHSceneTree class.
-            BoundingVolumeHierarchyGPU = 0x01,    ///< GPU-based implementation of a BVH tree. Not yet implemented.
-            QuadTreeCPU                = 0x02,    ///< CPU-based implementation of a Quad tree. Not yet implemented.
-            QuadTreeGPU                = 0x03,    ///< GPU-based implementation of a Quad tree. Not yet implemented.
-            OctTreeCPU                 = 0x04,    ///< CPU-based implementation of a Oct tree. Not yet implemented.
-            OctTreeGPU                 = 0x05,    ///< GPU-based implementation of a Oct tree. Not yet implemented.
-            BinarySpacePartitioningCPU = 0x06,    ///< CPU-based implementation of a BSP tree. Not yet implemented.
-            BinarySpacePartitioningGPU = 0x07,    ///< GPU-based implementation of a BSP tree. Not yet implemented.
+            BoundingVolumeHierarchyCPU     = 0x00,    ///< CPU-based implementation of a BVH tree. See BVHSceneTree class.
+            BoundingVolumeHierarchyGPU     = 0x01,    ///< GPU-based implementation of a BVH tree. Not yet implemented.
+            QuadTreeCPU                    = 0x02,    ///< CPU-based implementation of a Quad tree. Not yet implemented.
+            QuadTreeGPU                    = 0x03,    ///< GPU-based implementation of a Quad tree. Not yet implemented.
+            OctTreeCPU                     = 0x04,    ///< CPU-based implementation of a loose Oct tree. See LooseOctreeSceneTree class.
+            OctTreeGPU                     = 0x05,    ///< GPU-based implementation of a Oct tree. Not yet implemented.
+            BinarySpacePartitioningCPU     = 0x06,    ///< CPU-based implementation of a BSP tree. Not yet implemented.
+            BinarySpacePartitioningGPU     = 0x07,    ///< GPU-based implementation of a BSP tree. Not yet implemented.
+            BoundingVolumeHierarchySAHCPU  = 0x08,    ///< CPU-based implementation of a BVH tree built with the Surface Area Heuristic. See BVHSAHSceneTree class.
+            BoundingVolumeHierarchyQuadCPU = 0x09,    ///< CPU-based implementation of a 4-wide BVH tree with SIMD node tests. See QBVHSceneTree class.
+            UniformGridCPU                 = 0x0A,    ///< CPU-based implementation of a hashed uniform grid. See UniformGridSceneTree class.
             Unknown  
         };
     }
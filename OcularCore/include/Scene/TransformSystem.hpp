@@ -0,0 +1,306 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#ifndef __H__OCULAR_CORE_SCENE_TRANSFORM_SYSTEM__H__
+#define __H__OCULAR_CORE_SCENE_TRANSFORM_SYSTEM__H__
+
+#include "Math/Matrix4x4.hpp"
+#include "Math/Vector3.hpp"
+#include "Math/Quaternion.hpp"
+#include "Math/Bounds/BoundsSphereArray.hpp"
+#include "Math/Bounds/BoundsAABBArray.hpp"
+#include "Math/Bounds/BoundsOBB.hpp"
+
+#include <vector>
+#include <cstdint>
+
+//------------------------------------------------------------------------------------------
+
+/**
+ * \addtogroup Ocular
+ * @{
+ */
+namespace Ocular
+{
+    /**
+     * \addtogroup Core
+     * @{
+     */
+    namespace Core
+    {
+        class SceneObject;
+
+        /**
+         * \class TransformSystem
+         *
+         * Contiguous storage of the local transforms and world matrices of every SceneObject.
+         *
+         * The positions, rotations and scales are stored as separate arrays of each component
+         * (structure of arrays), while the composed local and world matrices are stored as
+         * consecutive column-major float[16] blocks. Entries are ordered by their depth within
+         * the hierarchy, so every parent is located before all of it's children.
+         *
+         * This allows for all world matrices to be updated in a single linear pass:
+         *
+         *     1. The local matrices of all modified entries are composed four at a time using SSE.
+         *     2. Each dirty entry is multiplied by the (already updated) world matrix of it's parent,
+         *        and it's local bounds are transformed into world space.
+         *
+         * As the entries of a single depth level never depend on one another, each level is split
+         * across all available threads (see ThreadManager::parallelFor). The levels themselves
+         * are processed in order, so that parents are always updated before their children.
+         *
+         * Entries are referenced by a handle which remains valid as the entries are reordered.
+         * Each SceneObject owns a single handle, and keeps the local transform in sync with it's
+         * Math::Transform (see SceneObject::getModelMatrix).
+         */
+        class TransformSystem
+        {
+        public:
+
+            static const uint32_t InvalidHandle = 0xFFFFFFFF;
+
+            TransformSystem();
+            ~TransformSystem();
+
+            /**
+             * Creates a new root entry with an identity transform.
+             *
+             * \param[in] owner Optional object that owns the entry (see getOwner).
+             * \return Handle to the new entry.
+             */
+            uint32_t create(SceneObject* owner = nullptr);
+
+            /**
+             * Destroys the entry. The handle may be reused by a later call to create.
+             * Any children of the entry become roots.
+             *
+             * \param[in] handle
+             */
+            void destroy(uint32_t handle);
+
+            /**
+             * Sets the parent of the entry, and flags it's world matrix as dirty.
+             *
+             * \param[in] handle
+             * \param[in] parent Handle of the new parent, or InvalidHandle for a root entry.
+             */
+            void setParent(uint32_t handle, uint32_t parent);
+
+            /**
+             * \return Handle of the parent of the entry, or InvalidHandle for a root entry.
+             */
+            uint32_t getParent(uint32_t handle) const;
+
+            /**
+             * \return The object that owns the entry, or NULL if it has no owner.
+             */
+            SceneObject* getOwner(uint32_t handle) const;
+
+            /**
+             * Detached entries, and all of their descendants, are skipped by update and must instead be
+             * updated individually (see updateWorldMatrix and setWorldMatrix). This is required for any SceneObject
+             * that overrides SceneObject::getModelMatrix, as it's world matrix is no longer (parent * local).
+             *
+             * \param[in] handle
+             * \param[in] detached
+             */
+            void setDetached(uint32_t handle, bool detached);
+
+            /**
+             * Sets the local transform of the entry, and flags both it's local and world matrices as dirty.
+             *
+             * \param[in] handle
+             * \param[in] position
+             * \param[in] rotation
+             * \param[in] scale
+             */
+            void setLocal(uint32_t handle, Math::Vector3f const& position, Math::Quaternion const& rotation, Math::Vector3f const& scale);
+
+            /**
+             * Sets the local bounds of the entry, which are transformed into world space along with
+             * it's world matrix. If the world matrix is already up to date, they are transformed immediately.
+             *
+             * \param[in] handle
+             * \param[in] sphere
+             * \param[in] aabb
+             * \param[in] obb
+             */
+            void setLocalBounds(uint32_t handle, Math::BoundsSphere const& sphere, Math::BoundsAABB const& aabb, Math::BoundsOBB const& obb);
+
+            /**
+             * Flags the world matrix of the entry as dirty.
+             *
+             * Descendants of the entry are updated along with it by the next call to update. However,
+             * if the entry may be updated individually (see updateWorldMatrix), then it's descendants
+             * must also be invalidated.
+             *
+             * \param[in] handle
+             */
+            void invalidate(uint32_t handle);
+
+            /**
+             * \return TRUE if the world matrix of the entry is out of date.
+             */
+            bool isDirty(uint32_t handle) const;
+
+            /**
+             * Updates the world matrix of a single entry.
+             *
+             * \param[in] handle
+             * \param[in] parentWorld Column-major world matrix of the parent, or NULL for a root entry.
+             */
+            void updateWorldMatrix(uint32_t handle, float const* parentWorld);
+
+            /**
+             * Overrides the world matrix of a single entry. Intended for detached entries, whose world
+             * matrix is not (parent * local), so that they are no longer considered dirty.
+             *
+             * \param[in] handle
+             * \param[in] world Column-major world matrix of the entry.
+             */
+            void setWorldMatrix(uint32_t handle, float const* world);
+
+            /**
+             * Retrieves the world matrix of the entry, as of the last update.
+             *
+             * \param[in]  handle
+             * \param[out] matrix
+             */
+            void getWorldMatrix(uint32_t handle, Math::Matrix4x4& matrix) const;
+
+            /**
+             * \return Column-major world matrix of the entry, as of the last update.
+             */
+            float const* getWorldMatrixData(uint32_t handle) const;
+
+            /**
+             * Retrieves the world space bounds of the entry, as of the last update.
+             * Any of the bounds may be NULL if they are not needed.
+             *
+             * \param[in]  handle
+             * \param[out] sphere
+             * \param[out] aabb
+             * \param[out] obb
+             */
+            void getWorldBounds(uint32_t handle, Math::BoundsSphere* sphere, Math::BoundsAABB* aabb, Math::BoundsOBB* obb) const;
+
+            /**
+             * Reorders the entries by depth if the hierarchy has changed, and then updates the
+             * world matrices and bounds of all dirty entries (and their descendants), one depth level
+             * at a time. Detached entries and their descendants are left as they are (see setDetached).
+             */
+            void update();
+
+            /**
+             * \return Handles of every entry whose world matrix was rebuilt since the previous call to update,
+             *         either by the last call to update or individually (see updateWorldMatrix). The first build
+             *         of a new entry is not included, as there were no previous world bounds that it changed.
+             */
+            std::vector<uint32_t> const& getUpdatedHandles() const;
+
+            /**
+             * \return Number of live entries.
+             */
+            uint32_t getNumTransforms() const;
+
+        protected:
+
+            /**
+             * Rebuilds the order of all live entries so that they are sorted by depth.
+             * Destroyed entries are removed in the process.
+             */
+            void sort();
+
+            /**
+             * Resizes every per-entry array to hold the specified number of entries.
+             * The component arrays are padded to a multiple of four for the SSE kernels.
+             */
+            void resize(uint32_t count);
+
+            /**
+             * Composes the local matrices of the four entries starting at the slot (T * R * S).
+             */
+            void composeLocal(uint32_t first);
+
+            /**
+             * Updates the world matrices and bounds of all dirty entries within the range of slots.
+             * Every slot in the range must be of the same depth, and all shallower slots must already be up to date.
+             */
+            void updateLevel(uint32_t first, uint32_t last);
+
+            /**
+             * Transforms the local bounds of each of the slots by their current world matrices.
+             * The spheres and AABBs are transformed together (see BoundsAABBArray::transform).
+             */
+            void updateBounds(uint32_t const* slots, uint32_t count);
+
+            //------------------------------------------------------------
+
+            std::vector<float> m_PositionX;
+            std::vector<float> m_PositionY;
+            std::vector<float> m_PositionZ;
+
+            std::vector<float> m_RotationW;
+            std::vector<float> m_RotationX;
+            std::vector<float> m_RotationY;
+            std::vector<float> m_RotationZ;
+
+            std::vector<float> m_ScaleX;
+            std::vector<float> m_ScaleY;
+            std::vector<float> m_ScaleZ;
+
+            std::vector<float> m_Local;               ///< 16 floats (column-major) per slot
+            std::vector<float> m_World;               ///< 16 floats (column-major) per slot
+
+            Math::BoundsSphereArray      m_BoundsSphereLocal;
+            Math::BoundsAABBArray        m_BoundsAABBLocal;
+            std::vector<Math::BoundsOBB> m_BoundsOBBLocal;
+            Math::BoundsSphereArray      m_BoundsSphereWorld;
+            Math::BoundsAABBArray        m_BoundsAABBWorld;
+            std::vector<Math::BoundsOBB> m_BoundsOBBWorld;
+
+            std::vector<uint8_t>  m_Dirty;            ///< Combination of dirty flags per slot
+            std::vector<uint8_t>  m_Detached;         ///< Non-zero for each detached slot (see setDetached)
+            std::vector<uint32_t> m_ParentSlots;      ///< Slot of the parent of each slot, or InvalidHandle
+            std::vector<uint32_t> m_ParentHandles;    ///< Handle of the parent of each slot, or InvalidHandle
+            std::vector<uint32_t> m_SlotHandles;      ///< Handle owning each slot, or InvalidHandle if destroyed
+            std::vector<uint32_t> m_HandleSlots;      ///< Slot of each handle, or InvalidHandle if destroyed
+            std::vector<SceneObject*> m_HandleOwners; ///< Owner of each handle
+            std::vector<uint32_t> m_FreeHandles;
+            std::vector<uint32_t> m_LevelOffsets;     ///< First slot of each depth level (as of the last sort), followed by the end of the deepest level
+            std::vector<uint32_t> m_UpdatedHandles;
+
+            uint32_t m_NumSlots;                      ///< Number of slots in use (including destroyed slots awaiting the next sort)
+            uint32_t m_NumTransforms;
+            bool m_IsSorted;
+
+        private:
+        };
+    }
+    /**
+     * @} End of Doxygen Groups
+     */
+}
+/**
+ * @} End of Doxygen Groups
+ */
+
+//------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
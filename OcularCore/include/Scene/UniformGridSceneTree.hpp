@@ -0,0 +1,158 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef __H__OCULAR_CORE_SCENE_UNIFORM_GRID_SCENE_TREE__H__
+#define __H__OCULAR_CORE_SCENE_UNIFORM_GRID_SCENE_TREE__H__
+
+#include "ACellSceneTree.hpp"
+
+//------------------------------------------------------------------------------------------
+
+/**
+ * \addtogroup Ocular
+ * @{
+ */
+namespace Ocular
+{
+    /**
+     * \addtogroup Core
+     * @{
+     */
+    namespace Core
+    {
+        /**
+         * \class UniformGridSceneTree
+         *
+         * Implementation of a hashed uniform grid Scene Tree.
+         *
+         * Space is divided into an unbounded grid of equally sized cubic cells, of which only the
+         * occupied cells are stored (in a hash map keyed by their packed integer coordinates).
+         * An object is stored in the cell that contains it's center. As with the loose octree,
+         * the bounds of each cell are loosened by half of the cell size in every direction so that
+         * every object is contained by the loose bounds of it's cell.
+         *
+         * Objects that are too large for the loose bounds of a cell (more than a cell across) are
+         * kept in a separate oversized cell that is tested against every query. The cell size should
+         * therefore be chosen to be at least as large as the majority of the objects in the tree.
+         *
+         * Queries visit the cells whose loose bounds overlap the bounds of the query. If that region
+         * spans more cells than are occupied, the occupied cells are iterated instead.
+         *
+         * Source:
+         *
+         *     Matthias Teschner, et al.
+         *     Optimized Spatial Hashing for Collision Detection of Deformable Objects
+         */
+        class UniformGridSceneTree : public ACellSceneTree
+        {
+        public:
+
+            /**
+             * \param[in] cellSize Length of each side of a grid cell.
+             */
+            UniformGridSceneTree(float cellSize = 16.0f);
+            virtual ~UniformGridSceneTree();
+
+            virtual void destroy() override;
+            virtual SceneTreeType getType() const override;
+
+        protected:
+
+            static const uint64_t OversizedCell = 0x8000000000000000;    ///< Cell code of objects too large to be stored in a grid cell
+
+            //------------------------------------------------------------
+            // Cell Methods
+            //------------------------------------------------------------
+
+            virtual uint64_t getCell(float const boundsMin[3], float const boundsMax[3]) const override;
+            virtual void onCellCreated(uint64_t cell) override;
+            virtual void onCellDestroyed(uint64_t cell) override;
+
+            /**
+             * Calculates the loose bounds of the cell with the specified coordinates.
+             */
+            void getLooseBounds(int32_t const coords[3], float boundsMin[3], float boundsMax[3]) const;
+
+            /**
+             * Calculates the loose bounds of the region of the grid that contains all occupied cells.
+             * \return FALSE if there are no occupied cells.
+             */
+            bool getOccupiedBounds(float boundsMin[3], float boundsMax[3]) const;
+
+            /**
+             * Invokes the visit for every occupied cell (excluding the oversized cell) whose loose bounds
+             * overlap the specified region. The visit is passed the cell coordinates and objects.
+             */
+            template<typename Visit>
+            void forEachCell(float const regionMin[3], float const regionMax[3], Visit const& visit) const;
+
+            //------------------------------------------------------------
+            // Traversal Methods
+            //------------------------------------------------------------
+
+            virtual void findVisible(Math::Frustum const& frustum, std::vector<SceneObject*>& objects) const override;
+            virtual void findIntersections(Math::Ray const& ray, std::vector<std::pair<SceneObject*, float>>& objects) const override;
+            virtual bool findIntersection(Math::Ray const& ray, RayQueryMode mode, float maxDistance, std::pair<SceneObject*, float>& result) const override;
+            virtual void findNearestObjects(Math::Vector3f const& point, uint32_t count, float maxDistance, std::vector<std::pair<SceneObject*, float>>& objects) const override;
+            virtual void findIntersections(Math::BoundsSphere const& bounds, std::vector<SceneObject*>& objects) const override;
+            virtual void findIntersections(Math::BoundsAABB const& bounds, std::vector<SceneObject*>& objects) const override;
+            virtual void findIntersections(Math::BoundsOBB const& bounds, std::vector<SceneObject*>& objects) const override;
+
+            /**
+             * Finds the region of the grid that the ray passes through within the maximum distance.
+             *
+             * \param[out] regionMin Minimum point of the bounds of the ray segment
+             * \param[out] regionMax Maximum point of the bounds of the ray segment
+             *
+             * \return FALSE if the ray misses all occupied cells.
+             */
+            bool getRayRegion(Math::Ray const& ray, float maxDistance, float regionMin[3], float regionMax[3]) const;
+
+            /**
+             * Generic query used by the bounds queries.
+             *
+             * The test is invoked with the loose bounds of each occupied cell within the region, and with
+             * the bounds of each object in the cells that pass (and of each oversized object). Every object 
+             * that passes is appended to the collection.
+             */
+            template<typename Test>
+            void findIntersecting(float const regionMin[3], float const regionMax[3], Test const& test, std::vector<SceneObject*>& objects) const;
+
+            //------------------------------------------------------------
+            // Variables
+            //------------------------------------------------------------
+
+            float m_CellSize;                ///< Length of each side of a grid cell
+            float m_InvCellSize;             ///< Reciprocal of the cell size
+
+            int32_t m_OccupiedMin[3];        ///< Minimum coordinates of all cells occupied since the grid was last empty
+            int32_t m_OccupiedMax[3];        ///< Maximum coordinates of all cells occupied since the grid was last empty
+
+        private:
+        };
+    }
+    /**
+     * @} End of Doxygen Groups
+     */
+}
+/**
+ * @} End of Doxygen Groups
+ */
+
+//------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
@@ -0,0 +1,94 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#ifndef __H__OCULAR_CORE_SCENE_VISIBILITY_CACHE__H__
+#define __H__OCULAR_CORE_SCENE_VISIBILITY_CACHE__H__
+
+#include "FrustumHints.hpp"
+#include "Math/Matrix4x4.hpp"
+
+#include <vector>
+#include <cstdint>
+
+//------------------------------------------------------------------------------------------
+
+/**
+ * \addtogroup Ocular
+ * @{
+ */
+namespace Ocular
+{
+    /**
+     * \addtogroup Core
+     * @{
+     */
+    namespace Core
+    {
+        class SceneObject;
+
+        /**
+         * \struct VisibilityCache
+         *
+         * The visible set of a single camera as of the last frame that it was rendered, along with
+         * the state of the camera and Scene that it was found with (see Scene::render).
+         *
+         * This is an invalidate-on-change cache. On the following frame, if the camera has not moved and
+         * no objects have been added to or removed from the Scene, the set is reused rather than culled again,
+         * and only the objects that have moved (or been activated/deactivated) since the previous frame are
+         * individually retested against the frustum.
+         *
+         * Any other change (camera movement, added or removed objects, or too many moved objects) discards
+         * the set, and the scene trees are culled again in full. No per-node visibility is kept, so unchanged
+         * subtrees are not skipped; the plane hints only change the order in which each node is tested.
+         */
+        struct VisibilityCache
+        {
+            VisibilityCache()
+                : revision(0),
+                  frame(0),
+                  occlusion(false),
+                  isValid(false)
+            {
+
+            }
+
+            Math::Matrix4x4 viewMatrix;           ///< View matrix of the camera when the set was found
+            Math::Matrix4x4 projMatrix;           ///< Projection matrix of the camera when the set was found
+
+            uint64_t revision;                    ///< Scene revision when the set was found
+            uint64_t frame;                       ///< Scene render frame that the set was last updated on
+            bool occlusion;                       ///< TRUE if the set was found with occlusion culling
+            bool isValid;                         ///< FALSE until the set has been found at least once
+
+            std::vector<SceneObject*> objects;    ///< All visible objects, including those that can not be rendered
+
+            FrustumHints staticHints;             ///< Plane hints of the camera for the nodes of the static tree
+            FrustumHints dynamicHints;            ///< Plane hints of the camera for the nodes of the dynamic tree
+        };
+    }
+    /**
+     * @} End of Doxygen Groups
+     */
+}
+/**
+ * @} End of Doxygen Groups
+ */
+
+//------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
@@ -2,6 +2,8 @@
 #ifndef __H__OCULAR_CORE_THREAD_MANAGER__H__
 #define __H__OCULAR_CORE_THREAD_MANAGER__H__
 
+#include <algorithm>
+#include <cstdint>
 #include <future>
 #include <thread>
 #include <utility>
@@ -45,6 +47,17 @@ namespace Ocular
          *         &OcularThreads->spawnAsyncNow(func, 1),
          *         &OcularThreads->spawnAsyncNow(func, 2),
          *         &OcularThreads->spawnAsyncNow(func, 3));
+         *
+         * Parallel For Example:
+         *
+         * Process a large array in contiguous batches across all hardware threads. The call
+         * blocks until every batch has completed. Batch indices are stable for a given count
+         * and minimum batch size, so per-batch scratch data may be sized with getNumBatches.
+         *
+         *     OcularThreads->parallelFor(count, 1024, [&](uint32_t const batch, uint32_t const first, uint32_t const last)
+         *     {
+         *         for(uint32_t i = first; i < last; i++) { ... do something ... }
+         *     });
          */
 
         class ThreadManager
@@ -54,6 +67,66 @@ namespace Ocular
             ThreadManager();
             ~ThreadManager();
 
+            /**
+             * \return The number of threads that may be run concurrently (at least 1).
+             */
+            uint32_t getNumThreads() const;
+
+            /**
+             * Returns the number of batches that parallelFor will split the specified range into.
+             *
+             * \param[in] count        Number of elements in the range.
+             * \param[in] minBatchSize Minimum number of elements processed by a single batch.
+             */
+            uint32_t getNumBatches(uint32_t count, uint32_t minBatchSize) const;
+
+            /**
+             * Splits the range [0, count) into contiguous batches and executes them concurrently.
+             * Blocks until all batches have completed. The first batch is executed on the calling thread.
+             *
+             * If the range is not larger than the minimum batch size, the function is simply
+             * executed once on the calling thread.
+             *
+             * \param[in] count        Number of elements in the range.
+             * \param[in] minBatchSize Minimum number of elements processed by a single batch.
+             * \param[in] function     Invoked as function(batch, first, last) where last is exclusive.
+             */
+            template<typename F>
+            void parallelFor(uint32_t const count, uint32_t const minBatchSize, F&& function) const
+            {
+                const uint32_t numBatches = getNumBatches(count, minBatchSize);
+
+                if(numBatches > 1)
+                {
+                    const uint32_t batchSize = (count + numBatches - 1) / numBatches;
+
+                    std::vector<std::future<void>> futures;
+                    futures.reserve(numBatches - 1);
+
+                    for(uint32_t batch = 1; batch < numBatches; batch++)
+                    {
+                        const uint32_t first = std::min(count, (batch * batchSize));
+                        const uint32_t last  = std::min(count, (first + batchSize));
+
+                        futures.emplace_back(std::async(std::launch::async, [&function, batch, first, last]()
+                        {
+                            function(batch, first, last);
+                        }));
+                    }
+
+                    function(0, 0, std::min(count, batchSize));
+
+                    for(auto& future : futures)
+                    {
+                        future.get();
+                    }
+                }
+                else if(count > 0)
+                {
+                    function(0, 0, count);
+                }
+            }
+
             /**
              * Spawns an asynchronous task.
              *
@@ -117,6 +190,8 @@ namespace Ocular
         protected:
 
         private:
+
+            uint32_t m_NumThreads;
         };
     }
 }
@@ -15,6 +15,7 @@
  */
 
 #include "Graphics/Mesh/Mesh.hpp"
+#include "Math/MathBatch.hpp"
 #include "OcularEngine.hpp"
 
 //------------------------------------------------------------------------------------------
@@ -148,6 +149,8 @@ namespace Ocular
             m_MinPoint = Math::Vector3f();
             m_MaxPoint = Math::Vector3f();
 
+            bool isFirst = true;
+
             for(auto submesh : m_SubMeshes)
             {
                 VertexBuffer* vb = nullptr;  
@@ -165,18 +168,27 @@ namespace Ocular
                     {
                         if(vertices->size())
                         {
-                            m_MinPoint = vertices->at(0).position.xyz();
-                            m_MaxPoint = m_MinPoint;
+                            Math::Vector3f minPoint;
+                            Math::Vector3f maxPoint;
+
+                            Math::CalculateMinMax(&(vertices->front().position), static_cast<uint32_t>(vertices->size()), sizeof(Vertex), minPoint, maxPoint);
 
-                            for(auto iter = vertices->begin(); iter != vertices->end(); ++iter)
+                            if(isFirst)
+                            {
+                                m_MinPoint = minPoint;
+                                m_MaxPoint = maxPoint;
+
+                                isFirst = false;
+                            }
+                            else
                             {
-                                m_MinPoint.x = std::min(m_MinPoint.x, (*iter).position.x);
-                                m_MinPoint.y = std::min(m_MinPoint.y, (*iter).position.y);
-                                m_MinPoint.z = std::min(m_MinPoint.z, (*iter).position.z);
+                                m_MinPoint.x = std::min(m_MinPoint.x, minPoint.x);
+                                m_MinPoint.y = std::min(m_MinPoint.y, minPoint.y);
+                                m_MinPoint.z = std::min(m_MinPoint.z, minPoint.z);
 
-                                m_MaxPoint.x = std::max(m_MaxPoint.x, (*iter).position.x);
-                                m_MaxPoint.y = std::max(m_MaxPoint.y, (*iter).position.y);
-                                m_MaxPoint.z = std::max(m_MaxPoint.z, (*iter).position.z);
+                                m_MaxPoint.x = std::max(m_MaxPoint.x, maxPoint.x);
+                                m_MaxPoint.y = std::max(m_MaxPoint.y, maxPoint.y);
+                                m_MaxPoint.z = std::max(m_MaxPoint.z, maxPoint.z);
                             }
                         }
                     }
@@ -19,6 +19,7 @@
 #include "Math/Bounds/BoundsOBB.hpp"
 #include "Math/Bounds/Ray.hpp"
 #include "Math/Geometry/Plane.hpp"
+#include "Math/MathBatch.hpp"
 
 //------------------------------------------------------------------------------------------
 
@@ -113,47 +114,25 @@ namespace Ocular
 
         void BoundsAABB::construct(std::vector<Graphics::Vertex> const& vertices, Math::Matrix4x4 const& matrix)
         {
-            float minX = FLT_MAX;
-            float minY = FLT_MAX;
-            float minZ = FLT_MAX;
-
-            float maxX = FLT_MIN;
-            float maxY = FLT_MIN;
-            float maxZ = FLT_MIN;
+            m_MinPoint = Vector3f();
+            m_MaxPoint = Vector3f();
 
-            if(matrix.isIdentity())
+            if(vertices.size())
             {
-                for(auto vertex : vertices)
-                {
-                    minX = fminf(minX, vertex.position.x);
-                    minY = fminf(minY, vertex.position.y);
-                    minZ = fminf(minZ, vertex.position.z);
+                const uint32_t count = static_cast<uint32_t>(vertices.size());
 
-                    maxX = fmaxf(maxX, vertex.position.x);
-                    maxY = fmaxf(maxY, vertex.position.y);
-                    maxZ = fmaxf(maxZ, vertex.position.z);
+                if(matrix.isIdentity())
+                {
+                    CalculateMinMax(&(vertices.front().position), count, sizeof(Graphics::Vertex), m_MinPoint, m_MaxPoint);
                 }
-            }
-            else
-            {
-                for(auto vertex : vertices)
+                else
                 {
-                    const Math::Vector4f transformed = matrix * vertex.position;
-
-                    minX = fminf(minX, transformed.x);
-                    minY = fminf(minY, transformed.y);
-                    minZ = fminf(minZ, transformed.z);
-
-                    maxX = fmaxf(maxX, transformed.x);
-                    maxY = fmaxf(maxY, transformed.y);
-                    maxZ = fmaxf(maxZ, transformed.z);
+                    CalculateMinMax(matrix, &(vertices.front().position), count, sizeof(Graphics::Vertex), m_MinPoint, m_MaxPoint);
                 }
             }
 
-            m_MinPoint = Vector3f(minX, minY, minZ);
-            m_MaxPoint = Vector3f(maxX, maxY, maxZ);
-            m_Center   = Vector3f::Midpoint(m_MinPoint, m_MaxPoint);
-            m_Extents  = m_MaxPoint - m_Center;
+            m_Center  = Vector3f::Midpoint(m_MinPoint, m_MaxPoint);
+            m_Extents = m_MaxPoint - m_Center;
         }
 
         void BoundsAABB::setCenter(Vector3f const& center)
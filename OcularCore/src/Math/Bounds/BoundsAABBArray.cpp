@@ -0,0 +1,204 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Math/Bounds/BoundsAABBArray.hpp"
+#include "Math/SIMD.hpp"
+
+#include <cmath>
+
+//------------------------------------------------------------------------------------------
+
+namespace Ocular
+{
+    namespace Math
+    {
+        //----------------------------------------------------------------------------------
+        // CONSTRUCTORS
+        //----------------------------------------------------------------------------------
+
+        BoundsAABBArray::BoundsAABBArray(uint32_t const size)
+        {
+            resize(size);
+        }
+
+        BoundsAABBArray::~BoundsAABBArray()
+        {
+
+        }
+
+        //----------------------------------------------------------------------------------
+        // PUBLIC METHODS
+        //----------------------------------------------------------------------------------
+
+        void BoundsAABBArray::resize(uint32_t const size)
+        {
+            m_CenterX.resize(size, 0.0f);
+            m_CenterY.resize(size, 0.0f);
+            m_CenterZ.resize(size, 0.0f);
+            m_ExtentsX.resize(size, 0.0f);
+            m_ExtentsY.resize(size, 0.0f);
+            m_ExtentsZ.resize(size, 0.0f);
+        }
+
+        uint32_t BoundsAABBArray::getSize() const
+        {
+            return static_cast<uint32_t>(m_CenterX.size());
+        }
+
+        void BoundsAABBArray::set(uint32_t const index, BoundsAABB const& bounds)
+        {
+            if(index < getSize())
+            {
+                Vector3f const& center = bounds.getCenter();
+                Vector3f const& extents = bounds.getExtents();
+
+                m_CenterX[index]  = center.x;
+                m_CenterY[index]  = center.y;
+                m_CenterZ[index]  = center.z;
+                m_ExtentsX[index] = extents.x;
+                m_ExtentsY[index] = extents.y;
+                m_ExtentsZ[index] = extents.z;
+            }
+        }
+
+        BoundsAABB BoundsAABBArray::get(uint32_t const index) const
+        {
+            BoundsAABB result;
+
+            if(index < getSize())
+            {
+                result = BoundsAABB(Vector3f(m_CenterX[index], m_CenterY[index], m_CenterZ[index]), Vector3f(m_ExtentsX[index], m_ExtentsY[index], m_ExtentsZ[index]));
+            }
+
+            return result;
+        }
+
+        float const* BoundsAABBArray::getCenterX() const
+        {
+            return m_CenterX.data();
+        }
+
+        float const* BoundsAABBArray::getCenterY() const
+        {
+            return m_CenterY.data();
+        }
+
+        float const* BoundsAABBArray::getCenterZ() const
+        {
+            return m_CenterZ.data();
+        }
+
+        float const* BoundsAABBArray::getExtentsX() const
+        {
+            return m_ExtentsX.data();
+        }
+
+        float const* BoundsAABBArray::getExtentsY() const
+        {
+            return m_ExtentsY.data();
+        }
+
+        float const* BoundsAABBArray::getExtentsZ() const
+        {
+            return m_ExtentsZ.data();
+        }
+
+        void BoundsAABBArray::transform(float const* matrices, uint32_t const* indices, uint32_t const count, BoundsAABBArray& result) const
+        {
+            uint32_t i = 0;
+
+#if defined(OCULAR_SIMD_SSE)
+            const __m128 sign = _mm_set1_ps(-0.0f);
+
+            float* centers[3] = { result.m_CenterX.data(), result.m_CenterY.data(), result.m_CenterZ.data() };
+            float* extents[3] = { result.m_ExtentsX.data(), result.m_ExtentsY.data(), result.m_ExtentsZ.data() };
+
+            __m128 m[16];
+            float values[4];
+
+            for(; (i + 4) <= count; i += 4)
+            {
+                uint32_t const* index = indices + i;
+                float const* sources[4] = { matrices + (index[0] * 16), matrices + (index[1] * 16), matrices + (index[2] * 16), matrices + (index[3] * 16) };
+
+                SIMD::LoadTransposed(sources, m);
+
+                const __m128 cx = _mm_setr_ps(m_CenterX[index[0]],  m_CenterX[index[1]],  m_CenterX[index[2]],  m_CenterX[index[3]]);
+                const __m128 cy = _mm_setr_ps(m_CenterY[index[0]],  m_CenterY[index[1]],  m_CenterY[index[2]],  m_CenterY[index[3]]);
+                const __m128 cz = _mm_setr_ps(m_CenterZ[index[0]],  m_CenterZ[index[1]],  m_CenterZ[index[2]],  m_CenterZ[index[3]]);
+                const __m128 ex = _mm_setr_ps(m_ExtentsX[index[0]], m_ExtentsX[index[1]], m_ExtentsX[index[2]], m_ExtentsX[index[3]]);
+                const __m128 ey = _mm_setr_ps(m_ExtentsY[index[0]], m_ExtentsY[index[1]], m_ExtentsY[index[2]], m_ExtentsY[index[3]]);
+                const __m128 ez = _mm_setr_ps(m_ExtentsZ[index[0]], m_ExtentsZ[index[1]], m_ExtentsZ[index[2]], m_ExtentsZ[index[3]]);
+
+                for(uint32_t row = 0; row < 3; row++)
+                {
+                    __m128 center = _mm_mul_ps(m[row], cx);
+                    center = _mm_add_ps(center, _mm_mul_ps(m[4 + row], cy));
+                    center = _mm_add_ps(center, _mm_mul_ps(m[8 + row], cz));
+                    center = _mm_add_ps(center, m[12 + row]);
+
+                    __m128 extent = _mm_mul_ps(_mm_andnot_ps(sign, m[row]), ex);
+                    extent = _mm_add_ps(extent, _mm_mul_ps(_mm_andnot_ps(sign, m[4 + row]), ey));
+                    extent = _mm_add_ps(extent, _mm_mul_ps(_mm_andnot_ps(sign, m[8 + row]), ez));
+
+                    _mm_storeu_ps(values, center);
+
+                    for(uint32_t j = 0; j < 4; j++)
+                    {
+                        centers[row][index[j]] = values[j];
+                    }
+
+                    _mm_storeu_ps(values, extent);
+
+                    for(uint32_t j = 0; j < 4; j++)
+                    {
+                        extents[row][index[j]] = values[j];
+                    }
+                }
+            }
+#endif
+
+            for(; i < count; i++)
+            {
+                const uint32_t index = indices[i];
+                float const* matrix = matrices + (index * 16);
+
+                const float cx = m_CenterX[index];
+                const float cy = m_CenterY[index];
+                const float cz = m_CenterZ[index];
+                const float ex = m_ExtentsX[index];
+                const float ey = m_ExtentsY[index];
+                const float ez = m_ExtentsZ[index];
+
+                result.m_CenterX[index] = (matrix[0] * cx) + (matrix[4] * cy) + (matrix[8]  * cz) + matrix[12];
+                result.m_CenterY[index] = (matrix[1] * cx) + (matrix[5] * cy) + (matrix[9]  * cz) + matrix[13];
+                result.m_CenterZ[index] = (matrix[2] * cx) + (matrix[6] * cy) + (matrix[10] * cz) + matrix[14];
+
+                result.m_ExtentsX[index] = (fabsf(matrix[0]) * ex) + (fabsf(matrix[4]) * ey) + (fabsf(matrix[8])  * ez);
+                result.m_ExtentsY[index] = (fabsf(matrix[1]) * ex) + (fabsf(matrix[5]) * ey) + (fabsf(matrix[9])  * ez);
+                result.m_ExtentsZ[index] = (fabsf(matrix[2]) * ex) + (fabsf(matrix[6]) * ey) + (fabsf(matrix[10]) * ez);
+            }
+        }
+
+        //----------------------------------------------------------------------------------
+        // PROTECTED METHODS
+        //----------------------------------------------------------------------------------
+
+        //----------------------------------------------------------------------------------
+        // PRIVATE METHODS
+        //----------------------------------------------------------------------------------
+    }
+}
\ No newline at end of file
@@ -0,0 +1,191 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Math/Bounds/BoundsSphereArray.hpp"
+#include "Math/SIMD.hpp"
+
+#include <cmath>
+
+//------------------------------------------------------------------------------------------
+
+namespace Ocular
+{
+    namespace Math
+    {
+        //----------------------------------------------------------------------------------
+        // CONSTRUCTORS
+        //----------------------------------------------------------------------------------
+
+        BoundsSphereArray::BoundsSphereArray(uint32_t const size)
+        {
+            resize(size);
+        }
+
+        BoundsSphereArray::~BoundsSphereArray()
+        {
+
+        }
+
+        //----------------------------------------------------------------------------------
+        // PUBLIC METHODS
+        //----------------------------------------------------------------------------------
+
+        void BoundsSphereArray::resize(uint32_t const size)
+        {
+            m_CenterX.resize(size, 0.0f);
+            m_CenterY.resize(size, 0.0f);
+            m_CenterZ.resize(size, 0.0f);
+            m_Radius.resize(size, 0.0f);
+        }
+
+        uint32_t BoundsSphereArray::getSize() const
+        {
+            return static_cast<uint32_t>(m_CenterX.size());
+        }
+
+        void BoundsSphereArray::set(uint32_t const index, BoundsSphere const& bounds)
+        {
+            if(index < getSize())
+            {
+                Vector3f const& center = bounds.getCenter();
+
+                m_CenterX[index] = center.x;
+                m_CenterY[index] = center.y;
+                m_CenterZ[index] = center.z;
+                m_Radius[index]  = bounds.getRadius();
+            }
+        }
+
+        BoundsSphere BoundsSphereArray::get(uint32_t const index) const
+        {
+            BoundsSphere result;
+
+            if(index < getSize())
+            {
+                result = BoundsSphere(Vector3f(m_CenterX[index], m_CenterY[index], m_CenterZ[index]), m_Radius[index]);
+            }
+
+            return result;
+        }
+
+        float const* BoundsSphereArray::getCenterX() const
+        {
+            return m_CenterX.data();
+        }
+
+        float const* BoundsSphereArray::getCenterY() const
+        {
+            return m_CenterY.data();
+        }
+
+        float const* BoundsSphereArray::getCenterZ() const
+        {
+            return m_CenterZ.data();
+        }
+
+        float const* BoundsSphereArray::getRadius() const
+        {
+            return m_Radius.data();
+        }
+
+        void BoundsSphereArray::transform(float const* matrices, uint32_t const* indices, uint32_t const count, BoundsSphereArray& result) const
+        {
+            uint32_t i = 0;
+
+#if defined(OCULAR_SIMD_SSE)
+            float* centers[3] = { result.m_CenterX.data(), result.m_CenterY.data(), result.m_CenterZ.data() };
+
+            __m128 m[16];
+            float values[4];
+
+            for(; (i + 4) <= count; i += 4)
+            {
+                uint32_t const* index = indices + i;
+                float const* sources[4] = { matrices + (index[0] * 16), matrices + (index[1] * 16), matrices + (index[2] * 16), matrices + (index[3] * 16) };
+
+                SIMD::LoadTransposed(sources, m);
+
+                const __m128 cx = _mm_setr_ps(m_CenterX[index[0]], m_CenterX[index[1]], m_CenterX[index[2]], m_CenterX[index[3]]);
+                const __m128 cy = _mm_setr_ps(m_CenterY[index[0]], m_CenterY[index[1]], m_CenterY[index[2]], m_CenterY[index[3]]);
+                const __m128 cz = _mm_setr_ps(m_CenterZ[index[0]], m_CenterZ[index[1]], m_CenterZ[index[2]], m_CenterZ[index[3]]);
+                const __m128 r  = _mm_setr_ps(m_Radius[index[0]],  m_Radius[index[1]],  m_Radius[index[2]],  m_Radius[index[3]]);
+
+                // Longest of the scaled axes
+
+                __m128 scale = _mm_setzero_ps();
+
+                for(uint32_t col = 0; col < 3; col++)
+                {
+                    __m128 length = _mm_mul_ps(m[(col * 4)], m[(col * 4)]);
+                    length = _mm_add_ps(length, _mm_mul_ps(m[(col * 4) + 1], m[(col * 4) + 1]));
+                    length = _mm_add_ps(length, _mm_mul_ps(m[(col * 4) + 2], m[(col * 4) + 2]));
+
+                    scale = _mm_max_ps(scale, length);
+                }
+
+                for(uint32_t row = 0; row < 3; row++)
+                {
+                    __m128 center = _mm_mul_ps(m[row], cx);
+                    center = _mm_add_ps(center, _mm_mul_ps(m[4 + row], cy));
+                    center = _mm_add_ps(center, _mm_mul_ps(m[8 + row], cz));
+                    center = _mm_add_ps(center, m[12 + row]);
+
+                    _mm_storeu_ps(values, center);
+
+                    for(uint32_t j = 0; j < 4; j++)
+                    {
+                        centers[row][index[j]] = values[j];
+                    }
+                }
+
+                _mm_storeu_ps(values, _mm_mul_ps(r, _mm_sqrt_ps(scale)));
+
+                for(uint32_t j = 0; j < 4; j++)
+                {
+                    result.m_Radius[index[j]] = values[j];
+                }
+            }
+#endif
+
+            for(; i < count; i++)
+            {
+                const uint32_t index = indices[i];
+                float const* matrix = matrices + (index * 16);
+
+                const float cx = m_CenterX[index];
+                const float cy = m_CenterY[index];
+                const float cz = m_CenterZ[index];
+
+                const float scaleX = (matrix[0] * matrix[0]) + (matrix[1] * matrix[1]) + (matrix[2]  * matrix[2]);
+                const float scaleY = (matrix[4] * matrix[4]) + (matrix[5] * matrix[5]) + (matrix[6]  * matrix[6]);
+                const float scaleZ = (matrix[8] * matrix[8]) + (matrix[9] * matrix[9]) + (matrix[10] * matrix[10]);
+
+                result.m_CenterX[index] = (matrix[0] * cx) + (matrix[4] * cy) + (matrix[8]  * cz) + matrix[12];
+                result.m_CenterY[index] = (matrix[1] * cx) + (matrix[5] * cy) + (matrix[9]  * cz) + matrix[13];
+                result.m_CenterZ[index] = (matrix[2] * cx) + (matrix[6] * cy) + (matrix[10] * cz) + matrix[14];
+                result.m_Radius[index]  = m_Radius[index] * sqrtf(fmaxf(scaleX, fmaxf(scaleY, scaleZ)));
+            }
+        }
+
+        //----------------------------------------------------------------------------------
+        // PROTECTED METHODS
+        //----------------------------------------------------------------------------------
+
+        //----------------------------------------------------------------------------------
+        // PRIVATE METHODS
+        //----------------------------------------------------------------------------------
+    }
+}
\ No newline at end of file
@@ -18,6 +18,53 @@
 #include "Math/Bounds/BoundsAABB.hpp"
 #include "Math/Bounds/BoundsOBB.hpp"
 #include "Math/Bounds/BoundsSphere.hpp"
+#include "Math/Bounds/BoundsAABBArray.hpp"
+#include "Math/Bounds/BoundsSphereArray.hpp"
+#include "Math/SIMD.hpp"
+
+#include <bitset>
+#include <cmath>
+
+//------------------------------------------------------------------------------------------
+
+namespace
+{
+    /**
+     * Clears the bit masks and sizes them to hold one bit per bounds.
+     */
+    void ResetMasks(uint32_t const count, std::vector<uint32_t>& visible, std::vector<uint32_t>* inside)
+    {
+        const uint32_t words = (count + 31) / 32;
+
+        visible.assign(words, 0);
+
+        if(inside)
+        {
+            inside->assign(words, 0);
+        }
+    }
+
+    /**
+     * Sets the bits of up to four consecutive bounds, beginning with the bounds at the specified index.
+     * As the index is always a multiple of four when multiple bits are set, they never span two elements.
+     */
+    inline void SetMaskBits(std::vector<uint32_t>& mask, uint32_t const index, uint32_t const bits)
+    {
+        mask[index / 32] |= (bits << (index % 32));
+    }
+
+    uint32_t CountMaskBits(std::vector<uint32_t> const& mask)
+    {
+        uint32_t result = 0;
+
+        for(auto word : mask)
+        {
+            result += static_cast<uint32_t>(std::bitset<32>(word).count());
+        }
+
+        return result;
+    }
+}
 
 //------------------------------------------------------------------------------------------
 
@@ -183,24 +230,75 @@ namespace Ocular
                    (m_FarPlane.getSignedDistance(point)    < EPSILON_FLOAT);
         }
 
-        bool Frustum::contains(BoundsSphere const& bounds) const
+        bool Frustum::contains(BoundsSphere const& bounds, IntersectionType* result) const
         {
             // If the bounds is outside of a single plane, then we return false.
-            // Otherwise, if it is inside/intersects all planes then return true.
-
-            // Plane::intersects returns TRUE if intersects or inside.
-            // We make no distinction between the two and only care that
-            // it is not entirely outside of the frustum.
+            // If it is inside of every plane, then it is fully inside of the frustum.
+            // Otherwise it intersects one or more of the planes.
+
+            const Plane* planes[6] = { &m_NearPlane, &m_FarPlane, &m_LeftPlane, &m_RightPlane, &m_TopPlane, &m_BottomPlane };
+
+            IntersectionType frustumResult = IntersectionType::Inside;
+
+            for(uint32_t i = 0; i < 6; i++)
+            {
+                IntersectionType planeResult = IntersectionType::Inside;
+                planes[i]->intersects(bounds, &planeResult);
+
+                if(planeResult == IntersectionType::Outside)
+                {
+                    frustumResult = IntersectionType::Outside;
+                    break;
+                }
+                else if(planeResult == IntersectionType::Intersects)
+                {
+                    frustumResult = IntersectionType::Intersects;
+                }
+            }
+
+            if(result)
+            {
+                *result = frustumResult;
+            }
+
+            return (frustumResult != IntersectionType::Outside);
+        }
 
-            return (m_NearPlane.intersects(bounds) &&
-                    m_FarPlane.intersects(bounds) &&
-                    m_LeftPlane.intersects(bounds) &&
-                    m_RightPlane.intersects(bounds) &&
-                    m_TopPlane.intersects(bounds) &&
-                    m_BottomPlane.intersects(bounds));
+        bool Frustum::contains(BoundsAABB const& bounds, IntersectionType* result) const
+        {
+            // If the bounds is outside of a single plane, then we return false.
+            // If it is inside of every plane, then it is fully inside of the frustum.
+            // Otherwise it intersects one or more of the planes.
+
+            const Plane* planes[6] = { &m_NearPlane, &m_FarPlane, &m_LeftPlane, &m_RightPlane, &m_TopPlane, &m_BottomPlane };
+
+            IntersectionType frustumResult = IntersectionType::Inside;
+
+            for(uint32_t i = 0; i < 6; i++)
+            {
+                IntersectionType planeResult = IntersectionType::Inside;
+                planes[i]->intersects(bounds, &planeResult);
+
+                if(planeResult == IntersectionType::Outside)
+                {
+                    frustumResult = IntersectionType::Outside;
+                    break;
+                }
+                else if(planeResult == IntersectionType::Intersects)
+                {
+                    frustumResult = IntersectionType::Intersects;
+                }
+            }
+
+            if(result)
+            {
+                *result = frustumResult;
+            }
+
+            return (frustumResult != IntersectionType::Outside);
         }
 
-        bool Frustum::contains(BoundsAABB const& bounds) const
+        bool Frustum::contains(BoundsOBB const& bounds) const
         {
             // If the bounds is outside of a single plane, then we return false.
             // Otherwise, if it is inside/intersects all planes then return true.
@@ -217,21 +315,170 @@ namespace Ocular
                     m_BottomPlane.intersects(bounds));
         }
 
-        bool Frustum::contains(BoundsOBB const& bounds) const
+        uint32_t Frustum::contains(BoundsAABBArray const& bounds, std::vector<uint32_t>& visible, std::vector<uint32_t>* inside) const
         {
-            // If the bounds is outside of a single plane, then we return false.
-            // Otherwise, if it is inside/intersects all planes then return true.
+            // Each AABB is projected onto the plane normal: it is outside of the plane if the nearest
+            // corner (center distance - projected radius) is in front of it, and crosses the plane if
+            // the furthest corner (center distance + projected radius) is in front of it.
+
+            const uint32_t count = bounds.getSize();
+
+            float planes[6][4];
+            getPlaneEquations(planes);
+
+            ResetMasks(count, visible, inside);
+
+            float const* centerX = bounds.getCenterX();
+            float const* centerY = bounds.getCenterY();
+            float const* centerZ = bounds.getCenterZ();
+            float const* extentsX = bounds.getExtentsX();
+            float const* extentsY = bounds.getExtentsY();
+            float const* extentsZ = bounds.getExtentsZ();
+
+            uint32_t i = 0;
+
+#if defined(OCULAR_SIMD_SSE)
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 sign = _mm_set1_ps(-0.0f);
+
+            for(; (i + 4) <= count; i += 4)
+            {
+                const __m128 cx = _mm_loadu_ps(centerX + i);
+                const __m128 cy = _mm_loadu_ps(centerY + i);
+                const __m128 cz = _mm_loadu_ps(centerZ + i);
+                const __m128 ex = _mm_loadu_ps(extentsX + i);
+                const __m128 ey = _mm_loadu_ps(extentsY + i);
+                const __m128 ez = _mm_loadu_ps(extentsZ + i);
+
+                __m128 outside = zero;
+                __m128 crossing = zero;
+
+                for(uint32_t p = 0; p < 6; p++)
+                {
+                    const __m128 nx = _mm_set1_ps(planes[p][0]);
+                    const __m128 ny = _mm_set1_ps(planes[p][1]);
+                    const __m128 nz = _mm_set1_ps(planes[p][2]);
+
+                    __m128 distance = _mm_add_ps(_mm_mul_ps(nx, cx), _mm_set1_ps(planes[p][3]));
+                    distance = _mm_add_ps(distance, _mm_mul_ps(ny, cy));
+                    distance = _mm_add_ps(distance, _mm_mul_ps(nz, cz));
+
+                    __m128 radius = _mm_mul_ps(_mm_andnot_ps(sign, nx), ex);
+                    radius = _mm_add_ps(radius, _mm_mul_ps(_mm_andnot_ps(sign, ny), ey));
+                    radius = _mm_add_ps(radius, _mm_mul_ps(_mm_andnot_ps(sign, nz), ez));
+
+                    outside  = _mm_or_ps(outside,  _mm_cmpgt_ps(_mm_sub_ps(distance, radius), zero));
+                    crossing = _mm_or_ps(crossing, _mm_cmpgt_ps(_mm_add_ps(distance, radius), zero));
+                }
+
+                SetMaskBits(visible, i, (~static_cast<uint32_t>(_mm_movemask_ps(outside)) & 0xF));
+
+                if(inside)
+                {
+                    SetMaskBits(*inside, i, (~static_cast<uint32_t>(_mm_movemask_ps(crossing)) & 0xF));
+                }
+            }
+#endif
+
+            for(; i < count; i++)
+            {
+                bool outside = false;
+                bool crossing = false;
+
+                for(uint32_t p = 0; p < 6; p++)
+                {
+                    const float distance = (planes[p][0] * centerX[i]) + (planes[p][1] * centerY[i]) + (planes[p][2] * centerZ[i]) + planes[p][3];
+                    const float radius = (fabsf(planes[p][0]) * extentsX[i]) + (fabsf(planes[p][1]) * extentsY[i]) + (fabsf(planes[p][2]) * extentsZ[i]);
+
+                    outside  = outside  || ((distance - radius) > 0.0f);
+                    crossing = crossing || ((distance + radius) > 0.0f);
+                }
+
+                SetMaskBits(visible, i, (outside ? 0 : 1));
+
+                if(inside)
+                {
+                    SetMaskBits(*inside, i, (crossing ? 0 : 1));
+                }
+            }
+
+            return CountMaskBits(visible);
+        }
 
-            // Plane::intersects returns TRUE if intersects or inside.
-            // We make no distinction between the two and only care that
-            // it is not entirely outside of the frustum.
+        uint32_t Frustum::contains(BoundsSphereArray const& bounds, std::vector<uint32_t>& visible, std::vector<uint32_t>* inside) const
+        {
+            // A sphere is outside of a plane if its center is further than its radius in front of it,
+            // and crosses the plane if its center is within its radius of it.
 
-            return (m_NearPlane.intersects(bounds) &&
-                    m_FarPlane.intersects(bounds) &&
-                    m_LeftPlane.intersects(bounds) &&
-                    m_RightPlane.intersects(bounds) &&
-                    m_TopPlane.intersects(bounds) &&
-                    m_BottomPlane.intersects(bounds));
+            const uint32_t count = bounds.getSize();
+
+            float planes[6][4];
+            getPlaneEquations(planes);
+
+            ResetMasks(count, visible, inside);
+
+            float const* centerX = bounds.getCenterX();
+            float const* centerY = bounds.getCenterY();
+            float const* centerZ = bounds.getCenterZ();
+            float const* radii = bounds.getRadius();
+
+            uint32_t i = 0;
+
+#if defined(OCULAR_SIMD_SSE)
+            const __m128 zero = _mm_setzero_ps();
+
+            for(; (i + 4) <= count; i += 4)
+            {
+                const __m128 cx = _mm_loadu_ps(centerX + i);
+                const __m128 cy = _mm_loadu_ps(centerY + i);
+                const __m128 cz = _mm_loadu_ps(centerZ + i);
+                const __m128 radius = _mm_loadu_ps(radii + i);
+                const __m128 negRadius = _mm_sub_ps(zero, radius);
+
+                __m128 outside = zero;
+                __m128 crossing = zero;
+
+                for(uint32_t p = 0; p < 6; p++)
+                {
+                    __m128 distance = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[p][0]), cx), _mm_set1_ps(planes[p][3]));
+                    distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes[p][1]), cy));
+                    distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes[p][2]), cz));
+
+                    outside  = _mm_or_ps(outside,  _mm_cmpgt_ps(distance, radius));
+                    crossing = _mm_or_ps(crossing, _mm_cmpge_ps(distance, negRadius));
+                }
+
+                SetMaskBits(visible, i, (~static_cast<uint32_t>(_mm_movemask_ps(outside)) & 0xF));
+
+                if(inside)
+                {
+                    SetMaskBits(*inside, i, (~static_cast<uint32_t>(_mm_movemask_ps(crossing)) & 0xF));
+                }
+            }
+#endif
+
+            for(; i < count; i++)
+            {
+                bool outside = false;
+                bool crossing = false;
+
+                for(uint32_t p = 0; p < 6; p++)
+                {
+                    const float distance = (planes[p][0] * centerX[i]) + (planes[p][1] * centerY[i]) + (planes[p][2] * centerZ[i]) + planes[p][3];
+
+                    outside  = outside  || (distance > radii[i]);
+                    crossing = crossing || (distance >= -radii[i]);
+                }
+
+                SetMaskBits(visible, i, (outside ? 0 : 1));
+
+                if(inside)
+                {
+                    SetMaskBits(*inside, i, (crossing ? 0 : 1));
+                }
+            }
+
+            return CountMaskBits(visible);
         }
 
         //----------------------------------------------------------------
@@ -278,6 +525,21 @@ namespace Ocular
             return m_FarPlane;
         }
 
+        void Frustum::getPlaneEquations(float planes[6][4]) const
+        {
+            const Plane* sources[6] = { &m_NearPlane, &m_FarPlane, &m_LeftPlane, &m_RightPlane, &m_TopPlane, &m_BottomPlane };
+
+            for(uint32_t i = 0; i < 6; i++)
+            {
+                Vector3f const& normal = sources[i]->getNormal();
+
+                planes[i][0] = normal.x;
+                planes[i][1] = normal.y;
+                planes[i][2] = normal.z;
+                planes[i][3] = -normal.dot(sources[i]->getPoint());
+            }
+        }
+
         float Frustum::getFieldOfView() const
         {
             return m_FieldOfView;
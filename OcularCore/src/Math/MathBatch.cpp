@@ -0,0 +1,374 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Math/MathBatch.hpp"
+#include "Math/MathInternal.hpp"
+#include "Math/Matrix4x4.hpp"
+#include "Math/Quaternion.hpp"
+#include "Math/SIMD.hpp"
+
+#include <algorithm>
+#include <cfloat>
+
+//------------------------------------------------------------------------------------------
+
+namespace
+{
+    inline float* GetData(Ocular::Math::Matrix4x4 const& matrix)
+    {
+        return &(matrix.getInternal()->matrix[0][0]);
+    }
+
+    /**
+     * The component order of the internal quaternion does not matter to the batch operations,
+     * only that the four components are stored contiguously.
+     */
+    inline float* GetData(Ocular::Math::Quaternion const& quaternion)
+    {
+        return reinterpret_cast<float*>(&(quaternion.getInternal()->quat));
+    }
+
+    inline float const* GetPoint(Ocular::Math::Vector4f const* points, uint32_t const stride, uint32_t const index)
+    {
+        return reinterpret_cast<float const*>(reinterpret_cast<uint8_t const*>(points) + (stride * index));
+    }
+
+    /**
+     * Transforms an array of tightly packed xyz-triplets by a column-major matrix.
+     *
+     * \param[in] w The w-component of each triplet (1 for points, 0 for directions)
+     */
+    void TransformTriplets(float const* matrix, float const* input, float* output, uint32_t const count, float const w)
+    {
+        uint32_t i = 0;
+
+#if defined(OCULAR_SIMD_SSE)
+        const __m128 m00 = _mm_set1_ps(matrix[0]);
+        const __m128 m01 = _mm_set1_ps(matrix[1]);
+        const __m128 m02 = _mm_set1_ps(matrix[2]);
+        const __m128 m10 = _mm_set1_ps(matrix[4]);
+        const __m128 m11 = _mm_set1_ps(matrix[5]);
+        const __m128 m12 = _mm_set1_ps(matrix[6]);
+        const __m128 m20 = _mm_set1_ps(matrix[8]);
+        const __m128 m21 = _mm_set1_ps(matrix[9]);
+        const __m128 m22 = _mm_set1_ps(matrix[10]);
+        const __m128 m30 = _mm_set1_ps(matrix[12] * w);
+        const __m128 m31 = _mm_set1_ps(matrix[13] * w);
+        const __m128 m32 = _mm_set1_ps(matrix[14] * w);
+
+        // Four triplets (twelve floats) are transposed into x, y, z registers at a time
+
+        for(; (i + 4) <= count; i += 4)
+        {
+            const __m128 a = _mm_loadu_ps(input + (i * 3));        // x0 y0 z0 x1
+            const __m128 b = _mm_loadu_ps(input + (i * 3) + 4);    // y1 z1 x2 y2
+            const __m128 c = _mm_loadu_ps(input + (i * 3) + 8);    // z2 x3 y3 z3
+
+            const __m128 x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+            const __m128 y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+            const __m128 z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+
+            const __m128 rx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m10, y)), _mm_mul_ps(m20, z)), m30);
+            const __m128 ry = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m01, x), _mm_mul_ps(m11, y)), _mm_mul_ps(m21, z)), m31);
+            const __m128 rz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m02, x), _mm_mul_ps(m12, y)), _mm_mul_ps(m22, z)), m32);
+
+            _mm_storeu_ps(output + (i * 3),     _mm_shuffle_ps(_mm_shuffle_ps(rx, ry, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(rz, rx, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(output + (i * 3) + 4, _mm_shuffle_ps(_mm_shuffle_ps(ry, rz, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(rx, ry, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(output + (i * 3) + 8, _mm_shuffle_ps(_mm_shuffle_ps(rz, rx, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(ry, rz, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0)));
+        }
+#endif
+
+        for(; i < count; i++)
+        {
+            const float x = input[(i * 3)];
+            const float y = input[(i * 3) + 1];
+            const float z = input[(i * 3) + 2];
+
+            for(uint32_t row = 0; row < 3; row++)
+            {
+                output[(i * 3) + row] = (matrix[row] * x) + (matrix[row + 4] * y) + (matrix[row + 8] * z) + (matrix[row + 12] * w);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+
+namespace Ocular
+{
+    namespace Math
+    {
+        static_assert(sizeof(Vector3f) == (sizeof(float) * 3), "Vector3f must be tightly packed for the batch operations");
+        static_assert(sizeof(Vector4f) == (sizeof(float) * 4), "Vector4f must be tightly packed for the batch operations");
+        static_assert(sizeof(Quaternion_Internal) == (sizeof(float) * 4), "Quaternion_Internal must be tightly packed for the batch operations");
+
+        //----------------------------------------------------------------------------------
+        // Batch Functions
+        //----------------------------------------------------------------------------------
+
+        void TransformPoints(Matrix4x4 const& matrix, Vector3f const* points, Vector3f* results, uint32_t const count)
+        {
+            TransformTriplets(GetData(matrix), &(points->x), &(results->x), count, 1.0f);
+        }
+
+        void TransformDirections(Matrix4x4 const& matrix, Vector3f const* directions, Vector3f* results, uint32_t const count)
+        {
+            TransformTriplets(GetData(matrix), &(directions->x), &(results->x), count, 0.0f);
+        }
+
+        void TransformVectors(Matrix4x4 const& matrix, Vector4f const* vectors, Vector4f* results, uint32_t const count)
+        {
+            float const* data = GetData(matrix);
+            float const* input = &(vectors->x);
+            float* output = &(results->x);
+
+            uint32_t i = 0;
+
+#if defined(OCULAR_SIMD_AVX)
+            // Two vectors are transformed at a time, one in each 128-bit lane
+
+            const __m256 c0 = _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(data));
+            const __m256 c1 = _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(data + 4));
+            const __m256 c2 = _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(data + 8));
+            const __m256 c3 = _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(data + 12));
+
+            for(; (i + 2) <= count; i += 2)
+            {
+                const __m256 v = _mm256_loadu_ps(input + (i * 4));
+
+                __m256 value = _mm256_mul_ps(c0, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+                value = _mm256_add_ps(value, _mm256_mul_ps(c1, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+                value = _mm256_add_ps(value, _mm256_mul_ps(c2, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+                value = _mm256_add_ps(value, _mm256_mul_ps(c3, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+
+                _mm256_storeu_ps(output + (i * 4), value);
+            }
+#endif
+
+#if defined(OCULAR_SIMD_SSE)
+            const __m128 s0 = _mm_loadu_ps(data);
+            const __m128 s1 = _mm_loadu_ps(data + 4);
+            const __m128 s2 = _mm_loadu_ps(data + 8);
+            const __m128 s3 = _mm_loadu_ps(data + 12);
+
+            for(; i < count; i++)
+            {
+                const __m128 v = _mm_loadu_ps(input + (i * 4));
+
+                __m128 value = _mm_mul_ps(s0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+                value = _mm_add_ps(value, _mm_mul_ps(s1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+                value = _mm_add_ps(value, _mm_mul_ps(s2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+                value = _mm_add_ps(value, _mm_mul_ps(s3, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+
+                _mm_storeu_ps(output + (i * 4), value);
+            }
+#else
+            for(; i < count; i++)
+            {
+                SIMD::TransformVector(data, input + (i * 4), output + (i * 4));
+            }
+#endif
+        }
+
+        void MultiplyMatrices(Matrix4x4 const* lhs, Matrix4x4 const* rhs, Matrix4x4* results, uint32_t const count)
+        {
+            for(uint32_t i = 0; i < count; i++)
+            {
+                SIMD::MultiplyMatrix(GetData(lhs[i]), GetData(rhs[i]), GetData(results[i]));
+            }
+        }
+
+        void MultiplyMatrices(Matrix4x4 const& lhs, Matrix4x4 const* rhs, Matrix4x4* results, uint32_t const count)
+        {
+            // Copied so that the left-hand matrix may also be one of the results
+
+            float data[16];
+            std::copy(GetData(lhs), GetData(lhs) + 16, data);
+
+            for(uint32_t i = 0; i < count; i++)
+            {
+                SIMD::MultiplyMatrix(data, GetData(rhs[i]), GetData(results[i]));
+            }
+        }
+
+        void NormalizeQuaternions(Quaternion* quaternions, uint32_t const count)
+        {
+            uint32_t i = 0;
+
+#if defined(OCULAR_SIMD_SSE)
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+
+            // Four quaternions are transposed into component registers at a time
+
+            for(; (i + 4) <= count; i += 4)
+            {
+                float* q0 = GetData(quaternions[i]);
+                float* q1 = GetData(quaternions[i + 1]);
+                float* q2 = GetData(quaternions[i + 2]);
+                float* q3 = GetData(quaternions[i + 3]);
+
+                __m128 c0 = _mm_loadu_ps(q0);
+                __m128 c1 = _mm_loadu_ps(q1);
+                __m128 c2 = _mm_loadu_ps(q2);
+                __m128 c3 = _mm_loadu_ps(q3);
+
+                _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+                __m128 lengthSq = _mm_mul_ps(c0, c0);
+                lengthSq = _mm_add_ps(lengthSq, _mm_mul_ps(c1, c1));
+                lengthSq = _mm_add_ps(lengthSq, _mm_mul_ps(c2, c2));
+                lengthSq = _mm_add_ps(lengthSq, _mm_mul_ps(c3, c3));
+
+                if(_mm_movemask_ps(_mm_cmple_ps(lengthSq, zero)) == 0)
+                {
+                    const __m128 inverseLength = _mm_div_ps(one, _mm_sqrt_ps(lengthSq));
+
+                    c0 = _mm_mul_ps(c0, inverseLength);
+                    c1 = _mm_mul_ps(c1, inverseLength);
+                    c2 = _mm_mul_ps(c2, inverseLength);
+                    c3 = _mm_mul_ps(c3, inverseLength);
+
+                    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+                    _mm_storeu_ps(q0, c0);
+                    _mm_storeu_ps(q1, c1);
+                    _mm_storeu_ps(q2, c2);
+                    _mm_storeu_ps(q3, c3);
+                }
+                else
+                {
+                    // Zero-length quaternions become the identity, which depends on the component order
+
+                    for(uint32_t j = 0; j < 4; j++)
+                    {
+                        quaternions[i + j].normalize();
+                    }
+                }
+            }
+#endif
+
+            for(; i < count; i++)
+            {
+                quaternions[i].normalize();
+            }
+        }
+
+        void CalculateMinMax(Vector4f const* points, uint32_t const count, uint32_t stride, Vector3f& min, Vector3f& max)
+        {
+            if(count > 0)
+            {
+                stride = (stride ? stride : static_cast<uint32_t>(sizeof(Vector4f)));
+
+#if defined(OCULAR_SIMD_SSE)
+                __m128 minimum = _mm_loadu_ps(GetPoint(points, stride, 0));
+                __m128 maximum = minimum;
+
+                for(uint32_t i = 1; i < count; i++)
+                {
+                    const __m128 point = _mm_loadu_ps(GetPoint(points, stride, i));
+
+                    minimum = _mm_min_ps(minimum, point);
+                    maximum = _mm_max_ps(maximum, point);
+                }
+
+                float values[4];
+
+                _mm_storeu_ps(values, minimum);
+                min = Vector3f(values[0], values[1], values[2]);
+
+                _mm_storeu_ps(values, maximum);
+                max = Vector3f(values[0], values[1], values[2]);
+#else
+                float const* first = GetPoint(points, stride, 0);
+
+                min = Vector3f(first[0], first[1], first[2]);
+                max = min;
+
+                for(uint32_t i = 1; i < count; i++)
+                {
+                    float const* point = GetPoint(points, stride, i);
+
+                    min.x = std::min(min.x, point[0]);
+                    min.y = std::min(min.y, point[1]);
+                    min.z = std::min(min.z, point[2]);
+
+                    max.x = std::max(max.x, point[0]);
+                    max.y = std::max(max.y, point[1]);
+                    max.z = std::max(max.z, point[2]);
+                }
+#endif
+            }
+        }
+
+        void CalculateMinMax(Matrix4x4 const& matrix, Vector4f const* points, uint32_t const count, uint32_t stride, Vector3f& min, Vector3f& max)
+        {
+            if(count > 0)
+            {
+                float const* data = GetData(matrix);
+                stride = (stride ? stride : static_cast<uint32_t>(sizeof(Vector4f)));
+
+#if defined(OCULAR_SIMD_SSE)
+                const __m128 c0 = _mm_loadu_ps(data);
+                const __m128 c1 = _mm_loadu_ps(data + 4);
+                const __m128 c2 = _mm_loadu_ps(data + 8);
+                const __m128 c3 = _mm_loadu_ps(data + 12);
+
+                __m128 minimum = _mm_set1_ps(FLT_MAX);
+                __m128 maximum = _mm_set1_ps(-FLT_MAX);
+
+                for(uint32_t i = 0; i < count; i++)
+                {
+                    const __m128 v = _mm_loadu_ps(GetPoint(points, stride, i));
+
+                    __m128 point = _mm_mul_ps(c0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+                    point = _mm_add_ps(point, _mm_mul_ps(c1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+                    point = _mm_add_ps(point, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+                    point = _mm_add_ps(point, _mm_mul_ps(c3, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+
+                    minimum = _mm_min_ps(minimum, point);
+                    maximum = _mm_max_ps(maximum, point);
+                }
+
+                float values[4];
+
+                _mm_storeu_ps(values, minimum);
+                min = Vector3f(values[0], values[1], values[2]);
+
+                _mm_storeu_ps(values, maximum);
+                max = Vector3f(values[0], values[1], values[2]);
+#else
+                min = Vector3f(FLT_MAX, FLT_MAX, FLT_MAX);
+                max = Vector3f(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+                for(uint32_t i = 0; i < count; i++)
+                {
+                    float point[4];
+                    SIMD::TransformVector(data, GetPoint(points, stride, i), point);
+
+                    min.x = std::min(min.x, point[0]);
+                    min.y = std::min(min.y, point[1]);
+                    min.z = std::min(min.z, point[2]);
+
+                    max.x = std::max(max.x, point[0]);
+                    max.y = std::max(max.y, point[1]);
+                    max.z = std::max(max.z, point[2]);
+                }
+#endif
+            }
+        }
+    }
+}
\ No newline at end of file
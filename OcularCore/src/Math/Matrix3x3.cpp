@@ -24,6 +24,8 @@
 #include "Utilities/StringRegistrar.hpp"
 #include "OcularEngine.hpp"
 
+#include <new>
+
 //------------------------------------------------------------------------------------------
 
 namespace Ocular
@@ -101,6 +103,9 @@ namespace Ocular
             }
         });
 
+        static_assert(sizeof(Matrix3x3_Internal) <= (sizeof(float) * 9), "Matrix3x3_Internal does not fit within the inline storage");
+        static_assert(alignof(Matrix3x3_Internal) <= alignof(float), "Matrix3x3_Internal requires stricter alignment than the inline storage");
+
         //----------------------------------------------------------------------------------
         // CONSTRUCTORS
         //----------------------------------------------------------------------------------
@@ -109,7 +114,7 @@ namespace Ocular
                              float const x1, float const y1, float const z1,
                              float const x2, float const y2, float const z2)
         {
-            m_Internal = new Matrix3x3_Internal(
+            new (m_Data) Matrix3x3_Internal(
                 glm::mat3x3(x0, y0, z0,
                             x1, y1, z1,
                             x2, y2, z2));
@@ -117,11 +122,11 @@ namespace Ocular
 
         Matrix3x3::Matrix3x3(float const* values)
         {
-            m_Internal = new Matrix3x3_Internal();
+            new (m_Data) Matrix3x3_Internal();
 
             if(values)
             {
-                m_Internal->matrix =
+                getInternal()->matrix =
                     glm::mat3x3(values[0], values[3], values[6],
                                 values[1], values[4], values[7],
                                 values[2], values[5], values[8]);
@@ -130,7 +135,7 @@ namespace Ocular
 
         Matrix3x3::Matrix3x3(Vector3<float> const& col0, Vector3<float> const& col1, Vector3<float> const& col2)
         {
-            m_Internal = new Matrix3x3_Internal(
+            new (m_Data) Matrix3x3_Internal(
                 glm::mat3x3(col0.x, col1.x, col2.x,
                             col0.y, col1.y, col2.y,
                             col0.z, col1.z, col2.z));
@@ -138,41 +143,37 @@ namespace Ocular
 
         Matrix3x3::Matrix3x3(Quaternion const& quat)
         {
-            m_Internal = new Matrix3x3_Internal(glm::mat3_cast(quat.getInternal()->quat));
+            new (m_Data) Matrix3x3_Internal(glm::mat3_cast(quat.getInternal()->quat));
         }
 
         Matrix3x3::Matrix3x3(Euler const& euler)
         {
-            m_Internal = new Matrix3x3_Internal(glm::mat3_cast(glm::quat(glm::vec3(euler.getPitch(), euler.getYaw(), euler.getRoll()))));
+            new (m_Data) Matrix3x3_Internal(glm::mat3_cast(glm::quat(glm::vec3(euler.getPitch(), euler.getYaw(), euler.getRoll()))));
         }
 
         Matrix3x3::Matrix3x3(Vector3<float> const& euler)
         {
-            m_Internal = new Matrix3x3_Internal(glm::mat3_cast(glm::quat(glm::vec3(euler.x, euler.y, euler.z))));
+            new (m_Data) Matrix3x3_Internal(glm::mat3_cast(glm::quat(glm::vec3(euler.x, euler.y, euler.z))));
         }
 
         Matrix3x3::Matrix3x3(Matrix3x3_Internal const& data)
         {
-            m_Internal = new Matrix3x3_Internal(data.matrix);
+            new (m_Data) Matrix3x3_Internal(data.matrix);
         }
 
         Matrix3x3::Matrix3x3(Matrix3x3 const& other)
         {
-            m_Internal = new Matrix3x3_Internal(other.m_Internal->matrix);
+            new (m_Data) Matrix3x3_Internal(other.getInternal()->matrix);
         }
 
         Matrix3x3::Matrix3x3()
         {
-            m_Internal = new Matrix3x3_Internal();
+            new (m_Data) Matrix3x3_Internal();
         }
 
         Matrix3x3::~Matrix3x3()
         {
-            if(m_Internal)
-            {
-                delete m_Internal;
-                m_Internal = nullptr;
-            }
+
         }
 
         //----------------------------------------------------------------------------------
@@ -191,7 +192,7 @@ namespace Ocular
             {
                 //[index % 3][index / 3] returns as column major
                 //[index / 3][index % 3] returns as row major
-                result = m_Internal->matrix[(index % 3)][(index / 3)];
+                result = getInternal()->matrix[(index % 3)][(index / 3)];
             }
 
             return result;
@@ -199,37 +200,37 @@ namespace Ocular
 
         Matrix3x3& Matrix3x3::operator=(Matrix3x3 const& rhs)
         {
-            m_Internal->matrix = rhs.m_Internal->matrix;
+            getInternal()->matrix = rhs.getInternal()->matrix;
             return (*this);
         }
 
         Matrix3x3& Matrix3x3::operator+=(Matrix3x3 const& rhs)
         {
-            m_Internal->matrix += rhs.m_Internal->matrix;
+            getInternal()->matrix += rhs.getInternal()->matrix;
             return (*this);
         }
 
         Matrix3x3& Matrix3x3::operator-=(Matrix3x3 const& rhs)
         {
-            m_Internal->matrix -= rhs.m_Internal->matrix;
+            getInternal()->matrix -= rhs.getInternal()->matrix;
             return (*this);
         }
 
         Matrix3x3& Matrix3x3::operator*=(Vector3<float> const& rhs)
         {
-            m_Internal->matrix *= glm::vec3(rhs.x, rhs.y, rhs.z);
+            getInternal()->matrix *= glm::vec3(rhs.x, rhs.y, rhs.z);
             return (*this);
         }
 
         Matrix3x3& Matrix3x3::operator*=(Matrix3x3 const& rhs)
         {
-            m_Internal->matrix *= rhs.m_Internal->matrix;
+            getInternal()->matrix *= rhs.getInternal()->matrix;
             return (*this);
         }
 
         Matrix3x3& Matrix3x3::operator*=(float const rhs)
         {
-            m_Internal->matrix *= rhs;
+            getInternal()->matrix *= rhs;
             return (*this);
         }
 
@@ -279,7 +280,7 @@ namespace Ocular
         {
             if(index < 9)
             {
-                m_Internal->matrix[(index % 3)][(index / 3)] = value;
+                getInternal()->matrix[(index % 3)][(index / 3)] = value;
             }
         }
 
@@ -291,7 +292,7 @@ namespace Ocular
             {
                 //[index % 3][index / 3] returns as column major
                 //[index / 3][index % 3] returns as row major
-                result = m_Internal->matrix[(index % 3)][(index / 3)];
+                result = getInternal()->matrix[(index % 3)][(index / 3)];
             }
 
             return result;
@@ -301,9 +302,9 @@ namespace Ocular
         {
             if(index < 3)
             {
-                m_Internal->matrix[0][index] = row[0];
-                m_Internal->matrix[1][index] = row[1];
-                m_Internal->matrix[2][index] = row[2];
+                getInternal()->matrix[0][index] = row[0];
+                getInternal()->matrix[1][index] = row[1];
+                getInternal()->matrix[2][index] = row[2];
             }
         }
 
@@ -311,9 +312,9 @@ namespace Ocular
         {
             if(index < 3)
             {
-                row[0] = m_Internal->matrix[0][index];
-                row[1] = m_Internal->matrix[1][index];
-                row[2] = m_Internal->matrix[2][index];
+                row[0] = getInternal()->matrix[0][index];
+                row[1] = getInternal()->matrix[1][index];
+                row[2] = getInternal()->matrix[2][index];
             }
         }
 
@@ -323,9 +324,9 @@ namespace Ocular
 
             if(index < 3)
             {
-                result[0] = m_Internal->matrix[0][index];
-                result[1] = m_Internal->matrix[1][index];
-                result[2] = m_Internal->matrix[2][index];
+                result[0] = getInternal()->matrix[0][index];
+                result[1] = getInternal()->matrix[1][index];
+                result[2] = getInternal()->matrix[2][index];
             }
 
             return result;
@@ -335,9 +336,9 @@ namespace Ocular
         {
             if(index < 3)
             {
-                m_Internal->matrix[index][0] = col[0];
-                m_Internal->matrix[index][1] = col[1];
-                m_Internal->matrix[index][2] = col[2];
+                getInternal()->matrix[index][0] = col[0];
+                getInternal()->matrix[index][1] = col[1];
+                getInternal()->matrix[index][2] = col[2];
             }
         }
 
@@ -345,9 +346,9 @@ namespace Ocular
         {
             if(index < 3)
             {
-                col[0] = m_Internal->matrix[index][0];
-                col[1] = m_Internal->matrix[index][1];
-                col[2] = m_Internal->matrix[index][2];
+                col[0] = getInternal()->matrix[index][0];
+                col[1] = getInternal()->matrix[index][1];
+                col[2] = getInternal()->matrix[index][2];
             }
         }
 
@@ -357,9 +358,9 @@ namespace Ocular
 
             if(index < 3)
             {
-                result[0] = m_Internal->matrix[index][0];
-                result[1] = m_Internal->matrix[index][1];
-                result[2] = m_Internal->matrix[index][2];
+                result[0] = getInternal()->matrix[index][0];
+                result[1] = getInternal()->matrix[index][1];
+                result[2] = getInternal()->matrix[index][2];
             }
 
             return result;
@@ -367,16 +368,16 @@ namespace Ocular
 
         void Matrix3x3::setData(float const* data)
         {
-            m_Internal->matrix[0][0] = data[0]; m_Internal->matrix[1][0] = data[3]; m_Internal->matrix[2][0] = data[6];
-            m_Internal->matrix[0][1] = data[1]; m_Internal->matrix[1][1] = data[4]; m_Internal->matrix[2][1] = data[7];
-            m_Internal->matrix[0][2] = data[2]; m_Internal->matrix[1][2] = data[5]; m_Internal->matrix[2][2] = data[8];
+            getInternal()->matrix[0][0] = data[0]; getInternal()->matrix[1][0] = data[3]; getInternal()->matrix[2][0] = data[6];
+            getInternal()->matrix[0][1] = data[1]; getInternal()->matrix[1][1] = data[4]; getInternal()->matrix[2][1] = data[7];
+            getInternal()->matrix[0][2] = data[2]; getInternal()->matrix[1][2] = data[5]; getInternal()->matrix[2][2] = data[8];
         }
 
         void Matrix3x3::getData(float* data) const
         {
-            data[0] = m_Internal->matrix[0][0]; data[3] = m_Internal->matrix[1][0]; data[6] = m_Internal->matrix[2][0];
-            data[1] = m_Internal->matrix[0][1]; data[4] = m_Internal->matrix[1][1]; data[7] = m_Internal->matrix[2][1];
-            data[2] = m_Internal->matrix[0][2]; data[5] = m_Internal->matrix[1][2]; data[8] = m_Internal->matrix[2][2];
+            data[0] = getInternal()->matrix[0][0]; data[3] = getInternal()->matrix[1][0]; data[6] = getInternal()->matrix[2][0];
+            data[1] = getInternal()->matrix[0][1]; data[4] = getInternal()->matrix[1][1]; data[7] = getInternal()->matrix[2][1];
+            data[2] = getInternal()->matrix[0][2]; data[5] = getInternal()->matrix[1][2]; data[8] = getInternal()->matrix[2][2];
         }
 
         //----------------------------------------------------------------
@@ -385,22 +386,22 @@ namespace Ocular
         
         void Matrix3x3::invert()
         {
-            m_Internal->matrix = glm::inverse(m_Internal->matrix);
+            getInternal()->matrix = glm::inverse(getInternal()->matrix);
         }
 
         Matrix3x3 Matrix3x3::getInverse() const
         {
-            return Matrix3x3(Matrix3x3_Internal(glm::inverse(m_Internal->matrix)));
+            return Matrix3x3(Matrix3x3_Internal(glm::inverse(getInternal()->matrix)));
         }
 
         float Matrix3x3::getDeterminant() const
         {
-            return glm::determinant(m_Internal->matrix);
+            return glm::determinant(getInternal()->matrix);
         }
 
         Matrix3x3 Matrix3x3::getTranspose() const
         {
-            return Matrix3x3(Matrix3x3_Internal(glm::transpose(m_Internal->matrix)));
+            return Matrix3x3(Matrix3x3_Internal(glm::transpose(getInternal()->matrix)));
         }
 
         //----------------------------------------------------------------
@@ -413,7 +414,7 @@ namespace Ocular
 
         Matrix3x3_Internal* Matrix3x3::getInternal() const
         {
-            return m_Internal;
+            return reinterpret_cast<Matrix3x3_Internal*>(const_cast<float*>(m_Data));
         }
 
         //----------------------------------------------------------------------------------
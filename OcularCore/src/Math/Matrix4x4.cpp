@@ -20,11 +20,13 @@
 #include "Math/Matrix3x3.hpp"
 #include "Math/Vector3.hpp"
 #include "Math/Vector4.hpp"
+#include "Math/SIMD.hpp"
 
 #include "Utilities/StringRegistrar.hpp"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <new>
 
 //------------------------------------------------------------------------------------------
 
@@ -103,6 +105,9 @@ namespace Ocular
             }
         });
 
+        static_assert(sizeof(Matrix4x4_Internal) <= (sizeof(float) * 16), "Matrix4x4_Internal does not fit within the inline storage");
+        static_assert(alignof(Matrix4x4_Internal) <= alignof(float), "Matrix4x4_Internal requires stricter alignment than the inline storage");
+
         //----------------------------------------------------------------------------------
         // CONSTRUCTORS
         //----------------------------------------------------------------------------------
@@ -112,7 +117,7 @@ namespace Ocular
                              float const x2, float const y2, float const z2, float const w2,
                              float const x3, float const y3, float const z3, float const w3)
         {
-            m_Internal = new Matrix4x4_Internal(
+            new (m_Data) Matrix4x4_Internal(
                 glm::mat4x4(x0, y0, z0, w0,
                             x1, y1, z1, w1,
                             x2, y2, z2, w2,
@@ -121,16 +126,16 @@ namespace Ocular
 
         Matrix4x4::Matrix4x4(Matrix3x3 const& matrix)
         {
-            m_Internal = new Matrix4x4_Internal(glm::mat4x4(matrix.getInternal()->matrix));
+            new (m_Data) Matrix4x4_Internal(glm::mat4x4(matrix.getInternal()->matrix));
         }
 
         Matrix4x4::Matrix4x4(float const* values)
         {
-            m_Internal = new Matrix4x4_Internal();
+            new (m_Data) Matrix4x4_Internal();
 
             if(values)
             {
-                m_Internal->matrix =
+                getInternal()->matrix =
                     glm::mat4x4(values[0], values[4], values[8],  values[12],
                                 values[1], values[5], values[9],  values[13],
                                 values[2], values[6], values[10], values[14],
@@ -140,7 +145,7 @@ namespace Ocular
 
         Matrix4x4::Matrix4x4(Vector4<float> const& col0, Vector4<float> const& col1, Vector4<float> const& col2, Vector4<float> const& col3)
         {
-            m_Internal = new Matrix4x4_Internal(
+            new (m_Data) Matrix4x4_Internal(
                 glm::mat4x4(col0.x, col1.x, col2.x, col3.x,
                             col0.y, col1.y, col2.y, col3.y,
                             col0.z, col1.z, col2.z, col3.z,
@@ -149,20 +154,20 @@ namespace Ocular
 
         Matrix4x4::Matrix4x4(Vector3<float> const& position, Quaternion const& rotation)
         {
-            m_Internal = new Matrix4x4_Internal(glm::mat4x4(glm::mat3_cast(rotation.getInternal()->quat)));
+            new (m_Data) Matrix4x4_Internal(glm::mat4x4(glm::mat3_cast(rotation.getInternal()->quat)));
             
-            m_Internal->matrix[3][0] = position[0];
-            m_Internal->matrix[3][1] = position[1];
-            m_Internal->matrix[3][2] = position[2];
+            getInternal()->matrix[3][0] = position[0];
+            getInternal()->matrix[3][1] = position[1];
+            getInternal()->matrix[3][2] = position[2];
         }
 
         Matrix4x4::Matrix4x4(Vector3<float> const& position, Vector3<float> const& eulerRotation)
         {
-            m_Internal = new Matrix4x4_Internal(glm::mat4x4(glm::mat3_cast(glm::quat(glm::vec3(eulerRotation.x, eulerRotation.y, eulerRotation.z)))));
+            new (m_Data) Matrix4x4_Internal(glm::mat4x4(glm::mat3_cast(glm::quat(glm::vec3(eulerRotation.x, eulerRotation.y, eulerRotation.z)))));
             
-            m_Internal->matrix[3][0] = position[0];
-            m_Internal->matrix[3][1] = position[1];
-            m_Internal->matrix[3][2] = position[2];
+            getInternal()->matrix[3][0] = position[0];
+            getInternal()->matrix[3][1] = position[1];
+            getInternal()->matrix[3][2] = position[2];
         }
 
         Matrix4x4::Matrix4x4(Vector3<float> const& position, Quaternion const& rotation, Vector3<float> const& scale)
@@ -171,31 +176,27 @@ namespace Ocular
             const glm::mat4x4 matRotate = glm::mat4x4(glm::mat3_cast(rotation.getInternal()->quat));
             const glm::mat4x4 matTranslate = glm::translate(glm::mat4(), glm::vec3(position.x, position.y, position.z));
 
-            m_Internal = new Matrix4x4_Internal(matTranslate * matRotate * matScale);
+            new (m_Data) Matrix4x4_Internal(matTranslate * matRotate * matScale);
         }
 
         Matrix4x4::Matrix4x4(Matrix4x4_Internal const& data)
         {
-            m_Internal = new Matrix4x4_Internal(data.matrix);
+            new (m_Data) Matrix4x4_Internal(data.matrix);
         }
 
         Matrix4x4::Matrix4x4(Matrix4x4 const& other)
         {
-            m_Internal = new Matrix4x4_Internal(other.m_Internal->matrix);
+            new (m_Data) Matrix4x4_Internal(other.getInternal()->matrix);
         }
 
         Matrix4x4::Matrix4x4()
         {
-            m_Internal = new Matrix4x4_Internal();
+            new (m_Data) Matrix4x4_Internal();
         }
 
         Matrix4x4::~Matrix4x4()
         {
-            if(m_Internal)
-            {
-                delete m_Internal;
-                m_Internal = nullptr;
-            }
+
         }
 
         //----------------------------------------------------------------------------------
@@ -210,42 +211,42 @@ namespace Ocular
         {
             //[index % 4][index / 4] returns as column major
             //[index / 4][index % 4] returns as row major
-            return m_Internal->matrix[(index % 4)][(index / 4)];
+            return getInternal()->matrix[(index % 4)][(index / 4)];
         }
 
         Matrix4x4& Matrix4x4::operator=(Matrix4x4 const& rhs)
         {
-            m_Internal->matrix = rhs.m_Internal->matrix;
+            getInternal()->matrix = rhs.getInternal()->matrix;
             return (*this);
         }
 
         Matrix4x4& Matrix4x4::operator+=(Matrix4x4 const& rhs)
         {
-            m_Internal->matrix += rhs.m_Internal->matrix;
+            getInternal()->matrix += rhs.getInternal()->matrix;
             return (*this);
         }
 
         Matrix4x4& Matrix4x4::operator-=(Matrix4x4 const& rhs)
         {
-            m_Internal->matrix -= rhs.m_Internal->matrix;
+            getInternal()->matrix -= rhs.getInternal()->matrix;
             return (*this);
         }
 
         Matrix4x4& Matrix4x4::operator*=(Matrix4x4 const& rhs)
         {
-            m_Internal->matrix *= rhs.m_Internal->matrix;
+            SIMD::MultiplyMatrix(&(getInternal()->matrix[0][0]), &(rhs.getInternal()->matrix[0][0]), &(getInternal()->matrix[0][0]));
             return (*this);
         }
 
         Matrix4x4& Matrix4x4::operator*=(float const rhs)
         {
-            m_Internal->matrix *= rhs;
+            getInternal()->matrix *= rhs;
             return (*this);
         }
 
         Matrix4x4& Matrix4x4::operator*=(Vector4<float> const& rhs)
         {
-            m_Internal->matrix *= glm::vec4(rhs.x, rhs.y, rhs.z, rhs.w);
+            getInternal()->matrix *= glm::vec4(rhs.x, rhs.y, rhs.z, rhs.w);
             return (*this);
         }
 
@@ -271,7 +272,10 @@ namespace Ocular
 
         Matrix4x4 operator*(Matrix4x4 const& lhs, Matrix4x4 const& rhs)
         {
-            return Matrix4x4(Matrix4x4_Internal(lhs.getInternal()->matrix * rhs.getInternal()->matrix));
+            Matrix4x4 result;
+            SIMD::MultiplyMatrix(&(lhs.getInternal()->matrix[0][0]), &(rhs.getInternal()->matrix[0][0]), &(result.getInternal()->matrix[0][0]));
+
+            return result;
         }
 
         Matrix4x4 operator*(Matrix4x4 const& lhs, float const rhs)
@@ -281,18 +285,20 @@ namespace Ocular
 
         Vector4<float> operator*(Matrix4x4 const& lhs, Vector4<float> const& rhs)
         {
-            glm::vec4 vec(rhs.x, rhs.y, rhs.z, rhs.w);
-            vec = lhs.getInternal()->matrix * vec;
+            Vector4<float> result;
+            SIMD::TransformVector(&(lhs.getInternal()->matrix[0][0]), &(rhs.x), &(result.x));
 
-            return Vector4<float>(vec.x, vec.y, vec.z, vec.w);
+            return result;
         }
 
         Vector3<float> operator*(Matrix4x4 const& lhs, Vector3<float> const& rhs)
         {
-            glm::vec4 vec(rhs.x, rhs.y, rhs.z, 1.0f);
-            vec = lhs.getInternal()->matrix * vec;
+            const Vector4<float> vec(rhs.x, rhs.y, rhs.z, 1.0f);
+
+            Vector4<float> result;
+            SIMD::TransformVector(&(lhs.getInternal()->matrix[0][0]), &(vec.x), &(result.x));
 
-            return Vector3<float>(vec.x, vec.y, vec.z);
+            return Vector3<float>(result.x, result.y, result.z);
         }
 
         //----------------------------------------------------------------
@@ -303,7 +309,7 @@ namespace Ocular
         {
             if(index < 16)
             {
-                m_Internal->matrix[(index % 4)][(index / 4)] = value;
+                getInternal()->matrix[(index % 4)][(index / 4)] = value;
             }
         }
 
@@ -315,7 +321,7 @@ namespace Ocular
             {
                 //[index % 4][index / 4] returns as column major
                 //[index / 4][index % 4] returns as row major
-                result = m_Internal->matrix[(index % 4)][(index / 4)];
+                result = getInternal()->matrix[(index % 4)][(index / 4)];
             }
 
             return result;
@@ -325,10 +331,10 @@ namespace Ocular
         {
             if(index < 4)
             {
-                m_Internal->matrix[0][index] = row[0];
-                m_Internal->matrix[1][index] = row[1];
-                m_Internal->matrix[2][index] = row[2];
-                m_Internal->matrix[3][index] = row[3];
+                getInternal()->matrix[0][index] = row[0];
+                getInternal()->matrix[1][index] = row[1];
+                getInternal()->matrix[2][index] = row[2];
+                getInternal()->matrix[3][index] = row[3];
             }
         }
 
@@ -336,9 +342,9 @@ namespace Ocular
         {
             if(index < 4)
             {
-                m_Internal->matrix[0][index] = row[0];
-                m_Internal->matrix[1][index] = row[1];
-                m_Internal->matrix[2][index] = row[2];
+                getInternal()->matrix[0][index] = row[0];
+                getInternal()->matrix[1][index] = row[1];
+                getInternal()->matrix[2][index] = row[2];
             }
         }
 
@@ -346,10 +352,10 @@ namespace Ocular
         {
             if(index < 4)
             {
-                row[0] = m_Internal->matrix[0][index];
-                row[1] = m_Internal->matrix[1][index];
-                row[2] = m_Internal->matrix[2][index];
-                row[3] = m_Internal->matrix[3][index];
+                row[0] = getInternal()->matrix[0][index];
+                row[1] = getInternal()->matrix[1][index];
+                row[2] = getInternal()->matrix[2][index];
+                row[3] = getInternal()->matrix[3][index];
             }
         }
 
@@ -359,10 +365,10 @@ namespace Ocular
             
             if(index < 4)
             {
-                result[0] = m_Internal->matrix[0][index];
-                result[1] = m_Internal->matrix[1][index];
-                result[2] = m_Internal->matrix[2][index];
-                result[3] = m_Internal->matrix[3][index];
+                result[0] = getInternal()->matrix[0][index];
+                result[1] = getInternal()->matrix[1][index];
+                result[2] = getInternal()->matrix[2][index];
+                result[3] = getInternal()->matrix[3][index];
             }
 
             return result;
@@ -372,10 +378,10 @@ namespace Ocular
         {
             if(index < 4)
             {
-                m_Internal->matrix[index][0] = col[0];
-                m_Internal->matrix[index][1] = col[1];
-                m_Internal->matrix[index][2] = col[2];
-                m_Internal->matrix[index][3] = col[3];
+                getInternal()->matrix[index][0] = col[0];
+                getInternal()->matrix[index][1] = col[1];
+                getInternal()->matrix[index][2] = col[2];
+                getInternal()->matrix[index][3] = col[3];
             }
         }
 
@@ -383,9 +389,9 @@ namespace Ocular
         {
             if(index < 4)
             {
-                m_Internal->matrix[index][0] = col[0];
-                m_Internal->matrix[index][1] = col[1];
-                m_Internal->matrix[index][2] = col[2];
+                getInternal()->matrix[index][0] = col[0];
+                getInternal()->matrix[index][1] = col[1];
+                getInternal()->matrix[index][2] = col[2];
             }
         }
 
@@ -393,10 +399,10 @@ namespace Ocular
         {
             if(index < 4)
             {
-                col[0] = m_Internal->matrix[index][0];
-                col[1] = m_Internal->matrix[index][1];
-                col[2] = m_Internal->matrix[index][2];
-                col[3] = m_Internal->matrix[index][3];
+                col[0] = getInternal()->matrix[index][0];
+                col[1] = getInternal()->matrix[index][1];
+                col[2] = getInternal()->matrix[index][2];
+                col[3] = getInternal()->matrix[index][3];
             }
         }
 
@@ -406,10 +412,10 @@ namespace Ocular
             
             if(index < 4)
             {
-                result[0] = m_Internal->matrix[index][0];
-                result[1] = m_Internal->matrix[index][1];
-                result[2] = m_Internal->matrix[index][2];
-                result[3] = m_Internal->matrix[index][3];
+                result[0] = getInternal()->matrix[index][0];
+                result[1] = getInternal()->matrix[index][1];
+                result[2] = getInternal()->matrix[index][2];
+                result[3] = getInternal()->matrix[index][3];
             }
 
             return result;
@@ -417,18 +423,18 @@ namespace Ocular
 
         void Matrix4x4::setData(float const* data)
         {
-            m_Internal->matrix[0][0] = data[0]; m_Internal->matrix[1][0] = data[4]; m_Internal->matrix[2][0] = data[8];  m_Internal->matrix[3][0] = data[12];
-            m_Internal->matrix[0][1] = data[1]; m_Internal->matrix[1][1] = data[5]; m_Internal->matrix[2][1] = data[9];  m_Internal->matrix[3][1] = data[13];
-            m_Internal->matrix[0][2] = data[2]; m_Internal->matrix[1][2] = data[6]; m_Internal->matrix[2][2] = data[10]; m_Internal->matrix[3][2] = data[14];
-            m_Internal->matrix[0][3] = data[3]; m_Internal->matrix[1][3] = data[7]; m_Internal->matrix[2][3] = data[11]; m_Internal->matrix[3][3] = data[15];
+            getInternal()->matrix[0][0] = data[0]; getInternal()->matrix[1][0] = data[4]; getInternal()->matrix[2][0] = data[8];  getInternal()->matrix[3][0] = data[12];
+            getInternal()->matrix[0][1] = data[1]; getInternal()->matrix[1][1] = data[5]; getInternal()->matrix[2][1] = data[9];  getInternal()->matrix[3][1] = data[13];
+            getInternal()->matrix[0][2] = data[2]; getInternal()->matrix[1][2] = data[6]; getInternal()->matrix[2][2] = data[10]; getInternal()->matrix[3][2] = data[14];
+            getInternal()->matrix[0][3] = data[3]; getInternal()->matrix[1][3] = data[7]; getInternal()->matrix[2][3] = data[11]; getInternal()->matrix[3][3] = data[15];
         }
 
         void Matrix4x4::getData(float* data) const
         {
-            data[0] = m_Internal->matrix[0][0]; data[4] = m_Internal->matrix[1][0]; data[8]  = m_Internal->matrix[2][0]; data[12] = m_Internal->matrix[3][0];
-            data[1] = m_Internal->matrix[0][1]; data[5] = m_Internal->matrix[1][1]; data[9]  = m_Internal->matrix[2][1]; data[13] = m_Internal->matrix[3][1];
-            data[2] = m_Internal->matrix[0][2]; data[6] = m_Internal->matrix[1][2]; data[10] = m_Internal->matrix[2][2]; data[14] = m_Internal->matrix[3][2];
-            data[3] = m_Internal->matrix[0][3]; data[7] = m_Internal->matrix[1][3]; data[11] = m_Internal->matrix[2][3]; data[15] = m_Internal->matrix[3][3];
+            data[0] = getInternal()->matrix[0][0]; data[4] = getInternal()->matrix[1][0]; data[8]  = getInternal()->matrix[2][0]; data[12] = getInternal()->matrix[3][0];
+            data[1] = getInternal()->matrix[0][1]; data[5] = getInternal()->matrix[1][1]; data[9]  = getInternal()->matrix[2][1]; data[13] = getInternal()->matrix[3][1];
+            data[2] = getInternal()->matrix[0][2]; data[6] = getInternal()->matrix[1][2]; data[10] = getInternal()->matrix[2][2]; data[14] = getInternal()->matrix[3][2];
+            data[3] = getInternal()->matrix[0][3]; data[7] = getInternal()->matrix[1][3]; data[11] = getInternal()->matrix[2][3]; data[15] = getInternal()->matrix[3][3];
         }
 
         //----------------------------------------------------------------
@@ -437,32 +443,32 @@ namespace Ocular
 
         void Matrix4x4::invert()
         {
-            m_Internal->matrix = glm::inverse(m_Internal->matrix);
+            getInternal()->matrix = glm::inverse(getInternal()->matrix);
         }
 
         Matrix4x4 Matrix4x4::getInverse() const
         {
-            return Matrix4x4(Matrix4x4_Internal(glm::inverse(m_Internal->matrix)));
+            return Matrix4x4(Matrix4x4_Internal(glm::inverse(getInternal()->matrix)));
         }
 
         float Matrix4x4::getDeterminant() const
         {
-            return glm::determinant(m_Internal->matrix);
+            return glm::determinant(getInternal()->matrix);
         }
 
         Matrix4x4 Matrix4x4::getTranspose() const
         {
-            return Matrix4x4(Matrix4x4_Internal(glm::transpose(m_Internal->matrix)));
+            return Matrix4x4(Matrix4x4_Internal(glm::transpose(getInternal()->matrix)));
         }
 
         bool Matrix4x4::isIdentity() const
         {
             bool result = false;
 
-            if( IsOne(m_Internal->matrix[0][0]) && IsZero(m_Internal->matrix[1][0]) && IsZero(m_Internal->matrix[2][0]) && IsZero(m_Internal->matrix[3][0]) &&
-               IsZero(m_Internal->matrix[0][0]) &&  IsOne(m_Internal->matrix[1][0]) && IsZero(m_Internal->matrix[2][0]) && IsZero(m_Internal->matrix[3][0]) &&
-               IsZero(m_Internal->matrix[0][0]) && IsZero(m_Internal->matrix[1][0]) &&  IsOne(m_Internal->matrix[2][0]) && IsZero(m_Internal->matrix[3][0]) &&
-               IsZero(m_Internal->matrix[0][0]) && IsZero(m_Internal->matrix[1][0]) && IsZero(m_Internal->matrix[2][0]) &&  IsOne(m_Internal->matrix[3][0]))
+            if( IsOne(getInternal()->matrix[0][0]) && IsZero(getInternal()->matrix[1][0]) && IsZero(getInternal()->matrix[2][0]) && IsZero(getInternal()->matrix[3][0]) &&
+               IsZero(getInternal()->matrix[0][0]) &&  IsOne(getInternal()->matrix[1][0]) && IsZero(getInternal()->matrix[2][0]) && IsZero(getInternal()->matrix[3][0]) &&
+               IsZero(getInternal()->matrix[0][0]) && IsZero(getInternal()->matrix[1][0]) &&  IsOne(getInternal()->matrix[2][0]) && IsZero(getInternal()->matrix[3][0]) &&
+               IsZero(getInternal()->matrix[0][0]) && IsZero(getInternal()->matrix[1][0]) && IsZero(getInternal()->matrix[2][0]) &&  IsOne(getInternal()->matrix[3][0]))
             {
                 result = true;
             }
@@ -513,7 +519,7 @@ namespace Ocular
 
         Matrix4x4_Internal* Matrix4x4::getInternal() const
         {
-            return m_Internal;
+            return reinterpret_cast<Matrix4x4_Internal*>(const_cast<float*>(m_Data));
         }
 
         //----------------------------------------------------------------------------------
@@ -16,7 +16,11 @@
 
 #include "Math/MortonCode.hpp"
 #include "Math/Vector3.hpp"
+#include "Math/SIMD.hpp"
+#include "OcularEngine.hpp"
+
 #include <algorithm>
+#include <cfloat>
 
 //------------------------------------------------------------------------------------------
 
@@ -131,6 +135,139 @@ static const uint32_t mZ[256] = {
     0x00924804, 0x00924820, 0x00924824, 0x00924900, 0x00924904, 0x00924920, 0x00924924
 };
 
+namespace
+{
+    const uint32_t BatchSize = 4096;    ///< Minimum number of codes calculated or sorted by a single thread
+    const uint32_t RadixBits = 11;      ///< Bits sorted per radix pass. The 63-bit codes are sorted in 6 passes, rather than 8 with bytes.
+    const uint32_t RadixSize = (1 << RadixBits);
+    const uint32_t RadixMask = (RadixSize - 1);
+
+#if defined(OCULAR_SIMD_BMI2)
+    const uint64_t MaskX = 0x1249249249249249ull;    ///< Bits of the Morton Code holding the x-component (every third bit from 0)
+    const uint64_t MaskY = 0x2492492492492492ull;    ///< Bits of the Morton Code holding the y-component (every third bit from 1)
+    const uint64_t MaskZ = 0x4924924924924924ull;    ///< Bits of the Morton Code holding the z-component (every third bit from 2)
+#else
+    /**
+     * Gathers every third bit (starting with the first) into the lowest 21 bits.
+     */
+    inline uint32_t Compact(uint64_t value)
+    {
+        value &= 0x1249249249249249ull;
+        value  = (value ^ (value >> 2))  & 0x10c30c30c30c30c3ull;
+        value  = (value ^ (value >> 4))  & 0x100f00f00f00f00full;
+        value  = (value ^ (value >> 8))  & 0x001f0000ff0000ffull;
+        value  = (value ^ (value >> 16)) & 0x001f00000000ffffull;
+        value  = (value ^ (value >> 32)) & 0x00000000001fffffull;
+
+        return static_cast<uint32_t>(value);
+    }
+#endif
+
+    /**
+     * Parallel least-significant-digit radix sort, RadixBits per pass.
+     *
+     * Each batch counts the digits of it's own range, the counts are then prefix-summed
+     * (digit-major, batch-minor) so that each batch scatters into it's own region of the
+     * output. As batches are processed in order, the sort is stable.
+     *
+     * If values is not NULL, it is permuted along with the codes.
+     */
+    void RadixSort(std::vector<uint64_t>& codes, std::vector<uint32_t>* values)
+    {
+        const uint32_t count      = static_cast<uint32_t>(codes.size());
+        const uint32_t numBatches = OcularThreads->getNumBatches(count, BatchSize);
+
+        std::vector<uint64_t> scratchCodes(count);
+        std::vector<uint32_t> scratchValues(values ? count : 0);
+        std::vector<uint32_t> offsets(numBatches * RadixSize);
+
+        std::vector<uint64_t>* sourceCodes       = &codes;
+        std::vector<uint64_t>* destinationCodes  = &scratchCodes;
+        std::vector<uint32_t>* sourceValues      = values;
+        std::vector<uint32_t>* destinationValues = &scratchValues;
+
+        for(uint32_t shift = 0; shift < 64; shift += RadixBits)
+        {
+            //------------------------------------------------------------
+            // Count the digits in each batch
+
+            OcularThreads->parallelFor(count, BatchSize, [&](uint32_t const batch, uint32_t const first, uint32_t const last)
+            {
+                uint32_t* counts = &offsets[batch * RadixSize];
+                std::fill(counts, (counts + RadixSize), 0);
+
+                for(uint32_t i = first; i < last; i++)
+                {
+                    counts[((*sourceCodes)[i] >> shift) & RadixMask]++;
+                }
+            });
+
+            //------------------------------------------------------------
+            // Convert the counts into output offsets.
+            // If every code shares the same digit, this pass would not change anything.
+
+            bool skipPass = false;
+            uint32_t offset = 0;
+
+            for(uint32_t digit = 0; (digit < RadixSize) && !skipPass; digit++)
+            {
+                const uint32_t start = offset;
+
+                for(uint32_t batch = 0; batch < numBatches; batch++)
+                {
+                    const uint32_t digitCount = offsets[(batch * RadixSize) + digit];
+
+                    offsets[(batch * RadixSize) + digit] = offset;
+                    offset += digitCount;
+                }
+
+                skipPass = ((offset - start) == count);
+            }
+
+            if(skipPass)
+            {
+                continue;
+            }
+
+            //------------------------------------------------------------
+            // Scatter
+
+            OcularThreads->parallelFor(count, BatchSize, [&](uint32_t const batch, uint32_t const first, uint32_t const last)
+            {
+                uint32_t* batchOffsets = &offsets[batch * RadixSize];
+
+                for(uint32_t i = first; i < last; i++)
+                {
+                    const uint64_t code = (*sourceCodes)[i];
+                    const uint32_t destination = batchOffsets[(code >> shift) & RadixMask]++;
+
+                    (*destinationCodes)[destination] = code;
+
+                    if(values)
+                    {
+                        (*destinationValues)[destination] = (*sourceValues)[i];
+                    }
+                }
+            });
+
+            std::swap(sourceCodes, destinationCodes);
+            std::swap(sourceValues, destinationValues);
+        }
+
+        if(sourceCodes != &codes)
+        {
+            codes.swap(scratchCodes);
+
+            if(values)
+            {
+                values->swap(scratchValues);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+
 namespace Ocular
 {
     namespace Math
@@ -165,18 +302,40 @@ namespace Ocular
 
         uint64_t MortonCode::calculate(uint32_t x, uint32_t y, uint32_t z)
         {
+            uint64_t result = 0;
+
+#if defined(OCULAR_SIMD_BMI2)
+            // PDEP deposits the low bits of each component into every third bit of the mask
+
+            result = _pdep_u64(x, MaskX) | _pdep_u64(y, MaskY) | _pdep_u64(z, MaskZ);
+#else
             // Source: Morton encoding/decoding through bit interleaving: Implementations
             // http://www.forceflow.be/2013/10/07/morton-encodingdecoding-through-bit-interleaving-implementations/
+            //
+            // Each table entry spreads 8 bits over 24, so the three bytes of each component are
+            // shifted 24 bits apart. Only the lowest 5 bits of the upper byte are part of the 21.
 
-            uint64_t result = 0;
-
-            result = mZ[(z >> 16) & 0xFF] | mY[(y >> 16) & 0xFF] | mX[(x >> 16) & 0xFF];
-            result = result << 48 | mZ[(z >> 8) & 0xFF] | mY[(y >> 8) & 0xFF] | mX[(x >> 8) & 0xFF];
-            result = result << 24 | mZ[z & 0xFF] | mY[y & 0xFF] | mX[x & 0xFF];
+            result = mZ[(z >> 16) & 0x1F] | mY[(y >> 16) & 0x1F] | mX[(x >> 16) & 0x1F];
+            result = (result << 24) | mZ[(z >> 8) & 0xFF] | mY[(y >> 8) & 0xFF] | mX[(x >> 8) & 0xFF];
+            result = (result << 24) | mZ[z & 0xFF] | mY[y & 0xFF] | mX[x & 0xFF];
+#endif
 
             return result;
         }
 
+        void MortonCode::decode(uint64_t const code, uint32_t& x, uint32_t& y, uint32_t& z)
+        {
+#if defined(OCULAR_SIMD_BMI2)
+            x = static_cast<uint32_t>(_pext_u64(code, MaskX));
+            y = static_cast<uint32_t>(_pext_u64(code, MaskY));
+            z = static_cast<uint32_t>(_pext_u64(code, MaskZ));
+#else
+            x = Compact(code);
+            y = Compact(code >> 1);
+            z = Compact(code >> 2);
+#endif
+        }
+
         void MortonCode::calculate(std::vector<Vector3<float>> const& vectors, std::vector<uint64_t>& mortonCodes, bool areInRange, bool sortCodes)
         {
             float scaleFactor  = 1.0f;
@@ -197,7 +356,68 @@ namespace Ocular
 
             if(sortCodes)
             {
-                std::sort(mortonCodes.begin(), mortonCodes.end());
+                RadixSort(mortonCodes, nullptr);
+            }
+        }
+
+        void MortonCode::calculate(float const* x, float const* y, float const* z, uint32_t const count, std::vector<uint64_t>& mortonCodes, std::vector<uint32_t>& order, bool const areInRange)
+        {
+            float scaleFactor  = 1.0f;
+            float offsetFactor = 0.0f;
+
+            if(!areInRange && (count > 0))
+            {
+                const uint32_t numBatches = OcularThreads->getNumBatches(count, BatchSize);
+                std::vector<float> batchExtents(numBatches * 2);
+
+                OcularThreads->parallelFor(count, BatchSize, [&](uint32_t const batch, uint32_t const first, uint32_t const last)
+                {
+                    float minValue =  FLT_MAX;
+                    float maxValue = -FLT_MAX;
+
+                    for(uint32_t i = first; i < last; i++)
+                    {
+                        minValue = fminf(minValue, fminf(x[i], fminf(y[i], z[i])));
+                        maxValue = fmaxf(maxValue, fmaxf(x[i], fmaxf(y[i], z[i])));
+                    }
+
+                    batchExtents[(batch * 2)]     = minValue;
+                    batchExtents[(batch * 2) + 1] = maxValue;
+                });
+
+                float minValue =  FLT_MAX;
+                float maxValue = -FLT_MAX;
+
+                for(uint32_t i = 0; i < numBatches; i++)
+                {
+                    minValue = fminf(minValue, batchExtents[(i * 2)]);
+                    maxValue = fmaxf(maxValue, batchExtents[(i * 2) + 1]);
+                }
+
+                scaleFactor  = 1.0f / fmaxf(EPSILON_FLOAT, (maxValue - minValue));
+                offsetFactor = -minValue;
+            }
+
+            mortonCodes.resize(count);
+            order.resize(count);
+
+            OcularThreads->parallelFor(count, BatchSize, [&](uint32_t const batch, uint32_t const first, uint32_t const last)
+            {
+                for(uint32_t i = first; i < last; i++)
+                {
+                    mortonCodes[i] = calculate(((x[i] + offsetFactor) * scaleFactor), ((y[i] + offsetFactor) * scaleFactor), ((z[i] + offsetFactor) * scaleFactor));
+                    order[i] = i;
+                }
+            });
+
+            RadixSort(mortonCodes, &order);
+        }
+
+        void MortonCode::sort(std::vector<uint64_t>& mortonCodes, std::vector<uint32_t>& values)
+        {
+            if(mortonCodes.size() == values.size())
+            {
+                RadixSort(mortonCodes, &values);
             }
         }
 
@@ -207,8 +427,8 @@ namespace Ocular
 
         void MortonCode::getTransformFactors(std::vector<Vector3<float>> const& vectors, float& scaleFactor, float& offsetFactor)
         {
-            float minValue = FLT_MAX;
-            float maxValue = FLT_MIN;
+            float minValue =  FLT_MAX;
+            float maxValue = -FLT_MAX;
 
             for(auto const& vector : vectors)
             {
@@ -219,7 +439,7 @@ namespace Ocular
             float difference = std::fmaxf(EPSILON_FLOAT, (maxValue - minValue));  // Avoid division by 0
 
             scaleFactor  = (1.0f / difference);
-            offsetFactor = (minValue < 0.0f) ? -minValue : 0.0f;
+            offsetFactor = -minValue;
         }
 
         //----------------------------------------------------------------------------------
@@ -25,6 +25,8 @@
 #include "Utilities/StringRegistrar.hpp"
 #include "OcularEngine.hpp"
 
+#include <new>
+
 //------------------------------------------------------------------------------------------
 
 namespace Ocular
@@ -95,75 +97,74 @@ namespace Ocular
             }
         });
 
+        static_assert(sizeof(Quaternion_Internal) <= (sizeof(float) * 4), "Quaternion_Internal does not fit within the inline storage");
+        static_assert(alignof(Quaternion_Internal) <= alignof(float), "Quaternion_Internal requires stricter alignment than the inline storage");
+
         //----------------------------------------------------------------------------------
         // CONSTRUCTORS
         //----------------------------------------------------------------------------------
 
         Quaternion::Quaternion(float const w, float const x, float const y, float const z)
         {
-            m_Internal = new Quaternion_Internal(glm::quat(w, x, y, z));
+            new (m_Data) Quaternion_Internal(glm::quat(w, x, y, z));
         }
 
         Quaternion::Quaternion(float const angle, Vector3<float> const& axis)
         {
-            m_Internal = new Quaternion_Internal(glm::quat(Math::DegreesToRadians(angle), glm::vec3(axis.x, axis.y, axis.z)));
+            new (m_Data) Quaternion_Internal(glm::quat(Math::DegreesToRadians(angle), glm::vec3(axis.x, axis.y, axis.z)));
         }
 
         Quaternion::Quaternion(Euler const& euler)
         {
-            m_Internal = new Quaternion_Internal(glm::quat(glm::vec3(euler.getPitchRadians(), euler.getYawRadians(), euler.getRollRadians())));
+            new (m_Data) Quaternion_Internal(glm::quat(glm::vec3(euler.getPitchRadians(), euler.getYawRadians(), euler.getRollRadians())));
         }
 
         Quaternion::Quaternion(Vector3<float> const& euler)
         { 
             // GLM expects vec3(pitch, yaw, roll)
-            m_Internal = new Quaternion_Internal(glm::quat(glm::vec3(euler.x, euler.y, euler.z)));
+            new (m_Data) Quaternion_Internal(glm::quat(glm::vec3(euler.x, euler.y, euler.z)));
         }
 
         Quaternion::Quaternion(Matrix3x3 const& matrix)
         {
-            m_Internal = new Quaternion_Internal();
+            new (m_Data) Quaternion_Internal();
             Matrix3x3_Internal* matrixInternal = matrix.getInternal();
 
             if(matrixInternal)
             {
-                m_Internal->quat = glm::quat(matrixInternal->matrix);
+                getInternal()->quat = glm::quat(matrixInternal->matrix);
             }
         }
 
         Quaternion::Quaternion(Matrix4x4 const& matrix)
         {
-            m_Internal = new Quaternion_Internal();
+            new (m_Data) Quaternion_Internal();
             Matrix4x4_Internal* matrixInternal = matrix.getInternal();
 
             if(matrixInternal)
             {
-                m_Internal->quat = glm::quat(matrixInternal->matrix);
+                getInternal()->quat = glm::quat(matrixInternal->matrix);
             }
         }
 
         Quaternion::Quaternion(Quaternion_Internal const& data)
         {
-            m_Internal = new Quaternion_Internal(data.quat);
+            new (m_Data) Quaternion_Internal(data.quat);
         }
 
         Quaternion::Quaternion(Quaternion const& other)
         {
-            m_Internal = new Quaternion_Internal(other.m_Internal->quat);
+            new (m_Data) Quaternion_Internal(other.getInternal()->quat);
         }
 
         Quaternion::Quaternion()
         {
-            m_Internal = new Quaternion_Internal();
+            new (m_Data) Quaternion_Internal();
         }
 
         Quaternion::~Quaternion()
         {
-            if(m_Internal)
-            {
-                delete m_Internal;
-                m_Internal = nullptr;
-            }
+
         }
 
         //----------------------------------------------------------------------------------
@@ -176,31 +177,31 @@ namespace Ocular
 
         Quaternion& Quaternion::operator=(Quaternion const& rhs)
         {
-            m_Internal->quat = rhs.m_Internal->quat;
+            getInternal()->quat = rhs.getInternal()->quat;
             return (*this);
         }
 
         Quaternion& Quaternion::operator+=(Quaternion const& rhs)
         {
-            m_Internal->quat += rhs.m_Internal->quat;
+            getInternal()->quat += rhs.getInternal()->quat;
             return (*this);
         }
 
         Quaternion& Quaternion::operator*=(Quaternion const& rhs)
         {
-            m_Internal->quat *= rhs.m_Internal->quat;
+            getInternal()->quat *= rhs.getInternal()->quat;
             return (*this);
         }
 
         Quaternion& Quaternion::operator*=(float const rhs)
         {
-            m_Internal->quat *= rhs;
+            getInternal()->quat *= rhs;
             return (*this);
         }
 
         Quaternion& Quaternion::operator/=(float const rhs)
         {
-            m_Internal->quat /= rhs;
+            getInternal()->quat /= rhs;
             return (*this);
         }
 
@@ -256,22 +257,22 @@ namespace Ocular
 
         float& Quaternion::w()
         {
-            return m_Internal->quat.w;
+            return getInternal()->quat.w;
         }
 
         float& Quaternion::x()
         {
-            return m_Internal->quat.x;
+            return getInternal()->quat.x;
         }
 
         float& Quaternion::y()
         {
-            return m_Internal->quat.y;
+            return getInternal()->quat.y;
         }
 
         float& Quaternion::z()
         {
-            return m_Internal->quat.z;
+            return getInternal()->quat.z;
         }
 
         //----------------------------------------------------------------
@@ -281,68 +282,68 @@ namespace Ocular
         float Quaternion::dot(Quaternion const& rhs)
         {
             Quaternion_Internal* rhsInternal = rhs.getInternal();
-            return (glm::dot(m_Internal->quat, rhsInternal->quat));
+            return (glm::dot(getInternal()->quat, rhsInternal->quat));
         }
 
         void Quaternion::inverse()
         {
-            m_Internal->quat = glm::inverse(m_Internal->quat);
+            getInternal()->quat = glm::inverse(getInternal()->quat);
         }
 
         Quaternion Quaternion::getInverse() const
         {
-            return Quaternion(Quaternion_Internal(glm::inverse(m_Internal->quat)));
+            return Quaternion(Quaternion_Internal(glm::inverse(getInternal()->quat)));
         }
 
         Quaternion Quaternion::getConjugate() const
         {
-            return Quaternion(Quaternion_Internal(glm::conjugate(m_Internal->quat)));
+            return Quaternion(Quaternion_Internal(glm::conjugate(getInternal()->quat)));
         }
 
         void Quaternion::normalize()
         {
-            m_Internal->quat = glm::normalize(m_Internal->quat);
+            getInternal()->quat = glm::normalize(getInternal()->quat);
         }
 
         Quaternion Quaternion::getNormalized() const
         {
-            return Quaternion(Quaternion_Internal(glm::normalize(m_Internal->quat)));
+            return Quaternion(Quaternion_Internal(glm::normalize(getInternal()->quat)));
         }
 
         float Quaternion::getLength() const
         {
-            return glm::length(m_Internal->quat);
+            return glm::length(getInternal()->quat);
         }
 
         float Quaternion::getYaw() const
         {
-            return glm::yaw(m_Internal->quat);
+            return glm::yaw(getInternal()->quat);
         }
 
         float Quaternion::getPitch() const
         {
-            return glm::pitch(m_Internal->quat);
+            return glm::pitch(getInternal()->quat);
         }
 
         float Quaternion::getRoll() const
         {
-            return glm::roll(m_Internal->quat);
+            return glm::roll(getInternal()->quat);
         }
 
         float Quaternion::getAngle() const
         {
-            return glm::angle(m_Internal->quat);
+            return glm::angle(getInternal()->quat);
         }
 
         Vector3<float> Quaternion::getAxis() const
         {
-            glm::vec3 axis = glm::axis(m_Internal->quat);
+            glm::vec3 axis = glm::axis(getInternal()->quat);
             return Vector3<float>(axis[0], axis[1], axis[2]);
         }
 
         Quaternion Quaternion::cross(Quaternion const& rhs) const
         {
-            return Quaternion(Quaternion_Internal(glm::cross(m_Internal->quat, rhs.m_Internal->quat)));
+            return Quaternion(Quaternion_Internal(glm::cross(getInternal()->quat, rhs.getInternal()->quat)));
         }
 
         //----------------------------------------------------------------
@@ -367,17 +368,17 @@ namespace Ocular
 
         Quaternion Quaternion::Mix(Quaternion const& a, Quaternion const& b, float const f)
         {
-            return Quaternion(Quaternion_Internal(glm::mix(a.m_Internal->quat, b.m_Internal->quat, f)));
+            return Quaternion(Quaternion_Internal(glm::mix(a.getInternal()->quat, b.getInternal()->quat, f)));
         }
 
         Quaternion Quaternion::Lerp(Quaternion const& a, Quaternion const& b, float const f)
         {
-            return Quaternion(Quaternion_Internal(glm::lerp(a.m_Internal->quat, b.m_Internal->quat, f)));
+            return Quaternion(Quaternion_Internal(glm::lerp(a.getInternal()->quat, b.getInternal()->quat, f)));
         }
 
         Quaternion Quaternion::Slerp(Quaternion const& a, Quaternion const& b, float const f)
         {
-            return Quaternion(Quaternion_Internal(glm::slerp(a.m_Internal->quat, b.m_Internal->quat, f)));
+            return Quaternion(Quaternion_Internal(glm::slerp(a.getInternal()->quat, b.getInternal()->quat, f)));
         }
 
         Quaternion Quaternion::Bilerp(Quaternion const& q00, Quaternion const& q10, Quaternion const& q01, Quaternion const& q11, float const x, float const y)
@@ -391,7 +392,7 @@ namespace Ocular
 
         Quaternion_Internal* Quaternion::getInternal() const
         {
-            return m_Internal;
+            return reinterpret_cast<Quaternion_Internal*>(const_cast<float*>(m_Data));
         }
 
         //----------------------------------------------------------------------------------
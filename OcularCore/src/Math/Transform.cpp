@@ -79,6 +79,11 @@ namespace Ocular
             return result;
         }
 
+        bool Transform::isDirty() const
+        {
+            return (m_DirtyFlags != 0);
+        }
+
         void Transform::setPosition(Vector3f const& position)
         {
             m_Position = position;
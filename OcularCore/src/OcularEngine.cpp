@@ -235,13 +235,8 @@ namespace Ocular
 
         if((m_SceneManager) && (m_GraphicsDriver))
         {
-            std::vector<Core::Camera*> cameras = m_CameraManager->getCameras();
-
-            for(auto iter = cameras.begin(); iter != cameras.end(); ++iter)
-            {
-                m_CameraManager->setActiveCamera((*iter));
-                m_SceneManager->render();
-            }
+            // The scene renders (and culls) for every camera itself
+            m_SceneManager->render();
         }
     }
 
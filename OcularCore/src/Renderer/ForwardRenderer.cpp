@@ -56,16 +56,17 @@ namespace Ocular
             OcularGraphics->clearBuffers(OcularCameras->getActiveCamera()->getClearColor());
 
             sort(objects);
+            updateUniforms(objects);
 
-            for(auto object : objects)
+            for(uint32_t i = 0; i < static_cast<uint32_t>(objects.size()); i++)
             {
-                auto renderable = object->getRenderable();
+                auto renderable = objects[i]->getRenderable();
 
                 if(renderable)
                 {
                     if(renderable->preRender())
                     {
-                        bindUniforms(object);
+                        bindUniforms(m_ObjectUniforms[i]);
 
                         renderable->render();
                         renderable->postRender();
@@ -81,16 +82,17 @@ namespace Ocular
             OcularGraphics->clearBuffers(OcularCameras->getActiveCamera()->getClearColor());
 
             sort(objects);
+            updateUniforms(objects);
 
-            for(auto object : objects)
+            for(uint32_t i = 0; i < static_cast<uint32_t>(objects.size()); i++)
             {
-                auto renderable = object->getRenderable();
+                auto renderable = objects[i]->getRenderable();
 
                 if(renderable)
                 {
                     if(renderable->preRender())
                     {
-                        bindUniforms(object);
+                        bindUniforms(m_ObjectUniforms[i]);
 
                         renderable->render(material);
                         renderable->postRender();
@@ -20,6 +20,7 @@
 #include "Scene/SceneObject.hpp"
 #include "Scene/ARenderable.hpp"
 
+#include "Math/SIMD.hpp"
 #include "OcularEngine.hpp"
 
 #include <algorithm>
@@ -108,24 +109,60 @@ namespace Ocular
             }
         }
 
-        void Renderer::bindUniforms(SceneObject* object)
+        void Renderer::updateUniforms(std::vector<SceneObject*> const& objects)
         {
-            if(!m_UniformBufferPerObject)
+            OCULAR_PROFILE()
+
+            // The view-projection matrix is shared by every object, so MVP = (Proj * View) * Model
+
+            float view[16];
+            float viewProj[16];
+
+            m_CurrViewMatrix.getData(view);
+            (m_CurrProjMatrix * m_CurrViewMatrix).getData(viewProj);
+
+            m_ObjectUniforms.resize(objects.size());
+
+            float model[16];
+            float result[16];
+
+            for(uint32_t i = 0; i < static_cast<uint32_t>(objects.size()); i++)
             {
-                m_UniformBufferPerObject = OcularGraphics->createUniformBuffer(Graphics::UniformBufferType::PerObject);
+                Graphics::UniformPerObject& data = m_ObjectUniforms[i];
+
+                objects[i]->getModelUniformData(data);
+                data.modelMatrix.getData(model);
+
+                Math::SIMD::MultiplyMatrix(view, model, result);
+                data.modelViewMatrix.setData(result);
+
+                Math::SIMD::MultiplyMatrix(viewProj, model, result);
+                data.modelViewProjMatrix.setData(result);
             }
+        }
 
+        void Renderer::bindUniforms(SceneObject* object)
+        {
             if(object)
             {
-                m_UniformBufferPerObject->setFixedData(object->getUniformData(m_CurrViewMatrix, m_CurrProjMatrix));
+                bindUniforms(object->getUniformData(m_CurrViewMatrix, m_CurrProjMatrix));
             }
             else
             {
                 // If NULL, use a default uniform buffer (identity model matrix, etc.)
                 Graphics::UniformPerObject uniformBuffer;
-                m_UniformBufferPerObject->setFixedData(uniformBuffer); 
+                bindUniforms(uniformBuffer);
             }
-            
+        }
+
+        void Renderer::bindUniforms(Graphics::UniformPerObject const& data)
+        {
+            if(!m_UniformBufferPerObject)
+            {
+                m_UniformBufferPerObject = OcularGraphics->createUniformBuffer(Graphics::UniformBufferType::PerObject);
+            }
+
+            m_UniformBufferPerObject->setFixedData(data);
             m_UniformBufferPerObject->bind();
         }
 
@@ -0,0 +1,699 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Scene/ACellSceneTree.hpp"
+#include "Scene/OcclusionBuffer.hpp"
+#include "Math/MathCommon.hpp"
+
+#include "OcularEngine.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+namespace
+{
+    const uint32_t RayBatchSize = 256;       ///< Minimum number of rays traced by a single thread during a batched ray query
+    const uint32_t NearestBatchSize = 64;    ///< Minimum number of points processed by a single thread during a batched nearest object query
+    const uint32_t PairQueryBatchSize = 256; ///< Minimum number of objects queried by a single thread during a pair query
+}
+
+//------------------------------------------------------------------------------------------
+
+namespace Ocular
+{
+    namespace Core
+    {
+        //----------------------------------------------------------------------------------
+        // CONSTRUCTORS
+        //----------------------------------------------------------------------------------
+
+        ACellSceneTree::ACellSceneTree()
+        {
+
+        }
+
+        ACellSceneTree::~ACellSceneTree()
+        {
+            destroy();
+        }
+
+        //----------------------------------------------------------------------------------
+        // PUBLIC METHODS
+        //----------------------------------------------------------------------------------
+
+        void ACellSceneTree::restructure()
+        {
+            OCULAR_PROFILE()
+
+            //------------------------------------------------------------
+            // Place all new objects
+
+            if(!m_NewObjects.empty())
+            {
+                std::vector<SceneObject*> newObjects;
+                newObjects.swap(m_NewObjects);
+
+                for(auto object : newObjects)
+                {
+                    placeObject(object);
+                }
+            }
+
+            //------------------------------------------------------------
+            // Move all dirty objects to their new cells.
+            
+            // Retrieving the bounds of an object may flag it as dirty again, so work from a local copy.
+            // An object may also have been flagged multiple times since the last update, which is harmless.
+
+            if(!m_DirtyObjects.empty())
+            {
+                std::vector<SceneObject*> dirtyObjects;
+                dirtyObjects.swap(m_DirtyObjects);
+
+                for(auto object : dirtyObjects)
+                {
+                    placeObject(object);
+                }
+            }
+        }
+
+        void ACellSceneTree::destroy()
+        {
+            m_Cells.clear();
+            m_Locations.clear();
+            m_UUIDs.clear();
+            m_DirtyObjects.clear();
+            m_NewObjects.clear();
+        }
+
+        bool ACellSceneTree::containsObject(SceneObject* object, bool const checkNewObjects) const
+        {
+            bool result = false;
+            auto findLocation = m_Locations.find(object);
+
+            if(findLocation != m_Locations.end())
+            {
+                result = checkNewObjects || (findLocation->second.cell != PendingCell);
+            }
+
+            return result;
+        }
+
+        void ACellSceneTree::addObject(SceneObject* object)
+        {
+            if(object)
+            {
+                if(containsObject(object, true))
+                {
+                    removeObject(object);
+                }
+
+                ObjectLocation location;
+                location.cell  = PendingCell;
+                location.index = static_cast<uint32_t>(m_NewObjects.size());
+
+                m_Locations[object] = location;
+                m_UUIDs[object->getUUID().getHash64()] = object;
+                m_NewObjects.emplace_back(object);
+            }
+        }
+
+        void ACellSceneTree::addObjects(std::vector<SceneObject*> const& objects)
+        {
+            m_NewObjects.reserve(m_NewObjects.size() + objects.size());
+
+            for(auto object : objects)
+            {
+                addObject(object);
+            }
+        }
+
+        bool ACellSceneTree::removeObject(SceneObject* object)
+        {
+            bool result = false;
+            auto findLocation = m_Locations.find(object);
+
+            if(findLocation != m_Locations.end())
+            {
+                const ObjectLocation location = findLocation->second;
+
+                if(location.cell == PendingCell)
+                {
+                    // Swap with the last new object
+
+                    SceneObject* last = m_NewObjects.back();
+
+                    m_NewObjects[location.index] = last;
+                    m_Locations[last].index = location.index;
+                    m_NewObjects.pop_back();
+                }
+                else
+                {
+                    removeFromCell(location);
+                }
+
+                m_Locations.erase(object);
+
+                //------------------------------------------------------------
+                // Remove the UUID entry. 
+
+                auto findUUID = m_UUIDs.find(object->getUUID().getHash64());
+
+                if((findUUID == m_UUIDs.end()) || (findUUID->second != object))
+                {
+                    // The UUID has changed since the object was added
+                    findUUID = std::find_if(m_UUIDs.begin(), m_UUIDs.end(), [object](std::pair<const uint64_t, SceneObject*> const& entry) { return (entry.second == object); });
+                }
+
+                if(findUUID != m_UUIDs.end())
+                {
+                    m_UUIDs.erase(findUUID);
+                }
+
+                result = true;
+            }
+
+            return result;
+        }
+
+        void ACellSceneTree::removeObjects(std::vector<SceneObject*> const& objects)
+        {
+            for(auto object : objects)
+            {
+                removeObject(object);
+            }
+        }
+
+        void ACellSceneTree::getAllObjects(std::vector<SceneObject*>& objects) const
+        {
+            objects.reserve(objects.size() + m_Locations.size());
+
+            for(auto const& cell : m_Cells)
+            {
+                for(auto const& entry : cell.second)
+                {
+                    objects.emplace_back(entry.object);
+                }
+            }
+        }
+
+        void ACellSceneTree::getAllVisibleObjects(Math::Frustum const& frustum, std::vector<SceneObject*>& objects, FrustumHints* hints) const
+        {
+            // The cells are not stored as linear nodes, so the plane hints are not used
+
+            findVisible(frustum, objects);
+        }
+
+        void ACellSceneTree::getAllVisibleObjects(std::vector<Math::Frustum> const& frustums, std::vector<std::vector<SceneObject*>>& objects, std::vector<FrustumHints*> const& hints) const
+        {
+            const uint32_t numFrustums = static_cast<uint32_t>(frustums.size());
+
+            if(objects.size() < numFrustums)
+            {
+                objects.resize(numFrustums);
+            }
+
+            // The visible objects are appended, as the containers may already hold those of another tree
+
+            std::vector<size_t> firstVisible(numFrustums);
+
+            for(uint32_t i = 0; i < numFrustums; i++)
+            {
+                firstVisible[i] = objects[i].size();
+                findVisible(frustums[i], objects[i]);
+            }
+
+            // A later view may have flagged an object seen by an earlier view as not visible
+
+            for(uint32_t i = 0; (i + 1) < numFrustums; i++)
+            {
+                for(size_t j = firstVisible[i]; j < objects[i].size(); j++)
+                {
+                    objects[i][j]->setVisible(true);
+                }
+            }
+        }
+
+        void ACellSceneTree::getAllVisibleObjects(Math::Frustum const& frustum, OcclusionBuffer const& occlusion, std::vector<SceneObject*>& objects, FrustumHints* hints) const
+        {
+            const size_t first = objects.size();
+            findVisible(frustum, objects);
+
+            // Cells are loose and may hold objects far larger than themselves, so the
+            // occlusion test is applied to the stored bounds of each visible object.
+
+            auto last = std::remove_if((objects.begin() + first), objects.end(), [&](SceneObject* object)
+            {
+                bool occluded = false;
+
+                auto location = m_Locations.find(object);
+
+                if((location != m_Locations.end()) && (location->second.cell != PendingCell))
+                {
+                    auto cell = m_Cells.find(location->second.cell);
+
+                    if(cell != m_Cells.end())
+                    {
+                        CellObject const& entry = cell->second[location->second.index];
+                        occluded = occlusion.isOccluded(entry.boundsMin, entry.boundsMax);
+                    }
+                }
+
+                if(occluded)
+                {
+                    object->setVisible(false);
+                }
+
+                return occluded;
+            });
+
+            objects.erase(last, objects.end());
+        }
+
+        void ACellSceneTree::getIntersections(Math::Ray const& ray, std::vector<std::pair<SceneObject*, float>>& objects) const
+        {
+            objects.clear();
+            findIntersections(ray, objects);
+
+            std::sort(objects.begin(), objects.end(), [](std::pair<SceneObject*, float> const& first, std::pair<SceneObject*, float> const& second)->bool
+            {
+                return (first.second) < (second.second);
+            });
+        }
+
+        bool ACellSceneTree::getIntersection(Math::Ray const& ray, RayQueryMode const mode, std::pair<SceneObject*, float>& result, float const maxDistance) const
+        {
+            result = std::make_pair(nullptr, maxDistance);
+            return findIntersection(ray, mode, maxDistance, result);
+        }
+
+        void ACellSceneTree::getIntersections(std::vector<Math::Ray> const& rays, RayQueryMode const mode, std::vector<std::pair<SceneObject*, float>>& results, std::vector<float> const& maxDistances) const
+        {
+            const uint32_t numRays = static_cast<uint32_t>(rays.size());
+            const bool bounded = (maxDistances.size() == rays.size());
+
+            results.resize(numRays);
+
+            OcularThreads->parallelFor(numRays, RayBatchSize, [&](uint32_t const batch, uint32_t const first, uint32_t const last)
+            {
+                for(uint32_t i = first; i < last; i++)
+                {
+                    const float maxDistance = bounded ? maxDistances[i] : FLT_MAX;
+
+                    results[i] = std::make_pair(nullptr, maxDistance);
+                    findIntersection(rays[i], mode, maxDistance, results[i]);
+                }
+            });
+        }
+
+        void ACellSceneTree::getIntersections(Math::BoundsSphere const& bounds, std::vector<SceneObject*>& objects) const
+        {
+            objects.clear();
+            findIntersections(bounds, objects);
+        }
+
+        void ACellSceneTree::getIntersections(Math::BoundsAABB const& bounds, std::vector<SceneObject*>& objects) const
+        {
+            objects.clear();
+            findIntersections(bounds, objects);
+        }
+
+        void ACellSceneTree::getIntersections(Math::BoundsOBB const& bounds, std::vector<SceneObject*>& objects) const
+        {
+            objects.clear();
+            findIntersections(bounds, objects);
+        }
+
+        void ACellSceneTree::getNearestObjects(Math::Vector3f const& point, uint32_t const count, std::vector<std::pair<SceneObject*, float>>& objects, float const maxDistance) const
+        {
+            objects.clear();
+            findNearestObjects(point, count, maxDistance, objects);
+        }
+
+        void ACellSceneTree::getNearestObjects(std::vector<Math::Vector3f> const& points, uint32_t const count, std::vector<std::vector<std::pair<SceneObject*, float>>>& objects, float const maxDistance) const
+        {
+            const uint32_t numPoints = static_cast<uint32_t>(points.size());
+
+            objects.resize(numPoints);
+
+            OcularThreads->parallelFor(numPoints, NearestBatchSize, [&](uint32_t const batch, uint32_t const first, uint32_t const last)
+            {
+                for(uint32_t i = first; i < last; i++)
+                {
+                    objects[i].clear();
+                    findNearestObjects(points[i], count, maxDistance, objects[i]);
+                }
+            });
+        }
+
+        void ACellSceneTree::getObjectsInRadius(Math::Vector3f const& point, float const radius, std::vector<std::pair<SceneObject*, float>>& objects) const
+        {
+            objects.clear();
+            findNearestObjects(point, std::numeric_limits<uint32_t>::max(), radius, objects);
+        }
+
+        void ACellSceneTree::getOverlappingPairs(std::vector<std::pair<SceneObject*, SceneObject*>>& pairs) const
+        {
+            OCULAR_PROFILE()
+
+            pairs.clear();
+            findOverlappingPairs(nullptr, pairs);
+        }
+
+        void ACellSceneTree::getOverlappingPairs(ISceneTree const* other, std::vector<std::pair<SceneObject*, SceneObject*>>& pairs) const
+        {
+            OCULAR_PROFILE()
+
+            pairs.clear();
+
+            if(other)
+            {
+                findOverlappingPairs(((other == this) ? nullptr : other), pairs);
+            }
+        }
+
+        void ACellSceneTree::setDirty(UUID const& uuid)
+        {
+            auto findObject = m_UUIDs.find(uuid.getHash64());
+
+            if(findObject != m_UUIDs.end())
+            {
+                m_DirtyObjects.emplace_back(findObject->second);
+            }
+        }
+
+        //----------------------------------------------------------------------------------
+        // PROTECTED METHODS
+        //----------------------------------------------------------------------------------
+
+        void ACellSceneTree::onCellCreated(uint64_t const cell)
+        {
+
+        }
+
+        void ACellSceneTree::onCellDestroyed(uint64_t const cell)
+        {
+
+        }
+
+        void ACellSceneTree::placeObject(SceneObject* object)
+        {
+            auto findLocation = m_Locations.find(object);
+
+            if(findLocation != m_Locations.end())
+            {
+                const Math::BoundsAABB bounds = object->getBoundsAABB(false);
+                const Math::Vector3f minPoint = bounds.getMinPoint();
+                const Math::Vector3f maxPoint = bounds.getMaxPoint();
+
+                CellObject entry;
+                entry.boundsMin[0] = minPoint.x;
+                entry.boundsMin[1] = minPoint.y;
+                entry.boundsMin[2] = minPoint.z;
+                entry.boundsMax[0] = maxPoint.x;
+                entry.boundsMax[1] = maxPoint.y;
+                entry.boundsMax[2] = maxPoint.z;
+                entry.object = object;
+
+                ObjectLocation& location = findLocation->second;
+                const uint64_t cell = getCell(entry.boundsMin, entry.boundsMax);
+
+                if(location.cell == cell)
+                {
+                    // Still in the same cell, only the stored bounds change
+                    m_Cells[cell][location.index] = entry;
+                }
+                else
+                {
+                    if(location.cell != PendingCell)
+                    {
+                        removeFromCell(location);
+                    }
+
+                    std::vector<CellObject>& objects = m_Cells[cell];
+
+                    location.cell  = cell;
+                    location.index = static_cast<uint32_t>(objects.size());
+
+                    objects.emplace_back(entry);
+
+                    if(objects.size() == 1)
+                    {
+                        onCellCreated(cell);
+                    }
+                }
+            }
+        }
+
+        void ACellSceneTree::removeFromCell(ObjectLocation const& location)
+        {
+            auto findCell = m_Cells.find(location.cell);
+
+            if(findCell != m_Cells.end())
+            {
+                std::vector<CellObject>& objects = findCell->second;
+
+                // Swap with the last object of the cell
+
+                objects[location.index] = objects.back();
+                m_Locations[objects[location.index].object].index = location.index;
+                objects.pop_back();
+
+                if(objects.empty())
+                {
+                    m_Cells.erase(findCell);
+                    onCellDestroyed(location.cell);
+                }
+            }
+        }
+
+        void ACellSceneTree::findOverlappingPairs(ISceneTree const* other, std::vector<std::pair<SceneObject*, SceneObject*>>& pairs) const
+        {
+            // Flatten the cells so that the objects may be split across threads
+
+            std::vector<CellObject const*> objects;
+            objects.reserve(m_Locations.size());
+
+            for(auto const& cell : m_Cells)
+            {
+                for(auto const& entry : cell.second)
+                {
+                    objects.emplace_back(&entry);
+                }
+            }
+
+            const uint32_t numObjects = static_cast<uint32_t>(objects.size());
+            std::vector<std::vector<std::pair<SceneObject*, SceneObject*>>> batchPairs(OcularThreads->getNumBatches(numObjects, PairQueryBatchSize));
+
+            OcularThreads->parallelFor(numObjects, PairQueryBatchSize, [&](uint32_t const batch, uint32_t const first, uint32_t const last)
+            {
+                std::vector<SceneObject*> found;
+
+                for(uint32_t i = first; i < last; i++)
+                {
+                    CellObject const* entry = objects[i];
+                    const Math::BoundsAABB bounds = ToBounds(entry->boundsMin, entry->boundsMax);
+
+                    found.clear();
+
+                    if(other)
+                    {
+                        other->getIntersections(bounds, found);
+                    }
+                    else
+                    {
+                        findIntersections(bounds, found);
+                    }
+
+                    for(auto foundObject : found)
+                    {
+                        // When querying this tree, each pair (and the object itself) is found from both of it's objects
+
+                        if(other || std::less<SceneObject*>()(entry->object, foundObject))
+                        {
+                            batchPairs[batch].emplace_back(std::make_pair(entry->object, foundObject));
+                        }
+                    }
+                }
+            });
+
+            for(auto const& batch : batchPairs)
+            {
+                pairs.insert(pairs.end(), batch.begin(), batch.end());
+            }
+        }
+
+        void ACellSceneTree::ExtractFrustumPlanes(Math::Frustum const& frustum, float planes[6][4])
+        {
+            frustum.getPlaneEquations(planes);
+        }
+
+        Math::IntersectionType ACellSceneTree::ClassifyFrustum(float const planes[6][4], float const boundsMin[3], float const boundsMax[3], uint32_t& mask)
+        {
+            Math::IntersectionType result = Math::IntersectionType::Inside;
+
+            for(uint32_t i = 0; i < 6; i++)
+            {
+                const uint32_t planeBit = (1 << i);
+
+                if(mask & planeBit)
+                {
+                    const float* plane = planes[i];
+
+                    // The corners of the bounds nearest to (n) and furthest from (p) the inside of the plane
+
+                    const float nx = (plane[0] >= 0.0f) ? boundsMin[0] : boundsMax[0];
+                    const float ny = (plane[1] >= 0.0f) ? boundsMin[1] : boundsMax[1];
+                    const float nz = (plane[2] >= 0.0f) ? boundsMin[2] : boundsMax[2];
+
+                    const float px = (plane[0] >= 0.0f) ? boundsMax[0] : boundsMin[0];
+                    const float py = (plane[1] >= 0.0f) ? boundsMax[1] : boundsMin[1];
+                    const float pz = (plane[2] >= 0.0f) ? boundsMax[2] : boundsMin[2];
+
+                    if(((plane[0] * nx) + (plane[1] * ny) + (plane[2] * nz) + plane[3]) > 0.0f)
+                    {
+                        result = Math::IntersectionType::Outside;
+                        break;
+                    }
+                    else if(((plane[0] * px) + (plane[1] * py) + (plane[2] * pz) + plane[3]) > 0.0f)
+                    {
+                        result = Math::IntersectionType::Intersects;
+                    }
+                    else
+                    {
+                        mask &= ~planeBit;
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        void ACellSceneTree::PrepareRay(Math::Ray const& ray, float origin[3], float invDir[3], bool parallel[3])
+        {
+            static const float epsilon = 0.000000000000001f;
+
+            const Math::Vector3f rayOrigin    = ray.getOrigin();
+            const Math::Vector3f rayDirection = ray.getDirection();
+
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                origin[i]   = rayOrigin[i];
+                parallel[i] = (fabs(rayDirection[i]) <= epsilon);
+                invDir[i]   = parallel[i] ? 0.0f : (1.0f / rayDirection[i]);
+            }
+        }
+
+        bool ACellSceneTree::IntersectsRay(float const origin[3], float const invDir[3], bool const parallel[3], float const boundsMin[3], float const boundsMax[3], float& distance)
+        {
+            float tMin = 0.0f;
+            float tMax = FLT_MAX;
+
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                if(parallel[i])
+                {
+                    if((origin[i] < boundsMin[i]) || (origin[i] > boundsMax[i]))
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    float t0 = (boundsMin[i] - origin[i]) * invDir[i];
+                    float t1 = (boundsMax[i] - origin[i]) * invDir[i];
+
+                    if(t0 > t1)
+                    {
+                        const float tTemp = t0;
+                        t0 = t1;
+                        t1 = tTemp;
+                    }
+
+                    tMin = (t0 > tMin) ? t0 : tMin;
+                    tMax = (t1 < tMax) ? t1 : tMax;
+
+                    if(tMin > tMax)
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            distance = tMin;
+            return true;
+        }
+
+        float ACellSceneTree::DistanceSquared(float const point[3], float const boundsMin[3], float const boundsMax[3])
+        {
+            float result = 0.0f;
+
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                const float delta = fmaxf(fmaxf((boundsMin[i] - point[i]), (point[i] - boundsMax[i])), 0.0f);
+                result += delta * delta;
+            }
+
+            return result;
+        }
+
+        Math::BoundsAABB ACellSceneTree::ToBounds(float const boundsMin[3], float const boundsMax[3])
+        {
+            const Math::Vector3f minPoint(boundsMin[0], boundsMin[1], boundsMin[2]);
+            const Math::Vector3f maxPoint(boundsMax[0], boundsMax[1], boundsMax[2]);
+
+            return Math::BoundsAABB(Math::Vector3f::Midpoint(minPoint, maxPoint), ((maxPoint - minPoint) * 0.5f));
+        }
+
+        void ACellSceneTree::InsertNearest(std::vector<std::pair<SceneObject*, float>>& nearest, uint32_t const count, SceneObject* object, float const distanceSq)
+        {
+            auto furthestFirst = [](std::pair<SceneObject*, float> const& a, std::pair<SceneObject*, float> const& b)->bool
+            {
+                return (a.second < b.second);
+            };
+
+            if(nearest.size() < count)
+            {
+                nearest.emplace_back(std::make_pair(object, distanceSq));
+                std::push_heap(nearest.begin(), nearest.end(), furthestFirst);
+            }
+            else if(distanceSq < nearest.front().second)
+            {
+                std::pop_heap(nearest.begin(), nearest.end(), furthestFirst);
+                nearest.back() = std::make_pair(object, distanceSq);
+                std::push_heap(nearest.begin(), nearest.end(), furthestFirst);
+            }
+        }
+
+        void ACellSceneTree::SortNearest(std::vector<std::pair<SceneObject*, float>>& nearest)
+        {
+            std::sort_heap(nearest.begin(), nearest.end(), [](std::pair<SceneObject*, float> const& a, std::pair<SceneObject*, float> const& b)->bool
+            {
+                return (a.second < b.second);
+            });
+
+            for(auto& pair : nearest)
+            {
+                pair.second = sqrtf(pair.second);
+            }
+        }
+
+        //----------------------------------------------------------------------------------
+        // PRIVATE METHODS
+        //----------------------------------------------------------------------------------
+    }
+}
\ No newline at end of file
@@ -95,6 +95,11 @@ namespace Ocular
 
         }
 
+        bool ARenderable::updateLOD(float const screenSize)
+        {
+            return true;
+        }
+
         SceneObject* ARenderable::getParent() const
         {
             return m_Parent;
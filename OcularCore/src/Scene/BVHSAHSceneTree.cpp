@@ -0,0 +1,409 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Scene/BVHSAHSceneTree.hpp"
+#include "Math/MortonCode.hpp"
+
+#include "OcularEngine.hpp"
+
+namespace
+{
+    const uint32_t NumBins           = 16;       ///< Number of bins along each axis that are considered as split candidates
+    const uint32_t ParallelBinSize   = 32768;    ///< Minimum number of objects in a node for it to be binned in parallel
+    const uint32_t ParallelChildSize = 8192;     ///< Minimum number of objects in a node for it's children to be built in parallel
+
+    /**
+     * Bounds and object count of a single bin (or collection of bins).
+     */
+    struct Bin
+    {
+        Bin()
+            : count(0)
+        {
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                boundsMin[i] =  FLT_MAX;
+                boundsMax[i] = -FLT_MAX;
+            }
+        }
+
+        void expand(Ocular::Math::Vector3f const& minPoint, Ocular::Math::Vector3f const& maxPoint)
+        {
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                boundsMin[i] = fminf(boundsMin[i], minPoint[i]);
+                boundsMax[i] = fmaxf(boundsMax[i], maxPoint[i]);
+            }
+        }
+
+        void expand(Bin const& other)
+        {
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                boundsMin[i] = fminf(boundsMin[i], other.boundsMin[i]);
+                boundsMax[i] = fmaxf(boundsMax[i], other.boundsMax[i]);
+            }
+
+            count += other.count;
+        }
+
+        float halfSurfaceArea() const
+        {
+            float result = 0.0f;
+
+            if(count > 0)
+            {
+                const float x = boundsMax[0] - boundsMin[0];
+                const float y = boundsMax[1] - boundsMin[1];
+                const float z = boundsMax[2] - boundsMin[2];
+
+                result = (x * y) + (y * z) + (z * x);
+            }
+
+            return result;
+        }
+
+        float boundsMin[3];
+        float boundsMax[3];
+        uint32_t count;
+    };
+
+    /**
+     * Returns the bin that the center falls into along the specified axis.
+     */
+    inline uint32_t GetBin(float const center, float const centerMin, float const binScale)
+    {
+        return std::min((NumBins - 1), static_cast<uint32_t>((center - centerMin) * binScale));
+    }
+}
+
+//------------------------------------------------------------------------------------------
+
+namespace Ocular
+{
+    namespace Core
+    {
+        //----------------------------------------------------------------------------------
+        // CONSTRUCTORS
+        //----------------------------------------------------------------------------------
+
+        BVHSAHSceneTree::BVHSAHSceneTree()
+            : BVHSceneTree()
+        {
+
+        }
+
+        BVHSAHSceneTree::~BVHSAHSceneTree()
+        {
+
+        }
+
+        //----------------------------------------------------------------------------------
+        // PUBLIC METHODS
+        //----------------------------------------------------------------------------------
+
+        SceneTreeType BVHSAHSceneTree::getType() const
+        {
+            return SceneTreeType::BoundingVolumeHierarchySAHCPU;
+        }
+
+        //----------------------------------------------------------------------------------
+        // PROTECTED METHODS
+        //----------------------------------------------------------------------------------
+
+        void BVHSAHSceneTree::build()
+        {
+            OCULAR_PROFILE()
+
+            const uint32_t numObjects = static_cast<uint32_t>(m_AllObjects.size());
+
+            if(numObjects > 1)
+            {
+                BuildData data;
+                gatherBounds(data.bounds);
+
+                data.centers.resize(numObjects);
+                data.indices.resize(numObjects);
+                data.leaves.resize(numObjects, nullptr);
+
+                for(uint32_t i = 0; i < numObjects; i++)
+                {
+                    data.centers[i] = data.bounds[i].getCenter();
+                    data.indices[i] = i;
+                }
+
+                m_Root = new BVHSceneNode();
+                m_Root->type = SceneNodeType::Root;
+
+                buildNode(m_Root, data, 0, numObjects);
+
+                // Leaves are looked up by object UUID when the object is marked dirty
+
+                m_Leaves.reserve(numObjects);
+
+                for(auto leaf : data.leaves)
+                {
+                    m_Leaves[leaf->object->getUUID().getHash64()] = leaf;
+                }
+            }
+            else
+            {
+                // Nothing to split. Identical to the Morton-ordered construction.
+                BVHSceneTree::build();
+            }
+        }
+
+        void BVHSAHSceneTree::buildNode(BVHSceneNode* node, BuildData& data, uint32_t const first, uint32_t const last) const
+        {
+            const uint32_t count = last - first;
+
+            //------------------------------------------------------------
+            // Fit the node and find the bounds of the object centers
+
+            Bin nodeBounds;
+            Bin centerBounds;
+
+            const uint32_t numBatches = (count >= ParallelBinSize) ? OcularThreads->getNumBatches(count, ParallelBinSize / 4) : 1;
+
+            std::vector<Bin> batchNodeBounds(numBatches);
+            std::vector<Bin> batchCenterBounds(numBatches);
+
+            auto fitBatch = [&](uint32_t const batch, uint32_t const batchFirst, uint32_t const batchLast)
+            {
+                for(uint32_t i = (first + batchFirst); i < (first + batchLast); i++)
+                {
+                    const uint32_t index = data.indices[i];
+
+                    batchNodeBounds[batch].expand(data.bounds[index].getMinPoint(), data.bounds[index].getMaxPoint());
+                    batchCenterBounds[batch].expand(data.centers[index], data.centers[index]);
+                }
+            };
+
+            if(numBatches > 1)
+            {
+                OcularThreads->parallelFor(count, ParallelBinSize / 4, fitBatch);
+            }
+            else
+            {
+                fitBatch(0, 0, count);
+            }
+
+            for(uint32_t i = 0; i < numBatches; i++)
+            {
+                nodeBounds.expand(batchNodeBounds[i]);
+                centerBounds.expand(batchCenterBounds[i]);
+            }
+
+            const Math::Vector3f nodeMin(nodeBounds.boundsMin[0], nodeBounds.boundsMin[1], nodeBounds.boundsMin[2]);
+            const Math::Vector3f nodeMax(nodeBounds.boundsMax[0], nodeBounds.boundsMax[1], nodeBounds.boundsMax[2]);
+
+            node->bounds = Math::BoundsAABB(Math::Vector3f::Midpoint(nodeMin, nodeMax), ((nodeMax - nodeMin) * 0.5f));
+            node->morton = Math::MortonCode::calculate(node->bounds.getCenter());
+
+            //------------------------------------------------------------
+            // Split the range and create the children
+
+            const uint32_t split = partition(data, first, last, 
+                Math::Vector3f(centerBounds.boundsMin[0], centerBounds.boundsMin[1], centerBounds.boundsMin[2]), 
+                Math::Vector3f(centerBounds.boundsMax[0], centerBounds.boundsMax[1], centerBounds.boundsMax[2]));
+
+            const uint32_t childFirst[2] = { first, split };
+            const uint32_t childLast[2]  = { split, last };
+
+            BVHSceneNode* children[2] = { nullptr, nullptr };
+
+            for(uint32_t i = 0; i < 2; i++)
+            {
+                children[i] = new BVHSceneNode();
+                children[i]->parent = node;
+
+                if((childLast[i] - childFirst[i]) == 1)
+                {
+                    const uint32_t index = data.indices[childFirst[i]];
+
+                    children[i]->type   = SceneNodeType::Leaf;
+                    children[i]->object = m_AllObjects[index];
+                    children[i]->bounds = data.bounds[index];
+                    children[i]->morton = Math::MortonCode::calculate(data.centers[index]);
+
+                    data.leaves[index] = children[i];
+                }
+                else
+                {
+                    children[i]->type = SceneNodeType::Internal;
+                }
+            }
+
+            node->left  = children[0];
+            node->right = children[1];
+
+            // Each child owns a separate portion of data.indices, so they may be built concurrently
+
+            auto buildChildren = [&](uint32_t const batch, uint32_t const childBegin, uint32_t const childEnd)
+            {
+                for(uint32_t i = childBegin; i < childEnd; i++)
+                {
+                    if(children[i]->type == SceneNodeType::Internal)
+                    {
+                        buildNode(children[i], data, childFirst[i], childLast[i]);
+                    }
+                }
+            };
+
+            if(count >= ParallelChildSize)
+            {
+                OcularThreads->parallelFor(2, 1, buildChildren);
+            }
+            else
+            {
+                buildChildren(0, 0, 2);
+            }
+        }
+
+        uint32_t BVHSAHSceneTree::partition(BuildData& data, uint32_t const first, uint32_t const last, Math::Vector3f const& centerMin, Math::Vector3f const& centerMax) const
+        {
+            const uint32_t count = last - first;
+            const uint32_t numBatches = (count >= ParallelBinSize) ? OcularThreads->getNumBatches(count, ParallelBinSize / 4) : 1;
+
+            //------------------------------------------------------------
+            // Place each object into a bin along each axis
+
+            float binScale[3];
+
+            for(uint32_t axis = 0; axis < 3; axis++)
+            {
+                const float extent = centerMax[axis] - centerMin[axis];
+                binScale[axis] = (extent > Math::EPSILON_FLOAT) ? (static_cast<float>(NumBins) / extent) : 0.0f;
+            }
+
+            std::vector<Bin> batchBins(numBatches * 3 * NumBins);
+
+            auto binBatch = [&](uint32_t const batch, uint32_t const batchFirst, uint32_t const batchLast)
+            {
+                Bin* bins = &batchBins[batch * 3 * NumBins];
+
+                for(uint32_t i = (first + batchFirst); i < (first + batchLast); i++)
+                {
+                    const uint32_t index = data.indices[i];
+
+                    const Math::Vector3f& minPoint = data.bounds[index].getMinPoint();
+                    const Math::Vector3f& maxPoint = data.bounds[index].getMaxPoint();
+
+                    for(uint32_t axis = 0; axis < 3; axis++)
+                    {
+                        Bin& bin = bins[(axis * NumBins) + GetBin(data.centers[index][axis], centerMin[axis], binScale[axis])];
+
+                        bin.expand(minPoint, maxPoint);
+                        bin.count++;
+                    }
+                }
+            };
+
+            if(numBatches > 1)
+            {
+                OcularThreads->parallelFor(count, ParallelBinSize / 4, binBatch);
+            }
+            else
+            {
+                binBatch(0, 0, count);
+            }
+
+            for(uint32_t batch = 1; batch < numBatches; batch++)
+            {
+                for(uint32_t i = 0; i < (3 * NumBins); i++)
+                {
+                    batchBins[i].expand(batchBins[(batch * 3 * NumBins) + i]);
+                }
+            }
+
+            //------------------------------------------------------------
+            // Evaluate the cost of splitting after each bin:
+            //
+            //     cost = (left count * left area) + (right count * right area)
+            //
+            // The cost of traversing the node itself is the same for every split, so it is omitted.
+
+            float    bestCost = FLT_MAX;
+            uint32_t bestAxis = 3;
+            uint32_t bestBin  = 0;
+
+            for(uint32_t axis = 0; axis < 3; axis++)
+            {
+                if(binScale[axis] > 0.0f)
+                {
+                    Bin const* bins = &batchBins[axis * NumBins];
+
+                    // Sweep from the right to find the area and count of everything after each split
+
+                    float rightCost[NumBins];
+                    Bin right;
+
+                    for(uint32_t i = (NumBins - 1); i > 0; i--)
+                    {
+                        right.expand(bins[i]);
+                        rightCost[i - 1] = right.halfSurfaceArea() * static_cast<float>(right.count);
+                    }
+
+                    // Sweep from the left and evaluate each split
+
+                    Bin left;
+
+                    for(uint32_t i = 0; i < (NumBins - 1); i++)
+                    {
+                        left.expand(bins[i]);
+
+                        const float cost = (left.halfSurfaceArea() * static_cast<float>(left.count)) + rightCost[i];
+
+                        if((left.count > 0) && (left.count < count) && (cost < bestCost))
+                        {
+                            bestCost = cost;
+                            bestAxis = axis;
+                            bestBin  = i;
+                        }
+                    }
+                }
+            }
+
+            //------------------------------------------------------------
+            // Partition the range around the best split
+
+            uint32_t result = first + (count / 2);
+
+            if(bestAxis < 3)
+            {
+                auto iter = std::partition((data.indices.begin() + first), (data.indices.begin() + last), [&](uint32_t const index)
+                {
+                    return (GetBin(data.centers[index][bestAxis], centerMin[bestAxis], binScale[bestAxis]) <= bestBin);
+                });
+
+                result = static_cast<uint32_t>(iter - data.indices.begin());
+            }
+
+            // If all of the centers are (nearly) identical, there is no meaningful split. Simply use the middle.
+
+            if((result == first) || (result == last))
+            {
+                result = first + (count / 2);
+            }
+
+            return result;
+        }
+
+        //----------------------------------------------------------------------------------
+        // PRIVATE METHODS
+        //----------------------------------------------------------------------------------
+    }
+}
\ No newline at end of file
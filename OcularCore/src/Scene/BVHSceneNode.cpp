@@ -35,6 +35,8 @@ namespace Ocular
             left   = nullptr;
             right  = nullptr;
             object = nullptr;
+            linearIndex = 0;
+            nodeIndex = 0;
         }
 
         BVHSceneNode::~BVHSceneNode()
@@ -15,11 +15,527 @@
  */
 
 #include "Scene/BVHSceneTree.hpp"
+#include "Scene/OcclusionBuffer.hpp"
 #include "Math/MortonCode.hpp"
 #include "Math/MathCommon.hpp"
+#include "FileIO/File.hpp"
 
 #include "OcularEngine.hpp"
 
+#include <atomic>
+#include <memory>
+#include <queue>
+#include <functional>
+#include <limits>
+#include <fstream>
+#include <cstring>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+namespace
+{
+    const uint32_t BuildBatchSize = 4096;    ///< Minimum number of objects/nodes processed by a single thread during a build
+    const uint32_t AllFrustumPlanes = 0x3F;  ///< Plane mask in which all six frustum planes are active
+    const uint32_t MaxViewsPerPass = 32;     ///< Number of frustums that can be tested in a single multi-view traversal (one bit per view)
+    const uint32_t RayBatchSize = 256;       ///< Minimum number of rays traced by a single thread during a batched ray query
+    const uint32_t NearestBatchSize = 64;    ///< Minimum number of points processed by a single thread during a batched nearest object query
+    const uint32_t PairBatchSize = 4096;     ///< Minimum number of objects in a tree before a pair query is split across threads
+    const uint32_t PairTasksPerThread = 16;  ///< Number of independent subtree pairs generated for each thread during a parallel pair query
+    const uint32_t PairQueryBatchSize = 256; ///< Minimum number of objects queried by a single thread when pairs are found with individual bounds queries
+
+    /**
+     * Single entry of the multi-view visibility traversal stack.
+     */
+    struct ViewTraversalEntry
+    {
+        uint32_t index;          ///< Index of the linear node
+        uint32_t testViews;      ///< Views that the node intersects and must still be tested against
+        uint32_t insideViews;    ///< Views that the node is entirely inside of
+    };
+
+    const float RebuildInsertRatio = 0.1f;   ///< Fraction of new objects (relative to those in the tree) that will trigger a full rebuild
+    const float RebuildCostRatio   = 1.3f;   ///< Growth in the tree cost (relative to the last full rebuild) that will trigger a full rebuild
+
+    const uint32_t SavedTreeMagic   = 0x48564230;  ///< Identifies a file written by BVHSceneTree::save ('0BVH')
+    const uint32_t SavedTreeVersion = 1;           ///< Must be incremented whenever the layout of a saved tree (or of BVHLinearNode) changes
+
+    /**
+     * Header of a saved tree. It is followed by the linear nodes, and then by the 64-bit UUID hash of each linear object.
+     */
+    struct SavedTreeHeader
+    {
+        uint32_t magic;        ///< Always SavedTreeMagic
+        uint32_t version;      ///< Always SavedTreeVersion
+        uint32_t type;         ///< SceneTreeType of the tree that was saved
+        uint32_t numNodes;     ///< Number of linear nodes
+        uint32_t numObjects;   ///< Number of linear objects
+        float    cost;         ///< Cost of the tree when it was saved
+        float    buildCost;    ///< Cost of the tree immediately after it's last full rebuild
+    };
+
+    /**
+     * Verifies that the loaded linear nodes form a valid depth-first binary tree that owns exactly the specified number of objects.
+     * This ensures that no traversal of the nodes can read outside of the linear arrays, and that the node tree can be restored from them.
+     */
+    bool ValidateLinearNodes(Ocular::Core::BVHLinearNode const* nodes, uint32_t const numNodes, uint32_t const numObjects)
+    {
+        bool result = (numNodes > 0) && (nodes[0].skip == numNodes) && !nodes[0].isLeaf(0);
+        uint32_t numLeaves = 0;
+
+        for(uint32_t i = 0; (i < numNodes) && result; i++)
+        {
+            // The first object of each subtree is the number of leaves that precede it
+            result = (nodes[i].skip > i) && (nodes[i].skip <= numNodes) && (nodes[i].object == numLeaves);
+
+            if(nodes[i].isLeaf(i))
+            {
+                numLeaves++;
+            }
+            else if(result)
+            {
+                // The children must exactly span the subtree. Only the root may have a single child.
+
+                const uint32_t right = nodes[i + 1].skip;
+
+                result = (right <= nodes[i].skip) && ((right == nodes[i].skip) ? (i == 0) : (nodes[right].skip == nodes[i].skip));
+            }
+        }
+
+        return result && (numLeaves == numObjects);
+    }
+
+    /**
+     * Returns half of the surface area of the bounds. 
+     * As it is only ever used for comparisons, there is no need for the full area.
+     */
+    inline float HalfSurfaceArea(Ocular::Math::BoundsAABB const& bounds)
+    {
+        const Ocular::Math::Vector3f size = bounds.getExtents() * 2.0f;
+        return (size.x * size.y) + (size.y * size.z) + (size.z * size.x);
+    }
+
+    /**
+     * Returns the bounds that contain both of the specified bounds.
+     */
+    inline Ocular::Math::BoundsAABB Combine(Ocular::Math::BoundsAABB const& a, Ocular::Math::BoundsAABB const& b)
+    {
+        Ocular::Math::BoundsAABB result = a;
+        result.expandToContain(b);
+
+        return result;
+    }
+
+    /**
+     * Equivalent to Frustum::contains(BoundsAABB, IntersectionType*) but operates directly on the compact node bounds.
+     *
+     * Only the planes set in the mask are tested. Planes that the node is entirely inside of are removed
+     * from the mask, as every descendant of the node must then also be inside of them.
+     *
+     * The plane that last rejected the node (lastPlane) is tested first, and is updated when the node is
+     * rejected. The hint is owned by the caller: either the per-node hints of the view (see FrustumHints),
+     * or a single hint carried from node to node when the view has none.
+     */
+    Ocular::Math::IntersectionType ClassifyFrustum(float const planes[6][4], Ocular::Core::BVHLinearNode const& node, uint32_t& mask, uint8_t& lastPlane)
+    {
+        Ocular::Math::IntersectionType result = Ocular::Math::IntersectionType::Inside;
+
+        for(uint32_t i = 0; i < 6; i++)
+        {
+            const uint32_t planeIndex = (lastPlane + i) % 6;
+            const uint32_t planeBit = (1 << planeIndex);
+
+            if(mask & planeBit)
+            {
+                const float* plane = planes[planeIndex];
+
+                // The corners of the node nearest to (n) and furthest from (p) the inside of the plane
+
+                const float nx = (plane[0] >= 0.0f) ? node.boundsMin[0] : node.boundsMax[0];
+                const float ny = (plane[1] >= 0.0f) ? node.boundsMin[1] : node.boundsMax[1];
+                const float nz = (plane[2] >= 0.0f) ? node.boundsMin[2] : node.boundsMax[2];
+
+                const float px = (plane[0] >= 0.0f) ? node.boundsMax[0] : node.boundsMin[0];
+                const float py = (plane[1] >= 0.0f) ? node.boundsMax[1] : node.boundsMin[1];
+                const float pz = (plane[2] >= 0.0f) ? node.boundsMax[2] : node.boundsMin[2];
+
+                if(((plane[0] * nx) + (plane[1] * ny) + (plane[2] * nz) + plane[3]) > 0.0f)
+                {
+                    result = Ocular::Math::IntersectionType::Outside;
+                    lastPlane = static_cast<uint8_t>(planeIndex);
+                    break;
+                }
+                else if(((plane[0] * px) + (plane[1] * py) + (plane[2] * pz) + plane[3]) > 0.0f)
+                {
+                    result = Ocular::Math::IntersectionType::Intersects;
+                }
+                else
+                {
+                    mask &= ~planeBit;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Returns the per-node plane hints to use for a query against the specified number of linear nodes,
+     * or NULL if there are none. The hints are reset if they were recorded for a different number of nodes.
+     */
+    uint8_t* PrepareHints(Ocular::Core::FrustumHints* hints, uint32_t const numNodes)
+    {
+        uint8_t* result = nullptr;
+
+        if(hints && (numNodes > 0))
+        {
+            if(hints->planes.size() != numNodes)
+            {
+                hints->planes.assign(numNodes, 0);
+            }
+
+            result = hints->planes.data();
+        }
+
+        return result;
+    }
+
+    /**
+     * Squared distance from a point to the nearest point of the compact node bounds (0 if the point is inside).
+     */
+    inline float DistanceSquared(float const point[3], Ocular::Core::BVHLinearNode const& node)
+    {
+        float result = 0.0f;
+
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            const float delta = fmaxf(fmaxf((node.boundsMin[i] - point[i]), (point[i] - node.boundsMax[i])), 0.0f);
+            result += delta * delta;
+        }
+
+        return result;
+    }
+
+    /**
+     * Converts a ray into the form used by IntersectsRay.
+     */
+    void PrepareRay(Ocular::Math::Ray const& ray, float origin[3], float invDir[3], bool parallel[3])
+    {
+        static const float epsilon = 0.000000000000001f;
+
+        const Ocular::Math::Vector3f rayOrigin    = ray.getOrigin();
+        const Ocular::Math::Vector3f rayDirection = ray.getDirection();
+
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            origin[i]   = rayOrigin[i];
+            parallel[i] = (fabs(rayDirection[i]) <= epsilon);
+            invDir[i]   = parallel[i] ? 0.0f : (1.0f / rayDirection[i]);
+        }
+    }
+
+    /**
+     * Slab test of a ray against the compact node bounds. Equivalent to Ray::intersects(BoundsAABB, Point3f, float).
+     *
+     * \param[in]  origin    Ray origin
+     * \param[in]  invDir    Reciprocal of the ray direction
+     * \param[in]  parallel  Per-axis flags indicating the ray is parallel to that slab
+     * \param[in]  node
+     * \param[out] distance  Distance along the ray to the point of entry (0 if the origin is inside)
+     */
+    bool IntersectsRay(float const origin[3], float const invDir[3], bool const parallel[3], Ocular::Core::BVHLinearNode const& node, float& distance)
+    {
+        float tMin = 0.0f;
+        float tMax = FLT_MAX;
+
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            if(parallel[i])
+            {
+                if((origin[i] < node.boundsMin[i]) || (origin[i] > node.boundsMax[i]))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                float t0 = (node.boundsMin[i] - origin[i]) * invDir[i];
+                float t1 = (node.boundsMax[i] - origin[i]) * invDir[i];
+
+                if(t0 > t1)
+                {
+                    const float tTemp = t0;
+                    t0 = t1;
+                    t1 = tTemp;
+                }
+
+                tMin = (t0 > tMin) ? t0 : tMin;
+                tMax = (t1 < tMax) ? t1 : tMax;
+
+                if(tMin > tMax)
+                {
+                    return false;
+                }
+            }
+        }
+
+        distance = tMin;
+        return true;
+    }
+
+    /**
+     * Appends the object to the collection and records its position in the index map.
+     */
+    inline void IndexedAppend(std::vector<Ocular::Core::SceneObject*>& objects, std::unordered_map<Ocular::Core::SceneObject*, uint32_t>& indices, Ocular::Core::SceneObject* object)
+    {
+        indices[object] = static_cast<uint32_t>(objects.size());
+        objects.emplace_back(object);
+    }
+
+    /**
+     * Removes the object from the collection in constant time by swapping it with the last element.
+     * The relative order of the remaining objects is not preserved.
+     *
+     * \return TRUE if the object was in the collection.
+     */
+    inline bool IndexedRemove(std::vector<Ocular::Core::SceneObject*>& objects, std::unordered_map<Ocular::Core::SceneObject*, uint32_t>& indices, Ocular::Core::SceneObject* object)
+    {
+        bool result = false;
+        auto findIndex = indices.find(object);
+
+        if(findIndex != indices.end())
+        {
+            const uint32_t index = findIndex->second;
+            Ocular::Core::SceneObject* last = objects.back();
+
+            objects[index] = last;
+            indices[last] = index;
+
+            objects.pop_back();
+            indices.erase(object);
+
+            result = true;
+        }
+
+        return result;
+    }
+
+    /**
+     * Counts the leading zero bits of a 64-bit value. 
+     * Faster than Math::Clz(uint64_t) as the 32-bit lookup version is used for each half.
+     */
+    inline uint32_t Clz64(uint64_t const value)
+    {
+        const uint32_t high = static_cast<uint32_t>(value >> 32);
+
+        return (high != 0) ? Ocular::Math::Clz(high) : (32 + Ocular::Math::Clz(static_cast<uint32_t>(value)));
+    }
+
+    /**
+     * Returns the length of the longest common prefix of the sorted morton codes at indices i and j,
+     * or -1 if j is outside of the range of codes. Duplicate codes are made unique by augmenting them
+     * with their index, which ensures that the generated hierarchy is always valid (Karras 2012).
+     */
+    inline int32_t CommonPrefix(std::vector<std::pair<uint64_t, uint32_t>> const& pairs, int64_t const i, int64_t const j)
+    {
+        int32_t result = -1;
+
+        if((j >= 0) && (j < static_cast<int64_t>(pairs.size())))
+        {
+            const uint64_t codeI = pairs[static_cast<size_t>(i)].first;
+            const uint64_t codeJ = pairs[static_cast<size_t>(j)].first;
+
+            if(codeI != codeJ)
+            {
+                result = static_cast<int32_t>(Clz64(codeI ^ codeJ));
+            }
+            else
+            {
+                result = static_cast<int32_t>(64 + Ocular::Math::Clz(static_cast<uint32_t>(i ^ j)));
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Half of the surface area of the compact node bounds. See HalfSurfaceArea(BoundsAABB).
+     */
+    inline float HalfSurfaceArea(Ocular::Core::BVHLinearNode const& node)
+    {
+        const float x = node.boundsMax[0] - node.boundsMin[0];
+        const float y = node.boundsMax[1] - node.boundsMin[1];
+        const float z = node.boundsMax[2] - node.boundsMin[2];
+
+        return (x * y) + (y * z) + (z * x);
+    }
+
+    /**
+     * Identical to BoundsAABB::intersects(BoundsAABB) but operates directly on the compact node bounds.
+     */
+    inline bool Overlaps(Ocular::Core::BVHLinearNode const& a, Ocular::Core::BVHLinearNode const& b)
+    {
+        return !((a.boundsMin[0] > b.boundsMax[0]) || (b.boundsMin[0] > a.boundsMax[0]) ||
+                 (a.boundsMin[1] > b.boundsMax[1]) || (b.boundsMin[1] > a.boundsMax[1]) ||
+                 (a.boundsMin[2] > b.boundsMax[2]) || (b.boundsMin[2] > a.boundsMax[2]));
+    }
+
+    /**
+     * Pair of linear nodes whose subtrees are to be tested against each other during a pair query.
+     */
+    struct NodePair
+    {
+        uint32_t first;     ///< Node of the first tree
+        uint32_t second;    ///< Node of the second tree. When a tree is tested against itself and this equals first, the subtree is tested against itself.
+    };
+
+    /**
+     * Simultaneous traversal of two linear trees (or of a single tree against itself) which discovers every pair of overlapping leaves.
+     *
+     * The traversal starts at the pair of roots. A pair of nodes that overlap is split by descending into the
+     * children of the larger node, until both nodes are leaves. A subtree tested against itself is split into 
+     * each child tested against itself, and the two children tested against each other, so every pair of 
+     * leaves is visited at most once.
+     *
+     * Each node pair is independent of all others, which allows for the traversal to be split across threads.
+     */
+    struct PairTraversal
+    {
+        std::vector<Ocular::Core::BVHLinearNode> const* nodes[2];
+        std::vector<Ocular::Core::SceneObject*> const*  objects[2];
+
+        /**
+         * Tests the specified node pair. Overlapping leaves are added to the pairs, and any 
+         * node pairs that must still be tested are appended to next.
+         */
+        void expand(NodePair const& pair, std::vector<NodePair>& next, std::vector<std::pair<Ocular::Core::SceneObject*, Ocular::Core::SceneObject*>>& pairs) const
+        {
+            std::vector<Ocular::Core::BVHLinearNode> const& nodesA = (*nodes[0]);
+            std::vector<Ocular::Core::BVHLinearNode> const& nodesB = (*nodes[1]);
+
+            Ocular::Core::BVHLinearNode const& nodeA = nodesA[pair.first];
+            Ocular::Core::BVHLinearNode const& nodeB = nodesB[pair.second];
+
+            const bool leafA = nodeA.isLeaf(pair.first);
+            const bool leafB = nodeB.isLeaf(pair.second);
+
+            if((nodes[0] == nodes[1]) && (pair.first == pair.second))
+            {
+                if(!leafA)
+                {
+                    // The right child directly follows the left subtree. The root may only have a left child.
+
+                    const uint32_t left  = pair.first + 1;
+                    const uint32_t right = nodesA[left].skip;
+
+                    next.push_back({ left, left });
+
+                    if(right < nodeA.skip)
+                    {
+                        next.push_back({ right, right });
+                        next.push_back({ left, right });
+                    }
+                }
+            }
+            else if(Overlaps(nodeA, nodeB))
+            {
+                if(leafA && leafB)
+                {
+                    Ocular::Core::SceneObject* objectA = (*objects[0])[nodeA.object];
+                    Ocular::Core::SceneObject* objectB = (*objects[1])[nodeB.object];
+
+                    if(objectA && objectB)
+                    {
+                        pairs.emplace_back(std::make_pair(objectA, objectB));
+                    }
+                }
+                else if(leafB || (!leafA && (HalfSurfaceArea(nodeA) >= HalfSurfaceArea(nodeB))))
+                {
+                    const uint32_t left  = pair.first + 1;
+                    const uint32_t right = nodesA[left].skip;
+
+                    next.push_back({ left, pair.second });
+
+                    if(right < nodeA.skip)
+                    {
+                        next.push_back({ right, pair.second });
+                    }
+                }
+                else
+                {
+                    const uint32_t left  = pair.second + 1;
+                    const uint32_t right = nodesB[left].skip;
+
+                    next.push_back({ pair.first, left });
+
+                    if(right < nodeB.skip)
+                    {
+                        next.push_back({ pair.first, right });
+                    }
+                }
+            }
+        }
+    };
+
+    /**
+     * Performs the complete pair traversal, starting at the roots of both trees.
+     *
+     * If either tree is large, the top of the traversal is first expanded breadth-first until there are enough
+     * independent node pairs to occupy every thread. Each batch of node pairs is then traversed depth-first 
+     * on it's own thread, into it's own container of pairs.
+     *
+     * \param[in]  traversal
+     * \param[in]  numObjects Number of objects in the largest of the two trees.
+     * \param[out] pairs
+     */
+    void FindOverlappingPairs(PairTraversal const& traversal, uint32_t const numObjects, std::vector<std::pair<Ocular::Core::SceneObject*, Ocular::Core::SceneObject*>>& pairs)
+    {
+        const size_t numTasks = (numObjects >= PairBatchSize) ? (OcularThreads->getNumThreads() * PairTasksPerThread) : 1;
+
+        std::vector<NodePair> tasks(1, NodePair{ 0, 0 });
+        std::vector<NodePair> next;
+
+        while(!tasks.empty() && (tasks.size() < numTasks))
+        {
+            next.clear();
+
+            for(auto const& task : tasks)
+            {
+                traversal.expand(task, next, pairs);
+            }
+
+            tasks.swap(next);
+        }
+
+        //------------------------------------------------------------
+
+        const uint32_t count = static_cast<uint32_t>(tasks.size());
+        std::vector<std::vector<std::pair<Ocular::Core::SceneObject*, Ocular::Core::SceneObject*>>> batchPairs(OcularThreads->getNumBatches(count, 1));
+
+        OcularThreads->parallelFor(count, 1, [&](uint32_t const batch, uint32_t const first, uint32_t const last)
+        {
+            std::vector<NodePair> stack;
+
+            for(uint32_t i = first; i < last; i++)
+            {
+                stack.push_back(tasks[i]);
+
+                while(!stack.empty())
+                {
+                    const NodePair pair = stack.back();
+                    stack.pop_back();
+
+                    traversal.expand(pair, stack, batchPairs[batch]);
+                }
+            }
+        });
+
+        for(auto const& batch : batchPairs)
+        {
+            pairs.insert(pairs.end(), batch.begin(), batch.end());
+        }
+    }
+}
+
 //------------------------------------------------------------------------------------------
 
 namespace Ocular
@@ -34,6 +550,10 @@ namespace Ocular
         {
             m_Root = nullptr;
             m_IsDirty = true;
+            m_IsTopologyChanged = true;
+            m_Cost = 0.0f;
+            m_BuildCost = 0.0f;
+            m_NodeArea = 0.0f;
         }
 
         BVHSceneTree::~BVHSceneTree()
@@ -55,13 +575,24 @@ namespace Ocular
                 {
                     // A complete rebuild is needed.
                     rebuild();
+                    flatten();
+
+                    m_BuildCost = m_Cost;
                 }
                 else
                 {
+                    // If only bounds have changed, the linear nodes were already refit in place
+
                     insertNewObjects();
                     updateDirtyNodes();
+
+                    if(m_IsTopologyChanged)
+                    {
+                        flatten();
+                    }
                 }
 
+                m_IsTopologyChanged = false;
                 m_IsDirty = false;
             }
         }
@@ -72,10 +603,19 @@ namespace Ocular
             {
                 destroyNode(m_Root);
                 m_Root = nullptr;
-
-                m_NewObjects.clear();
-                m_AllObjects.clear();
             }
+
+            m_NewObjects.clear();
+            m_AllObjects.clear();
+            m_NewObjectIndices.clear();
+            m_ObjectIndices.clear();
+
+            m_Leaves.clear();
+            m_DirtyNodes.clear();
+            m_LinearNodes.clear();
+            m_LinearObjects.clear();
+
+            m_IsTopologyChanged = true;
         }
 
         bool BVHSceneTree::containsObject(SceneObject* object, bool const checkNewObjects) const
@@ -84,26 +624,8 @@ namespace Ocular
 
             if(object)
             {
-                for(auto obj : m_AllObjects)
-                {
-                    if(obj == object)
-                    {
-                        result = true;
-                        break;
-                    }
-                }
-
-                if(!result && checkNewObjects)
-                {
-                    for(auto obj : m_NewObjects)
-                    {
-                        if(obj == object)
-                        {
-                            result = true;
-                            break;
-                        }
-                    }
-                }
+                result = (m_ObjectIndices.find(object) != m_ObjectIndices.end()) ||
+                         (checkNewObjects && (m_NewObjectIndices.find(object) != m_NewObjectIndices.end()));
             }
 
             return result;
@@ -118,7 +640,7 @@ namespace Ocular
                     removeObject(object);
                 }
 
-                m_NewObjects.emplace_back(object);
+                IndexedAppend(m_NewObjects, m_NewObjectIndices, object);
                 m_IsDirty = true;
             }
         }
@@ -127,11 +649,18 @@ namespace Ocular
         {
             if(objects.size() > 0)
             {
+                m_NewObjects.reserve(m_NewObjects.size() + objects.size());
+
                 for(auto object : objects)
                 {
                     if(object)
                     {
-                        m_NewObjects.emplace_back(object);
+                        if(containsObject(object, true))
+                        {
+                            removeObject(object);
+                        }
+
+                        IndexedAppend(m_NewObjects, m_NewObjectIndices, object);
                     }
                 }
 
@@ -145,127 +674,128 @@ namespace Ocular
 
             if(object)
             {
-                BVHSceneNode* leaf = findParent(m_Root, object);
-
-                if(leaf)
+                if(IndexedRemove(m_AllObjects, m_ObjectIndices, object))
                 {
-                    //----------------------------------------------------
-                    // Must remove the leaf node and organize the tree.
+                    BVHSceneNode* leaf = findLeaf(object);
 
-                    BVHSceneNode* parent = dynamic_cast<BVHSceneNode*>(leaf->parent);
-
-                    if(parent->type == SceneNodeType::Root)
+                    if(leaf)
                     {
-                        // If the parent is the root, we can simply remove the leaf.
+                        auto findEntry = m_Leaves.find(object->getUUID().getHash64());
 
-                        if(parent->left == leaf)
+                        if((findEntry == m_Leaves.end()) || (findEntry->second != leaf))
                         {
-                            // Remove the left child and shift the right over
-
-                            delete leaf;
-                            leaf = nullptr;
-
-                            parent->left = parent->right;
-                            parent->right = nullptr;
+                            // The UUID has changed since the leaf was registered
+                            findEntry = std::find_if(m_Leaves.begin(), m_Leaves.end(), [leaf](std::pair<const uint64_t, BVHSceneNode*> const& entry) { return (entry.second == leaf); });
                         }
-                        else
-                        {
-                            // This is the right child of the root. Can simply remove.
 
-                            delete leaf;
-                            leaf = nullptr;
-                            parent->right = nullptr;
+                        if(findEntry != m_Leaves.end())
+                        {
+                            m_Leaves.erase(findEntry);
                         }
 
-                        m_Root->morton = m_Root->left->morton;
-                        fitNodeBounds(m_Root);
-                    }
-                    else
-                    {
-                        // The parent is a non-root internal node.
-
-                        // The parent will be removed and the remaining child will be moved
-                        // to be a child of the parent's parent.
+                        m_DirtyNodes.erase(std::remove(m_DirtyNodes.begin(), m_DirtyNodes.end(), leaf), m_DirtyNodes.end());
+                        m_IsTopologyChanged = true;
 
-                        BVHSceneNode* survivingChild = (parent->left == leaf) ? parent->right : parent->left;
-                        BVHSceneNode* parentParent = dynamic_cast<BVHSceneNode*>(parent->parent);
+                        // The linear arrays are not rebuilt until the next restructure, so the object
+                        // is simply removed from them. The stale node bounds remain conservative.
 
-                        if(parentParent->left == parent)
-                        {
-                            parentParent->left = survivingChild;
-                        }
-                        else
+                        if((leaf->linearIndex < m_LinearObjects.size()) && (m_LinearObjects[leaf->linearIndex] == object))
                         {
-                            parentParent->right = survivingChild;
+                            m_LinearObjects[leaf->linearIndex] = nullptr;
                         }
 
-                        survivingChild->parent = parentParent;
+                        //----------------------------------------------------
+                        // Must remove the leaf node and organize the tree.
 
-                        delete leaf;
-                        delete parent;
+                        BVHSceneNode* parent = dynamic_cast<BVHSceneNode*>(leaf->parent);
 
-                        leaf = nullptr;
-                        parent = nullptr;
+                        if(parent->type == SceneNodeType::Root)
+                        {
+                            // If the parent is the root, we can simply remove the leaf.
 
-                        uint64_t morton = 0;
+                            if(parent->left == leaf)
+                            {
+                                // Remove the left child and shift the right over
 
-                        if(parentParent->left)
-                        {
-                            morton = parentParent->left->morton;
+                                delete leaf;
+                                leaf = nullptr;
+
+                                parent->left = parent->right;
+                                parent->right = nullptr;
+                            }
+                            else
+                            {
+                                // This is the right child of the root. Can simply remove.
+
+                                delete leaf;
+                                leaf = nullptr;
+                                parent->right = nullptr;
+                            }
 
-                            if(parentParent->right)
+                            if(m_Root->left)
                             {
-                                morton += parentParent->right->morton;
-                                morton /= 2;
+                                m_Root->morton = m_Root->left->morton;
+                                refitPath(m_Root);
                             }
                         }
-                        else if(parentParent->right)
+                        else
                         {
-                            morton = parentParent->right->morton;
-                        }
-
-                        parentParent->morton = morton;
-                        fitNodeBounds(parentParent);
-                    }
+                            // The parent is a non-root internal node.
 
-                    //----------------------------------------------------
-                    // Remove from object collection
+                            // The parent will be removed and the remaining child will be moved
+                            // to be a child of the parent's parent.
 
-                    auto findObject = std::find(m_AllObjects.begin(), m_AllObjects.end(), object);
+                            BVHSceneNode* survivingChild = (parent->left == leaf) ? parent->right : parent->left;
+                            BVHSceneNode* parentParent = dynamic_cast<BVHSceneNode*>(parent->parent);
 
-                    if(findObject != m_AllObjects.end())
-                    {
-                        m_AllObjects.erase(findObject);
-                        m_IsDirty = true;
-                    }
+                            if(parentParent->left == parent)
+                            {
+                                parentParent->left = survivingChild;
+                            }
+                            else
+                            {
+                                parentParent->right = survivingChild;
+                            }
 
-                    // Make sure the object isn't being queued for addition to the tree
-                    for(auto iter = m_NewObjects.begin(); iter != m_NewObjects.end(); ++iter)
-                    {
-                        if((*iter) == object)
-                        {
-                            m_NewObjects.erase(iter);
-                            break;
+                            survivingChild->parent = parentParent;
+
+                            delete leaf;
+                            delete parent;
+
+                            leaf = nullptr;
+                            parent = nullptr;
+
+                            uint64_t morton = 0;
+
+                            if(parentParent->left)
+                            {
+                                morton = parentParent->left->morton;
+
+                                if(parentParent->right)
+                                {
+                                    morton += parentParent->right->morton;
+                                    morton /= 2;
+                                }
+                            }
+                            else if(parentParent->right)
+                            {
+                                morton = parentParent->right->morton;
+                            }
+
+                            parentParent->morton = morton;
+                            refitPath(parentParent);
                         }
                     }
 
+                    m_IsDirty = true;
                     result = true;
                 }
-            }
-
-            if(!result)
-            {
-                // Possibility that we are being asked to remove an item that is still in the
-                // new object collection (added and removed prior to a restructure call)
-
-                for(auto iter = m_NewObjects.begin(); iter != m_NewObjects.end(); ++iter)
+                else
                 {
-                    if((*iter) == object)
-                    {
-                        result = true;
-                        m_NewObjects.erase(iter);
-                        break;
-                    }
+                    // Possibility that we are being asked to remove an item that is still in the
+                    // new object collection (added and removed prior to a restructure call)
+
+                    result = IndexedRemove(m_NewObjects, m_NewObjectIndices, object);
                 }
             }
 
@@ -286,10 +816,30 @@ namespace Ocular
             objects.insert(objects.end(), m_AllObjects.begin(), m_AllObjects.end());
         }
         
-        void BVHSceneTree::getAllVisibleObjects(Math::Frustum const& frustum, std::vector<SceneObject*>& objects) const
+        void BVHSceneTree::getAllVisibleObjects(Math::Frustum const& frustum, std::vector<SceneObject*>& objects, FrustumHints* hints) const
+        {
+            objects.reserve(objects.size() + m_LinearObjects.size());
+            findVisible(frustum, objects, hints);
+        }
+
+        void BVHSceneTree::getAllVisibleObjects(std::vector<Math::Frustum> const& frustums, std::vector<std::vector<SceneObject*>>& objects, std::vector<FrustumHints*> const& hints) const
+        {
+            const uint32_t numFrustums = static_cast<uint32_t>(frustums.size());
+
+            if(objects.size() < numFrustums)
+            {
+                objects.resize(numFrustums);
+            }
+
+            for(uint32_t first = 0; first < numFrustums; first += MaxViewsPerPass)
+            {
+                findVisible(frustums, first, objects, hints);
+            }
+        }
+
+        void BVHSceneTree::getAllVisibleObjects(Math::Frustum const& frustum, OcclusionBuffer const& occlusion, std::vector<SceneObject*>& objects, FrustumHints* hints) const
         {
-            objects.reserve(m_AllObjects.size() + m_AllObjects.size());
-            findVisible(m_Root, frustum, objects);
+            findVisible(frustum, occlusion, objects, hints);
         }
 
         void BVHSceneTree::getIntersections(Math::Ray const& ray, std::vector<std::pair<SceneObject*, float>>& objects) const
@@ -298,9 +848,9 @@ namespace Ocular
             // Find intersections and their distances from the origin.
 
             std::vector<std::pair<SceneObject*, float>> intersections;
-            intersections.reserve(m_AllObjects.size());
+            intersections.reserve(m_LinearObjects.size());
 
-            findIntersections(m_Root, ray, intersections);
+            findIntersections(ray, intersections);
 
             //------------------------------------------------------------
             // Sort the objects based on distance from origin.
@@ -323,33 +873,142 @@ namespace Ocular
             }
         }
 
+        bool BVHSceneTree::getIntersection(Math::Ray const& ray, RayQueryMode const mode, std::pair<SceneObject*, float>& result, float const maxDistance) const
+        {
+            result = std::make_pair(nullptr, maxDistance);
+            return findIntersection(ray, mode, maxDistance, result);
+        }
+
+        void BVHSceneTree::getIntersections(std::vector<Math::Ray> const& rays, RayQueryMode const mode, std::vector<std::pair<SceneObject*, float>>& results, std::vector<float> const& maxDistances) const
+        {
+            const uint32_t numRays = static_cast<uint32_t>(rays.size());
+            const bool bounded = (maxDistances.size() == rays.size());
+
+            results.resize(numRays);
+
+            // Queries are read-only, so each batch of rays may be traced independently
+
+            OcularThreads->parallelFor(numRays, RayBatchSize, [&](uint32_t const batch, uint32_t const first, uint32_t const last)
+            {
+                for(uint32_t i = first; i < last; i++)
+                {
+                    const float maxDistance = bounded ? maxDistances[i] : FLT_MAX;
+
+                    results[i] = std::make_pair(nullptr, maxDistance);
+                    findIntersection(rays[i], mode, maxDistance, results[i]);
+                }
+            });
+        }
+
+        void BVHSceneTree::getNearestObjects(Math::Vector3f const& point, uint32_t const count, std::vector<std::pair<SceneObject*, float>>& objects, float const maxDistance) const
+        {
+            objects.clear();
+            findNearestObjects(point, count, maxDistance, objects);
+        }
+
+        void BVHSceneTree::getNearestObjects(std::vector<Math::Vector3f> const& points, uint32_t const count, std::vector<std::vector<std::pair<SceneObject*, float>>>& objects, float const maxDistance) const
+        {
+            const uint32_t numPoints = static_cast<uint32_t>(points.size());
+
+            objects.resize(numPoints);
+
+            OcularThreads->parallelFor(numPoints, NearestBatchSize, [&](uint32_t const batch, uint32_t const first, uint32_t const last)
+            {
+                for(uint32_t i = first; i < last; i++)
+                {
+                    objects[i].clear();
+                    findNearestObjects(points[i], count, maxDistance, objects[i]);
+                }
+            });
+        }
+
+        void BVHSceneTree::getObjectsInRadius(Math::Vector3f const& point, float const radius, std::vector<std::pair<SceneObject*, float>>& objects) const
+        {
+            objects.clear();
+            findNearestObjects(point, std::numeric_limits<uint32_t>::max(), radius, objects);
+        }
+
         void BVHSceneTree::getIntersections(Math::BoundsSphere const& bounds, std::vector<SceneObject*>& objects) const
         {
             objects.clear();
-            objects.reserve(m_AllObjects.size());
+            objects.reserve(m_LinearObjects.size());
 
-            findIntersections(m_Root, bounds, objects);
+            findIntersections(bounds, objects);
         }
 
         void BVHSceneTree::getIntersections(Math::BoundsAABB const& bounds, std::vector<SceneObject*>& objects) const
         {
             objects.clear();
-            objects.reserve(m_AllObjects.size());
+            objects.reserve(m_LinearObjects.size());
 
-            findIntersections(m_Root, bounds, objects);
+            findIntersections(bounds, objects);
         }
 
         void BVHSceneTree::getIntersections(Math::BoundsOBB const& bounds, std::vector<SceneObject*>& objects) const
         {
             objects.clear();
-            objects.reserve(m_AllObjects.size());
+            objects.reserve(m_LinearObjects.size());
+
+            findIntersections(bounds, objects);
+        }
+
+        void BVHSceneTree::getOverlappingPairs(std::vector<std::pair<SceneObject*, SceneObject*>>& pairs) const
+        {
+            OCULAR_PROFILE()
+
+            pairs.clear();
+
+            if(!m_LinearNodes.empty())
+            {
+                PairTraversal traversal = { { &m_LinearNodes, &m_LinearNodes }, { &m_LinearObjects, &m_LinearObjects } };
+                FindOverlappingPairs(traversal, static_cast<uint32_t>(m_LinearObjects.size()), pairs);
+            }
+            else
+            {
+                findOverlappingPairs(nullptr, pairs);
+            }
+        }
+
+        void BVHSceneTree::getOverlappingPairs(ISceneTree const* other, std::vector<std::pair<SceneObject*, SceneObject*>>& pairs) const
+        {
+            OCULAR_PROFILE()
+
+            if(other == this)
+            {
+                getOverlappingPairs(pairs);
+            }
+            else if(other)
+            {
+                pairs.clear();
+
+                BVHSceneTree const* otherTree = dynamic_cast<BVHSceneTree const*>(other);
 
-            findIntersections(m_Root, bounds, objects);
+                if(otherTree && !m_LinearNodes.empty() && !otherTree->m_LinearNodes.empty())
+                {
+                    const uint32_t numObjects = static_cast<uint32_t>(std::max(m_LinearObjects.size(), otherTree->m_LinearObjects.size()));
+
+                    PairTraversal traversal = { { &m_LinearNodes, &otherTree->m_LinearNodes }, { &m_LinearObjects, &otherTree->m_LinearObjects } };
+                    FindOverlappingPairs(traversal, numObjects, pairs);
+                }
+                else
+                {
+                    findOverlappingPairs(other, pairs);
+                }
+            }
         }
 
         void BVHSceneTree::setDirty(UUID const& uuid)
         {
-            m_IsDirty = true;
+            // Only objects already in the tree need to be tracked. New objects will have their
+            // bounds fit when they are inserted.
+
+            auto findLeaf = m_Leaves.find(uuid.getHash64());
+
+            if(findLeaf != m_Leaves.end())
+            {
+                m_DirtyNodes.emplace_back(findLeaf->second);
+                m_IsDirty = true;
+            }
         }
 
         SceneTreeType BVHSceneTree::getType() const
@@ -357,6 +1016,198 @@ namespace Ocular
             return SceneTreeType::BoundingVolumeHierarchyCPU;
         }
 
+        float BVHSceneTree::getCost() const
+        {
+            return m_Cost;
+        }
+
+        bool BVHSceneTree::save(File const& file) const
+        {
+            bool result = false;
+
+            // Removed objects leave null entries in the linear objects, but they also dirty the tree
+
+            if(!m_IsDirty && m_NewObjects.empty() && !m_LinearNodes.empty())
+            {
+                std::vector<uint64_t> hashes;
+                hashes.reserve(m_LinearObjects.size());
+
+                for(auto object : m_LinearObjects)
+                {
+                    hashes.emplace_back(object->getUUID().getHash64());
+                }
+
+                SavedTreeHeader header;
+                header.magic      = SavedTreeMagic;
+                header.version    = SavedTreeVersion;
+                header.type       = static_cast<uint32_t>(getType());
+                header.numNodes   = static_cast<uint32_t>(m_LinearNodes.size());
+                header.numObjects = static_cast<uint32_t>(hashes.size());
+                header.cost       = m_Cost;
+                header.buildCost  = m_BuildCost;
+
+                std::ofstream outStream(file.getFullPath(), std::ios_base::out | std::ios_base::binary);
+
+                if(outStream.is_open())
+                {
+                    outStream.write(reinterpret_cast<char const*>(&header), sizeof(SavedTreeHeader));
+                    outStream.write(reinterpret_cast<char const*>(m_LinearNodes.data()), m_LinearNodes.size() * sizeof(BVHLinearNode));
+                    outStream.write(reinterpret_cast<char const*>(hashes.data()), hashes.size() * sizeof(uint64_t));
+
+                    result = outStream.good();
+                    outStream.close();
+                }
+            }
+
+            return result;
+        }
+
+        bool BVHSceneTree::load(File const& file)
+        {
+            OCULAR_PROFILE()
+
+            bool result = false;
+
+            if((m_Root == nullptr) && m_AllObjects.empty() && !m_NewObjects.empty())
+            {
+                boost::iostreams::mapped_file_source source;
+
+                if(file.exists())
+                {
+                    try
+                    {
+                        source.open(file.getFullPath());
+                    }
+                    catch(std::exception const& e)
+                    {
+                        OcularLogger->warning("Failed to map saved tree '", file.getFullPath(), "' with error: ", e.what(), OCULAR_INTERNAL_LOG("BVHSceneTree", "load"));
+                    }
+                }
+
+                if(source.is_open())
+                {
+                    //------------------------------------------------------------
+                    // The nodes are validated in place within the mapped file, and only copied once accepted
+
+                    char const* data = source.data();
+                    const size_t size = source.size();
+
+                    SavedTreeHeader header;
+                    std::memset(&header, 0, sizeof(SavedTreeHeader));
+
+                    if(size >= sizeof(SavedTreeHeader))
+                    {
+                        std::memcpy(&header, data, sizeof(SavedTreeHeader));
+                    }
+
+                    const size_t nodesOffset  = sizeof(SavedTreeHeader);
+                    const size_t hashesOffset = nodesOffset + (static_cast<size_t>(header.numNodes) * sizeof(BVHLinearNode));
+
+                    BVHLinearNode const* nodes = nullptr;
+                    char const* hashes = nullptr;
+
+                    if((header.magic == SavedTreeMagic) && 
+                       (header.version == SavedTreeVersion) &&
+                       (header.type == static_cast<uint32_t>(getType())) &&
+                       (header.numObjects == static_cast<uint32_t>(m_NewObjects.size())) &&
+                       (header.numNodes > 0) &&
+                       (header.numNodes <= (header.numObjects * 2)) &&
+                       (size >= (hashesOffset + (static_cast<size_t>(header.numObjects) * sizeof(uint64_t)))))
+                    {
+                        nodes  = reinterpret_cast<BVHLinearNode const*>(data + nodesOffset);
+                        hashes = data + hashesOffset;
+                        result = ValidateLinearNodes(nodes, header.numNodes, header.numObjects);
+                    }
+
+                    //------------------------------------------------------------
+                    // Match the saved objects to those that were added to the tree
+
+                    std::vector<SceneObject*> objects;
+
+                    if(result)
+                    {
+                        std::unordered_map<uint64_t, SceneObject*> newObjects;
+                        newObjects.reserve(m_NewObjects.size());
+
+                        for(auto object : m_NewObjects)
+                        {
+                            newObjects[object->getUUID().getHash64()] = object;
+                        }
+
+                        objects.reserve(header.numObjects);
+
+                        for(uint32_t i = 0; i < header.numObjects; i++)
+                        {
+                            // The hashes follow the 32-byte nodes, so they are not necessarily 8-byte aligned
+
+                            uint64_t hash = 0;
+                            std::memcpy(&hash, (hashes + (i * sizeof(uint64_t))), sizeof(uint64_t));
+
+                            auto findObject = newObjects.find(hash);
+
+                            if(findObject == newObjects.end())
+                            {
+                                // Missing or duplicated object
+                                result = false;
+                                break;
+                            }
+
+                            objects.emplace_back(findObject->second);
+                            newObjects.erase(findObject);
+                        }
+                    }
+
+                    //------------------------------------------------------------
+                    // Ensure that no object has moved outside of it's leaf since the tree was saved.
+                    // This also updates any stale object bounds before the tree takes ownership of them.
+
+                    for(uint32_t i = 0; (i < header.numNodes) && result; i++)
+                    {
+                        BVHLinearNode const& node = nodes[i];
+
+                        if(node.isLeaf(i))
+                        {
+                            const Math::BoundsAABB bounds = objects[node.object]->getBoundsAABB(false);
+                            const Math::Vector3f minPoint = bounds.getMinPoint();
+                            const Math::Vector3f maxPoint = bounds.getMaxPoint();
+
+                            result = (minPoint.x >= node.boundsMin[0]) && (minPoint.y >= node.boundsMin[1]) && (minPoint.z >= node.boundsMin[2]) &&
+                                     (maxPoint.x <= node.boundsMax[0]) && (maxPoint.y <= node.boundsMax[1]) && (maxPoint.z <= node.boundsMax[2]);
+                        }
+                    }
+
+                    //------------------------------------------------------------
+                    // Take ownership of the loaded tree
+
+                    if(result)
+                    {
+                        m_NewObjects.clear();
+                        m_NewObjectIndices.clear();
+
+                        m_AllObjects.reserve(objects.size());
+
+                        for(auto object : objects)
+                        {
+                            IndexedAppend(m_AllObjects, m_ObjectIndices, object);
+                        }
+
+                        m_LinearNodes.assign(nodes, (nodes + header.numNodes));
+                        m_LinearObjects.swap(objects);
+
+                        // The node tree is restored so that later changes are refit instead of rebuilt
+                        unflatten();
+
+                        m_Cost = header.cost;
+                        m_BuildCost = header.buildCost;
+                        m_IsTopologyChanged = false;
+                        m_IsDirty = false;
+                    }
+                }
+            }
+
+            return result;
+        }
+
         //----------------------------------------------------------------------------------
         // PROTECTED METHODS
         //----------------------------------------------------------------------------------
@@ -369,6 +1220,9 @@ namespace Ocular
             destroyNode(m_Root);
             m_Root = nullptr;
 
+            m_Leaves.clear();
+            m_DirtyNodes.clear();
+
             //------------------------------------------------------------
             // Add any new objects
 
@@ -378,9 +1232,14 @@ namespace Ocular
             if(numNewObjects > 0)
             {
                 m_AllObjects.reserve(numTotalObjects);
-                m_AllObjects.insert(m_AllObjects.end(), m_NewObjects.begin(), m_NewObjects.end());
+
+                for(auto object : m_NewObjects)
+                {
+                    IndexedAppend(m_AllObjects, m_ObjectIndices, object);
+                }
 
                 m_NewObjects.clear();
+                m_NewObjectIndices.clear();
 
                 // May want to sort objects by if they are forced visible here.
                 // Could potentially speed up visibility tests on large scenes.
@@ -397,19 +1256,74 @@ namespace Ocular
             // There are new objects that need to be added to the tree, 
             // but not enough to require a complete rebuild.
 
+            // Each new leaf is treated as dirty, so that it's path is rotated along with
+            // those of all other modified objects in updateDirtyNodes.
+
+            m_AllObjects.reserve(m_AllObjects.size() + m_NewObjects.size());
+
             for(auto object : m_NewObjects) 
             {
-                insertObject(object);
+                BVHSceneNode* leaf = insertObject(object);
+
+                if(leaf)
+                {
+                    IndexedAppend(m_AllObjects, m_ObjectIndices, object);
+                    m_DirtyNodes.emplace_back(leaf);
+                }
             }
 
             m_NewObjects.clear();
-
-            fitNodeBounds(m_Root);
+            m_NewObjectIndices.clear();
         }
 
         void BVHSceneTree::updateDirtyNodes()
         {
-            /// \todo Update dirty nodes
+            OCULAR_PROFILE()
+
+            // Retrieving the bounds of an object may flag it as dirty again, so work from a local copy.
+            // An object may also have been flagged multiple times since the last update.
+
+            std::vector<BVHSceneNode*> dirtyNodes;
+            dirtyNodes.swap(m_DirtyNodes);
+
+            std::sort(dirtyNodes.begin(), dirtyNodes.end());
+            dirtyNodes.erase(std::unique(dirtyNodes.begin(), dirtyNodes.end()), dirtyNodes.end());
+
+            //------------------------------------------------------------
+            // Refit the bounds along the path of each dirty leaf
+
+            for(auto leaf : dirtyNodes)
+            {
+                leaf->bounds = leaf->object->getBoundsAABB(false);
+                refitPath(dynamic_cast<BVHSceneNode*>(leaf->parent));
+            }
+
+            //------------------------------------------------------------
+            // Restore the tree quality along the same paths.
+            // Rotations preserve the bounds of the rotated node, so no further refitting is needed.
+
+            for(auto leaf : dirtyNodes)
+            {
+                BVHSceneNode* node = dynamic_cast<BVHSceneNode*>(leaf->parent);
+
+                while(node)
+                {
+                    if(rotateNode(node))
+                    {
+                        m_IsTopologyChanged = true;
+                    }
+
+                    node = dynamic_cast<BVHSceneNode*>(node->parent);
+                }
+            }
+
+            //------------------------------------------------------------
+            // Without any structural changes, only the linear nodes along the same paths need updating
+
+            if(!m_IsTopologyChanged && !refitLinearNodes(dirtyNodes))
+            {
+                m_IsTopologyChanged = true;
+            }
         }
 
         bool BVHSceneTree::rebuildNeeded() const
@@ -418,11 +1332,23 @@ namespace Ocular
 
             if(m_IsDirty)
             {
-                result = true;
-            }
-            else
-            {
-                // ...
+                const float numObjects = static_cast<float>(m_AllObjects.size());
+
+                if((m_Root == nullptr) || (m_AllObjects.size() < 2))
+                {
+                    // Nothing (worthwhile) to update
+                    result = true;
+                }
+                else if(static_cast<float>(m_NewObjects.size()) > (numObjects * RebuildInsertRatio))
+                {
+                    // Inserting this many objects individually is slower than a rebuild, and degrades the tree.
+                    result = true;
+                }
+                else if(m_Cost > (m_BuildCost * RebuildCostRatio))
+                {
+                    // Refitting and rotations are no longer able to maintain the quality of the tree.
+                    result = true;
+                }
             }
 
             return result;
@@ -440,17 +1366,24 @@ namespace Ocular
             }
         }
 
-        void BVHSceneTree::insertObject(SceneObject* object)
+        BVHSceneNode* BVHSceneTree::insertObject(SceneObject* object)
         {
+            BVHSceneNode* newLeafNode = nullptr;
+
             if(object)
             {
-                const uint64_t morton = Math::MortonCode::calculate(object->getBoundsAABB(false).getCenter());
+                const Math::BoundsAABB bounds = object->getBoundsAABB(false);
+                const uint64_t morton = Math::MortonCode::calculate(bounds.getCenter());
 
-                BVHSceneNode* newLeafNode = new BVHSceneNode();
+                newLeafNode = new BVHSceneNode();
+                newLeafNode->bounds = bounds;
                 newLeafNode->morton = morton;
                 newLeafNode->object = object;
                 newLeafNode->type   = SceneNodeType::Leaf;
 
+                m_Leaves[object->getUUID().getHash64()] = newLeafNode;
+                m_IsTopologyChanged = true;
+
 
                 if(m_AllObjects.size() < 2)
                 {
@@ -487,53 +1420,167 @@ namespace Ocular
                     //----------------------------------------------------
                     // Insert into an arbitrary node
 
-                    // Get the nearest leaf node
+                    // Get the nearest leaf node. If the root itself is nearest, insert directly beneath it.
                     BVHSceneNode* nearestLeafNode = findNearest(m_Root, morton);
-                    BVHSceneNode* nearestParent = dynamic_cast<BVHSceneNode*>(nearestLeafNode->parent);
-
-                    // Insert our new leaf into the internal parent of the one we just found.
-                    // The parent will already have two children. So we will need to create
-                    // a new internal node as three children can not belong to a single parent.
-
-                    BVHSceneNode* newInternalNode = new BVHSceneNode();
-                    newInternalNode->type = SceneNodeType::Internal;
-                    newInternalNode->parent = nearestParent;
+                    BVHSceneNode* nearestParent = (nearestLeafNode == m_Root) ? m_Root : dynamic_cast<BVHSceneNode*>(nearestLeafNode->parent);
 
-                    // One of the three children will remain direct descendents of the parent,
-                    // the other two children will move to be descendents of the new internal.
-
-                    // The left-most child (smallest morton code) will remain as the direct descendent (left).
-                    // The other two, will move to the new internal and place in order of their morton value.
-
-                    if(newLeafNode->morton <= nearestParent->left->morton)
+                    if(nearestParent->right == nullptr)
                     {
-                        newInternalNode->left = nearestParent->left;
-                        newInternalNode->right = nearestParent->right;
+                        // Only the root may have a single child. The leaf can simply take the empty spot.
 
-                        nearestParent->left = newLeafNode;
-                    }
-                    else if(newLeafNode->morton <= nearestParent->right->morton)
-                    {
-                        newInternalNode->left = newLeafNode;
-                        newInternalNode->right = nearestParent->right;
+                        newLeafNode->parent = nearestParent;
+                        nearestParent->right = newLeafNode;
                     }
                     else
                     {
-                        newInternalNode->left = nearestParent->right;
-                        newInternalNode->right = newLeafNode;
-                    }
+                        // Insert our new leaf into the internal parent of the one we just found.
+                        // The parent will already have two children. So we will need to create
+                        // a new internal node as three children can not belong to a single parent.
 
-                    nearestParent->right = newInternalNode;
+                        BVHSceneNode* newInternalNode = new BVHSceneNode();
+                        newInternalNode->type = SceneNodeType::Internal;
+                        newInternalNode->parent = nearestParent;
 
-                    // Refit the morton codes
+                        // One of the three children will remain direct descendents of the parent,
+                        // the other two children will move to be descendents of the new internal.
 
-                    newInternalNode->morton = (newInternalNode->left->morton + newInternalNode->right->morton) / 2;
-                    nearestParent->morton = (nearestParent->left->morton + nearestParent->right->morton) / 2;
+                        // The left-most child (smallest morton code) will remain as the direct descendent (left).
+                        // The other two, will move to the new internal and place in order of their morton value.
 
-                    // Bounds are fit by the caller method. No need to do so here.
-                }
-            }
-        }
+                        if(newLeafNode->morton <= nearestParent->left->morton)
+                        {
+                            newInternalNode->left = nearestParent->left;
+                            newInternalNode->right = nearestParent->right;
+
+                            nearestParent->left = newLeafNode;
+                        }
+                        else if(newLeafNode->morton <= nearestParent->right->morton)
+                        {
+                            newInternalNode->left = newLeafNode;
+                            newInternalNode->right = nearestParent->right;
+                        }
+                        else
+                        {
+                            newInternalNode->left = nearestParent->right;
+                            newInternalNode->right = newLeafNode;
+                        }
+
+                        nearestParent->right = newInternalNode;
+
+                        nearestParent->left->parent = nearestParent;
+                        newInternalNode->left->parent = newInternalNode;
+                        newInternalNode->right->parent = newInternalNode;
+
+                        // The new internal node may not be on the path of the new leaf, so it must be fit here
+
+                        newInternalNode->bounds = Combine(newInternalNode->left->bounds, newInternalNode->right->bounds);
+
+                        // Refit the morton codes
+
+                        newInternalNode->morton = (newInternalNode->left->morton + newInternalNode->right->morton) / 2;
+                        nearestParent->morton = (nearestParent->left->morton + nearestParent->right->morton) / 2;
+                    }
+                }
+
+                // Fit the bounds of all nodes along the path of the new leaf
+                refitPath(dynamic_cast<BVHSceneNode*>(newLeafNode->parent));
+            }
+
+            return newLeafNode;
+        }
+
+        void BVHSceneTree::refitPath(BVHSceneNode* node) const
+        {
+            // The specified node is always refit. Stops early once an ancestor's bounds are unaffected, 
+            // as none of it's own ancestors will be either.
+
+            bool isFirst = true;
+
+            while(node && node->left)
+            {
+                const Math::BoundsAABB bounds = (node->right ? Combine(node->left->bounds, node->right->bounds) : node->left->bounds);
+
+                if(!isFirst && (bounds.getMinPoint() == node->bounds.getMinPoint()) && (bounds.getMaxPoint() == node->bounds.getMaxPoint()))
+                {
+                    break;
+                }
+
+                isFirst = false;
+                node->bounds = bounds;
+                node->morton = Math::MortonCode::calculate(bounds.getCenter());
+
+                node = dynamic_cast<BVHSceneNode*>(node->parent);
+            }
+        }
+
+        bool BVHSceneTree::rotateNode(BVHSceneNode* node) const
+        {
+            bool result = false;
+
+            // Tree rotations as described by Kopta et al. A child is swapped with one of it's grandchildren 
+            // (on the other side) if doing so reduces the surface area of the child that receives it.
+            // The set of leaves beneath the node remains the same, so the node's own bounds are unchanged.
+
+            if(node && node->left && node->right)
+            {
+                BVHSceneNode* child[2] = { node->left, node->right };
+
+                float bestReduction = 0.0f;
+                uint32_t bestSide = 0;                 // Which child receives the swapped node
+                BVHSceneNode** bestGrandchild = nullptr;
+
+                for(uint32_t side = 0; side < 2; side++)
+                {
+                    BVHSceneNode* receiver = child[side];
+                    BVHSceneNode* other    = child[1 - side];
+
+                    if(receiver->type != SceneNodeType::Leaf)
+                    {
+                        // The other child is swapped with either grandchild. The receiver then contains
+                        // the other child and the grandchild that was not swapped.
+
+                        const float currentArea = HalfSurfaceArea(receiver->bounds);
+
+                        const float reductionLeft  = currentArea - HalfSurfaceArea(Combine(other->bounds, receiver->right->bounds));
+                        const float reductionRight = currentArea - HalfSurfaceArea(Combine(other->bounds, receiver->left->bounds));
+
+                        if(reductionLeft > bestReduction)
+                        {
+                            bestReduction  = reductionLeft;
+                            bestSide       = side;
+                            bestGrandchild = &receiver->left;
+                        }
+
+                        if(reductionRight > bestReduction)
+                        {
+                            bestReduction  = reductionRight;
+                            bestSide       = side;
+                            bestGrandchild = &receiver->right;
+                        }
+                    }
+                }
+
+                if(bestGrandchild)
+                {
+                    BVHSceneNode* receiver   = child[bestSide];
+                    BVHSceneNode* grandchild = (*bestGrandchild);
+                    BVHSceneNode*& otherSlot = (bestSide == 0) ? node->right : node->left;
+
+                    (*bestGrandchild) = otherSlot;
+                    otherSlot = grandchild;
+
+                    (*bestGrandchild)->parent = receiver;
+                    grandchild->parent = node;
+
+                    receiver->bounds = Combine(receiver->left->bounds, receiver->right->bounds);
+                    receiver->morton = Math::MortonCode::calculate(receiver->bounds.getCenter());
+
+                    result = true;
+                }
+            }
+
+            return result;
+        }
 
         //----------------------------------------------------------------------
         // Traversal Methods
@@ -543,7 +1590,11 @@ namespace Ocular
         {
             BVHSceneNode* parent = nullptr;
 
-            if(node->type == SceneNodeType::Leaf)
+            if(node == nullptr)
+            {
+                // Empty child of a root with a single object
+            }
+            else if(node->type == SceneNodeType::Leaf)
             {
                 if(node->object == object)
                 {
@@ -563,6 +1614,24 @@ namespace Ocular
             return parent;
         }
 
+        BVHSceneNode* BVHSceneTree::findLeaf(SceneObject* object)
+        {
+            BVHSceneNode* result = nullptr;
+
+            auto findEntry = m_Leaves.find(object->getUUID().getHash64());
+
+            if((findEntry != m_Leaves.end()) && (findEntry->second->object == object))
+            {
+                result = findEntry->second;
+            }
+            else if(m_Root)
+            {
+                result = findParent(m_Root, object);
+            }
+
+            return result;
+        }
+
         BVHSceneNode* BVHSceneTree::findNearest(BVHSceneNode* node, uint64_t const& morton) const
         {
             if(morton < node->morton)
@@ -583,114 +1652,635 @@ namespace Ocular
             return node;
         }
 
-        void BVHSceneTree::findVisible(BVHSceneNode* node, Math::Frustum const& frustum, std::vector<SceneObject*>& objects) const
+        void BVHSceneTree::findVisible(Math::Frustum const& frustum, std::vector<SceneObject*>& objects, FrustumHints* hints) const
         {
-            if(node)
+            float planes[6][4];
+            ExtractFrustumPlanes(frustum, planes);
+
+            // Depth-first traversal in which each node inherits the active plane mask of it's parent.
+            // Each stack entry is a node index and the plane mask to test it with.
+
+            std::vector<std::pair<uint32_t, uint32_t>> stack;
+
+            if(!m_LinearNodes.empty())
             {
-                if(frustum.contains(node->bounds))
+                stack.reserve(64);
+                stack.emplace_back(std::make_pair(0, AllFrustumPlanes));
+            }
+
+            const uint32_t numNodes = static_cast<uint32_t>(m_LinearNodes.size());
+
+            uint8_t* nodeHints = PrepareHints(hints, numNodes);
+            uint8_t lastPlane = 0;
+
+            while(!stack.empty())
+            {
+                const uint32_t index = stack.back().first;
+                uint32_t mask = stack.back().second;
+
+                stack.pop_back();
+
+                BVHLinearNode const& node = m_LinearNodes[index];
+                const Math::IntersectionType result = ClassifyFrustum(planes, node, mask, (nodeHints ? nodeHints[index] : lastPlane));
+
+                if(result == Math::IntersectionType::Outside)
                 {
-                    if((node->type == SceneNodeType::Leaf) && 
-                       (node->object) &&
-                       (node->object->isActive()))
+                    if(node.isLeaf(index) && m_LinearObjects[node.object])
                     {
-                        node->object->setVisible(true);
-                        objects.emplace_back(node->object);
+                        m_LinearObjects[node.object]->setVisible(false);
                     }
-                    else
+                }
+                else if((result == Math::IntersectionType::Inside) || node.isLeaf(index))
+                {
+                    // Every object in the subtree is visible, and they are stored contiguously
+
+                    const uint32_t lastObject = (node.skip < numNodes) ? m_LinearNodes[node.skip].object : static_cast<uint32_t>(m_LinearObjects.size());
+
+                    for(uint32_t i = node.object; i < lastObject; i++)
                     {
-                        findVisible(node->left, frustum, objects);
-                        findVisible(node->right, frustum, objects);
+                        SceneObject* object = m_LinearObjects[i];
+
+                        if(object && object->isActive())
+                        {
+                            object->setVisible(true);
+                            objects.emplace_back(object);
+                        }
                     }
                 }
-                else if((node->type == SceneNodeType::Leaf) && (node->object))
+                else
                 {
-                    node->object->setVisible(false);
+                    // The left child directly follows this node, and the right child follows the left subtree
+
+                    const uint32_t left  = index + 1;
+                    const uint32_t right = m_LinearNodes[left].skip;
+
+                    if(right < node.skip)
+                    {
+                        stack.emplace_back(std::make_pair(right, mask));
+                    }
+
+                    stack.emplace_back(std::make_pair(left, mask));
                 }
             }
         }
 
-        void BVHSceneTree::findIntersections(BVHSceneNode* node, Math::Ray const& ray, std::vector<std::pair<SceneObject*, float>>& objects) const
+        void BVHSceneTree::findVisible(std::vector<Math::Frustum> const& frustums, uint32_t const first, std::vector<std::vector<SceneObject*>>& objects, std::vector<FrustumHints*> const& hints) const
         {
-            if(node)
+            const uint32_t numViews = std::min(MaxViewsPerPass, (static_cast<uint32_t>(frustums.size()) - first));
+            const uint32_t numNodes = static_cast<uint32_t>(m_LinearNodes.size());
+
+            float planes[MaxViewsPerPass][6][4];
+            uint8_t* nodeHints[MaxViewsPerPass];
+            uint8_t lastPlanes[MaxViewsPerPass] = { 0 };
+
+            for(uint32_t view = 0; view < numViews; view++)
+            {
+                ExtractFrustumPlanes(frustums[first + view], planes[view]);
+                nodeHints[view] = PrepareHints(((first + view) < hints.size()) ? hints[first + view] : nullptr, numNodes);
+            }
+
+            std::vector<ViewTraversalEntry> stack;
+
+            if(!m_LinearNodes.empty() && (numViews > 0))
             {
-                Math::Vector3f point;
-                float distance;
+                const ViewTraversalEntry root = { 0, ((numViews == 32) ? 0xFFFFFFFF : ((1u << numViews) - 1)), 0 };
 
-                if(ray.intersects(node->bounds, point, distance))
+                stack.reserve(64);
+                stack.emplace_back(root);
+            }
+
+            while(!stack.empty())
+            {
+                ViewTraversalEntry entry = stack.back();
+                stack.pop_back();
+
+                BVHLinearNode const& node = m_LinearNodes[entry.index];
+
+                //--------------------------------------------------------
+                // Classify the node against every view that it still intersects
+
+                for(uint32_t view = 0; view < numViews; view++)
                 {
-                    if((node->type == SceneNodeType::Leaf) && (node->object))
+                    const uint32_t viewBit = (1u << view);
+
+                    if(entry.testViews & viewBit)
                     {
-                        objects.emplace_back(std::make_pair(node->object, distance));
+                        uint32_t planeMask = AllFrustumPlanes;
+                        uint8_t& hint = (nodeHints[view] ? nodeHints[view][entry.index] : lastPlanes[view]);
+                        const Math::IntersectionType result = ClassifyFrustum(planes[view], node, planeMask, hint);
+
+                        if(result != Math::IntersectionType::Intersects)
+                        {
+                            entry.testViews &= ~viewBit;
+                        }
+
+                        if(result == Math::IntersectionType::Inside)
+                        {
+                            entry.insideViews |= viewBit;
+                        }
                     }
-                    else
+                }
+
+                const uint32_t visibleViews = (entry.testViews | entry.insideViews);
+                const bool isLeaf = node.isLeaf(entry.index);
+
+                if(visibleViews == 0)
+                {
+                    if(isLeaf && m_LinearObjects[node.object])
                     {
-                        findIntersections(node->left, ray, objects);
-                        findIntersections(node->right, ray, objects);
+                        m_LinearObjects[node.object]->setVisible(false);
+                    }
+                }
+                else if((entry.testViews == 0) || isLeaf)
+                {
+                    // Every object in the subtree is visible to the same set of views
+
+                    const uint32_t lastObject = (node.skip < numNodes) ? m_LinearNodes[node.skip].object : static_cast<uint32_t>(m_LinearObjects.size());
+
+                    for(uint32_t i = node.object; i < lastObject; i++)
+                    {
+                        SceneObject* object = m_LinearObjects[i];
+
+                        if(object && object->isActive())
+                        {
+                            object->setVisible(true);
+
+                            for(uint32_t view = 0; view < numViews; view++)
+                            {
+                                if(visibleViews & (1u << view))
+                                {
+                                    objects[first + view].emplace_back(object);
+                                }
+                            }
+                        }
+                    }
+                }
+                else
+                {
+                    const uint32_t left  = entry.index + 1;
+                    const uint32_t right = m_LinearNodes[left].skip;
+
+                    if(right < node.skip)
+                    {
+                        const ViewTraversalEntry rightEntry = { right, entry.testViews, entry.insideViews };
+                        stack.emplace_back(rightEntry);
+                    }
+
+                    const ViewTraversalEntry leftEntry = { left, entry.testViews, entry.insideViews };
+                    stack.emplace_back(leftEntry);
+                }
+            }
+        }
+
+        void BVHSceneTree::findVisible(Math::Frustum const& frustum, OcclusionBuffer const& occlusion, std::vector<SceneObject*>& objects, FrustumHints* hints) const
+        {
+            float planes[6][4];
+            ExtractFrustumPlanes(frustum, planes);
+
+            // Identical to the frustum-only traversal, except that subtrees entirely inside of the frustum are
+            // still descended into. Their nodes only require the occlusion test, as the plane mask is empty.
+
+            std::vector<std::pair<uint32_t, uint32_t>> stack;
+
+            if(!m_LinearNodes.empty())
+            {
+                stack.reserve(64);
+                stack.emplace_back(std::make_pair(0, AllFrustumPlanes));
+            }
+
+            const uint32_t numNodes = static_cast<uint32_t>(m_LinearNodes.size());
+
+            uint8_t* nodeHints = PrepareHints(hints, numNodes);
+            uint8_t lastPlane = 0;
+
+            while(!stack.empty())
+            {
+                const uint32_t index = stack.back().first;
+                uint32_t mask = stack.back().second;
+
+                stack.pop_back();
+
+                BVHLinearNode const& node = m_LinearNodes[index];
+                const Math::IntersectionType result = ClassifyFrustum(planes, node, mask, (nodeHints ? nodeHints[index] : lastPlane));
+
+                if(node.isLeaf(index))
+                {
+                    const bool visible = (result != Math::IntersectionType::Outside) && !occlusion.isOccluded(node.boundsMin, node.boundsMax);
+                    const uint32_t lastObject = (node.skip < numNodes) ? m_LinearNodes[node.skip].object : static_cast<uint32_t>(m_LinearObjects.size());
+
+                    for(uint32_t i = node.object; i < lastObject; i++)
+                    {
+                        SceneObject* object = m_LinearObjects[i];
+
+                        if(object)
+                        {
+                            object->setVisible(visible);
+
+                            if(visible && object->isActive())
+                            {
+                                objects.emplace_back(object);
+                            }
+                        }
+                    }
+                }
+                else if((result != Math::IntersectionType::Outside) && !occlusion.isOccluded(node.boundsMin, node.boundsMax))
+                {
+                    const uint32_t left  = index + 1;
+                    const uint32_t right = m_LinearNodes[left].skip;
+
+                    if(right < node.skip)
+                    {
+                        stack.emplace_back(std::make_pair(right, mask));
+                    }
+
+                    stack.emplace_back(std::make_pair(left, mask));
+                }
+            }
+        }
+
+        void BVHSceneTree::findIntersections(Math::Ray const& ray, std::vector<std::pair<SceneObject*, float>>& objects) const
+        {
+            float origin[3];
+            float invDir[3];
+            bool  parallel[3];
+
+            PrepareRay(ray, origin, invDir, parallel);
+
+            const uint32_t numNodes = static_cast<uint32_t>(m_LinearNodes.size());
+            uint32_t index = 0;
+
+            while(index < numNodes)
+            {
+                BVHLinearNode const& node = m_LinearNodes[index];
+                float distance = 0.0f;
+
+                if(IntersectsRay(origin, invDir, parallel, node, distance))
+                {
+                    if(node.isLeaf(index) && m_LinearObjects[node.object])
+                    {
+                        objects.emplace_back(std::make_pair(m_LinearObjects[node.object], distance));
+                    }
+
+                    index++;
+                }
+                else
+                {
+                    index = node.skip;
+                }
+            }
+        }
+
+        bool BVHSceneTree::findIntersection(Math::Ray const& ray, RayQueryMode const mode, float const maxDistance, std::pair<SceneObject*, float>& result) const
+        {
+            bool found = false;
+
+            float origin[3];
+            float invDir[3];
+            bool  parallel[3];
+
+            PrepareRay(ray, origin, invDir, parallel);
+
+            // Each stack entry is a node index and the distance at which the ray enters it
+
+            std::vector<std::pair<uint32_t, float>> stack;
+            float nearest = maxDistance;
+            float distance = 0.0f;
+
+            if(!m_LinearNodes.empty() && IntersectsRay(origin, invDir, parallel, m_LinearNodes[0], distance) && (distance <= nearest))
+            {
+                stack.reserve(64);
+                stack.emplace_back(std::make_pair(0, distance));
+            }
+
+            while(!stack.empty())
+            {
+                const uint32_t index = stack.back().first;
+                const float entry = stack.back().second;
+
+                stack.pop_back();
+
+                if(entry > nearest)
+                {
+                    // A nearer intersection was found since this node was pushed
+                    continue;
+                }
+
+                BVHLinearNode const& node = m_LinearNodes[index];
+
+                if(node.isLeaf(index))
+                {
+                    SceneObject* object = m_LinearObjects[node.object];
+
+                    if(object)
+                    {
+                        result = std::make_pair(object, entry);
+                        nearest = entry;
+                        found = true;
+
+                        if(mode == RayQueryMode::Any)
+                        {
+                            break;
+                        }
+                    }
+                }
+                else
+                {
+                    const uint32_t left  = index + 1;
+                    const uint32_t right = m_LinearNodes[left].skip;
+
+                    float leftDistance  = 0.0f;
+                    float rightDistance = 0.0f;
+
+                    const bool hitLeft  = IntersectsRay(origin, invDir, parallel, m_LinearNodes[left], leftDistance) && (leftDistance <= nearest);
+                    const bool hitRight = (right < node.skip) && IntersectsRay(origin, invDir, parallel, m_LinearNodes[right], rightDistance) && (rightDistance <= nearest);
+
+                    // Push the further child first so that the nearer child is visited next
+
+                    if(hitLeft && hitRight)
+                    {
+                        if(leftDistance < rightDistance)
+                        {
+                            stack.emplace_back(std::make_pair(right, rightDistance));
+                            stack.emplace_back(std::make_pair(left, leftDistance));
+                        }
+                        else
+                        {
+                            stack.emplace_back(std::make_pair(left, leftDistance));
+                            stack.emplace_back(std::make_pair(right, rightDistance));
+                        }
+                    }
+                    else if(hitLeft)
+                    {
+                        stack.emplace_back(std::make_pair(left, leftDistance));
+                    }
+                    else if(hitRight)
+                    {
+                        stack.emplace_back(std::make_pair(right, rightDistance));
+                    }
+                }
+            }
+
+            return found;
+        }
+
+        void BVHSceneTree::findNearestObjects(Math::Vector3f const& point, uint32_t const count, float const maxDistance, std::vector<std::pair<SceneObject*, float>>& objects) const
+        {
+            // Distances are kept squared until the results are returned.
+            // Each queue entry is the squared distance to a node and the node index, nearest first.
+
+            typedef std::pair<float, uint32_t> QueueEntry;
+
+            std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+
+            const float origin[3] = { point.x, point.y, point.z };
+            const float maxDistanceSq = maxDistance * maxDistance;
+
+            if(!m_LinearNodes.empty() && (count > 0))
+            {
+                queue.push(QueueEntry(DistanceSquared(origin, m_LinearNodes[0]), 0));
+            }
+
+            while(!queue.empty())
+            {
+                const QueueEntry entry = queue.top();
+                queue.pop();
+
+                const float bound = (objects.size() == count) ? objects.front().second : maxDistanceSq;
+
+                if(entry.first > bound)
+                {
+                    // Every remaining node is at least this far away
+                    break;
+                }
+
+                const uint32_t index = entry.second;
+                BVHLinearNode const& node = m_LinearNodes[index];
+
+                if(node.isLeaf(index))
+                {
+                    if(m_LinearObjects[node.object])
+                    {
+                        InsertNearest(objects, count, m_LinearObjects[node.object], entry.first);
+                    }
+                }
+                else
+                {
+                    const uint32_t left  = index + 1;
+                    const uint32_t right = m_LinearNodes[left].skip;
+
+                    const float leftDistance = DistanceSquared(origin, m_LinearNodes[left]);
+
+                    if(leftDistance <= bound)
+                    {
+                        queue.push(QueueEntry(leftDistance, left));
+                    }
+
+                    if(right < node.skip)
+                    {
+                        const float rightDistance = DistanceSquared(origin, m_LinearNodes[right]);
+
+                        if(rightDistance <= bound)
+                        {
+                            queue.push(QueueEntry(rightDistance, right));
+                        }
+                    }
+                }
+            }
+
+            SortNearest(objects);
+        }
+
+        void BVHSceneTree::findIntersections(Math::BoundsSphere const& bounds, std::vector<SceneObject*>& objects) const
+        {
+            const uint32_t numNodes = static_cast<uint32_t>(m_LinearNodes.size());
+            uint32_t index = 0;
+
+            while(index < numNodes)
+            {
+                BVHLinearNode const& node = m_LinearNodes[index];
+
+                if(bounds.intersects(getLinearBounds(node)))
+                {
+                    if(node.isLeaf(index) && m_LinearObjects[node.object])
+                    {
+                        objects.emplace_back(m_LinearObjects[node.object]);
+                    }
+
+                    index++;
+                }
+                else
+                {
+                    index = node.skip;
+                }
+            }
+        }
+
+        void BVHSceneTree::findIntersections(Math::BoundsAABB const& bounds, std::vector<SceneObject*>& objects) const
+        {
+            const Math::Vector3f boundsMin = bounds.getMinPoint();
+            const Math::Vector3f boundsMax = bounds.getMaxPoint();
+
+            const uint32_t numNodes = static_cast<uint32_t>(m_LinearNodes.size());
+            uint32_t index = 0;
+
+            while(index < numNodes)
+            {
+                BVHLinearNode const& node = m_LinearNodes[index];
+
+                // Identical to BoundsAABB::intersects(BoundsAABB)
+
+                const bool intersects = !((node.boundsMin[0] > boundsMax.x) || (boundsMin.x > node.boundsMax[0]) ||
+                                          (node.boundsMin[1] > boundsMax.y) || (boundsMin.y > node.boundsMax[1]) ||
+                                          (node.boundsMin[2] > boundsMax.z) || (boundsMin.z > node.boundsMax[2]));
+
+                if(intersects)
+                {
+                    if(node.isLeaf(index) && m_LinearObjects[node.object])
+                    {
+                        objects.emplace_back(m_LinearObjects[node.object]);
+                    }
+
+                    index++;
+                }
+                else
+                {
+                    index = node.skip;
+                }
+            }
+        }
+
+        void BVHSceneTree::findIntersections(Math::BoundsOBB const& bounds, std::vector<SceneObject*>& objects) const
+        {
+            const uint32_t numNodes = static_cast<uint32_t>(m_LinearNodes.size());
+            uint32_t index = 0;
+
+            while(index < numNodes)
+            {
+                BVHLinearNode const& node = m_LinearNodes[index];
+
+                if(bounds.intersects(getLinearBounds(node)))
+                {
+                    if(node.isLeaf(index) && m_LinearObjects[node.object])
+                    {
+                        objects.emplace_back(m_LinearObjects[node.object]);
+                    }
+
+                    index++;
+                }
+                else
+                {
+                    index = node.skip;
+                }
+            }
+        }
+
+        void BVHSceneTree::findOverlappingPairs(ISceneTree const* other, std::vector<std::pair<SceneObject*, SceneObject*>>& pairs) const
+        {
+            std::vector<Math::BoundsAABB> bounds;
+            getLeafBounds(bounds);
+
+            const uint32_t numObjects = static_cast<uint32_t>(bounds.size());
+            std::vector<std::vector<std::pair<SceneObject*, SceneObject*>>> batchPairs(OcularThreads->getNumBatches(numObjects, PairQueryBatchSize));
+
+            OcularThreads->parallelFor(numObjects, PairQueryBatchSize, [&](uint32_t const batch, uint32_t const first, uint32_t const last)
+            {
+                std::vector<SceneObject*> found;
+
+                for(uint32_t i = first; i < last; i++)
+                {
+                    SceneObject* object = m_LinearObjects[i];
+
+                    if(object)
+                    {
+                        found.clear();
+
+                        if(other)
+                        {
+                            other->getIntersections(bounds[i], found);
+                        }
+                        else
+                        {
+                            findIntersections(bounds[i], found);
+                        }
+
+                        for(auto foundObject : found)
+                        {
+                            // When querying this tree, each pair (and the object itself) is found from both of it's objects
+
+                            if(other || std::less<SceneObject*>()(object, foundObject))
+                            {
+                                batchPairs[batch].emplace_back(std::make_pair(object, foundObject));
+                            }
+                        }
                     }
                 }
+            });
+
+            for(auto const& batch : batchPairs)
+            {
+                pairs.insert(pairs.end(), batch.begin(), batch.end());
             }
         }
 
-        void BVHSceneTree::findIntersections(BVHSceneNode* node, Math::BoundsSphere const& bounds, std::vector<SceneObject*>& objects) const
+        void BVHSceneTree::getLeafBounds(std::vector<Math::BoundsAABB>& bounds) const
         {
-            if(node)
+            bounds.resize(m_LinearObjects.size());
+
+            for(uint32_t i = 0; i < static_cast<uint32_t>(m_LinearNodes.size()); i++)
             {
-                if(bounds.intersects(node->bounds))
+                if(m_LinearNodes[i].isLeaf(i))
                 {
-                    if((node->type == SceneNodeType::Leaf) && (node->object))
-                    {
-                        objects.emplace_back(node->object);
-                    }
-                    else
-                    {
-                        findIntersections(node->left, bounds, objects);
-                        findIntersections(node->right, bounds, objects);
-                    }
+                    bounds[m_LinearNodes[i].object] = getLinearBounds(m_LinearNodes[i]);
                 }
-
-                // Do nothing if there is no intersection.
             }
         }
 
-        void BVHSceneTree::findIntersections(BVHSceneNode* node, Math::BoundsAABB const& bounds, std::vector<SceneObject*>& objects) const
+        Math::BoundsAABB BVHSceneTree::getLinearBounds(BVHLinearNode const& node) const
         {
-            if(node)
+            const Math::Vector3f minPoint(node.boundsMin[0], node.boundsMin[1], node.boundsMin[2]);
+            const Math::Vector3f maxPoint(node.boundsMax[0], node.boundsMax[1], node.boundsMax[2]);
+
+            return Math::BoundsAABB(Math::Vector3f::Midpoint(minPoint, maxPoint), ((maxPoint - minPoint) * 0.5f));
+        }
+
+        void BVHSceneTree::ExtractFrustumPlanes(Math::Frustum const& frustum, float planes[6][4])
+        {
+            frustum.getPlaneEquations(planes);
+        }
+
+        void BVHSceneTree::InsertNearest(std::vector<std::pair<SceneObject*, float>>& nearest, uint32_t const count, SceneObject* object, float const distanceSq)
+        {
+            auto furthestFirst = [](std::pair<SceneObject*, float> const& a, std::pair<SceneObject*, float> const& b)->bool
             {
-                if(bounds.intersects(node->bounds))
-                {
-                    if(node->type == SceneNodeType::Leaf)
-                    {
-                        objects.emplace_back(node->object);
-                    }
-                    else
-                    {
-                        findIntersections(node->left, bounds, objects);
-                        findIntersections(node->right, bounds, objects);
-                    }
-                }
+                return (a.second < b.second);
+            };
+
+            if(nearest.size() < count)
+            {
+                nearest.emplace_back(std::make_pair(object, distanceSq));
+                std::push_heap(nearest.begin(), nearest.end(), furthestFirst);
+            }
+            else if(distanceSq < nearest.front().second)
+            {
+                std::pop_heap(nearest.begin(), nearest.end(), furthestFirst);
+                nearest.back() = std::make_pair(object, distanceSq);
+                std::push_heap(nearest.begin(), nearest.end(), furthestFirst);
             }
         }
 
-        void BVHSceneTree::findIntersections(BVHSceneNode* node, Math::BoundsOBB const& bounds, std::vector<SceneObject*>& objects) const
+        void BVHSceneTree::SortNearest(std::vector<std::pair<SceneObject*, float>>& nearest)
         {
-            if(node)
+            std::sort_heap(nearest.begin(), nearest.end(), [](std::pair<SceneObject*, float> const& a, std::pair<SceneObject*, float> const& b)->bool
             {
-                if(bounds.intersects(node->bounds))
-                {
-                    if(node->type == SceneNodeType::Leaf)
-                    {
-                        objects.emplace_back(node->object);
-                    }
-                    else
-                    {
-                        findIntersections(node->left, bounds, objects);
-                        findIntersections(node->right, bounds, objects);
-                    }
-                }
+                return (a.second < b.second);
+            });
+
+            for(auto& pair : nearest)
+            {
+                pair.second = sqrtf(pair.second);
             }
         }
 
-
         //----------------------------------------------------------------------
         // Build Methods
         //----------------------------------------------------------------------
@@ -699,170 +2289,312 @@ namespace Ocular
         {
             OCULAR_PROFILE()
 
-            // 1. Generate the morton codes for each scene object and sort them
-            // 2. Recursively build the tree top-down
-            // 3. Recursively fit the bounds of each node around it's children
+            // Parallel LBVH construction as described by Karras (Thinking Parallel, Part III):
+            //
+            // 1. Gather the world bounds of each scene object
+            // 2. Generate the morton codes for each scene object and radix sort them
+            // 3. Emit all internal nodes independently of one another
+            // 4. Fit the bounds of each node bottom-up, from the leaves to the root
+            //
+            // Steps 2-4 are split across all available threads.
 
             const uint32_t numObjects = static_cast<uint32_t>(m_AllObjects.size());
 
-            if(numObjects > 0)
+            if(numObjects > 1)
             {
+                std::vector<Math::BoundsAABB> bounds;
+                gatherBounds(bounds);
+
                 std::vector<MortonPair> mortonPairs;  
-                createMortonPairs(mortonPairs);
+                createMortonPairs(bounds, mortonPairs);
 
-                m_Root = generateTree(nullptr, mortonPairs, 0, (numObjects) - 1);
-                m_Root->type = SceneNodeType::Root;
+                // Internal nodes occupy [0, N-1) and leaf nodes occupy [N-1, 2N-1).
+                // The first internal node is the root of the tree.
+
+                std::vector<BVHSceneNode*> nodes;
+                std::vector<uint32_t> parents;
+
+                generateTree(mortonPairs, nodes, parents);
+                fitTreeBounds(bounds, mortonPairs, nodes, parents);
+
+                m_Root = nodes[0];
+
+                // Leaves are looked up by object UUID when the object is marked dirty
+
+                m_Leaves.reserve(numObjects);
+
+                for(uint32_t i = (numObjects - 1); i < nodes.size(); i++)
+                {
+                    m_Leaves[nodes[i]->object->getUUID().getHash64()] = nodes[i];
+                }
             }
             else
             {
                 m_Root = new BVHSceneNode();
                 m_Root->type = SceneNodeType::Root;
+
+                if(numObjects == 1)
+                {
+                    // The root is the only internal node that may have a single (left) child.
+
+                    BVHSceneNode* leaf = new BVHSceneNode();
+                    leaf->type   = SceneNodeType::Leaf;
+                    leaf->parent = m_Root;
+                    leaf->object = m_AllObjects[0];
+
+                    m_Root->left = leaf;
+                    m_Leaves[leaf->object->getUUID().getHash64()] = leaf;
+
+                    fitNodeBounds(m_Root);
+                }
             }
+        }
+
+        void BVHSceneTree::gatherBounds(std::vector<Math::BoundsAABB>& bounds) const
+        {
+            OCULAR_PROFILE()
 
-            fitNodeBounds(m_Root);
+            // Retrieving the world bounds may cause a dirty object to update itself (and notify the scene)
+            // which is not safe to do concurrently. So the bounds are gathered once, up-front, on this thread.
+
+            bounds.resize(m_AllObjects.size());
+
+            for(size_t i = 0; i < m_AllObjects.size(); i++)
+            {
+                bounds[i] = m_AllObjects[i]->getBoundsAABB(false);
+            }
         }
 
-        void BVHSceneTree::createMortonPairs(std::vector<MortonPair>& pairs) const
+        void BVHSceneTree::createMortonPairs(std::vector<Math::BoundsAABB> const& bounds, std::vector<MortonPair>& pairs) const
         {
             OCULAR_PROFILE()
 
-            // MortonCode::calculate(vector) performs the same essential steps as below.
-            // We do not use that method as it would require allocating and filling
-            // an additional vector with N points.
+            const uint32_t numObjects = static_cast<uint32_t>(bounds.size());
 
             //------------------------------------------------------------
-            // Find the minimum and maximum component extents
+            // Split the centers into component arrays for the batch calculation
 
-            float minValue = FLT_MAX;
-            float maxValue = FLT_MIN;
+            std::vector<float> centerX(numObjects);
+            std::vector<float> centerY(numObjects);
+            std::vector<float> centerZ(numObjects);
 
-            for(auto const object : m_AllObjects)
+            OcularThreads->parallelFor(numObjects, BuildBatchSize, [&](uint32_t const batch, uint32_t const first, uint32_t const last)
             {
-                const Math::Vector3f center = object->getBoundsAABB(false).getCenter();
-
-                minValue = fminf(minValue, fminf(center.x, fminf(center.y, center.z)));
-                maxValue = fmaxf(maxValue, fmaxf(center.x, fmaxf(center.y, center.z)));
-            }
+                for(uint32_t i = first; i < last; i++)
+                {
+                    const Math::Vector3f center = bounds[i].getCenter();
 
-            //------------------------------------------------------------
-            // Find the transform values needed to transform all values to the range [0,1]
+                    centerX[i] = center.x;
+                    centerY[i] = center.y;
+                    centerZ[i] = center.z;
+                }
+            });
 
-            float scaleValue = 1.0f / fmaxf(Math::EPSILON_FLOAT, (maxValue - minValue));
-            float offsetValue = (minValue < 0.0f) ? -minValue : 0.0f;
-            
             //------------------------------------------------------------
-            // Create and sort the codes
+            // Create and sort the codes (mapped to [0,1] across all objects)
 
             OCULAR_PROFILE_START("Create Morton Codes")
 
-            pairs.reserve(m_AllObjects.size());
+            std::vector<uint64_t> codes;
+            std::vector<uint32_t> order;
 
-            for(auto const object : m_AllObjects)
-            {
-                Math::Vector3f transformedCenter = (object->getBoundsAABB(false).getCenter() + offsetValue) * scaleValue;
-                uint64_t mortonCode = Math::MortonCode::calculate(transformedCenter);
+            Math::MortonCode::calculate(centerX.data(), centerY.data(), centerZ.data(), numObjects, codes, order);
 
-                pairs.push_back(std::make_pair(mortonCode, object));
-            }
+            pairs.resize(numObjects);
+
+            OcularThreads->parallelFor(numObjects, BuildBatchSize, [&](uint32_t const batch, uint32_t const first, uint32_t const last)
+            {
+                for(uint32_t i = first; i < last; i++)
+                {
+                    pairs[i] = std::make_pair(codes[i], order[i]);
+                }
+            });
 
             OCULAR_PROFILE_STOP()
-            OCULAR_PROFILE_START("Sort Morton Codes")
 
-            std::sort(pairs.begin(), pairs.end(), [](MortonPair const& a, MortonPair const& b)
+            // Duplicate codes are handled during tree generation (see CommonPrefix)
+        }
+
+        void BVHSceneTree::generateTree(std::vector<MortonPair> const& pairs, std::vector<BVHSceneNode*>& nodes, std::vector<uint32_t>& parents) const
+        {
+            OCULAR_PROFILE()
+
+            // Each internal node i determines the range of leaves it covers (one end of which is always i),
+            // and where that range is split. This only depends on the sorted codes, so every internal node
+            // can be emitted at once.
+            //
+            // Source: Tero Karras, Maximizing Parallelism in the Construction of BVHs, Octrees, and k-d Trees
+
+            const uint32_t numLeaves    = static_cast<uint32_t>(pairs.size());
+            const uint32_t numInternals = numLeaves - 1;
+            const uint32_t numNodes     = numInternals + numLeaves;
+
+            nodes.resize(numNodes);
+            parents.resize(numNodes);
+
+            //------------------------------------------------------------
+            // Allocate all nodes
+
+            OcularThreads->parallelFor(numNodes, BuildBatchSize, [&](uint32_t const batch, uint32_t const first, uint32_t const last)
             {
-                return (a.first < b.first);
+                for(uint32_t i = first; i < last; i++)
+                {
+                    BVHSceneNode* node = new BVHSceneNode();
+
+                    if(i == 0)
+                    {
+                        node->type = SceneNodeType::Root;
+                    }
+                    else if(i < numInternals)
+                    {
+                        node->type = SceneNodeType::Internal;
+                    }
+                    else
+                    {
+                        node->type   = SceneNodeType::Leaf;
+                        node->morton = pairs[i - numInternals].first;
+                        node->object = m_AllObjects[pairs[i - numInternals].second];
+                    }
+
+                    nodes[i] = node;
+                }
             });
-            
-            OCULAR_PROFILE_STOP()
 
             //------------------------------------------------------------
-            // Handle any duplicates
+            // Link the internal nodes to their children
+
+            OcularThreads->parallelFor(numInternals, BuildBatchSize, [&](uint32_t const batch, uint32_t const first, uint32_t const last)
+            {
+                for(uint32_t i = first; i < last; i++)
+                {
+                    // Determine the range of leaves covered by this node: [i, j] or [j, i]
+
+                    const int64_t index     = static_cast<int64_t>(i);
+                    const int64_t direction = ((CommonPrefix(pairs, index, (index + 1)) - CommonPrefix(pairs, index, (index - 1))) >= 0) ? 1 : -1;
+                    const int32_t minPrefix = CommonPrefix(pairs, index, (index - direction));
+
+                    int64_t maxLength = 2;
+
+                    while(CommonPrefix(pairs, index, (index + (maxLength * direction))) > minPrefix)
+                    {
+                        maxLength *= 2;
+                    }
+
+                    int64_t length = 0;
+
+                    for(int64_t step = (maxLength / 2); step >= 1; step /= 2)
+                    {
+                        if(CommonPrefix(pairs, index, (index + ((length + step) * direction))) > minPrefix)
+                        {
+                            length += step;
+                        }
+                    }
+
+                    const uint32_t other      = static_cast<uint32_t>(index + (length * direction));
+                    const uint32_t rangeFirst = std::min(i, other);
+                    const uint32_t rangeLast  = std::max(i, other);
 
-            // ...
+                    // Find the split and link the children
+
+                    const uint32_t split = findSplit(pairs, rangeFirst, rangeLast);
+
+                    const uint32_t leftIndex  = (split == rangeFirst) ? (numInternals + split) : split;
+                    const uint32_t rightIndex = ((split + 1) == rangeLast) ? (numInternals + split + 1) : (split + 1);
+
+                    BVHSceneNode* node = nodes[i];
+
+                    node->left  = nodes[leftIndex];
+                    node->right = nodes[rightIndex];
+
+                    node->left->parent  = node;
+                    node->right->parent = node;
+
+                    parents[leftIndex]  = i;
+                    parents[rightIndex] = i;
+                }
+            });
 
+            parents[0] = 0;
         }
 
-        BVHSceneNode* BVHSceneTree::generateTree(BVHSceneNode* parent, std::vector<MortonPair> const& pairs, uint32_t first, uint32_t last) const
+        uint32_t BVHSceneTree::findSplit(std::vector<MortonPair> const& pairs, uint32_t first, uint32_t last) const
         {
-            OCULAR_PROFILE()
+            uint32_t result = first;
 
-            BVHSceneNode* result = nullptr;
+            // Calculate the number of highest bits are the same for all objects.
 
-            if(first == last)
-            {
-                // Split contains only one item. This is a leaf node.
-                result = new BVHSceneNode();
-                result->parent = parent;
-                result->type   = SceneNodeType::Leaf;
-                result->morton = pairs[first].first;
-                result->object = pairs[first].second;
-            }
-            else
-            {
-                // Multiple objects. Determine where to split the collection.
-                uint32_t split = findSplit(pairs, first, last);
+            const int32_t commonPrefix = CommonPrefix(pairs, first, last);
 
-                // Create a new internal node and it's children.
-                result = new BVHSceneNode();
-                result->parent = parent;
-                result->type   = SceneNodeType::Internal;
+            // Use binary search to find where the next bit differs.
+            // We are looking for the highest object that shares more than
+            // just the commonPrefix bits with the first one.
 
-                BVHSceneNode* childA = generateTree(result, pairs, first, split);
-                BVHSceneNode* childB = generateTree(result, pairs, (split + 1), last);
+            uint32_t stepSize = (last - first);
+            uint32_t newSplit = result;
 
-                result->left  = childA;
-                result->right = childB;
-            }
+            do
+            {
+                stepSize = (stepSize + 1) >> 1;    // Exponential decrease
+                newSplit = (result + stepSize);    // Proposed new position
+
+                if(newSplit < last)
+                {
+                    if(CommonPrefix(pairs, first, newSplit) > commonPrefix)
+                    {
+                        result = newSplit;         // Accept the new split
+                    }
+                }
+            } while(stepSize > 1);
 
             return result;
         }
 
-        uint32_t BVHSceneTree::findSplit(std::vector<MortonPair> const& pairs, uint32_t first, uint32_t last) const
+        void BVHSceneTree::fitTreeBounds(std::vector<Math::BoundsAABB> const& bounds, std::vector<MortonPair> const& pairs, std::vector<BVHSceneNode*> const& nodes, std::vector<uint32_t> const& parents) const
         {
             OCULAR_PROFILE()
 
-            uint32_t result = first;
+            // Each leaf walks up towards the root. The first thread to reach an internal node stops,
+            // as the other child may not be fit yet. The second thread to arrive fits the node and continues.
+            // Every internal node is therefore fit exactly once, after both of it's children.
+
+            const uint32_t numLeaves    = static_cast<uint32_t>(pairs.size());
+            const uint32_t numInternals = numLeaves - 1;
 
-            const uint64_t firstCode = pairs[first].first;
-            const uint64_t lastCode = pairs[last].first;
+            std::unique_ptr<std::atomic<uint32_t>[]> visits(new std::atomic<uint32_t>[numInternals]);
 
-            if(firstCode == lastCode)
+            for(uint32_t i = 0; i < numInternals; i++)
             {
-                // Identical morton codes, so split the range in the middle
-                result = (first + last) >> 1;
+                visits[i].store(0, std::memory_order_relaxed);
             }
-            else
-            {
-                // Calculate the number of highest bits are the same for all objects.
 
-                uint32_t commonPrefix = Math::Clz((firstCode ^ lastCode));
-
-                // Use binary search to find where the next bit differs.
-                // We are looking for the highest object that shares more than
-                // just the commonPrefix bits with the first one.
+            OcularThreads->parallelFor(numLeaves, BuildBatchSize, [&](uint32_t const batch, uint32_t const first, uint32_t const last)
+            {
+                for(uint32_t i = first; i < last; i++)
+                {
+                    BVHSceneNode* leaf = nodes[numInternals + i];
+                    leaf->bounds = bounds[pairs[i].second];
 
-                uint32_t stepSize = (last - first);
-                uint32_t newSplit = result;
+                    uint32_t current = parents[numInternals + i];
 
-                do
-                {
-                    stepSize = (stepSize + 1) >> 1;    // Exponential decrease
-                    newSplit = (result + stepSize);    // Proposed new position
+                    // acq_rel: the second arrival must see the bounds written by the first
 
-                    if(newSplit < last)
+                    while(visits[current].fetch_add(1, std::memory_order_acq_rel) == 1)
                     {
-                        uint64_t splitCode   = pairs[newSplit].first;
-                        uint32_t splitPrefix = Math::Clz((firstCode ^ splitCode));
+                        BVHSceneNode* node = nodes[current];
 
-                        if(splitPrefix > commonPrefix)
+                        node->bounds = node->left->bounds;
+                        node->bounds.expandToContain(node->right->bounds);
+                        node->morton = Math::MortonCode::calculate(node->bounds.getCenter());
+
+                        if(current == 0)
                         {
-                            result = newSplit;         // Accept the new split
+                            break;
                         }
-                    }
-                } while(stepSize > 1);
-            }
 
-            return result;
+                        current = parents[current];
+                    }
+                }
+            });
         }
 
         void BVHSceneTree::fitNodeBounds(BVHSceneNode* node) const
@@ -912,6 +2644,190 @@ namespace Ocular
             }
         }
 
+        void BVHSceneTree::flatten()
+        {
+            OCULAR_PROFILE()
+
+            m_LinearNodes.clear();
+            m_LinearObjects.clear();
+
+            m_Cost = 0.0f;
+
+            if(m_Root && m_Root->left)
+            {
+                // A tree of N leaves has N-1 internal nodes
+
+                m_LinearNodes.reserve(m_AllObjects.size() * 2);
+                m_LinearObjects.reserve(m_AllObjects.size());
+
+                flattenNode(m_Root);
+
+                // The cost of the tree is the sum of the node areas relative to the root area.
+                // This is proportional to the expected number of nodes visited by a random query.
+
+                m_NodeArea = m_Cost;
+                m_Cost /= fmaxf(Math::EPSILON_FLOAT, HalfSurfaceArea(m_Root->bounds));
+            }
+        }
+
+        void BVHSceneTree::flattenNode(BVHSceneNode* node)
+        {
+            if(node)
+            {
+                const uint32_t index = static_cast<uint32_t>(m_LinearNodes.size());
+
+                node->nodeIndex = index;
+                m_LinearNodes.emplace_back();
+
+                BVHLinearNode& linear = m_LinearNodes.back();
+                
+                const Math::Vector3f minPoint = node->bounds.getMinPoint();
+                const Math::Vector3f maxPoint = node->bounds.getMaxPoint();
+
+                linear.boundsMin[0] = minPoint.x;
+                linear.boundsMin[1] = minPoint.y;
+                linear.boundsMin[2] = minPoint.z;
+                linear.boundsMax[0] = maxPoint.x;
+                linear.boundsMax[1] = maxPoint.y;
+                linear.boundsMax[2] = maxPoint.z;
+                linear.object       = static_cast<uint32_t>(m_LinearObjects.size());
+
+                m_Cost += HalfSurfaceArea(node->bounds);
+
+                if(node->type == SceneNodeType::Leaf)
+                {
+                    node->linearIndex = static_cast<uint32_t>(m_LinearObjects.size());
+                    m_LinearObjects.emplace_back(node->object);
+                }
+                else
+                {
+                    // Depth-first: the left subtree directly follows this node, then the right subtree
+                    flattenNode(node->left);
+                    flattenNode(node->right);
+                }
+
+                // Can not use the 'linear' reference here as the vector may have been reallocated
+                m_LinearNodes[index].skip = static_cast<uint32_t>(m_LinearNodes.size());
+            }
+        }
+
+        void BVHSceneTree::unflatten()
+        {
+            OCULAR_PROFILE()
+
+            m_NodeArea = 0.0f;
+
+            if(!m_LinearNodes.empty())
+            {
+                m_Leaves.reserve(m_LinearObjects.size());
+                m_Root = unflattenNode(0, nullptr);
+            }
+        }
+
+        BVHSceneNode* BVHSceneTree::unflattenNode(uint32_t const index, BVHSceneNode* parent)
+        {
+            BVHLinearNode const& linear = m_LinearNodes[index];
+
+            BVHSceneNode* node = new BVHSceneNode();
+            node->bounds    = getLinearBounds(linear);
+            node->morton    = Math::MortonCode::calculate(node->bounds.getCenter());
+            node->parent    = parent;
+            node->nodeIndex = index;
+
+            m_NodeArea += HalfSurfaceArea(linear);
+
+            if(parent == nullptr)
+            {
+                node->type = SceneNodeType::Root;
+            }
+            else if(linear.isLeaf(index))
+            {
+                node->type        = SceneNodeType::Leaf;
+                node->object      = m_LinearObjects[linear.object];
+                node->linearIndex = linear.object;
+
+                m_Leaves[node->object->getUUID().getHash64()] = node;
+            }
+            else
+            {
+                node->type = SceneNodeType::Internal;
+            }
+
+            if(!linear.isLeaf(index))
+            {
+                // Depth-first: the left child directly follows this node, and the right child follows the left subtree
+
+                const uint32_t left  = index + 1;
+                const uint32_t right = m_LinearNodes[left].skip;
+
+                node->left = unflattenNode(left, node);
+
+                if(right < linear.skip)
+                {
+                    node->right = unflattenNode(right, node);
+                }
+            }
+
+            return node;
+        }
+
+        bool BVHSceneTree::refitLinearNodes(std::vector<BVHSceneNode*> const& leaves)
+        {
+            OCULAR_PROFILE()
+
+            // As in refitPath, each path is left once a node is already up to date. Any ancestor
+            // above it that still changed lies on the path of another dirty leaf.
+
+            bool result = (m_Root != nullptr) && !m_LinearNodes.empty();
+
+            for(uint32_t i = 0; (i < static_cast<uint32_t>(leaves.size())) && result; i++)
+            {
+                BVHSceneNode* node = leaves[i];
+
+                while(node)
+                {
+                    if(node->nodeIndex >= m_LinearNodes.size())
+                    {
+                        result = false;
+                        break;
+                    }
+
+                    BVHLinearNode& linear = m_LinearNodes[node->nodeIndex];
+
+                    const Math::Vector3f minPoint = node->bounds.getMinPoint();
+                    const Math::Vector3f maxPoint = node->bounds.getMaxPoint();
+
+                    const bool isCurrent = (linear.boundsMin[0] == minPoint.x) && (linear.boundsMin[1] == minPoint.y) && (linear.boundsMin[2] == minPoint.z) &&
+                                           (linear.boundsMax[0] == maxPoint.x) && (linear.boundsMax[1] == maxPoint.y) && (linear.boundsMax[2] == maxPoint.z);
+
+                    if(isCurrent && (node != leaves[i]))
+                    {
+                        break;
+                    }
+
+                    m_NodeArea -= HalfSurfaceArea(linear);
+
+                    linear.boundsMin[0] = minPoint.x;
+                    linear.boundsMin[1] = minPoint.y;
+                    linear.boundsMin[2] = minPoint.z;
+                    linear.boundsMax[0] = maxPoint.x;
+                    linear.boundsMax[1] = maxPoint.y;
+                    linear.boundsMax[2] = maxPoint.z;
+
+                    m_NodeArea += HalfSurfaceArea(node->bounds);
+
+                    node = dynamic_cast<BVHSceneNode*>(node->parent);
+                }
+            }
+
+            if(result)
+            {
+                m_Cost = m_NodeArea / fmaxf(Math::EPSILON_FLOAT, HalfSurfaceArea(m_Root->bounds));
+            }
+
+            return result;
+        }
+
         //----------------------------------------------------------------------------------
         // PRIVATE METHODS
         //----------------------------------------------------------------------------------
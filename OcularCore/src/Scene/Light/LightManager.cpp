@@ -146,11 +146,40 @@ namespace Ocular
                 {
                     const Math::Frustum cameraFrustum = activeCamera->getFrustum();
 
+                    // Point lights and spotlights are culled together as a single array of bounding spheres.
+                    // Directional lights affect the entire scene, so they are always visible.
+
+                    m_CullLights.clear();
+                    m_CullSpheres.resize(static_cast<uint32_t>(m_Lights.size()));
+
                     for(auto pair : m_Lights)
                     {
-                        if(isLightVisible(pair.second, cameraFrustum))
+                        LightSource* light = pair.second;
+
+                        if(light && light->isActive())
+                        {
+                            const float type = light->getLightType();
+
+                            if(Math::IsEqual(type, 1.0f) || Math::IsEqual(type, 2.0f))
+                            {
+                                m_CullSpheres.set(static_cast<uint32_t>(m_CullLights.size()), Math::BoundsSphere(light->getPosition(false), light->getRange()));
+                                m_CullLights.emplace_back(light);
+                            }
+                            else if(Math::IsEqual(type, 3.0f))
+                            {
+                                visibleLights.emplace_back(light);
+                            }
+                        }
+                    }
+
+                    m_CullSpheres.resize(static_cast<uint32_t>(m_CullLights.size()));
+                    cameraFrustum.contains(m_CullSpheres, m_CullMask);
+
+                    for(uint32_t i = 0; i < static_cast<uint32_t>(m_CullLights.size()); i++)
+                    {
+                        if(m_CullMask[i >> 5] & (1u << (i & 31)))
                         {
-                            visibleLights.emplace_back(pair.second);
+                            visibleLights.emplace_back(m_CullLights[i]);
                         }
                     }
                 }
@@ -98,12 +98,7 @@ namespace Ocular
                 m_BoundsAABBWorld.setCenter(position);
                 m_BoundsAABBWorld.setExtents(Math::Vector3f(0.5f, 0.5f, 0.5f));
 
-                OcularScene->triggerObjectDirty(m_UUID, isStatic());
-
-                for(auto child : m_Children)
-                {
-                    child->updateBounds(dirtyFlags);
-                }
+                m_IsBoundsDirty = false;
             }
         }
 
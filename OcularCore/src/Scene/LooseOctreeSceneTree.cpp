@@ -0,0 +1,627 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Scene/LooseOctreeSceneTree.hpp"
+#include "Math/MortonCode.hpp"
+#include "Math/MathCommon.hpp"
+
+#include "OcularEngine.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    const uint64_t RootCell = 1;             ///< Locational code of the root cell
+    const uint32_t MaxCellDepth = 20;        ///< Deepest cell that can be represented by a 64-bit locational code
+    const uint32_t AllFrustumPlanes = 0x3F;  ///< Plane mask in which all six frustum planes are active
+}
+
+//------------------------------------------------------------------------------------------
+
+namespace Ocular
+{
+    namespace Core
+    {
+        //----------------------------------------------------------------------------------
+        // CONSTRUCTORS
+        //----------------------------------------------------------------------------------
+
+        LooseOctreeSceneTree::LooseOctreeSceneTree(float const worldSize, uint32_t const maxDepth)
+            : m_WorldSize(worldSize),
+              m_WorldMin(worldSize * -0.5f),
+              m_MaxDepth(std::min(maxDepth, MaxCellDepth))
+        {
+            m_AxisBits[0] = Math::MortonCode::calculate(1u, 0u, 0u);
+            m_AxisBits[1] = Math::MortonCode::calculate(0u, 1u, 0u);
+            m_AxisBits[2] = Math::MortonCode::calculate(0u, 0u, 1u);
+        }
+
+        LooseOctreeSceneTree::~LooseOctreeSceneTree()
+        {
+            destroy();
+        }
+
+        //----------------------------------------------------------------------------------
+        // PUBLIC METHODS
+        //----------------------------------------------------------------------------------
+
+        void LooseOctreeSceneTree::destroy()
+        {
+            ACellSceneTree::destroy();
+            m_Branches.clear();
+        }
+
+        SceneTreeType LooseOctreeSceneTree::getType() const
+        {
+            return SceneTreeType::OctTreeCPU;
+        }
+
+        //----------------------------------------------------------------------------------
+        // PROTECTED METHODS
+        //----------------------------------------------------------------------------------
+
+        uint64_t LooseOctreeSceneTree::getCell(float const boundsMin[3], float const boundsMax[3]) const
+        {
+            uint64_t result = RootCell;
+
+            float center[3];
+            float extent = 0.0f;
+            bool inside = true;
+
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                center[i] = (boundsMin[i] + boundsMax[i]) * 0.5f;
+                extent = fmaxf(extent, ((boundsMax[i] - boundsMin[i]) * 0.5f));
+                inside = inside && (center[i] >= m_WorldMin) && (center[i] < (m_WorldMin + m_WorldSize));
+            }
+
+            if(inside)
+            {
+                // Descend while the object still fits within the loose bounds of a child (half the child's size)
+
+                uint32_t depth = 0;
+                float size = m_WorldSize;
+
+                while((depth < m_MaxDepth) && (extent <= (size * 0.25f)))
+                {
+                    size *= 0.5f;
+                    depth++;
+                }
+
+                if(depth > 0)
+                {
+                    const uint32_t maxCoord = (1u << depth) - 1;
+                    uint32_t coords[3];
+
+                    for(uint32_t i = 0; i < 3; i++)
+                    {
+                        coords[i] = std::min(static_cast<uint32_t>((center[i] - m_WorldMin) / size), maxCoord);
+                    }
+
+                    result = (static_cast<uint64_t>(1) << (depth * 3)) | Math::MortonCode::calculate(coords[0], coords[1], coords[2]);
+                }
+            }
+
+            return result;
+        }
+
+        void LooseOctreeSceneTree::onCellCreated(uint64_t const cell)
+        {
+            // Link the cell to it's ancestors, creating them as needed, until an existing one is reached
+
+            uint64_t child = cell;
+
+            while(child != RootCell)
+            {
+                const uint64_t parent = child >> 3;
+                const bool parentExists = (m_Branches.find(parent) != m_Branches.end()) || (m_Cells.find(parent) != m_Cells.end());
+
+                m_Branches[parent] |= (1u << (child & 7));
+
+                if(parentExists)
+                {
+                    break;
+                }
+
+                child = parent;
+            }
+        }
+
+        void LooseOctreeSceneTree::onCellDestroyed(uint64_t const cell)
+        {
+            // Unlink the cell from it's ancestors, removing those that are left with no objects and no children
+
+            uint64_t child = cell;
+
+            while(child != RootCell)
+            {
+                if((m_Branches.find(child) != m_Branches.end()) || (m_Cells.find(child) != m_Cells.end()))
+                {
+                    // Still exists
+                    break;
+                }
+
+                const uint64_t parent = child >> 3;
+                auto findParent = m_Branches.find(parent);
+
+                if(findParent != m_Branches.end())
+                {
+                    findParent->second &= ~(1u << (child & 7));
+
+                    if(findParent->second == 0)
+                    {
+                        m_Branches.erase(findParent);
+                    }
+                }
+
+                child = parent;
+            }
+        }
+
+        void LooseOctreeSceneTree::getLooseBounds(CellPosition const& position, float boundsMin[3], float boundsMax[3]) const
+        {
+            if(position.depth == 0)
+            {
+                for(uint32_t i = 0; i < 3; i++)
+                {
+                    boundsMin[i] = -FLT_MAX;
+                    boundsMax[i] =  FLT_MAX;
+                }
+            }
+            else
+            {
+                const float size = ldexpf(m_WorldSize, -static_cast<int32_t>(position.depth));
+
+                for(uint32_t i = 0; i < 3; i++)
+                {
+                    const float cellMin = m_WorldMin + (static_cast<float>(position.coords[i]) * size);
+
+                    boundsMin[i] = cellMin - (size * 0.5f);
+                    boundsMax[i] = cellMin + (size * 1.5f);
+                }
+            }
+        }
+
+        LooseOctreeSceneTree::CellPosition LooseOctreeSceneTree::getChild(CellPosition const& position, uint32_t const child) const
+        {
+            CellPosition result;
+
+            result.code  = (position.code << 3) | child;
+            result.depth = position.depth + 1;
+
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                result.coords[i] = (position.coords[i] << 1) | ((child & m_AxisBits[i]) ? 1 : 0);
+            }
+
+            return result;
+        }
+
+        uint32_t LooseOctreeSceneTree::getChildren(uint64_t const cell) const
+        {
+            auto findBranch = m_Branches.find(cell);
+            return (findBranch != m_Branches.end()) ? findBranch->second : 0;
+        }
+
+        std::vector<ACellSceneTree::CellObject> const* LooseOctreeSceneTree::getObjects(uint64_t const cell) const
+        {
+            auto findCell = m_Cells.find(cell);
+            return (findCell != m_Cells.end()) ? &(findCell->second) : nullptr;
+        }
+
+        //----------------------------------------------------------------------
+        // Traversal Methods
+        //----------------------------------------------------------------------
+
+        void LooseOctreeSceneTree::findVisible(Math::Frustum const& frustum, std::vector<SceneObject*>& objects) const
+        {
+            float planes[6][4];
+            ExtractFrustumPlanes(frustum, planes);
+
+            // Each stack entry is a cell and the plane mask to test it with. 
+            // A cell with an empty mask is entirely inside of the frustum.
+
+            std::vector<std::pair<CellPosition, uint32_t>> stack;
+            stack.reserve(64);
+
+            CellPosition root = { RootCell, 0, { 0, 0, 0 } };
+            stack.emplace_back(std::make_pair(root, AllFrustumPlanes));
+
+            while(!stack.empty())
+            {
+                const CellPosition position = stack.back().first;
+                uint32_t mask = stack.back().second;
+
+                stack.pop_back();
+
+                Math::IntersectionType result = Math::IntersectionType::Inside;
+
+                if((position.depth > 0) && (mask != 0))
+                {
+                    float boundsMin[3];
+                    float boundsMax[3];
+
+                    getLooseBounds(position, boundsMin, boundsMax);
+                    result = ClassifyFrustum(planes, boundsMin, boundsMax, mask);
+                }
+                else if(mask != 0)
+                {
+                    result = Math::IntersectionType::Intersects;
+                }
+
+                std::vector<CellObject> const* cellObjects = getObjects(position.code);
+
+                if(result == Math::IntersectionType::Outside)
+                {
+                    if(cellObjects)
+                    {
+                        for(auto const& entry : (*cellObjects))
+                        {
+                            entry.object->setVisible(false);
+                        }
+                    }
+                }
+                else
+                {
+                    if(cellObjects)
+                    {
+                        for(auto const& entry : (*cellObjects))
+                        {
+                            uint32_t objectMask = mask;
+
+                            if((mask != 0) && (ClassifyFrustum(planes, entry.boundsMin, entry.boundsMax, objectMask) == Math::IntersectionType::Outside))
+                            {
+                                entry.object->setVisible(false);
+                            }
+                            else if(entry.object->isActive())
+                            {
+                                entry.object->setVisible(true);
+                                objects.emplace_back(entry.object);
+                            }
+                        }
+                    }
+
+                    const uint32_t children = getChildren(position.code);
+
+                    for(uint32_t child = 0; child < 8; child++)
+                    {
+                        if(children & (1u << child))
+                        {
+                            stack.emplace_back(std::make_pair(getChild(position, child), mask));
+                        }
+                    }
+                }
+            }
+        }
+
+        void LooseOctreeSceneTree::findIntersections(Math::Ray const& ray, std::vector<std::pair<SceneObject*, float>>& objects) const
+        {
+            float origin[3];
+            float invDir[3];
+            bool  parallel[3];
+
+            PrepareRay(ray, origin, invDir, parallel);
+
+            std::vector<CellPosition> stack;
+            stack.reserve(64);
+
+            CellPosition root = { RootCell, 0, { 0, 0, 0 } };
+            stack.emplace_back(root);
+
+            while(!stack.empty())
+            {
+                const CellPosition position = stack.back();
+                stack.pop_back();
+
+                float boundsMin[3];
+                float boundsMax[3];
+                float distance = 0.0f;
+
+                getLooseBounds(position, boundsMin, boundsMax);
+
+                if((position.depth == 0) || IntersectsRay(origin, invDir, parallel, boundsMin, boundsMax, distance))
+                {
+                    std::vector<CellObject> const* cellObjects = getObjects(position.code);
+
+                    if(cellObjects)
+                    {
+                        for(auto const& entry : (*cellObjects))
+                        {
+                            if(IntersectsRay(origin, invDir, parallel, entry.boundsMin, entry.boundsMax, distance))
+                            {
+                                objects.emplace_back(std::make_pair(entry.object, distance));
+                            }
+                        }
+                    }
+
+                    const uint32_t children = getChildren(position.code);
+
+                    for(uint32_t child = 0; child < 8; child++)
+                    {
+                        if(children & (1u << child))
+                        {
+                            stack.emplace_back(getChild(position, child));
+                        }
+                    }
+                }
+            }
+        }
+
+        bool LooseOctreeSceneTree::findIntersection(Math::Ray const& ray, RayQueryMode const mode, float const maxDistance, std::pair<SceneObject*, float>& result) const
+        {
+            bool found = false;
+
+            float origin[3];
+            float invDir[3];
+            bool  parallel[3];
+
+            PrepareRay(ray, origin, invDir, parallel);
+
+            // Cells are visited in the order that the ray enters them. As the cells overlap, the objects 
+            // of a cell may still be nearer than those of a cell visited before it, so the query only
+            // terminates once the next cell is entered beyond the nearest intersection.
+
+            typedef std::pair<float, CellPosition> QueueEntry;
+
+            auto furthestFirst = [](QueueEntry const& a, QueueEntry const& b)->bool
+            {
+                return (a.first > b.first);
+            };
+
+            std::vector<QueueEntry> queue;
+            queue.reserve(64);
+
+            CellPosition root = { RootCell, 0, { 0, 0, 0 } };
+            queue.emplace_back(std::make_pair(0.0f, root));
+
+            float nearest = maxDistance;
+
+            while(!queue.empty())
+            {
+                std::pop_heap(queue.begin(), queue.end(), furthestFirst);
+
+                const QueueEntry entry = queue.back();
+                queue.pop_back();
+
+                if(entry.first > nearest)
+                {
+                    // Every remaining cell is entered further along the ray
+                    break;
+                }
+
+                std::vector<CellObject> const* cellObjects = getObjects(entry.second.code);
+
+                if(cellObjects)
+                {
+                    for(auto const& object : (*cellObjects))
+                    {
+                        float distance = 0.0f;
+
+                        if(IntersectsRay(origin, invDir, parallel, object.boundsMin, object.boundsMax, distance) && (distance <= nearest))
+                        {
+                            result = std::make_pair(object.object, distance);
+                            nearest = distance;
+                            found = true;
+
+                            if(mode == RayQueryMode::Any)
+                            {
+                                break;
+                            }
+                        }
+                    }
+                }
+
+                if(found && (mode == RayQueryMode::Any))
+                {
+                    break;
+                }
+
+                const uint32_t children = getChildren(entry.second.code);
+
+                for(uint32_t child = 0; child < 8; child++)
+                {
+                    if(children & (1u << child))
+                    {
+                        const CellPosition position = getChild(entry.second, child);
+
+                        float boundsMin[3];
+                        float boundsMax[3];
+                        float distance = 0.0f;
+
+                        getLooseBounds(position, boundsMin, boundsMax);
+
+                        if(IntersectsRay(origin, invDir, parallel, boundsMin, boundsMax, distance) && (distance <= nearest))
+                        {
+                            queue.emplace_back(std::make_pair(distance, position));
+                            std::push_heap(queue.begin(), queue.end(), furthestFirst);
+                        }
+                    }
+                }
+            }
+
+            return found;
+        }
+
+        void LooseOctreeSceneTree::findNearestObjects(Math::Vector3f const& point, uint32_t const count, float const maxDistance, std::vector<std::pair<SceneObject*, float>>& objects) const
+        {
+            // Distances are kept squared until the results are returned.
+            // Each queue entry is the squared distance to a cell and the cell, nearest first.
+
+            typedef std::pair<float, CellPosition> QueueEntry;
+
+            auto furthestFirst = [](QueueEntry const& a, QueueEntry const& b)->bool
+            {
+                return (a.first > b.first);
+            };
+
+            const float origin[3] = { point.x, point.y, point.z };
+            const float maxDistanceSq = (maxDistance < FLT_MAX) ? (maxDistance * maxDistance) : FLT_MAX;
+
+            std::vector<QueueEntry> queue;
+
+            if(count > 0)
+            {
+                CellPosition root = { RootCell, 0, { 0, 0, 0 } };
+
+                queue.reserve(64);
+                queue.emplace_back(std::make_pair(0.0f, root));
+            }
+
+            while(!queue.empty())
+            {
+                std::pop_heap(queue.begin(), queue.end(), furthestFirst);
+
+                const QueueEntry entry = queue.back();
+                queue.pop_back();
+
+                if(entry.first > ((objects.size() == count) ? objects.front().second : maxDistanceSq))
+                {
+                    // Every remaining cell is at least this far away
+                    break;
+                }
+
+                std::vector<CellObject> const* cellObjects = getObjects(entry.second.code);
+
+                if(cellObjects)
+                {
+                    for(auto const& object : (*cellObjects))
+                    {
+                        const float distanceSq = DistanceSquared(origin, object.boundsMin, object.boundsMax);
+
+                        if(distanceSq <= maxDistanceSq)
+                        {
+                            InsertNearest(objects, count, object.object, distanceSq);
+                        }
+                    }
+                }
+
+                const float bound = (objects.size() == count) ? objects.front().second : maxDistanceSq;
+                const uint32_t children = getChildren(entry.second.code);
+
+                for(uint32_t child = 0; child < 8; child++)
+                {
+                    if(children & (1u << child))
+                    {
+                        const CellPosition position = getChild(entry.second, child);
+
+                        float boundsMin[3];
+                        float boundsMax[3];
+
+                        getLooseBounds(position, boundsMin, boundsMax);
+
+                        const float distanceSq = DistanceSquared(origin, boundsMin, boundsMax);
+
+                        if(distanceSq <= bound)
+                        {
+                            queue.emplace_back(std::make_pair(distanceSq, position));
+                            std::push_heap(queue.begin(), queue.end(), furthestFirst);
+                        }
+                    }
+                }
+            }
+
+            SortNearest(objects);
+        }
+
+        void LooseOctreeSceneTree::findIntersections(Math::BoundsSphere const& bounds, std::vector<SceneObject*>& objects) const
+        {
+            const Math::Vector3f center = bounds.getCenter();
+            const float point[3] = { center.x, center.y, center.z };
+            const float radiusSq = bounds.getRadius() * bounds.getRadius();
+
+            findIntersecting([&](float const boundsMin[3], float const boundsMax[3])->bool
+            {
+                return (DistanceSquared(point, boundsMin, boundsMax) <= radiusSq);
+            }, objects);
+        }
+
+        void LooseOctreeSceneTree::findIntersections(Math::BoundsAABB const& bounds, std::vector<SceneObject*>& objects) const
+        {
+            const Math::Vector3f queryMin = bounds.getMinPoint();
+            const Math::Vector3f queryMax = bounds.getMaxPoint();
+
+            findIntersecting([&](float const boundsMin[3], float const boundsMax[3])->bool
+            {
+                // Identical to BoundsAABB::intersects(BoundsAABB)
+
+                return !((boundsMin[0] > queryMax.x) || (queryMin.x > boundsMax[0]) ||
+                         (boundsMin[1] > queryMax.y) || (queryMin.y > boundsMax[1]) ||
+                         (boundsMin[2] > queryMax.z) || (queryMin.z > boundsMax[2]));
+            }, objects);
+        }
+
+        void LooseOctreeSceneTree::findIntersections(Math::BoundsOBB const& bounds, std::vector<SceneObject*>& objects) const
+        {
+            findIntersecting([&](float const boundsMin[3], float const boundsMax[3])->bool
+            {
+                return bounds.intersects(ToBounds(boundsMin, boundsMax));
+            }, objects);
+        }
+
+        template<typename Test>
+        void LooseOctreeSceneTree::findIntersecting(Test const& test, std::vector<SceneObject*>& objects) const
+        {
+            std::vector<CellPosition> stack;
+            stack.reserve(64);
+
+            CellPosition root = { RootCell, 0, { 0, 0, 0 } };
+            stack.emplace_back(root);
+
+            while(!stack.empty())
+            {
+                const CellPosition position = stack.back();
+                stack.pop_back();
+
+                float boundsMin[3];
+                float boundsMax[3];
+
+                getLooseBounds(position, boundsMin, boundsMax);
+
+                // The root is unbounded and always passes
+
+                if((position.depth == 0) || test(boundsMin, boundsMax))
+                {
+                    std::vector<CellObject> const* cellObjects = getObjects(position.code);
+
+                    if(cellObjects)
+                    {
+                        for(auto const& entry : (*cellObjects))
+                        {
+                            if(test(entry.boundsMin, entry.boundsMax))
+                            {
+                                objects.emplace_back(entry.object);
+                            }
+                        }
+                    }
+
+                    const uint32_t children = getChildren(position.code);
+
+                    for(uint32_t child = 0; child < 8; child++)
+                    {
+                        if(children & (1u << child))
+                        {
+                            stack.emplace_back(getChild(position, child));
+                        }
+                    }
+                }
+            }
+        }
+
+        //----------------------------------------------------------------------------------
+        // PRIVATE METHODS
+        //----------------------------------------------------------------------------------
+    }
+}
\ No newline at end of file
@@ -0,0 +1,584 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Scene/OcclusionBuffer.hpp"
+#include "Scene/SceneObject.hpp"
+#include "Scene/Renderables/MeshRenderable.hpp"
+#include "Graphics/Mesh/Mesh.hpp"
+#include "Math/SIMD.hpp"
+
+#include "OcularEngine.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace
+{
+    const float NearW = 0.0001f;    ///< Minimum clip space w. Occluders are clipped against it, and bounds that cross it are never occluded.
+
+    /**
+     * Transforms the point (x, y, z, 1) by the column-major matrix.
+     */
+    inline void TransformPoint(float const matrix[16], float const x, float const y, float const z, float result[4])
+    {
+        result[0] = (matrix[0] * x) + (matrix[4] * y) + (matrix[8]  * z) + matrix[12];
+        result[1] = (matrix[1] * x) + (matrix[5] * y) + (matrix[9]  * z) + matrix[13];
+        result[2] = (matrix[2] * x) + (matrix[6] * y) + (matrix[10] * z) + matrix[14];
+        result[3] = (matrix[3] * x) + (matrix[7] * y) + (matrix[11] * z) + matrix[15];
+    }
+
+    inline void ExtractMatrix(Ocular::Math::Matrix4x4 const& matrix, float result[16])
+    {
+        // Note that getData is column-major, while getElement is indexed row-major
+        matrix.getData(result);
+    }
+
+    /**
+     * Returns the first and last pixel whose center lies within [minCoord, maxCoord], clamped to [0, size).
+     * If no pixel center lies within the range, first will be greater than last.
+     */
+    inline void CoveredPixels(double const minCoord, double const maxCoord, uint32_t const size, int32_t& first, int32_t& last)
+    {
+        const double limit = static_cast<double>(size);
+
+        first = static_cast<int32_t>(std::max(0.0, std::min(limit, std::ceil(minCoord - 0.5))));
+        last  = static_cast<int32_t>(std::max(-1.0, std::min((limit - 1.0), std::floor(maxCoord - 0.5))));
+    }
+}
+
+//------------------------------------------------------------------------------------------
+
+namespace Ocular
+{
+    namespace Core
+    {
+        //----------------------------------------------------------------------------------
+        // CONSTRUCTORS
+        //----------------------------------------------------------------------------------
+
+        OcclusionBuffer::OcclusionBuffer(uint32_t const width, uint32_t const height)
+            : m_Width(0),
+              m_Height(0),
+              m_TilesX(0),
+              m_TilesY(0),
+              m_IsEmpty(true)
+        {
+            ExtractMatrix(Math::Matrix4x4(), m_ViewProjection);
+            setResolution(width, height);
+        }
+
+        OcclusionBuffer::~OcclusionBuffer()
+        {
+
+        }
+
+        //----------------------------------------------------------------------------------
+        // PUBLIC METHODS
+        //----------------------------------------------------------------------------------
+
+        void OcclusionBuffer::setResolution(uint32_t const width, uint32_t const height)
+        {
+            m_TilesX = std::max(1u, ((width + TileSize - 1) / TileSize));
+            m_TilesY = std::max(1u, ((height + TileSize - 1) / TileSize));
+            m_Width  = m_TilesX * TileSize;
+            m_Height = m_TilesY * TileSize;
+
+            m_Depth.assign((m_Width * m_Height), FLT_MAX);
+            m_TileDepth.assign((m_TilesX * m_TilesY), FLT_MAX);
+            m_Triangles.clear();
+
+            m_IsEmpty = true;
+        }
+
+        uint32_t OcclusionBuffer::getWidth() const
+        {
+            return m_Width;
+        }
+
+        uint32_t OcclusionBuffer::getHeight() const
+        {
+            return m_Height;
+        }
+
+        void OcclusionBuffer::clear(Math::Matrix4x4 const& viewProjection)
+        {
+            ExtractMatrix(viewProjection, m_ViewProjection);
+
+            std::fill(m_Depth.begin(), m_Depth.end(), FLT_MAX);
+            std::fill(m_TileDepth.begin(), m_TileDepth.end(), FLT_MAX);
+
+            m_Triangles.clear();
+            m_IsEmpty = true;
+        }
+
+        void OcclusionBuffer::addOccluder(std::vector<Math::Vector3f> const& vertices, std::vector<uint32_t> const& indices, Math::Matrix4x4 const& modelMatrix)
+        {
+            float model[16];
+            float modelViewProjection[16];
+
+            ExtractMatrix(modelMatrix, model);
+            Math::SIMD::MultiplyMatrix(m_ViewProjection, model, modelViewProjection);
+
+            m_ClipVertices.resize(vertices.size() * 4);
+
+            for(size_t i = 0; i < vertices.size(); i++)
+            {
+                TransformPoint(modelViewProjection, vertices[i].x, vertices[i].y, vertices[i].z, &m_ClipVertices[i * 4]);
+            }
+
+            addTriangles(indices);
+        }
+
+        bool OcclusionBuffer::addOccluder(SceneObject* object)
+        {
+            bool result = false;
+
+            if(object)
+            {
+                MeshRenderable* renderable = dynamic_cast<MeshRenderable*>(object->getRenderable());
+                Graphics::Mesh* mesh = (renderable ? renderable->getMesh() : nullptr);
+
+                if(mesh)
+                {
+                    float model[16];
+                    float modelViewProjection[16];
+
+                    ExtractMatrix(object->getModelMatrix(false), model);
+                    Math::SIMD::MultiplyMatrix(m_ViewProjection, model, modelViewProjection);
+
+                    for(uint32_t submesh = 0; submesh < mesh->getNumSubMeshes(); submesh++)
+                    {
+                        Graphics::VertexBuffer* vertexBuffer = mesh->getVertexBuffer(submesh);
+                        Graphics::IndexBuffer* indexBuffer = mesh->getIndexBuffer(submesh);
+
+                        if(vertexBuffer && indexBuffer)
+                        {
+                            std::vector<Graphics::Vertex> const& vertices = vertexBuffer->getVertices();
+
+                            m_ClipVertices.resize(vertices.size() * 4);
+
+                            for(size_t i = 0; i < vertices.size(); i++)
+                            {
+                                Math::Vector4f const& position = vertices[i].position;
+                                TransformPoint(modelViewProjection, position.x, position.y, position.z, &m_ClipVertices[i * 4]);
+                            }
+
+                            addTriangles(indexBuffer->getIndices());
+                            result = true;
+                        }
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        void OcclusionBuffer::rasterize()
+        {
+            OCULAR_PROFILE()
+
+            if(!m_Triangles.empty())
+            {
+                // Each batch owns whole rows of tiles, so no two threads ever write the same pixel or tile
+
+                OcularThreads->parallelFor(m_TilesY, 1, [&](uint32_t const batch, uint32_t const first, uint32_t const last)
+                {
+                    rasterizeRows((first * TileSize), (last * TileSize));
+                    buildTiles(first, last);
+                });
+            }
+
+            m_IsEmpty = m_Triangles.empty();
+        }
+
+        bool OcclusionBuffer::isOccluded(float const boundsMin[3], float const boundsMax[3]) const
+        {
+            bool result = false;
+
+            if(!m_IsEmpty)
+            {
+                bool valid = true;
+
+                float minX = FLT_MAX;
+                float minY = FLT_MAX;
+                float maxX = -FLT_MAX;
+                float maxY = -FLT_MAX;
+                float nearest = FLT_MAX;
+
+                for(uint32_t i = 0; (i < 8) && valid; i++)
+                {
+                    float clip[4];
+
+                    TransformPoint(m_ViewProjection,
+                        ((i & 1) ? boundsMax[0] : boundsMin[0]),
+                        ((i & 2) ? boundsMax[1] : boundsMin[1]),
+                        ((i & 4) ? boundsMax[2] : boundsMin[2]), clip);
+
+                    if(clip[3] < NearW)
+                    {
+                        // Part of the bounds is at or behind the viewer
+                        valid = false;
+                    }
+                    else
+                    {
+                        const float invW = 1.0f / clip[3];
+                        const float x = ((clip[0] * invW * 0.5f) + 0.5f) * static_cast<float>(m_Width);
+                        const float y = ((clip[1] * invW * 0.5f) + 0.5f) * static_cast<float>(m_Height);
+
+                        minX = std::min(minX, x);
+                        maxX = std::max(maxX, x);
+                        minY = std::min(minY, y);
+                        maxY = std::max(maxY, y);
+                        nearest = std::min(nearest, (clip[2] * invW));
+                    }
+                }
+
+                if(valid && (maxX >= 0.0f) && (maxY >= 0.0f) && (minX < static_cast<float>(m_Width)) && (minY < static_cast<float>(m_Height)))
+                {
+                    // Every pixel that the projected bounds may touch, not just those whose centers it covers
+
+                    const int32_t firstX = static_cast<int32_t>(std::max(0.0f, std::floor(minX)));
+                    const int32_t firstY = static_cast<int32_t>(std::max(0.0f, std::floor(minY)));
+                    const int32_t lastX  = static_cast<int32_t>(std::min(static_cast<float>(m_Width - 1), std::floor(maxX)));
+                    const int32_t lastY  = static_cast<int32_t>(std::min(static_cast<float>(m_Height - 1), std::floor(maxY)));
+
+                    result = isRangeOccluded(firstX, lastX, firstY, lastY, nearest);
+                }
+            }
+
+            return result;
+        }
+
+        bool OcclusionBuffer::isOccluded(Math::BoundsAABB const& bounds) const
+        {
+            const Math::Vector3f minPoint = bounds.getMinPoint();
+            const Math::Vector3f maxPoint = bounds.getMaxPoint();
+
+            const float boundsMin[3] = { minPoint.x, minPoint.y, minPoint.z };
+            const float boundsMax[3] = { maxPoint.x, maxPoint.y, maxPoint.z };
+
+            return isOccluded(boundsMin, boundsMax);
+        }
+
+        float OcclusionBuffer::getDepth(uint32_t const x, uint32_t const y) const
+        {
+            float result = FLT_MAX;
+
+            if((x < m_Width) && (y < m_Height))
+            {
+                result = m_Depth[(y * m_Width) + x];
+            }
+
+            return result;
+        }
+
+        uint32_t OcclusionBuffer::getNumTriangles() const
+        {
+            return static_cast<uint32_t>(m_Triangles.size());
+        }
+
+        //----------------------------------------------------------------------------------
+        // PROTECTED METHODS
+        //----------------------------------------------------------------------------------
+
+        void OcclusionBuffer::addTriangles(std::vector<uint32_t> const& indices)
+        {
+            const size_t numVertices = m_ClipVertices.size() / 4;
+
+            for(size_t i = 0; (i + 2) < indices.size(); i += 3)
+            {
+                if((indices[i] < numVertices) && (indices[i + 1] < numVertices) && (indices[i + 2] < numVertices))
+                {
+                    float vertices[3][4];
+
+                    for(uint32_t j = 0; j < 3; j++)
+                    {
+                        std::copy_n(&m_ClipVertices[indices[i + j] * 4], 4, vertices[j]);
+                    }
+
+                    clipTriangle(vertices);
+                }
+            }
+        }
+
+        void OcclusionBuffer::clipTriangle(float const vertices[3][4])
+        {
+            // Sutherland-Hodgman against the single plane w = NearW. A triangle clipped by one plane has at most four vertices.
+
+            float polygon[4][4];
+            uint32_t numVertices = 0;
+
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                float const* current = vertices[i];
+                float const* next = vertices[(i + 1) % 3];
+
+                const bool currentInside = (current[3] >= NearW);
+                const bool nextInside = (next[3] >= NearW);
+
+                if(currentInside)
+                {
+                    std::copy_n(current, 4, polygon[numVertices++]);
+                }
+
+                if(currentInside != nextInside)
+                {
+                    const float t = (NearW - current[3]) / (next[3] - current[3]);
+
+                    for(uint32_t j = 0; j < 4; j++)
+                    {
+                        polygon[numVertices][j] = current[j] + ((next[j] - current[j]) * t);
+                    }
+
+                    polygon[numVertices++][3] = NearW;
+                }
+            }
+
+            for(uint32_t i = 1; (i + 1) < numVertices; i++)
+            {
+                float const* triangle[3] = { polygon[0], polygon[i], polygon[i + 1] };
+                setupTriangle(triangle);
+            }
+        }
+
+        void OcclusionBuffer::setupTriangle(float const* vertices[3])
+        {
+            // Setup is performed in double precision as vertices near the viewer may project far outside of the screen
+
+            double x[3];
+            double y[3];
+            double z[3];
+
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                const double invW = 1.0 / static_cast<double>(vertices[i][3]);
+
+                x[i] = ((static_cast<double>(vertices[i][0]) * invW * 0.5) + 0.5) * static_cast<double>(m_Width);
+                y[i] = ((static_cast<double>(vertices[i][1]) * invW * 0.5) + 0.5) * static_cast<double>(m_Height);
+                z[i] = static_cast<double>(vertices[i][2]) * invW;
+            }
+
+            double area = ((x[1] - x[0]) * (y[2] - y[0])) - ((x[2] - x[0]) * (y[1] - y[0]));
+
+            if(area < 0.0)
+            {
+                // Occluders are rasterized regardless of their facing, so flip to a consistent winding
+
+                std::swap(x[1], x[2]);
+                std::swap(y[1], y[2]);
+                std::swap(z[1], z[2]);
+
+                area = -area;
+            }
+
+            if(area > 0.0)
+            {
+                Triangle triangle;
+
+                CoveredPixels(std::min({ x[0], x[1], x[2] }), std::max({ x[0], x[1], x[2] }), m_Width, triangle.minX, triangle.maxX);
+                CoveredPixels(std::min({ y[0], y[1], y[2] }), std::max({ y[0], y[1], y[2] }), m_Height, triangle.minY, triangle.maxY);
+
+                if((triangle.minX <= triangle.maxX) && (triangle.minY <= triangle.maxY))
+                {
+                    for(uint32_t i = 0; i < 3; i++)
+                    {
+                        const uint32_t j = (i + 1) % 3;
+
+                        triangle.edges[i][0] = static_cast<float>(y[i] - y[j]);
+                        triangle.edges[i][1] = static_cast<float>(x[j] - x[i]);
+                        triangle.edges[i][2] = static_cast<float>((x[i] * y[j]) - (y[i] * x[j]));
+                    }
+
+                    const double dzdx = (((z[1] - z[0]) * (y[2] - y[0])) - ((z[2] - z[0]) * (y[1] - y[0]))) / area;
+                    const double dzdy = (((x[1] - x[0]) * (z[2] - z[0])) - ((x[2] - x[0]) * (z[1] - z[0]))) / area;
+
+                    triangle.depth[0] = static_cast<float>(dzdx);
+                    triangle.depth[1] = static_cast<float>(dzdy);
+                    triangle.depth[2] = static_cast<float>(z[0] - (dzdx * x[0]) - (dzdy * y[0]));
+
+                    m_Triangles.emplace_back(triangle);
+                }
+            }
+        }
+
+        void OcclusionBuffer::rasterizeRows(uint32_t const firstRow, uint32_t const lastRow)
+        {
+#if defined(OCULAR_SIMD_SSE)
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+            for(auto const& triangle : m_Triangles)
+            {
+                const int32_t minY = std::max(triangle.minY, static_cast<int32_t>(firstRow));
+                const int32_t maxY = std::min(triangle.maxY, (static_cast<int32_t>(lastRow) - 1));
+
+                if(minY > maxY)
+                {
+                    continue;
+                }
+
+                // Spans are processed four pixels at a time, beginning at an aligned column.
+                // The buffer width is a multiple of four, so a span never runs past the end of a row.
+
+                const int32_t minX = triangle.minX & ~3;
+                const int32_t maxX = triangle.maxX;
+
+                const __m128 edgeX0 = _mm_set1_ps(triangle.edges[0][0]);
+                const __m128 edgeX1 = _mm_set1_ps(triangle.edges[1][0]);
+                const __m128 edgeX2 = _mm_set1_ps(triangle.edges[2][0]);
+                const __m128 depthX = _mm_set1_ps(triangle.depth[0]);
+
+                for(int32_t y = minY; y <= maxY; y++)
+                {
+                    const float center = static_cast<float>(y) + 0.5f;
+
+                    const __m128 edgeY0 = _mm_set1_ps((triangle.edges[0][1] * center) + triangle.edges[0][2]);
+                    const __m128 edgeY1 = _mm_set1_ps((triangle.edges[1][1] * center) + triangle.edges[1][2]);
+                    const __m128 edgeY2 = _mm_set1_ps((triangle.edges[2][1] * center) + triangle.edges[2][2]);
+                    const __m128 depthY = _mm_set1_ps((triangle.depth[1] * center) + triangle.depth[2]);
+
+                    float* row = &m_Depth[y * m_Width];
+
+                    for(int32_t x = minX; x <= maxX; x += 4)
+                    {
+                        const __m128 centers = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+
+                        __m128 covered = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeX0, centers), edgeY0), zero);
+                        covered = _mm_and_ps(covered, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeX1, centers), edgeY1), zero));
+                        covered = _mm_and_ps(covered, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeX2, centers), edgeY2), zero));
+
+                        if(_mm_movemask_ps(covered))
+                        {
+                            const __m128 depth = _mm_add_ps(_mm_mul_ps(depthX, centers), depthY);
+                            const __m128 current = _mm_loadu_ps(row + x);
+                            const __m128 nearest = _mm_min_ps(current, depth);
+
+                            _mm_storeu_ps((row + x), _mm_or_ps(_mm_and_ps(covered, nearest), _mm_andnot_ps(covered, current)));
+                        }
+                    }
+                }
+            }
+#else
+            for(auto const& triangle : m_Triangles)
+            {
+                const int32_t minY = std::max(triangle.minY, static_cast<int32_t>(firstRow));
+                const int32_t maxY = std::min(triangle.maxY, (static_cast<int32_t>(lastRow) - 1));
+
+                for(int32_t y = minY; y <= maxY; y++)
+                {
+                    const float center = static_cast<float>(y) + 0.5f;
+
+                    const float edgeY0 = (triangle.edges[0][1] * center) + triangle.edges[0][2];
+                    const float edgeY1 = (triangle.edges[1][1] * center) + triangle.edges[1][2];
+                    const float edgeY2 = (triangle.edges[2][1] * center) + triangle.edges[2][2];
+                    const float depthY = (triangle.depth[1] * center) + triangle.depth[2];
+
+                    float* row = &m_Depth[y * m_Width];
+
+                    for(int32_t x = triangle.minX; x <= triangle.maxX; x++)
+                    {
+                        const float centerX = static_cast<float>(x) + 0.5f;
+
+                        if((((triangle.edges[0][0] * centerX) + edgeY0) >= 0.0f) &&
+                           (((triangle.edges[1][0] * centerX) + edgeY1) >= 0.0f) &&
+                           (((triangle.edges[2][0] * centerX) + edgeY2) >= 0.0f))
+                        {
+                            row[x] = std::min(row[x], ((triangle.depth[0] * centerX) + depthY));
+                        }
+                    }
+                }
+            }
+#endif
+        }
+
+        void OcclusionBuffer::buildTiles(uint32_t const firstTileRow, uint32_t const lastTileRow)
+        {
+            for(uint32_t tileY = firstTileRow; tileY < lastTileRow; tileY++)
+            {
+                for(uint32_t tileX = 0; tileX < m_TilesX; tileX++)
+                {
+#if defined(OCULAR_SIMD_SSE)
+                    __m128 furthest = _mm_set1_ps(-FLT_MAX);
+
+                    for(uint32_t y = 0; y < TileSize; y++)
+                    {
+                        float const* row = &m_Depth[(((tileY * TileSize) + y) * m_Width) + (tileX * TileSize)];
+
+                        furthest = _mm_max_ps(furthest, _mm_loadu_ps(row));
+                        furthest = _mm_max_ps(furthest, _mm_loadu_ps(row + 4));
+                    }
+
+                    furthest = _mm_max_ps(furthest, _mm_movehl_ps(furthest, furthest));
+                    furthest = _mm_max_ps(furthest, _mm_shuffle_ps(furthest, furthest, _MM_SHUFFLE(1, 1, 1, 1)));
+
+                    _mm_store_ss(&m_TileDepth[(tileY * m_TilesX) + tileX], furthest);
+#else
+                    float furthest = -FLT_MAX;
+
+                    for(uint32_t y = 0; y < TileSize; y++)
+                    {
+                        float const* row = &m_Depth[(((tileY * TileSize) + y) * m_Width) + (tileX * TileSize)];
+
+                        for(uint32_t x = 0; x < TileSize; x++)
+                        {
+                            furthest = std::max(furthest, row[x]);
+                        }
+                    }
+
+                    m_TileDepth[(tileY * m_TilesX) + tileX] = furthest;
+#endif
+                }
+            }
+        }
+
+        bool OcclusionBuffer::isRangeOccluded(int32_t const minX, int32_t const maxX, int32_t const minY, int32_t const maxY, float const depth) const
+        {
+            bool result = true;
+
+            const int32_t tileSize = static_cast<int32_t>(TileSize);
+
+            for(int32_t tileY = (minY / tileSize); (tileY <= (maxY / tileSize)) && result; tileY++)
+            {
+                for(int32_t tileX = (minX / tileSize); (tileX <= (maxX / tileSize)) && result; tileX++)
+                {
+                    if(m_TileDepth[(tileY * m_TilesX) + tileX] >= depth)
+                    {
+                        // Some pixel of the tile is not nearer than the bounds. Test only those pixels the bounds overlap.
+
+                        const int32_t firstX = std::max(minX, (tileX * tileSize));
+                        const int32_t lastX  = std::min(maxX, ((tileX * tileSize) + tileSize - 1));
+                        const int32_t firstY = std::max(minY, (tileY * tileSize));
+                        const int32_t lastY  = std::min(maxY, ((tileY * tileSize) + tileSize - 1));
+
+                        for(int32_t y = firstY; (y <= lastY) && result; y++)
+                        {
+                            float const* row = &m_Depth[y * m_Width];
+
+                            for(int32_t x = firstX; (x <= lastX) && result; x++)
+                            {
+                                result = (row[x] < depth);
+                            }
+                        }
+                    }
+                }
+            }
+
+            return result;
+        }
+    }
+}
\ No newline at end of file
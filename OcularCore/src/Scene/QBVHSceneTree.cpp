@@ -0,0 +1,809 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Scene/QBVHSceneTree.hpp"
+#include "Scene/OcclusionBuffer.hpp"
+#include "Math/MathCommon.hpp"
+
+#include "OcularEngine.hpp"
+
+#include <xmmintrin.h>
+#include <cstring>
+#include <queue>
+#include <functional>
+
+namespace
+{
+    /**
+     * Returns half of the surface area of the bounds. Identical to the measure used by BVHSceneTree::getCost.
+     */
+    inline float HalfSurfaceArea(Ocular::Math::BoundsAABB const& bounds)
+    {
+        const Ocular::Math::Vector3f size = bounds.getExtents() * 2.0f;
+        return (size.x * size.y) + (size.y * size.z) + (size.z * size.x);
+    }
+
+    /**
+     * Creates a BoundsAABB from the bounds of a single child of a node.
+     */
+    inline Ocular::Math::BoundsAABB GetChildBounds(Ocular::Core::QBVHNode const& node, uint32_t const child)
+    {
+        const Ocular::Math::Vector3f minPoint(node.boundsMinX[child], node.boundsMinY[child], node.boundsMinZ[child]);
+        const Ocular::Math::Vector3f maxPoint(node.boundsMaxX[child], node.boundsMaxY[child], node.boundsMaxZ[child]);
+
+        return Ocular::Math::BoundsAABB(Ocular::Math::Vector3f::Midpoint(minPoint, maxPoint), ((maxPoint - minPoint) * 0.5f));
+    }
+
+    /**
+     * Generic stack-based traversal of the 4-wide tree.
+     *
+     * The test is invoked once for each visited node and returns a bitmask of the children that pass.
+     * The visit is then invoked for every leaf child of the node, along with if it passed the test.
+     * Only internal children that pass the test are traversed.
+     */
+    template<typename Test, typename Visit>
+    void TraverseQuad(std::vector<Ocular::Core::QBVHNode> const& nodes, Test const& test, Visit const& visit)
+    {
+        if(!nodes.empty())
+        {
+            std::vector<uint32_t> stack;
+            stack.reserve(64);
+            stack.push_back(0);
+
+            while(!stack.empty())
+            {
+                Ocular::Core::QBVHNode const& node = nodes[stack.back()];
+                stack.pop_back();
+
+                const uint32_t mask = test(node) & ((1 << node.numChildren) - 1);
+
+                for(uint32_t i = 0; i < node.numChildren; i++)
+                {
+                    const uint32_t child = node.children[i];
+                    const bool passed = ((mask & (1 << i)) != 0);
+
+                    if(child & Ocular::Core::QBVHNode::LeafFlag)
+                    {
+                        visit((child & ~Ocular::Core::QBVHNode::LeafFlag), node, i, passed);
+                    }
+                    else if(passed)
+                    {
+                        stack.push_back(child);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Tests all four children of a node against the six frustum planes (see BVHSceneTree::ExtractFrustumPlanes).
+     * Equivalent to Frustum::contains(BoundsAABB) for each child.
+     */
+    inline uint32_t TestFrustum(float const planes[6][4], Ocular::Core::QBVHNode const& node)
+    {
+        const __m128 zero = _mm_setzero_ps();
+
+        const __m128 minX = _mm_loadu_ps(node.boundsMinX);
+        const __m128 minY = _mm_loadu_ps(node.boundsMinY);
+        const __m128 minZ = _mm_loadu_ps(node.boundsMinZ);
+        const __m128 maxX = _mm_loadu_ps(node.boundsMaxX);
+        const __m128 maxY = _mm_loadu_ps(node.boundsMaxY);
+        const __m128 maxZ = _mm_loadu_ps(node.boundsMaxZ);
+
+        __m128 outside = zero;
+
+        for(uint32_t i = 0; i < 6; i++)
+        {
+            const float* plane = planes[i];
+
+            // The corner of each child nearest to the inside of the plane
+
+            const __m128 x = (plane[0] >= 0.0f) ? minX : maxX;
+            const __m128 y = (plane[1] >= 0.0f) ? minY : maxY;
+            const __m128 z = (plane[2] >= 0.0f) ? minZ : maxZ;
+
+            __m128 distance = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane[0])), _mm_set1_ps(plane[3]));
+            distance = _mm_add_ps(distance, _mm_mul_ps(y, _mm_set1_ps(plane[1])));
+            distance = _mm_add_ps(distance, _mm_mul_ps(z, _mm_set1_ps(plane[2])));
+
+            outside = _mm_or_ps(outside, _mm_cmpgt_ps(distance, zero));
+
+            if(_mm_movemask_ps(outside) == 0xF)
+            {
+                break;
+            }
+        }
+
+        return (~static_cast<uint32_t>(_mm_movemask_ps(outside))) & 0xF;
+    }
+
+    /**
+     * Converts a ray into the form used by TestRay.
+     */
+    void PrepareRay(Ocular::Math::Ray const& ray, __m128 origin[3], __m128 invDir[3])
+    {
+        static const float epsilon = 0.000000000000001f;
+
+        const Ocular::Math::Vector3f rayOrigin    = ray.getOrigin();
+        const Ocular::Math::Vector3f rayDirection = ray.getDirection();
+
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            // Parallel axes use a huge (but finite) inverse so that the slab test never produces a NaN.
+            // The slab is then either unbounded (origin inside) or unreachable (origin outside).
+
+            origin[i] = _mm_set1_ps(rayOrigin[i]);
+            invDir[i] = _mm_set1_ps((fabs(rayDirection[i]) > epsilon) ? (1.0f / rayDirection[i]) : FLT_MAX);
+        }
+    }
+
+    /**
+     * Slab test of a ray against all four children of a node. The entry distance of each child is
+     * written to distances (0 if the origin is inside of the child).
+     */
+    inline uint32_t TestRay(__m128 const origin[3], __m128 const invDir[3], Ocular::Core::QBVHNode const& node, float distances[4])
+    {
+        const __m128 t0x = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.boundsMinX), origin[0]), invDir[0]);
+        const __m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.boundsMaxX), origin[0]), invDir[0]);
+        const __m128 t0y = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.boundsMinY), origin[1]), invDir[1]);
+        const __m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.boundsMaxY), origin[1]), invDir[1]);
+        const __m128 t0z = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.boundsMinZ), origin[2]), invDir[2]);
+        const __m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.boundsMaxZ), origin[2]), invDir[2]);
+
+        __m128 tMin = _mm_max_ps(_mm_min_ps(t0x, t1x), _mm_min_ps(t0y, t1y));
+        tMin = _mm_max_ps(tMin, _mm_max_ps(_mm_min_ps(t0z, t1z), _mm_setzero_ps()));
+
+        __m128 tMax = _mm_min_ps(_mm_max_ps(t0x, t1x), _mm_max_ps(t0y, t1y));
+        tMax = _mm_min_ps(tMax, _mm_min_ps(_mm_max_ps(t0z, t1z), _mm_set1_ps(FLT_MAX)));
+
+        _mm_storeu_ps(distances, tMin);
+
+        return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(tMin, tMax)));
+    }
+
+    /**
+     * Overlap test of an axis-aligned box against all four children of a node.
+     * Equivalent to BoundsAABB::intersects(BoundsAABB) for each child.
+     */
+    inline uint32_t TestAABB(__m128 const boundsMin[3], __m128 const boundsMax[3], Ocular::Core::QBVHNode const& node)
+    {
+        __m128 separated = _mm_or_ps(_mm_cmpgt_ps(_mm_loadu_ps(node.boundsMinX), boundsMax[0]), _mm_cmpgt_ps(boundsMin[0], _mm_loadu_ps(node.boundsMaxX)));
+        separated = _mm_or_ps(separated, _mm_or_ps(_mm_cmpgt_ps(_mm_loadu_ps(node.boundsMinY), boundsMax[1]), _mm_cmpgt_ps(boundsMin[1], _mm_loadu_ps(node.boundsMaxY))));
+        separated = _mm_or_ps(separated, _mm_or_ps(_mm_cmpgt_ps(_mm_loadu_ps(node.boundsMinZ), boundsMax[2]), _mm_cmpgt_ps(boundsMin[2], _mm_loadu_ps(node.boundsMaxZ))));
+
+        return (~static_cast<uint32_t>(_mm_movemask_ps(separated))) & 0xF;
+    }
+
+    /**
+     * Squared distance from a point to the nearest point of each of the four children of a node (0 if inside).
+     */
+    inline __m128 DistanceSquared(__m128 const point[3], Ocular::Core::QBVHNode const& node)
+    {
+        const __m128 zero = _mm_setzero_ps();
+
+        const __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(node.boundsMinX), point[0]), _mm_sub_ps(point[0], _mm_loadu_ps(node.boundsMaxX))), zero);
+        const __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(node.boundsMinY), point[1]), _mm_sub_ps(point[1], _mm_loadu_ps(node.boundsMaxY))), zero);
+        const __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(node.boundsMinZ), point[2]), _mm_sub_ps(point[2], _mm_loadu_ps(node.boundsMaxZ))), zero);
+
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+    }
+
+    /**
+     * Overlap test of a sphere against all four children of a node, using the squared distance
+     * from the sphere center to the nearest point of each child.
+     */
+    inline uint32_t TestSphere(__m128 const center[3], __m128 const radiusSquared, Ocular::Core::QBVHNode const& node)
+    {
+        return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(DistanceSquared(center, node), radiusSquared)));
+    }
+}
+
+//------------------------------------------------------------------------------------------
+
+namespace Ocular
+{
+    namespace Core
+    {
+        //----------------------------------------------------------------------------------
+        // CONSTRUCTORS
+        //----------------------------------------------------------------------------------
+
+        QBVHSceneTree::QBVHSceneTree()
+            : BVHSceneTree()
+        {
+
+        }
+
+        QBVHSceneTree::~QBVHSceneTree()
+        {
+
+        }
+
+        //----------------------------------------------------------------------------------
+        // PUBLIC METHODS
+        //----------------------------------------------------------------------------------
+
+        void QBVHSceneTree::destroy()
+        {
+            BVHSceneTree::destroy();
+            m_QuadNodes.clear();
+        }
+
+        SceneTreeType QBVHSceneTree::getType() const
+        {
+            return SceneTreeType::BoundingVolumeHierarchyQuadCPU;
+        }
+
+        bool QBVHSceneTree::save(File const& file) const
+        {
+            return false;
+        }
+
+        bool QBVHSceneTree::load(File const& file)
+        {
+            return false;
+        }
+
+        //----------------------------------------------------------------------------------
+        // PROTECTED METHODS
+        //----------------------------------------------------------------------------------
+
+        void QBVHSceneTree::flatten()
+        {
+            OCULAR_PROFILE()
+
+            m_QuadNodes.clear();
+            m_LinearNodes.clear();
+            m_LinearObjects.clear();
+
+            m_Cost = 0.0f;
+
+            if(m_Root && m_Root->left)
+            {
+                // Each node has up to four children, so there are roughly N/3 nodes
+
+                m_QuadNodes.reserve((m_AllObjects.size() / 3) + 1);
+                m_LinearObjects.reserve(m_AllObjects.size());
+
+                flattenQuadNode(m_Root);
+
+                // The cost is that of the binary tree, so that it remains comparable to a BVHSceneTree
+                m_Cost /= fmaxf(Math::EPSILON_FLOAT, HalfSurfaceArea(m_Root->bounds));
+            }
+        }
+
+        uint32_t QBVHSceneTree::flattenQuadNode(BVHSceneNode* node)
+        {
+            const uint32_t index = static_cast<uint32_t>(m_QuadNodes.size());
+
+            m_QuadNodes.emplace_back();
+            m_Cost += HalfSurfaceArea(node->bounds);
+
+            //------------------------------------------------------------
+            // Collapse: repeatedly replace the largest internal child with it's own two children
+
+            BVHSceneNode* children[4] = { node->left, node->right, nullptr, nullptr };
+            uint32_t numChildren = (node->right ? 2 : 1);
+
+            while(numChildren < 4)
+            {
+                int32_t largest = -1;
+                float largestArea = -1.0f;
+
+                for(uint32_t i = 0; i < numChildren; i++)
+                {
+                    if(children[i]->type != SceneNodeType::Leaf)
+                    {
+                        const float area = HalfSurfaceArea(children[i]->bounds);
+
+                        if(area > largestArea)
+                        {
+                            largest = static_cast<int32_t>(i);
+                            largestArea = area;
+                        }
+                    }
+                }
+
+                if(largest < 0)
+                {
+                    // All children are leaves
+                    break;
+                }
+
+                BVHSceneNode* collapsed = children[largest];
+                m_Cost += largestArea;
+
+                children[largest] = collapsed->left;
+                children[numChildren++] = collapsed->right;
+            }
+
+            //------------------------------------------------------------
+            // Fill in the node. Unused children are left zeroed.
+
+            QBVHNode quadNode;
+            memset(&quadNode, 0, sizeof(QBVHNode));
+
+            quadNode.numChildren = numChildren;
+
+            for(uint32_t i = 0; i < numChildren; i++)
+            {
+                const Math::Vector3f minPoint = children[i]->bounds.getMinPoint();
+                const Math::Vector3f maxPoint = children[i]->bounds.getMaxPoint();
+
+                quadNode.boundsMinX[i] = minPoint.x;
+                quadNode.boundsMinY[i] = minPoint.y;
+                quadNode.boundsMinZ[i] = minPoint.z;
+                quadNode.boundsMaxX[i] = maxPoint.x;
+                quadNode.boundsMaxY[i] = maxPoint.y;
+                quadNode.boundsMaxZ[i] = maxPoint.z;
+
+                if(children[i]->type == SceneNodeType::Leaf)
+                {
+                    m_Cost += HalfSurfaceArea(children[i]->bounds);
+
+                    children[i]->linearIndex = static_cast<uint32_t>(m_LinearObjects.size());
+                    quadNode.children[i] = children[i]->linearIndex | QBVHNode::LeafFlag;
+                    m_LinearObjects.emplace_back(children[i]->object);
+                }
+                else
+                {
+                    quadNode.children[i] = flattenQuadNode(children[i]);
+                }
+            }
+
+            // Can not hold a reference into the node array as it may have been reallocated
+            m_QuadNodes[index] = quadNode;
+
+            return index;
+        }
+
+        bool QBVHSceneTree::refitLinearNodes(std::vector<BVHSceneNode*> const& leaves)
+        {
+            return false;
+        }
+
+        //----------------------------------------------------------------------
+        // Traversal Methods
+        //----------------------------------------------------------------------
+
+        void QBVHSceneTree::findVisible(Math::Frustum const& frustum, std::vector<SceneObject*>& objects, FrustumHints* hints) const
+        {
+            float planes[6][4];
+            ExtractFrustumPlanes(frustum, planes);
+
+            TraverseQuad(m_QuadNodes, [&](QBVHNode const& node)
+            {
+                return TestFrustum(planes, node);
+            },
+            [&](uint32_t const object, QBVHNode const& node, uint32_t const child, bool const passed)
+            {
+                SceneObject* sceneObject = m_LinearObjects[object];
+
+                if(sceneObject)
+                {
+                    if(passed && sceneObject->isActive())
+                    {
+                        sceneObject->setVisible(true);
+                        objects.emplace_back(sceneObject);
+                    }
+                    else if(!passed)
+                    {
+                        sceneObject->setVisible(false);
+                    }
+                }
+            });
+        }
+
+        void QBVHSceneTree::findVisible(Math::Frustum const& frustum, OcclusionBuffer const& occlusion, std::vector<SceneObject*>& objects, FrustumHints* hints) const
+        {
+            float planes[6][4];
+            ExtractFrustumPlanes(frustum, planes);
+
+            TraverseQuad(m_QuadNodes, [&](QBVHNode const& node)
+            {
+                // Only the children that pass the SIMD frustum test are tested against the occlusion buffer
+
+                uint32_t mask = TestFrustum(planes, node);
+
+                for(uint32_t i = 0; i < node.numChildren; i++)
+                {
+                    if(mask & (1 << i))
+                    {
+                        const float boundsMin[3] = { node.boundsMinX[i], node.boundsMinY[i], node.boundsMinZ[i] };
+                        const float boundsMax[3] = { node.boundsMaxX[i], node.boundsMaxY[i], node.boundsMaxZ[i] };
+
+                        if(occlusion.isOccluded(boundsMin, boundsMax))
+                        {
+                            mask &= ~(1 << i);
+                        }
+                    }
+                }
+
+                return mask;
+            },
+            [&](uint32_t const object, QBVHNode const& node, uint32_t const child, bool const passed)
+            {
+                SceneObject* sceneObject = m_LinearObjects[object];
+
+                if(sceneObject)
+                {
+                    if(passed && sceneObject->isActive())
+                    {
+                        sceneObject->setVisible(true);
+                        objects.emplace_back(sceneObject);
+                    }
+                    else if(!passed)
+                    {
+                        sceneObject->setVisible(false);
+                    }
+                }
+            });
+        }
+
+        void QBVHSceneTree::findVisible(std::vector<Math::Frustum> const& frustums, uint32_t const first, std::vector<std::vector<SceneObject*>>& objects, std::vector<FrustumHints*> const& hints) const
+        {
+            const uint32_t numViews = std::min(32u, (static_cast<uint32_t>(frustums.size()) - first));
+
+            float planes[32][6][4];
+
+            for(uint32_t view = 0; view < numViews; view++)
+            {
+                ExtractFrustumPlanes(frustums[first + view], planes[view]);
+            }
+
+            // Single traversal for all views, in which each stack entry is a node index and the bitmask
+            // of the views that it's bounds are (at least partially) inside of.
+
+            std::vector<std::pair<uint32_t, uint32_t>> stack;
+
+            if(!m_QuadNodes.empty() && (numViews > 0))
+            {
+                stack.reserve(64);
+                stack.emplace_back(std::make_pair(0, ((numViews == 32) ? 0xFFFFFFFF : ((1u << numViews) - 1))));
+            }
+
+            while(!stack.empty())
+            {
+                QBVHNode const& node = m_QuadNodes[stack.back().first];
+                const uint32_t activeViews = stack.back().second;
+
+                stack.pop_back();
+
+                //--------------------------------------------------------
+                // Find the views that each child is visible to, testing the node only against the active views
+
+                uint32_t childViews[4] = { 0, 0, 0, 0 };
+
+                for(uint32_t view = 0; view < numViews; view++)
+                {
+                    const uint32_t viewBit = (1u << view);
+
+                    if(activeViews & viewBit)
+                    {
+                        const uint32_t mask = TestFrustum(planes[view], node);
+
+                        for(uint32_t i = 0; i < node.numChildren; i++)
+                        {
+                            if(mask & (1 << i))
+                            {
+                                childViews[i] |= viewBit;
+                            }
+                        }
+                    }
+                }
+
+                //--------------------------------------------------------
+
+                for(uint32_t i = 0; i < node.numChildren; i++)
+                {
+                    const uint32_t child = node.children[i];
+
+                    if(child & QBVHNode::LeafFlag)
+                    {
+                        SceneObject* sceneObject = m_LinearObjects[child & ~QBVHNode::LeafFlag];
+
+                        if(sceneObject)
+                        {
+                            sceneObject->setVisible(childViews[i] != 0);
+
+                            if(childViews[i] && sceneObject->isActive())
+                            {
+                                for(uint32_t view = 0; view < numViews; view++)
+                                {
+                                    if(childViews[i] & (1u << view))
+                                    {
+                                        objects[first + view].emplace_back(sceneObject);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                    else if(childViews[i])
+                    {
+                        stack.emplace_back(std::make_pair(child, childViews[i]));
+                    }
+                }
+            }
+        }
+
+        void QBVHSceneTree::findIntersections(Math::Ray const& ray, std::vector<std::pair<SceneObject*, float>>& objects) const
+        {
+            __m128 origin[3];
+            __m128 invDir[3];
+
+            PrepareRay(ray, origin, invDir);
+
+            float distances[4];
+
+            TraverseQuad(m_QuadNodes, [&](QBVHNode const& node)
+            {
+                return TestRay(origin, invDir, node, distances);
+            },
+            [&](uint32_t const object, QBVHNode const& node, uint32_t const child, bool const passed)
+            {
+                if(passed && m_LinearObjects[object])
+                {
+                    objects.emplace_back(std::make_pair(m_LinearObjects[object], distances[child]));
+                }
+            });
+        }
+
+        bool QBVHSceneTree::findIntersection(Math::Ray const& ray, RayQueryMode const mode, float const maxDistance, std::pair<SceneObject*, float>& result) const
+        {
+            bool found = false;
+            bool done = false;
+
+            __m128 origin[3];
+            __m128 invDir[3];
+
+            PrepareRay(ray, origin, invDir);
+
+            // Each stack entry is a node index and the distance at which the ray enters it
+
+            std::vector<std::pair<uint32_t, float>> stack;
+            float nearest = maxDistance;
+
+            if(!m_QuadNodes.empty())
+            {
+                stack.reserve(64);
+                stack.emplace_back(std::make_pair(0, 0.0f));
+            }
+
+            while(!stack.empty() && !done)
+            {
+                const uint32_t index = stack.back().first;
+                const float entry = stack.back().second;
+
+                stack.pop_back();
+
+                if(entry > nearest)
+                {
+                    // A nearer intersection was found since this node was pushed
+                    continue;
+                }
+
+                QBVHNode const& node = m_QuadNodes[index];
+
+                float distances[4];
+                const uint32_t mask = TestRay(origin, invDir, node, distances) & ((1 << node.numChildren) - 1);
+
+                std::pair<uint32_t, float> internals[4];
+                uint32_t numInternals = 0;
+
+                for(uint32_t i = 0; (i < node.numChildren) && !done; i++)
+                {
+                    const uint32_t child = node.children[i];
+
+                    if((mask & (1 << i)) && (distances[i] <= nearest))
+                    {
+                        if(child & QBVHNode::LeafFlag)
+                        {
+                            SceneObject* object = m_LinearObjects[child & ~QBVHNode::LeafFlag];
+
+                            if(object)
+                            {
+                                result = std::make_pair(object, distances[i]);
+                                nearest = distances[i];
+                                found = true;
+                                done = (mode == RayQueryMode::Any);
+                            }
+                        }
+                        else
+                        {
+                            // Insertion sort so that the internal children are ordered furthest to nearest
+
+                            uint32_t position = numInternals++;
+
+                            while((position > 0) && (internals[position - 1].second < distances[i]))
+                            {
+                                internals[position] = internals[position - 1];
+                                position--;
+                            }
+
+                            internals[position] = std::make_pair(child, distances[i]);
+                        }
+                    }
+                }
+
+                // The nearest child is pushed last, so that it is visited next
+
+                for(uint32_t i = 0; i < numInternals; i++)
+                {
+                    stack.emplace_back(internals[i]);
+                }
+            }
+
+            return found;
+        }
+
+        void QBVHSceneTree::findNearestObjects(Math::Vector3f const& point, uint32_t const count, float const maxDistance, std::vector<std::pair<SceneObject*, float>>& objects) const
+        {
+            // Distances are kept squared until the results are returned.
+            // Each queue entry is the squared distance to a node and the node index, nearest first.
+
+            typedef std::pair<float, uint32_t> QueueEntry;
+
+            std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+
+            const __m128 origin[3] = { _mm_set1_ps(point.x), _mm_set1_ps(point.y), _mm_set1_ps(point.z) };
+            const float maxDistanceSq = maxDistance * maxDistance;
+
+            if(!m_QuadNodes.empty() && (count > 0))
+            {
+                queue.push(QueueEntry(0.0f, 0));
+            }
+
+            while(!queue.empty())
+            {
+                const QueueEntry entry = queue.top();
+                queue.pop();
+
+                if(entry.first > ((objects.size() == count) ? objects.front().second : maxDistanceSq))
+                {
+                    // Every remaining node is at least this far away
+                    break;
+                }
+
+                QBVHNode const& node = m_QuadNodes[entry.second];
+
+                float distances[4];
+                _mm_storeu_ps(distances, DistanceSquared(origin, node));
+
+                for(uint32_t i = 0; i < node.numChildren; i++)
+                {
+                    const uint32_t child = node.children[i];
+                    const float bound = (objects.size() == count) ? objects.front().second : maxDistanceSq;
+
+                    if(distances[i] <= bound)
+                    {
+                        if(child & QBVHNode::LeafFlag)
+                        {
+                            SceneObject* object = m_LinearObjects[child & ~QBVHNode::LeafFlag];
+
+                            if(object)
+                            {
+                                InsertNearest(objects, count, object, distances[i]);
+                            }
+                        }
+                        else
+                        {
+                            queue.push(QueueEntry(distances[i], child));
+                        }
+                    }
+                }
+            }
+
+            SortNearest(objects);
+        }
+
+        void QBVHSceneTree::findIntersections(Math::BoundsSphere const& bounds, std::vector<SceneObject*>& objects) const
+        {
+            const Math::Vector3f sphereCenter = bounds.getCenter();
+            const float radius = bounds.getRadius();
+
+            const __m128 center[3] = { _mm_set1_ps(sphereCenter.x), _mm_set1_ps(sphereCenter.y), _mm_set1_ps(sphereCenter.z) };
+            const __m128 radiusSquared = _mm_set1_ps(radius * radius);
+
+            TraverseQuad(m_QuadNodes, [&](QBVHNode const& node)
+            {
+                return TestSphere(center, radiusSquared, node);
+            },
+            [&](uint32_t const object, QBVHNode const& node, uint32_t const child, bool const passed)
+            {
+                if(passed && m_LinearObjects[object])
+                {
+                    objects.emplace_back(m_LinearObjects[object]);
+                }
+            });
+        }
+
+        void QBVHSceneTree::findIntersections(Math::BoundsAABB const& bounds, std::vector<SceneObject*>& objects) const
+        {
+            const Math::Vector3f minPoint = bounds.getMinPoint();
+            const Math::Vector3f maxPoint = bounds.getMaxPoint();
+
+            const __m128 boundsMin[3] = { _mm_set1_ps(minPoint.x), _mm_set1_ps(minPoint.y), _mm_set1_ps(minPoint.z) };
+            const __m128 boundsMax[3] = { _mm_set1_ps(maxPoint.x), _mm_set1_ps(maxPoint.y), _mm_set1_ps(maxPoint.z) };
+
+            TraverseQuad(m_QuadNodes, [&](QBVHNode const& node)
+            {
+                return TestAABB(boundsMin, boundsMax, node);
+            },
+            [&](uint32_t const object, QBVHNode const& node, uint32_t const child, bool const passed)
+            {
+                if(passed && m_LinearObjects[object])
+                {
+                    objects.emplace_back(m_LinearObjects[object]);
+                }
+            });
+        }
+
+        void QBVHSceneTree::findIntersections(Math::BoundsOBB const& bounds, std::vector<SceneObject*>& objects) const
+        {
+            // Nodes are culled against the axis-aligned box that encloses the OBB.
+            // Only the leaves are tested against the OBB itself.
+
+            const Math::Vector3f center  = bounds.getCenter();
+            const Math::Vector3f extents = bounds.getExtents();
+            const Math::Vector3f dirX    = bounds.getDirectionX();
+            const Math::Vector3f dirY    = bounds.getDirectionY();
+            const Math::Vector3f dirZ    = bounds.getDirectionZ();
+
+            __m128 boundsMin[3];
+            __m128 boundsMax[3];
+
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                const float enclosingExtent = (fabs(dirX[i]) * extents.x) + (fabs(dirY[i]) * extents.y) + (fabs(dirZ[i]) * extents.z);
+
+                boundsMin[i] = _mm_set1_ps(center[i] - enclosingExtent);
+                boundsMax[i] = _mm_set1_ps(center[i] + enclosingExtent);
+            }
+
+            TraverseQuad(m_QuadNodes, [&](QBVHNode const& node)
+            {
+                return TestAABB(boundsMin, boundsMax, node);
+            },
+            [&](uint32_t const object, QBVHNode const& node, uint32_t const child, bool const passed)
+            {
+                if(passed && m_LinearObjects[object] && bounds.intersects(GetChildBounds(node, child)))
+                {
+                    objects.emplace_back(m_LinearObjects[object]);
+                }
+            });
+        }
+
+        void QBVHSceneTree::getLeafBounds(std::vector<Math::BoundsAABB>& bounds) const
+        {
+            bounds.resize(m_LinearObjects.size());
+
+            for(auto const& node : m_QuadNodes)
+            {
+                for(uint32_t child = 0; child < node.numChildren; child++)
+                {
+                    if(node.children[child] & QBVHNode::LeafFlag)
+                    {
+                        bounds[node.children[child] & ~QBVHNode::LeafFlag] = GetChildBounds(node, child);
+                    }
+                }
+            }
+        }
+
+        //----------------------------------------------------------------------------------
+        // PRIVATE METHODS
+        //----------------------------------------------------------------------------------
+    }
+}
\ No newline at end of file
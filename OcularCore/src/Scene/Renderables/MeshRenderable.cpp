@@ -22,6 +22,9 @@
 
 #include "Utilities/StringComposer.hpp"
 
+#include <cfloat>
+#include <algorithm>
+
 OCULAR_REGISTER_RENDERABLE(Ocular::Core::MeshRenderable, "MeshRenderable");
 
 //------------------------------------------------------------------------------------------
@@ -36,16 +39,20 @@ namespace Ocular
 
         MeshRenderable::MeshRenderable(std::string const& name, SceneObject* parent)
             : ARenderable(name, "MeshRenderable", parent),
-              m_Mesh(nullptr)
+              m_Mesh(nullptr),
+              m_CurrentLOD(0),
+              m_CullScreenSize(0.0f)
         {
-
+            OCULAR_EXPOSE(m_CullScreenSize);
         }
 
         MeshRenderable::MeshRenderable(std::string const& name, std::string const& type, SceneObject* parent)
             : ARenderable(name, type, parent),
-              m_Mesh(nullptr)
+              m_Mesh(nullptr),
+              m_CurrentLOD(0),
+              m_CullScreenSize(0.0f)
         {
-            
+            OCULAR_EXPOSE(m_CullScreenSize);
         }
 
         MeshRenderable::~MeshRenderable()
@@ -53,6 +60,7 @@ namespace Ocular
             // Do not delete as Mesh and Materials are shared resources
             m_Mesh = nullptr;
             m_Materials.clear();
+            m_LODs.clear();
         }
 
         //----------------------------------------------------------------------------------
@@ -87,9 +95,11 @@ namespace Ocular
 
         void MeshRenderable::render()
         {
-            if(m_Mesh)
+            Graphics::Mesh* mesh = getLODMesh(m_CurrentLOD);
+
+            if(mesh)
             {
-                const uint32_t submeshCount = m_Mesh->getNumSubMeshes();
+                const uint32_t submeshCount = mesh->getNumSubMeshes();
                 const uint32_t materialCount = getNumMaterials();
 
                 for(uint32_t i = 0; i < submeshCount; i++)
@@ -101,7 +111,7 @@ namespace Ocular
                         if(material)
                         {
                             material->bind();
-                            OcularGraphics->renderMesh(m_Mesh, i);
+                            OcularGraphics->renderMesh(mesh, i);
                         }
                     }
                 }
@@ -110,15 +120,17 @@ namespace Ocular
 
         void MeshRenderable::render(Graphics::Material* material)
         {
-            if(m_Mesh && material)
+            Graphics::Mesh* mesh = getLODMesh(m_CurrentLOD);
+
+            if(mesh && material)
             {
                 material->bind();
 
-                const uint32_t submeshCount = m_Mesh->getNumSubMeshes();
+                const uint32_t submeshCount = mesh->getNumSubMeshes();
 
                 for(uint32_t i = 0; i < submeshCount; i++)
                 {
-                    OcularGraphics->renderMesh(m_Mesh, i);
+                    OcularGraphics->renderMesh(mesh, i);
                 }
             }
         }
@@ -146,6 +158,29 @@ namespace Ocular
                         }
                     }
                 }
+
+                const BuilderNode* lodsNode = node->getChild("LODs");
+
+                if(lodsNode)
+                {
+                    const uint32_t numChildren = lodsNode->getNumChildren();
+
+                    for(uint32_t i = 0; i < numChildren; i++)
+                    {
+                        auto lodNode = lodsNode->getChild(OCULAR_STRING_COMPOSER("LOD_", i));
+
+                        if(lodNode)
+                        {
+                            auto meshNode = lodNode->getChild("Mesh");
+                            auto sizeNode = lodNode->getChild("ScreenSize");
+
+                            if(meshNode && sizeNode)
+                            {
+                                addLOD(meshNode->getValue(), OcularString->fromString<float>(sizeNode->getValue()));
+                            }
+                        }
+                    }
+                }
             }
         }
 
@@ -176,6 +211,30 @@ namespace Ocular
                         }
                     }
                 }
+
+                if(!m_LODs.empty())
+                {
+                    auto lodsNode = node->addChild("LODs", "", "");
+
+                    if(lodsNode)
+                    {
+                        uint32_t count = 0;
+
+                        for(auto const& lod : m_LODs)
+                        {
+                            if(lod.first)
+                            {
+                                auto lodNode = lodsNode->addChild(OCULAR_STRING_COMPOSER("LOD_", count++), "", "");
+
+                                if(lodNode)
+                                {
+                                    lodNode->addChild("Mesh", OCULAR_TYPE_NAME(std::string), lod.first->getMappingName());
+                                    lodNode->addChild("ScreenSize", OCULAR_TYPE_NAME(float), OcularString->toString<float>(lod.second));
+                                }
+                            }
+                        }
+                    }
+                }
             }
         }
 
@@ -255,6 +314,25 @@ namespace Ocular
             }
         }
 
+        bool MeshRenderable::updateLOD(float const screenSize)
+        {
+            m_CurrentLOD = 0;
+
+            for(uint32_t i = 0; i < static_cast<uint32_t>(m_LODs.size()); i++)
+            {
+                if(screenSize < m_LODs[i].second)
+                {
+                    m_CurrentLOD = i + 1;
+                }
+                else
+                {
+                    break;
+                }
+            }
+
+            return (screenSize >= m_CullScreenSize);
+        }
+
         uint32_t MeshRenderable::getRenderPriority() const
         {
             uint32_t result = 0;
@@ -304,6 +382,96 @@ namespace Ocular
             return m_Mesh;
         }
 
+        //----------------------------------------------------------------------------------
+        // Level of Detail Methods
+        //----------------------------------------------------------------------------------
+
+        uint32_t MeshRenderable::addLOD(Graphics::Mesh* mesh, float const screenSize)
+        {
+            // Keep the levels ordered from the largest screen size to the smallest
+
+            auto iter = std::find_if(m_LODs.begin(), m_LODs.end(), [&](std::pair<Graphics::Mesh*, float> const& lod)
+            {
+                return (lod.second < screenSize);
+            });
+
+            const uint32_t result = static_cast<uint32_t>(std::distance(m_LODs.begin(), iter)) + 1;
+            m_LODs.insert(iter, std::make_pair(mesh, screenSize));
+
+            return result;
+        }
+
+        bool MeshRenderable::addLOD(std::string const& name, float const screenSize)
+        {
+            bool result = false;
+            Graphics::Mesh* mesh = OcularResources->getResource<Graphics::Mesh>(name);
+
+            if(mesh)
+            {
+                addLOD(mesh, screenSize);
+                result = true;
+            }
+
+            return result;
+        }
+
+        void MeshRenderable::removeLOD(uint32_t const level)
+        {
+            if((level > 0) && (level <= static_cast<uint32_t>(m_LODs.size())))
+            {
+                m_LODs.erase(m_LODs.begin() + (level - 1));
+                m_CurrentLOD = 0;
+            }
+        }
+
+        uint32_t MeshRenderable::getNumLODs() const
+        {
+            return static_cast<uint32_t>(m_LODs.size()) + 1;
+        }
+
+        Graphics::Mesh* MeshRenderable::getLODMesh(uint32_t const level) const
+        {
+            Graphics::Mesh* result = nullptr;
+
+            if(level == 0)
+            {
+                result = m_Mesh;
+            }
+            else if(level <= static_cast<uint32_t>(m_LODs.size()))
+            {
+                result = m_LODs[level - 1].first;
+            }
+
+            return result;
+        }
+
+        float MeshRenderable::getLODScreenSize(uint32_t const level) const
+        {
+            float result = FLT_MAX;
+
+            if((level > 0) && (level <= static_cast<uint32_t>(m_LODs.size())))
+            {
+                result = m_LODs[level - 1].second;
+            }
+
+            return result;
+        }
+
+        uint32_t MeshRenderable::getCurrentLOD() const
+        {
+            return m_CurrentLOD;
+        }
+
+        void MeshRenderable::setCullScreenSize(float const screenSize)
+        {
+            m_CullScreenSize = screenSize;
+        }
+
+        float MeshRenderable::getCullScreenSize() const
+        {
+            return m_CullScreenSize;
+        }
+
         //----------------------------------------------------------------------------------
         // Material Methods
         //----------------------------------------------------------------------------------
@@ -21,13 +21,63 @@
 #include "Scene/SceneObject.hpp"
 #include "Scene/ARoutine.hpp"
 #include "Scene/ARenderable.hpp"
+#include "Scene/OcclusionBuffer.hpp"
 
 // SceneTree implementations
 
 #include "Scene/BVHSceneTree.hpp"
+#include "Scene/BVHSAHSceneTree.hpp"
+#include "Scene/QBVHSceneTree.hpp"
+#include "Scene/LooseOctreeSceneTree.hpp"
+#include "Scene/UniformGridSceneTree.hpp"
 #include "Graphics/Shader/Uniform/UniformBuffer.hpp"
 #include "Renderer/Renderer.hpp"
 
+#include <algorithm>
+#include <unordered_set>
+#include <cfloat>
+
+namespace
+{
+    const size_t MaxChangedObjects = 1024;    ///< Changes beyond this in a single frame invalidate every visibility cache, as a full cull is cheaper than retesting each object
+
+    /**
+     * Calculates the projected diameter of the sphere as a fraction of the viewport height.
+     *
+     * \param[in] sphere
+     * \param[in] viewProj  Combined projection * view matrix of the camera
+     * \param[in] proj      Projection matrix of the camera
+     * \param[in] ortho     TRUE if the camera uses an orthographic projection
+     */
+    float CalculateScreenSize(Ocular::Math::BoundsSphere const& sphere, Ocular::Math::Matrix4x4 const& viewProj, Ocular::Math::Matrix4x4 const& proj, bool const ortho)
+    {
+        float result = FLT_MAX;
+
+        const float radius = sphere.getRadius();
+        const float scale  = proj.getElement(5);     // Row 1, Column 1: cot(fov / 2) or 2 / (top - bottom)
+
+        if(ortho)
+        {
+            result = radius * scale;
+        }
+        else
+        {
+            // Clip-space w is the view-space distance in front of the camera
+
+            Ocular::Math::Vector3f const& center = sphere.getCenter();
+
+            const float w = (viewProj.getElement(12) * center.x) + (viewProj.getElement(13) * center.y) + (viewProj.getElement(14) * center.z) + viewProj.getElement(15);
+
+            if(w > radius)
+            {
+                result = (radius * scale) / w;
+            }
+        }
+
+        return result;
+    }
+}
+
 //------------------------------------------------------------------------------------------
 
 namespace Ocular
@@ -45,7 +95,11 @@ namespace Ocular
             m_DynamicTreeType(SceneTreeType::BoundingVolumeHierarchyCPU),
             m_StaticSceneTree(nullptr),
             m_DynamicSceneTree(nullptr),
-            m_Renderer(nullptr)
+            m_Renderer(nullptr),
+            m_OcclusionBuffer(nullptr),
+            m_MinScreenPixels(0.0f),
+            m_Revision(0),
+            m_RenderFrame(0)
         {
 
         }
@@ -55,6 +109,9 @@ namespace Ocular
             delete m_Renderer;
             m_Renderer = nullptr;
 
+            delete m_OcclusionBuffer;
+            m_OcclusionBuffer = nullptr;
+
             //------------------------------------------------------------
             // Tell the routines the scene is ending
 
@@ -105,7 +162,22 @@ namespace Ocular
             {
             case SceneTreeType::BoundingVolumeHierarchyCPU:
                 m_StaticSceneTree = new BVHSceneTree();
-                m_DynamicSceneTree = new BVHSceneTree();
+                break;
+
+            case SceneTreeType::BoundingVolumeHierarchySAHCPU:
+                m_StaticSceneTree = new BVHSAHSceneTree();
+                break;
+
+            case SceneTreeType::BoundingVolumeHierarchyQuadCPU:
+                m_StaticSceneTree = new QBVHSceneTree();
+                break;
+
+            case SceneTreeType::OctTreeCPU:
+                m_StaticSceneTree = new LooseOctreeSceneTree();
+                break;
+
+            case SceneTreeType::UniformGridCPU:
+                m_StaticSceneTree = new UniformGridSceneTree();
                 break;
 
             default:
@@ -120,6 +192,22 @@ namespace Ocular
                 m_DynamicSceneTree = new BVHSceneTree();
                 break;
 
+            case SceneTreeType::BoundingVolumeHierarchySAHCPU:
+                m_DynamicSceneTree = new BVHSAHSceneTree();
+                break;
+
+            case SceneTreeType::BoundingVolumeHierarchyQuadCPU:
+                m_DynamicSceneTree = new QBVHSceneTree();
+                break;
+
+            case SceneTreeType::OctTreeCPU:
+                m_DynamicSceneTree = new LooseOctreeSceneTree();
+                break;
+
+            case SceneTreeType::UniformGridCPU:
+                m_DynamicSceneTree = new UniformGridSceneTree();
+                break;
+
             default:
                 m_DynamicSceneTree = nullptr;
                 OcularLogger->error("Unsupported SceneTree Type specified for new Dynamic SceneTree", OCULAR_INTERNAL_LOG("Scene", "Scene"));
@@ -140,6 +228,13 @@ namespace Ocular
                     m_DynamicSceneTree->addObject(object);
                 }
 
+                if(object->isOccluder())
+                {
+                    m_Occluders.emplace_back(object);
+                }
+
+                m_Revision++;
+
                 auto routines = object->getAllRoutines();
 
                 for(auto routine : routines)
@@ -184,6 +279,9 @@ namespace Ocular
                     m_DynamicSceneTree->removeObject(object);
                 }
 
+                m_Occluders.erase(std::remove(m_Occluders.begin(), m_Occluders.end(), object), m_Occluders.end());
+                m_Revision++;
+
                 //--------------------------------------------------------
                 // Remove it's Routines
 
@@ -219,6 +317,9 @@ namespace Ocular
             }
 
             m_Routines.clear();
+            m_Occluders.clear();
+
+            m_Revision++;
         }
 
         void Scene::update()
@@ -234,46 +335,140 @@ namespace Ocular
                 //m_UniformBufferPerFrame->bind();
             //}
 
+            m_RenderFrame++;
+
             if(m_Renderer)
             {
                 auto cameras = OcularCameras->getCameras();
 
                 if(cameras.size())
                 {
+                    //----------------------------------------------------
+                    // Reuse the visible set of every camera whose view has not changed
+                    //----------------------------------------------------
+
+                    std::vector<Camera*> stale;
+                    std::vector<Math::Frustum> frustums;
+
                     for(auto camera : cameras)
                     {
-                        //------------------------------------------------
-                        // Perform simple Frustum Culling on the SceneObjects
-                        //------------------------------------------------
+                        if(!updateVisibilityCache(camera))
+                        {
+                            stale.emplace_back(camera);
+                            frustums.emplace_back(camera->getFrustum());
+                        }
+                    }
 
-                        OcularCameras->setActiveCamera(camera);
-                        const Math::Frustum frustum = camera->getFrustum();
+                    if(!stale.empty())
+                    {
+                        std::vector<std::vector<SceneObject*>> visible;
+
+                        if(m_OcclusionBuffer)
+                        {
+                            //------------------------------------------------
+                            // Perform Frustum and Occlusion Culling for each camera
+                            //------------------------------------------------
+
+                            visible.resize(stale.size());
+
+                            for(uint32_t i = 0; i < static_cast<uint32_t>(stale.size()); i++)
+                            {
+                                getUnoccludedObjects(stale[i], frustums[i], visible[i]);
+                            }
+                        }
+                        else
+                        {
+                            //------------------------------------------------
+                            // Perform Frustum Culling for every camera in a single pass
+                            //------------------------------------------------
+
+                            std::vector<FrustumHints*> staticHints;
+                            std::vector<FrustumHints*> dynamicHints;
+
+                            staticHints.reserve(stale.size());
+                            dynamicHints.reserve(stale.size());
+
+                            for(auto camera : stale)
+                            {
+                                VisibilityCache& cache = m_VisibilityCaches[camera];
+
+                                staticHints.emplace_back(&cache.staticHints);
+                                dynamicHints.emplace_back(&cache.dynamicHints);
+                            }
 
-                        std::vector<SceneObject*> objects;
+                            if(m_StaticSceneTree)
+                            {
+                                m_StaticSceneTree->getAllVisibleObjects(frustums, visible, staticHints);
+                            }
+
+                            if(m_DynamicSceneTree)
+                            {
+                                m_DynamicSceneTree->getAllVisibleObjects(frustums, visible, dynamicHints);
+                            }
+                        }
+
+                        visible.resize(stale.size());
 
-                        if(m_StaticSceneTree)
+                        for(uint32_t i = 0; i < static_cast<uint32_t>(stale.size()); i++)
                         {
-                            //m_StaticSceneTree->getAllVisibleObjects(frustum, objects);
+                            m_VisibilityCaches[stale[i]].objects.swap(visible[i]);
                         }
+                    }
+
+                    //----------------------------------------------------
+                    // Discard the caches of any cameras that no longer exist
+                    //----------------------------------------------------
 
-                        if(m_DynamicSceneTree)
+                    for(auto iter = m_VisibilityCaches.begin(); iter != m_VisibilityCaches.end(); )
+                    {
+                        if(std::find(cameras.begin(), cameras.end(), iter->first) == cameras.end())
                         {
-                            m_DynamicSceneTree->getAllVisibleObjects(frustum, objects);
+                            iter = m_VisibilityCaches.erase(iter);
                         }
+                        else
+                        {
+                            ++iter;
+                        }
+                    }
+
+                    std::vector<SceneObject*> objects;
+
+                    for(auto camera : cameras)
+                    {
+                        OcularCameras->setActiveCamera(camera);
 
                         //------------------------------------------------
-                        // Remove any SceneObjects that can't be rendered
+                        // Remove any SceneObjects that can't be rendered,
+                        // and select the LOD of those that can
                         //------------------------------------------------
 
-                        for(auto iter = objects.begin(); iter != objects.end(); )
+                        std::vector<SceneObject*> const& visible = m_VisibilityCaches[camera].objects;
+
+                        Math::Matrix4x4 const& projMatrix = camera->getProjectionMatrix();
+                        const Math::Matrix4x4 viewProjMatrix = projMatrix * camera->getViewMatrix();
+                        const bool ortho = (camera->getProjectionType() == ProjectionType::Orthographic);
+
+                        // Without a viewport the pixel size of an object is unknown, so small object culling is skipped
+
+                        Graphics::Viewport* viewport = camera->getViewport();
+                        const float viewportHeight = (viewport ? viewport->getHeight() : 0.0f);
+                        const bool cullSmall = (viewportHeight > 0.0f) && (m_MinScreenPixels > 0.0f);
+
+                        objects.clear();
+                        objects.reserve(visible.size());
+
+                        for(auto object : visible)
                         {
-                            if((*iter)->getRenderable() == nullptr)
-                            {
-                                iter = objects.erase(iter);
-                            }
-                            else
+                            ARenderable* renderable = object->getRenderable();
+
+                            if(renderable)
                             {
-                                ++iter;
+                                const float screenSize = CalculateScreenSize(object->getBoundsSphere(false), viewProjMatrix, projMatrix, ortho);
+
+                                if((!cullSmall || ((screenSize * viewportHeight) >= m_MinScreenPixels)) && renderable->updateLOD(screenSize))
+                                {
+                                    objects.emplace_back(object);
+                                }
                             }
                         }
 
@@ -285,6 +480,10 @@ namespace Ocular
                     }
                 }
             }
+
+            // Every cache is now up to date with the changes made during the previous frame
+
+            m_ChangedObjects.clear();
         }
 
         //----------------------------------------------------------------------------------
@@ -337,6 +536,67 @@ namespace Ocular
             return m_RendererType;
         }
 
+        bool Scene::saveStaticTree(File const& file)
+        {
+            bool result = false;
+            BVHSceneTree* tree = dynamic_cast<BVHSceneTree*>(m_StaticSceneTree);
+
+            if(tree)
+            {
+                tree->restructure();
+                result = tree->save(file);
+            }
+
+            return result;
+        }
+
+        bool Scene::loadStaticTree(File const& file)
+        {
+            bool result = false;
+            BVHSceneTree* tree = dynamic_cast<BVHSceneTree*>(m_StaticSceneTree);
+
+            if(tree)
+            {
+                result = tree->load(file);
+                m_Revision++;
+            }
+
+            return result;
+        }
+
+        void Scene::setOcclusionCulling(bool const enabled)
+        {
+            if(enabled && !m_OcclusionBuffer)
+            {
+                m_OcclusionBuffer = new OcclusionBuffer();
+            }
+            else if(!enabled)
+            {
+                delete m_OcclusionBuffer;
+                m_OcclusionBuffer = nullptr;
+            }
+        }
+
+        bool Scene::isOcclusionCullingEnabled() const
+        {
+            return (m_OcclusionBuffer != nullptr);
+        }
+
+        OcclusionBuffer* Scene::getOcclusionBuffer() const
+        {
+            return m_OcclusionBuffer;
+        }
+
+        void Scene::setSmallObjectCulling(float const pixels)
+        {
+            m_MinScreenPixels = pixels;
+        }
+
+        float Scene::getSmallObjectCulling() const
+        {
+            return m_MinScreenPixels;
+        }
+
         //----------------------------------------------------------------------------------
         // PROTECTED METHODS
         //----------------------------------------------------------------------------------
@@ -345,7 +605,7 @@ namespace Ocular
         {
             if(verifySceneTrees())
             {
-                //m_StaticSceneTree->restructure();
+                m_StaticSceneTree->restructure();
                 m_DynamicSceneTree->restructure();
             }
         }
@@ -395,10 +655,108 @@ namespace Ocular
             return m_DynamicSceneTree;
         }
 
+        void Scene::getUnoccludedObjects(Camera* camera, Math::Frustum const& frustum, std::vector<SceneObject*>& objects)
+        {
+            m_OcclusionBuffer->clear(camera->getProjectionMatrix() * camera->getViewMatrix());
+
+            for(auto occluder : m_Occluders)
+            {
+                if(occluder->isActive() && frustum.contains(occluder->getBoundsAABB(false)))
+                {
+                    m_OcclusionBuffer->addOccluder(occluder);
+                }
+            }
+
+            m_OcclusionBuffer->rasterize();
+
+            VisibilityCache& cache = m_VisibilityCaches[camera];
+
+            if(m_StaticSceneTree)
+            {
+                m_StaticSceneTree->getAllVisibleObjects(frustum, *m_OcclusionBuffer, objects, &cache.staticHints);
+            }
+
+            if(m_DynamicSceneTree)
+            {
+                m_DynamicSceneTree->getAllVisibleObjects(frustum, *m_OcclusionBuffer, objects, &cache.dynamicHints);
+            }
+        }
+
+        bool Scene::updateVisibilityCache(Camera* camera)
+        {
+            bool result = false;
+
+            VisibilityCache& cache = m_VisibilityCaches[camera];
+
+            Math::Matrix4x4 const& viewMatrix = camera->getViewMatrix();
+            Math::Matrix4x4 const& projMatrix = camera->getProjectionMatrix();
+
+            const bool occlusion = (m_OcclusionBuffer != nullptr);
+
+            // The changed objects only cover the previous frame, so the cache must have been updated on it
+
+            if(cache.isValid && ((cache.frame + 1) == m_RenderFrame) && (cache.revision == m_Revision) && (cache.occlusion == occlusion) &&
+               (cache.viewMatrix == viewMatrix) && (cache.projMatrix == projMatrix))
+            {
+                if(m_ChangedObjects.empty())
+                {
+                    result = true;
+                }
+                else if(!occlusion)
+                {
+                    updateChangedObjects(camera->getFrustum(), cache.objects);
+                    result = true;
+                }
+            }
+
+            cache.viewMatrix = viewMatrix;
+            cache.projMatrix = projMatrix;
+            cache.revision   = m_Revision;
+            cache.frame      = m_RenderFrame;
+            cache.occlusion  = occlusion;
+            cache.isValid    = true;
+
+            return result;
+        }
+
+        void Scene::updateChangedObjects(Math::Frustum const& frustum, std::vector<SceneObject*>& objects)
+        {
+            std::unordered_set<SceneObject*> changed;
+            changed.reserve(m_ChangedObjects.size());
+
+            for(auto const& uuid : m_ChangedObjects)
+            {
+                SceneObject* object = OcularScene->findObject(uuid);
+
+                if(object)
+                {
+                    changed.insert(object);
+                }
+            }
+
+            objects.erase(std::remove_if(objects.begin(), objects.end(), [&](SceneObject* object)
+            {
+                return (changed.find(object) != changed.end());
+            }), objects.end());
+
+            for(auto object : changed)
+            {
+                const bool inScene = verifySceneTrees() && (m_StaticSceneTree->containsObject(object, true) || m_DynamicSceneTree->containsObject(object, true));
+
+                if(inScene && object->isActive() && frustum.contains(object->getBoundsAABB(false)))
+                {
+                    object->setVisible(true);
+                    objects.emplace_back(object);
+                }
+            }
+        }
+
         void Scene::objectTreeChanged(SceneObject* object)
         {
             if(object && verifySceneTrees())
             {
+                m_Revision++;
+
                 if(object->isStatic())
                 {
                     // Was dynamic, is now static.
@@ -414,10 +772,39 @@ namespace Ocular
             }
         }
 
+        void Scene::objectOccluderChanged(SceneObject* object)
+        {
+            if(object)
+            {
+                auto find = std::find(m_Occluders.begin(), m_Occluders.end(), object);
+
+                if(object->isOccluder() && (find == m_Occluders.end()))
+                {
+                    m_Occluders.emplace_back(object);
+                }
+                else if(!object->isOccluder() && (find != m_Occluders.end()))
+                {
+                    m_Occluders.erase(find);
+                }
+
+                m_Revision++;
+            }
+        }
+
+        void Scene::objectActiveChanged(SceneObject* object)
+        {
+            if(object)
+            {
+                triggerObjectDirty(object->getUUID(), object->isStatic());
+            }
+        }
+
         void Scene::objectParentChanged(SceneObject* object, SceneObject* oldParent)
         {
             if(object && verifySceneTrees())
             {
+                m_Revision++;
+
                 /**
                  * A change in object parentage can have an effect on the SceneTrees.
                  * 
@@ -497,6 +884,16 @@ namespace Ocular
         
         void Scene::triggerObjectDirty(UUID const& uuid, bool const staticObject)
         {
+            if(m_ChangedObjects.size() < MaxChangedObjects)
+            {
+                m_ChangedObjects.emplace_back(uuid);
+            }
+            else
+            {
+                m_ChangedObjects.clear();
+                m_Revision++;
+            }
+
             if(staticObject)
             {
                 if(m_StaticSceneTree)
@@ -27,6 +27,21 @@
 
 //------------------------------------------------------------------------------------------
 
+namespace
+{
+    const std::string StaticTreeExtension = ".obvh";
+
+    /**
+     * Returns the file that the static tree of the specified scene file is saved alongside it to.
+     */
+    Ocular::Core::File GetStaticTreeFile(Ocular::Core::File const& sceneFile)
+    {
+        return Ocular::Core::File(sceneFile.getDirectory() + "/" + sceneFile.getName() + StaticTreeExtension);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+
 namespace Ocular
 {
     namespace Core
@@ -314,6 +329,81 @@ namespace Ocular
             }
         }
 
+        bool SceneManager::getIntersection(Math::Ray const& ray, RayQueryMode const mode, std::pair<SceneObject*, float>& result, float const maxDistance) const
+        {
+            bool found = false;
+
+            result = std::make_pair(nullptr, maxDistance);
+
+            if(m_Scene)
+            {
+                auto staticTree = m_Scene->getStaticTree();
+                auto dynamicTree = m_Scene->getDynamicTree();
+
+                if(staticTree)
+                {
+                    found = staticTree->getIntersection(ray, mode, result, maxDistance);
+                }
+
+                if(dynamicTree && !(found && (mode == RayQueryMode::Any)))
+                {
+                    // Only an intersection nearer than the static result is of interest
+
+                    std::pair<SceneObject*, float> dynamicResult;
+
+                    if(dynamicTree->getIntersection(ray, mode, dynamicResult, result.second))
+                    {
+                        result = dynamicResult;
+                        found = true;
+                    }
+                }
+            }
+
+            return found;
+        }
+
+        void SceneManager::getIntersections(std::vector<Math::Ray> const& rays, RayQueryMode const mode, std::vector<std::pair<SceneObject*, float>>& results, std::vector<float> const& maxDistances) const
+        {
+            results.assign(rays.size(), std::make_pair(nullptr, FLT_MAX));
+
+            if(m_Scene)
+            {
+                auto staticTree = m_Scene->getStaticTree();
+                auto dynamicTree = m_Scene->getDynamicTree();
+
+                std::vector<std::pair<SceneObject*, float>> staticResults;
+                std::vector<std::pair<SceneObject*, float>> dynamicResults;
+
+                if(staticTree)
+                {
+                    staticTree->getIntersections(rays, mode, staticResults, maxDistances);
+                }
+
+                if(dynamicTree)
+                {
+                    dynamicTree->getIntersections(rays, mode, dynamicResults, maxDistances);
+                }
+
+                //------------------------------------------------------------
+                // Keep the nearer result of the two trees for each ray
+
+                for(size_t i = 0; i < rays.size(); i++)
+                {
+                    const bool staticHit  = (i < staticResults.size())  && (staticResults[i].first != nullptr);
+                    const bool dynamicHit = (i < dynamicResults.size()) && (dynamicResults[i].first != nullptr);
+
+                    if(staticHit && (!dynamicHit || (staticResults[i].second <= dynamicResults[i].second)))
+                    {
+                        results[i] = staticResults[i];
+                    }
+                    else if(dynamicHit)
+                    {
+                        results[i] = dynamicResults[i];
+                    }
+                }
+            }
+        }
+
         void SceneManager::getIntersections(Math::BoundsSphere const& bounds, std::vector<SceneObject*>& objects) const
         {
             if(m_Scene)
@@ -407,6 +497,35 @@ namespace Ocular
             }
         }
 
+        void SceneManager::getOverlappingPairs(std::vector<std::pair<SceneObject*, SceneObject*>>& pairs) const
+        {
+            pairs.clear();
+
+            if(m_Scene)
+            {
+                std::vector<std::pair<SceneObject*, SceneObject*>> dynamicPairs;
+                std::vector<std::pair<SceneObject*, SceneObject*>> staticPairs;
+
+                auto staticTree = m_Scene->getStaticTree();
+                auto dynamicTree = m_Scene->getDynamicTree();
+
+                if(dynamicTree)
+                {
+                    dynamicTree->getOverlappingPairs(dynamicPairs);
+
+                    if(staticTree)
+                    {
+                        dynamicTree->getOverlappingPairs(staticTree, staticPairs);
+                    }
+                }
+
+                pairs.reserve(dynamicPairs.size() + staticPairs.size());
+
+                pairs.insert(pairs.end(), dynamicPairs.begin(), dynamicPairs.end());
+                pairs.insert(pairs.end(), staticPairs.begin(), staticPairs.end());
+            }
+        }
+
         void SceneManager::createScene(std::string const& name, SceneTreeType const staticType, SceneTreeType const dynamicType)
         {
             /**
@@ -454,6 +573,19 @@ namespace Ocular
 
             loadPersistentObjects();
 
+            if(result)
+            {
+                // A saved static tree that is older than the scene may no longer match it.
+                // If it does not match, the static tree is simply built as normal.
+
+                const File treeFile = GetStaticTreeFile(file);
+
+                if(treeFile.exists() && (treeFile.getLastModifiedTime() >= file.getLastModifiedTime()))
+                {
+                    m_Scene->loadStaticTree(treeFile);
+                }
+            }
+
             return result;
         }
 
@@ -464,6 +596,11 @@ namespace Ocular
             if(m_Scene)
             {
                 result = SceneSaver::Save(m_Scene, file);
+
+                if(result)
+                {
+                    m_Scene->saveStaticTree(GetStaticTreeFile(file));
+                }
             }
 
             return result;
@@ -494,6 +631,11 @@ namespace Ocular
             return m_RendererFactory;
         }
 
+        TransformSystem& SceneManager::getTransformSystem()
+        {
+            return m_TransformSystem;
+        }
+
         //----------------------------------------------------------------------------------
         // PROTECTED METHODS
         //----------------------------------------------------------------------------------
@@ -590,6 +732,33 @@ namespace Ocular
             {
                 m_Scene->update();
             }
+
+            updateBounds();
+        }
+
+        void SceneManager::updateBounds()
+        {
+            OCULAR_PROFILE()
+
+            m_TransformSystem.update();
+
+            const uint32_t dirtyFlags = static_cast<uint32_t>(Math::Transform::DirtyFlags::Position) |
+                                        static_cast<uint32_t>(Math::Transform::DirtyFlags::Rotation) |
+                                        static_cast<uint32_t>(Math::Transform::DirtyFlags::Scale);
+
+            // The first build of a new object is not reported. A SceneTree that holds the object already
+            // retrieved it's bounds (forcing that build), so notifying it would only dirty the tree.
+
+            for(auto handle : m_TransformSystem.getUpdatedHandles())
+            {
+                SceneObject* object = m_TransformSystem.getOwner(handle);
+
+                if(object)
+                {
+                    object->updateBounds(dirtyFlags);
+                    triggerObjectDirty(object->getUUID(), object->isStatic());
+                }
+            }
         }
 
         void SceneManager::render()
@@ -604,7 +773,10 @@ namespace Ocular
         {
             if(object)
             {
-
+                if(m_Scene)
+                {
+                    m_Scene->objectActiveChanged(object);
+                }
             }
         }
 
@@ -627,6 +799,17 @@ namespace Ocular
             }
         }
 
+        void SceneManager::objectOccluderChanged(SceneObject* object)
+        {
+            if(object)
+            {
+                if(m_Scene)
+                {
+                    m_Scene->objectOccluderChanged(object);
+                }
+            }
+        }
+
         void SceneManager::objectAddedRoutine(ARoutine* routine)
         {
             if(routine)
@@ -25,6 +25,13 @@
 
 OCULAR_REGISTER_SCENEOBJECT(Ocular::Core::SceneObject, "SceneObject");
 
+namespace
+{
+    const uint32_t AllDirtyFlags = static_cast<uint32_t>(Ocular::Math::Transform::DirtyFlags::Position) |
+                                   static_cast<uint32_t>(Ocular::Math::Transform::DirtyFlags::Rotation) |
+                                   static_cast<uint32_t>(Ocular::Math::Transform::DirtyFlags::Scale);
+}
+
 //------------------------------------------------------------------------------------------
 
 namespace Ocular
@@ -41,15 +48,20 @@ namespace Ocular
               m_IsActive(true),
               m_IsVisible(false),
               m_ForcedVisible(false),
+              m_IsOccluder(false),
               m_Persists(false),
               m_Renderable(nullptr),
               m_Parent(nullptr),
-              m_Layer(0)
+              m_Layer(0),
+              m_TransformHandle(OcularScene->getTransformSystem().create(this)),
+              m_IsBoundsDirty(true),
+              m_IsUniformDirty(true)
         {
             OcularScene->addObject(this, parent);
             
             OCULAR_EXPOSE(m_IsStatic);
             OCULAR_EXPOSE(m_ForcedVisible);
+            OCULAR_EXPOSE(m_IsOccluder);
             OCULAR_EXPOSE(m_Transform);
         }
 
@@ -59,15 +71,20 @@ namespace Ocular
               m_IsActive(true),
               m_IsVisible(false),
               m_ForcedVisible(false),
+              m_IsOccluder(false),
               m_Persists(false),
               m_Renderable(nullptr),
               m_Parent(nullptr),
-              m_Layer(0)
+              m_Layer(0),
+              m_TransformHandle(OcularScene->getTransformSystem().create(this)),
+              m_IsBoundsDirty(true),
+              m_IsUniformDirty(true)
         {
             OcularScene->addObject(this);
 
             OCULAR_EXPOSE(m_IsStatic);
             OCULAR_EXPOSE(m_ForcedVisible);
+            OCULAR_EXPOSE(m_IsOccluder);
             OCULAR_EXPOSE(m_Transform);
         }
 
@@ -133,6 +150,11 @@ namespace Ocular
                 delete m_Renderable;
                 m_Renderable = nullptr;
             }
+
+            //------------------------------------------------------------
+            // Release the cached matrices
+
+            OcularScene->getTransformSystem().destroy(m_TransformHandle);
         }
 
         //----------------------------------------------------------------------------------
@@ -147,7 +169,7 @@ namespace Ocular
         {
             if(Utils::String::IsEqual(varName, "m_Transform"))
             {
-                updateBounds(m_Transform.getDirtyFlags());
+                updateTransform();
             }
         }
 
@@ -245,6 +267,20 @@ namespace Ocular
             return m_IsStatic;
         }
 
+        void SceneObject::setOccluder(bool isOccluder)
+        {
+            if(m_IsOccluder != isOccluder)
+            {
+                m_IsOccluder = isOccluder;
+                OcularScene->objectOccluderChanged(this);
+            }
+        }
+
+        bool SceneObject::isOccluder() const
+        {
+            return m_IsOccluder;
+        }
+
         void SceneObject::setPersistent(bool persists)
         {
             m_Persists = persists;
@@ -257,15 +293,35 @@ namespace Ocular
 
         Graphics::UniformPerObject const& SceneObject::getUniformData(Math::Matrix4x4 const& viewMatrix, Math::Matrix4x4 const& projMatrix)
         {
-            m_UniformData.modelMatrix = getModelMatrix(false);
+            getModelUniformData(m_UniformData);
 
             m_UniformData.modelViewMatrix     = viewMatrix * m_UniformData.modelMatrix;
             m_UniformData.modelViewProjMatrix = projMatrix * m_UniformData.modelViewMatrix;
-            m_UniformData.normalMatrix        = m_UniformData.modelMatrix.getInverse().getTranspose();
 
             return m_UniformData;
         }
 
+        void SceneObject::getModelUniformData(Graphics::UniformPerObject& data)
+        {
+            updateTransform();
+
+            if(m_IsUniformDirty)
+            {
+                // The inverse is by far the most expensive part of the uniform data, so is only rebuilt as needed
+
+                m_UniformData.modelMatrix  = getModelMatrix(false);
+                m_UniformData.normalMatrix = m_UniformData.modelMatrix.getInverse().getTranspose();
+
+                m_IsUniformDirty = false;
+            }
+
+            if(&data != &m_UniformData)
+            {
+                data.modelMatrix  = m_UniformData.modelMatrix;
+                data.normalMatrix = m_UniformData.normalMatrix;
+            }
+        }
+
         //----------------------------------------------------------------
         // Movement and Rotation Methods
         //----------------------------------------------------------------
@@ -273,13 +329,13 @@ namespace Ocular
         void SceneObject::setPosition(float const x, float const y, float const z)
         {
             m_Transform.setPosition(x, y, z);
-            updateBounds(m_Transform.getDirtyFlags());
+            updateTransform();
         }
 
         void SceneObject::setPosition(Math::Vector3f const& position)
         {
             m_Transform.setPosition(position);
-            updateBounds(m_Transform.getDirtyFlags());
+            updateTransform();
         }
 
         Math::Vector3f SceneObject::getPosition(bool const local) const
@@ -302,49 +358,49 @@ namespace Ocular
         void SceneObject::translate(Math::Vector3f const& translation, bool local)
         {
             m_Transform.translate(translation, local);
-            updateBounds(m_Transform.getDirtyFlags());
+            updateTransform();
         }
 
         void SceneObject::moveForward(float const distance)
         {
             m_Transform.moveForward(distance);
-            updateBounds(m_Transform.getDirtyFlags());
+            updateTransform();
         }
 
         void SceneObject::moveUp(float const distance)
         {
             m_Transform.moveUp(distance);
-            updateBounds(m_Transform.getDirtyFlags());
+            updateTransform();
         }
 
         void SceneObject::moveRight(float const distance)
         {
             m_Transform.moveRight(distance);
-            updateBounds(m_Transform.getDirtyFlags());
+            updateTransform();
         }
 
         void SceneObject::rotate(float const angle, Math::Vector3f const& axis)
         {
             m_Transform.rotate(angle, axis);
-            updateBounds(m_Transform.getDirtyFlags());
+            updateTransform();
         }
 
         void SceneObject::rotate(Math::Quaternion const& rotation)
         {
             m_Transform.rotate(rotation);
-            updateBounds(m_Transform.getDirtyFlags());
+            updateTransform();
         }
 
         void SceneObject::resetRotation()
         {
             m_Transform.setRotation(Math::Quaternion());
-            updateBounds(m_Transform.getDirtyFlags());
+            updateTransform();
         }
 
         void SceneObject::setRotation(Math::Quaternion const& rotation)
         {
             m_Transform.setRotation(rotation);
-            updateBounds(m_Transform.getDirtyFlags());
+            updateTransform();
         }
 
         Math::Quaternion const& SceneObject::getRotation() const
@@ -355,13 +411,13 @@ namespace Ocular
         void SceneObject::setScale(Math::Vector3f const& scale)
         {
             m_Transform.setScale(scale);
-            updateBounds(m_Transform.getDirtyFlags());
+            updateTransform();
         }
 
         void SceneObject::setScale(float const xScale, float const yScale, float const zScale)
         {
             m_Transform.setScale(Math::Vector3f(xScale, yScale, zScale));
-            updateBounds(m_Transform.getDirtyFlags());
+            updateTransform();
         }
 
         Math::Vector3f SceneObject::getScale(bool const local) const
@@ -383,15 +439,17 @@ namespace Ocular
         {
             m_Transform = transform;
 
-            updateBounds(static_cast<uint32_t>(Math::Transform::DirtyFlags::Position) | 
-                         static_cast<uint32_t>(Math::Transform::DirtyFlags::Rotation) | 
-                         static_cast<uint32_t>(Math::Transform::DirtyFlags::Scale));
+            // The copied transform may carry the dirty flags of it's source. Clear them, as it is synced
+            // immediately below, and a later updateTransform would otherwise sync it a second time.
+            m_Transform.getDirtyFlags(true);
+
+            syncTransform();
         }
 
         void SceneObject::lookAt(Math::Vector3f const& point)
         {
             m_Transform.lookAt(point);
-            updateBounds(m_Transform.getDirtyFlags());
+            updateTransform();
         }
 
         Math::Transform const& SceneObject::getTransform() const
@@ -402,22 +460,37 @@ namespace Ocular
         Math::Matrix4x4 SceneObject::getModelMatrix(bool const local) const
         {
             Math::Matrix4x4 result;
-            const Math::Matrix4x4 localMatrix = m_Transform.getModelMatrix();
 
             if(local)
             {
-                result = localMatrix;
+                result = m_Transform.getModelMatrix();
             }
             else
             {
-                Math::Matrix4x4 parentMatrix;
+                TransformSystem& transforms = OcularScene->getTransformSystem();
 
-                if(m_Parent)
+                if(m_Transform.isDirty())
                 {
-                    parentMatrix = m_Parent->getModelMatrix(false);
+                    // Transform was modified directly and the change has not yet been applied to the bounds
+                    syncTransform();
+                }
+
+                if(transforms.isDirty(m_TransformHandle))
+                {
+                    if(m_Parent)
+                    {
+                        float parentWorld[16];
+                        m_Parent->getModelMatrix(false).getData(parentWorld);
+
+                        transforms.updateWorldMatrix(m_TransformHandle, parentWorld);
+                    }
+                    else
+                    {
+                        transforms.updateWorldMatrix(m_TransformHandle, nullptr);
+                    }
                 }
 
-                result = parentMatrix * localMatrix;
+                transforms.getWorldMatrix(m_TransformHandle, result);
             }
 
             return result;
@@ -451,6 +524,8 @@ namespace Ocular
                     }
 
                     m_Parent = parent;
+                    syncTransformParent();
+
                     forceBoundsRebuild();
                 }
             }
@@ -486,6 +561,7 @@ namespace Ocular
                 }
 
                 child->m_Parent = this;
+                child->syncTransformParent();
                 child->setActive(isActive());
                 child->setForcedVisible(isForcedVisible());
                 child->setStatic(isStatic());
@@ -555,6 +631,7 @@ namespace Ocular
                         m_Children.erase(iter);
 
                         child->m_Parent = nullptr;
+                        child->syncTransformParent();
                         OcularScene->objectParentChanged(child, this);
 
                         break;
@@ -581,6 +658,7 @@ namespace Ocular
                         m_Children.erase(iter);
 
                         child->m_Parent = nullptr;
+                        child->syncTransformParent();
                         OcularScene->objectParentChanged(child, this);
 
                         break;
@@ -605,6 +683,7 @@ namespace Ocular
                     m_Children.erase(iter);
 
                     child->m_Parent = nullptr;
+                    child->syncTransformParent();
                     OcularScene->objectParentChanged(child, this);
 
                     break;
@@ -831,6 +910,7 @@ namespace Ocular
             const UUID old = m_UUID;
 
             Object::onLoad(node);
+            syncTransform();
 
             if(old != m_UUID)
             {
@@ -992,65 +1072,25 @@ namespace Ocular
                 m_Renderable->buildBounds(&m_BoundsSphereLocal, &m_BoundsAABBLocal, &m_BoundsOBBLocal);
             }
 
-            updateBounds(static_cast<uint32_t>(Math::Transform::DirtyFlags::Position) | 
-                         static_cast<uint32_t>(Math::Transform::DirtyFlags::Rotation) | 
-                         static_cast<uint32_t>(Math::Transform::DirtyFlags::Scale));
+            // The world bounds are rebuilt along with the world matrix, either lazily or at the end of SceneManager::update
+            OcularScene->getTransformSystem().setLocalBounds(m_TransformHandle, m_BoundsSphereLocal, m_BoundsAABBLocal, m_BoundsOBBLocal);
+            m_IsBoundsDirty = true;
         }
 
         void SceneObject::updateBounds(uint32_t const dirtyFlags)
         {
             if(dirtyFlags)
             {
-                const Math::Matrix4x4 modelMatrix = getModelMatrix(false); 
-
-                bool boundsUpdated = false;
-
-                if(dirtyFlags & static_cast<uint32_t>(Math::Transform::DirtyFlags::Rotation))
-                {
-                    if(m_Renderable)
-                    {
-                        m_Renderable->buildBounds(nullptr, &m_BoundsAABBWorld, nullptr, modelMatrix);
-                        boundsUpdated = true;
-                    }
-                }
-                else if(dirtyFlags & static_cast<uint32_t>(Math::Transform::DirtyFlags::Scale))
-                {
-                    // If scale is dirty we must adjust both the size and position of the bounds.
-                    // Note that position is only affected if its a cascading scale change (ie coming
-                    // from the parent), but we perform the adjustment everytime for simplicity.
-
-                    const Math::Vector3f scale = getScale();
-                    const float maxScale = fmaxf(fmaxf(scale.x, scale.y), scale.z);
-                    
-                    m_BoundsSphereWorld.setCenter((modelMatrix * m_BoundsSphereLocal.getCenter()));
-                    m_BoundsSphereWorld.setRadius(m_BoundsSphereLocal.getRadius() * maxScale);
-
-                    m_BoundsAABBWorld.setCenter((modelMatrix * m_BoundsAABBLocal.getCenter()));
-                    m_BoundsAABBWorld.setExtents(m_BoundsAABBLocal.getExtents() * maxScale);
-
-                    m_BoundsOBBWorld.setCenter((modelMatrix * m_BoundsOBBWorld.getCenter()));
-                    m_BoundsOBBWorld.setExtents(m_BoundsOBBLocal.getExtents() * scale);
+                TransformSystem& transforms = OcularScene->getTransformSystem();
 
-                    boundsUpdated = true;
-                }
-                else if(dirtyFlags & static_cast<uint32_t>(Math::Transform::DirtyFlags::Position))
+                if(transforms.isDirty(m_TransformHandle))
                 {
-                    m_BoundsSphereWorld.setCenter((modelMatrix * m_BoundsSphereLocal.getCenter()));
-                    m_BoundsAABBWorld.setCenter((modelMatrix * m_BoundsAABBLocal.getCenter()));
-                    m_BoundsOBBWorld.setCenter((modelMatrix * m_BoundsOBBWorld.getCenter()));
-
-                    boundsUpdated = true;
+                    // Rebuilds the world matrix and bounds of this object (but not of it's children)
+                    getModelMatrix(false);
                 }
 
-                if(boundsUpdated)
-                {
-                    OcularScene->triggerObjectDirty(m_UUID, m_IsStatic);
-                }
-
-                for(auto child : m_Children)
-                {
-                    child->updateBounds(dirtyFlags);
-                }
+                transforms.getWorldBounds(m_TransformHandle, &m_BoundsSphereWorld, &m_BoundsAABBWorld, &m_BoundsOBBWorld);
+                m_IsBoundsDirty = false;
             }
         }
 
@@ -1060,7 +1100,13 @@ namespace Ocular
 
             if(!local)
             {
-                updateBounds(m_Transform.getDirtyFlags());
+                updateTransform();
+
+                if(m_IsBoundsDirty)
+                {
+                    updateBounds(AllDirtyFlags);
+                }
+
                 result = m_BoundsSphereWorld;
             }
 
@@ -1073,7 +1119,13 @@ namespace Ocular
 
             if(!local)
             {
-                updateBounds(m_Transform.getDirtyFlags());
+                updateTransform();
+
+                if(m_IsBoundsDirty)
+                {
+                    updateBounds(AllDirtyFlags);
+                }
+
                 result = m_BoundsAABBWorld;
             }
 
@@ -1086,7 +1138,13 @@ namespace Ocular
 
             if(!local)
             {
-                updateBounds(m_Transform.getDirtyFlags());
+                updateTransform();
+
+                if(m_IsBoundsDirty)
+                {
+                    updateBounds(AllDirtyFlags);
+                }
+
                 result = m_BoundsOBBWorld;
             }
 
@@ -1099,14 +1157,48 @@ namespace Ocular
 
         void SceneObject::getModelMatrix(Math::Matrix4x4& matrix)
         {
-            Math::Matrix4x4 parentMatrix;
+            matrix = getModelMatrix(false);
+        }
 
-            if(m_Parent)
+        void SceneObject::invalidateWorldMatrix() const
+        {
+            TransformSystem& transforms = OcularScene->getTransformSystem();
+
+            if(!transforms.isDirty(m_TransformHandle))
             {
-                m_Parent->getModelMatrix(parentMatrix);
+                transforms.invalidate(m_TransformHandle);
+
+                m_IsBoundsDirty  = true;
+                m_IsUniformDirty = true;
+
+                for(auto child : m_Children)
+                {
+                    child->invalidateWorldMatrix();
+                }
             }
+        }
 
-            matrix = parentMatrix * m_Transform.getModelMatrix();
+        void SceneObject::syncTransform() const
+        {
+            // Invalidate first, as the descendants are only invalidated if this object is not yet dirty
+            invalidateWorldMatrix();
+
+            OcularScene->getTransformSystem().setLocal(m_TransformHandle, m_Transform.getPosition(), m_Transform.getRotation(), m_Transform.getScale());
+        }
+
+        void SceneObject::syncTransformParent()
+        {
+            invalidateWorldMatrix();
+
+            OcularScene->getTransformSystem().setParent(m_TransformHandle, (m_Parent ? m_Parent->m_TransformHandle : TransformSystem::InvalidHandle));
+        }
+
+        void SceneObject::updateTransform()
+        {
+            if(m_Transform.getDirtyFlags())
+            {
+                syncTransform();
+            }
         }
 
         //----------------------------------------------------------------------------------
@@ -0,0 +1,843 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Scene/TransformSystem.hpp"
+#include "Math/SIMD.hpp"
+#include "OcularEngine.hpp"
+
+#include <xmmintrin.h>
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    const uint8_t DirtyLocal = 0x01;    ///< The local transform has changed, and the local matrix must be composed
+    const uint8_t DirtyWorld = 0x02;    ///< The world matrix must be rebuilt
+    const uint8_t Updated    = 0x04;    ///< The world matrix was rebuilt during the current update pass
+    const uint8_t Skipped    = 0x08;    ///< The entry is detached, or a descendant of a detached entry, and was left for individual updates
+    const uint8_t Rebuilt    = 0x10;    ///< The world matrix or bounds were rebuilt individually since the last update pass
+    const uint8_t Created    = 0x20;    ///< The world matrix has not been built since the entry was created
+    const uint8_t FirstBuild = 0x40;    ///< The last build was the first of the entry, so there were no previous world bounds to report a change from
+
+    const uint32_t UpdateBatchSize = 1024;    ///< Minimum number of slots processed by a single thread during an update
+
+    const float Identity[16] = { 1.0f, 0.0f, 0.0f, 0.0f,
+                                 0.0f, 1.0f, 0.0f, 0.0f,
+                                 0.0f, 0.0f, 1.0f, 0.0f,
+                                 0.0f, 0.0f, 0.0f, 1.0f };
+
+    inline uint32_t PadCount(uint32_t const count)
+    {
+        return ((count + 3) & ~3u);
+    }
+
+    /**
+     * Returns the flags of an entry that has just been built (either Updated or Rebuilt).
+     * If it is the first build of the entry, it is also flagged as a FirstBuild.
+     */
+    inline uint8_t BuiltFlags(uint8_t const flags, uint8_t const built)
+    {
+        return (built | ((flags & Created) ? FirstBuild : 0));
+    }
+
+    /**
+     * Transposes four rows (one element of each of four matrices per row) into a single column of each matrix.
+     */
+    inline void StoreColumn(__m128 row0, __m128 row1, __m128 row2, __m128 row3, float* matrices, uint32_t const column)
+    {
+        _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+        _mm_storeu_ps(matrices + (column * 4),      row0);
+        _mm_storeu_ps(matrices + (column * 4) + 16, row1);
+        _mm_storeu_ps(matrices + (column * 4) + 32, row2);
+        _mm_storeu_ps(matrices + (column * 4) + 48, row3);
+    }
+
+    /**
+     * Transforms a direction by the first three columns of an affine matrix.
+     */
+    inline __m128 TransformDirection(__m128 const* columns, Ocular::Math::Vector3f const& direction)
+    {
+        __m128 result = _mm_mul_ps(columns[0], _mm_set1_ps(direction.x));
+        result = _mm_add_ps(result, _mm_mul_ps(columns[1], _mm_set1_ps(direction.y)));
+        result = _mm_add_ps(result, _mm_mul_ps(columns[2], _mm_set1_ps(direction.z)));
+
+        return result;
+    }
+
+    /**
+     * Transforms a point by the columns of an affine matrix.
+     */
+    inline __m128 TransformPoint(__m128 const* columns, Ocular::Math::Vector3f const& point)
+    {
+        return _mm_add_ps(TransformDirection(columns, point), columns[3]);
+    }
+
+    inline Ocular::Math::Vector3f ToVector(__m128 const value)
+    {
+        float values[4];
+        _mm_storeu_ps(values, value);
+
+        return Ocular::Math::Vector3f(values[0], values[1], values[2]);
+    }
+
+    template<typename T>
+    void Reorder(std::vector<T>& values, std::vector<uint32_t> const& order, uint32_t const stride, uint32_t const count, T const* padding)
+    {
+        std::vector<T> result(count * stride);
+
+        for(uint32_t i = 0; i < static_cast<uint32_t>(order.size()); i++)
+        {
+            std::copy(values.begin() + (order[i] * stride), values.begin() + ((order[i] + 1) * stride), result.begin() + (i * stride));
+        }
+
+        for(uint32_t i = static_cast<uint32_t>(order.size()); i < count; i++)
+        {
+            std::copy(padding, padding + stride, result.begin() + (i * stride));
+        }
+
+        values.swap(result);
+    }
+
+    template<typename T>
+    void ReorderBounds(T& values, std::vector<uint32_t> const& order, uint32_t const count)
+    {
+        T result(count);
+
+        for(uint32_t i = 0; i < static_cast<uint32_t>(order.size()); i++)
+        {
+            result.set(i, values.get(order[i]));
+        }
+
+        values = result;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+
+namespace Ocular
+{
+    namespace Core
+    {
+        const uint32_t TransformSystem::InvalidHandle;
+
+        //----------------------------------------------------------------------------------
+        // CONSTRUCTORS
+        //----------------------------------------------------------------------------------
+
+        TransformSystem::TransformSystem()
+            : m_NumSlots(0),
+              m_NumTransforms(0),
+              m_IsSorted(true)
+        {
+
+        }
+
+        TransformSystem::~TransformSystem()
+        {
+
+        }
+
+        //----------------------------------------------------------------------------------
+        // PUBLIC METHODS
+        //----------------------------------------------------------------------------------
+
+        uint32_t TransformSystem::create(SceneObject* owner)
+        {
+            uint32_t result = InvalidHandle;
+
+            if(m_FreeHandles.empty())
+            {
+                result = static_cast<uint32_t>(m_HandleSlots.size());
+                m_HandleSlots.push_back(InvalidHandle);
+                m_HandleOwners.push_back(nullptr);
+            }
+            else
+            {
+                result = m_FreeHandles.back();
+                m_FreeHandles.pop_back();
+            }
+
+            // New entries are roots, so appending them keeps every parent ahead of it's children.
+            // The depth order is only restored once the entry is given a parent.
+
+            const uint32_t slot = m_NumSlots;
+            resize(slot + 1);
+
+            m_PositionX[slot] = 0.0f;
+            m_PositionY[slot] = 0.0f;
+            m_PositionZ[slot] = 0.0f;
+            m_RotationW[slot] = 1.0f;
+            m_RotationX[slot] = 0.0f;
+            m_RotationY[slot] = 0.0f;
+            m_RotationZ[slot] = 0.0f;
+            m_ScaleX[slot]    = 1.0f;
+            m_ScaleY[slot]    = 1.0f;
+            m_ScaleZ[slot]    = 1.0f;
+
+            std::copy(Identity, Identity + 16, m_Local.begin() + (slot * 16));
+            std::copy(Identity, Identity + 16, m_World.begin() + (slot * 16));
+
+            // New entries are dirty, so that their bounds can not be retrieved before they are first built
+
+            m_Dirty[slot]         = (Created | DirtyWorld);
+            m_Detached[slot]      = 0;
+            m_ParentSlots[slot]   = InvalidHandle;
+            m_ParentHandles[slot] = InvalidHandle;
+            m_SlotHandles[slot]   = result;
+            m_HandleSlots[result] = slot;
+            m_HandleOwners[result] = owner;
+
+            m_NumTransforms++;
+
+            return result;
+        }
+
+        void TransformSystem::destroy(uint32_t const handle)
+        {
+            if((handle < m_HandleSlots.size()) && (m_HandleSlots[handle] != InvalidHandle))
+            {
+                const uint32_t slot = m_HandleSlots[handle];
+
+                m_Dirty[slot]       = 0;
+                m_SlotHandles[slot] = InvalidHandle;
+                m_HandleSlots[handle] = InvalidHandle;
+                m_HandleOwners[handle] = nullptr;
+
+                m_FreeHandles.push_back(handle);
+                m_NumTransforms--;
+
+                // The slot itself is only removed during the next sort
+                m_IsSorted = false;
+            }
+        }
+
+        void TransformSystem::setParent(uint32_t const handle, uint32_t const parent)
+        {
+            if((handle < m_HandleSlots.size()) && (m_HandleSlots[handle] != InvalidHandle))
+            {
+                const uint32_t slot = m_HandleSlots[handle];
+
+                if(m_ParentHandles[slot] != parent)
+                {
+                    m_ParentHandles[slot] = parent;
+                    m_IsSorted = false;
+                }
+
+                m_Dirty[slot] |= DirtyWorld;
+            }
+        }
+
+        uint32_t TransformSystem::getParent(uint32_t const handle) const
+        {
+            uint32_t result = InvalidHandle;
+
+            if((handle < m_HandleSlots.size()) && (m_HandleSlots[handle] != InvalidHandle))
+            {
+                result = m_ParentHandles[m_HandleSlots[handle]];
+            }
+
+            return result;
+        }
+
+        SceneObject* TransformSystem::getOwner(uint32_t const handle) const
+        {
+            SceneObject* result = nullptr;
+
+            if(handle < m_HandleOwners.size())
+            {
+                result = m_HandleOwners[handle];
+            }
+
+            return result;
+        }
+
+        void TransformSystem::setDetached(uint32_t const handle, bool const detached)
+        {
+            if((handle < m_HandleSlots.size()) && (m_HandleSlots[handle] != InvalidHandle))
+            {
+                m_Detached[m_HandleSlots[handle]] = (detached ? 1 : 0);
+            }
+        }
+
+        void TransformSystem::setLocal(uint32_t const handle, Math::Vector3f const& position, Math::Quaternion const& rotation, Math::Vector3f const& scale)
+        {
+            if((handle < m_HandleSlots.size()) && (m_HandleSlots[handle] != InvalidHandle))
+            {
+                const uint32_t slot = m_HandleSlots[handle];
+                Math::Quaternion quat = rotation;
+
+                m_PositionX[slot] = position.x;
+                m_PositionY[slot] = position.y;
+                m_PositionZ[slot] = position.z;
+                m_RotationW[slot] = quat.w();
+                m_RotationX[slot] = quat.x();
+                m_RotationY[slot] = quat.y();
+                m_RotationZ[slot] = quat.z();
+                m_ScaleX[slot]    = scale.x;
+                m_ScaleY[slot]    = scale.y;
+                m_ScaleZ[slot]    = scale.z;
+
+                m_Dirty[slot] |= (DirtyLocal | DirtyWorld);
+            }
+        }
+
+        void TransformSystem::setLocalBounds(uint32_t const handle, Math::BoundsSphere const& sphere, Math::BoundsAABB const& aabb, Math::BoundsOBB const& obb)
+        {
+            if((handle < m_HandleSlots.size()) && (m_HandleSlots[handle] != InvalidHandle))
+            {
+                const uint32_t slot = m_HandleSlots[handle];
+
+                m_BoundsSphereLocal.set(slot, sphere);
+                m_BoundsAABBLocal.set(slot, aabb);
+                m_BoundsOBBLocal[slot] = obb;
+
+                // The world matrix (and so any descendants) is not affected. If it is already up to date,
+                // the bounds are simply transformed now, otherwise they are transformed along with it.
+
+                if(!(m_Dirty[slot] & (DirtyLocal | DirtyWorld)))
+                {
+                    updateBounds(&slot, 1);
+                    m_Dirty[slot] = ((m_Dirty[slot] & ~FirstBuild) | Rebuilt);
+                }
+            }
+        }
+
+        void TransformSystem::invalidate(uint32_t const handle)
+        {
+            if((handle < m_HandleSlots.size()) && (m_HandleSlots[handle] != InvalidHandle))
+            {
+                m_Dirty[m_HandleSlots[handle]] |= DirtyWorld;
+            }
+        }
+
+        bool TransformSystem::isDirty(uint32_t const handle) const
+        {
+            bool result = false;
+
+            if((handle < m_HandleSlots.size()) && (m_HandleSlots[handle] != InvalidHandle))
+            {
+                result = ((m_Dirty[m_HandleSlots[handle]] & (DirtyLocal | DirtyWorld)) != 0);
+            }
+
+            return result;
+        }
+
+        void TransformSystem::updateWorldMatrix(uint32_t const handle, float const* parentWorld)
+        {
+            if((handle < m_HandleSlots.size()) && (m_HandleSlots[handle] != InvalidHandle))
+            {
+                const uint32_t slot = m_HandleSlots[handle];
+
+                if(m_Dirty[slot] & DirtyLocal)
+                {
+                    // Uses the same kernel as update so that both produce identical matrices
+                    composeLocal(slot & ~3u);
+                }
+
+                float const* local = &m_Local[slot * 16];
+                float* world = &m_World[slot * 16];
+
+                if(parentWorld)
+                {
+                    Math::SIMD::MultiplyAffineMatrix(parentWorld, local, world);
+                }
+                else
+                {
+                    std::copy(local, local + 16, world);
+                }
+
+                updateBounds(&slot, 1);
+
+                m_Dirty[slot] = BuiltFlags(m_Dirty[slot], Rebuilt);
+            }
+        }
+
+        void TransformSystem::setWorldMatrix(uint32_t const handle, float const* world)
+        {
+            if((handle < m_HandleSlots.size()) && (m_HandleSlots[handle] != InvalidHandle) && world)
+            {
+                const uint32_t slot = m_HandleSlots[handle];
+
+                std::copy(world, world + 16, m_World.begin() + (slot * 16));
+
+                updateBounds(&slot, 1);
+
+                // The local matrix is not used, so any pending composition is simply dropped
+                m_Dirty[slot] = BuiltFlags(m_Dirty[slot], Rebuilt);
+            }
+        }
+
+        void TransformSystem::getWorldMatrix(uint32_t const handle, Math::Matrix4x4& matrix) const
+        {
+            float const* data = getWorldMatrixData(handle);
+
+            if(data)
+            {
+                matrix.setData(data);
+            }
+        }
+
+        float const* TransformSystem::getWorldMatrixData(uint32_t const handle) const
+        {
+            float const* result = nullptr;
+
+            if((handle < m_HandleSlots.size()) && (m_HandleSlots[handle] != InvalidHandle))
+            {
+                result = &m_World[m_HandleSlots[handle] * 16];
+            }
+
+            return result;
+        }
+
+        void TransformSystem::getWorldBounds(uint32_t const handle, Math::BoundsSphere* sphere, Math::BoundsAABB* aabb, Math::BoundsOBB* obb) const
+        {
+            if((handle < m_HandleSlots.size()) && (m_HandleSlots[handle] != InvalidHandle))
+            {
+                const uint32_t slot = m_HandleSlots[handle];
+
+                if(sphere)
+                {
+                    (*sphere) = m_BoundsSphereWorld.get(slot);
+                }
+
+                if(aabb)
+                {
+                    (*aabb) = m_BoundsAABBWorld.get(slot);
+                }
+
+                if(obb)
+                {
+                    (*obb) = m_BoundsOBBWorld[slot];
+                }
+            }
+        }
+
+        void TransformSystem::update()
+        {
+            if(!m_IsSorted)
+            {
+                sort();
+            }
+
+            //------------------------------------------------------------
+            // Compose the modified local matrices, four at a time
+
+            OcularThreads->parallelFor((PadCount(m_NumSlots) / 4), (UpdateBatchSize / 4), [&](uint32_t const batch, uint32_t const first, uint32_t const last)
+            {
+                for(uint32_t group = first; group < last; group++)
+                {
+                    const uint32_t slot = group * 4;
+
+                    if((m_Dirty[slot] | m_Dirty[slot + 1] | m_Dirty[slot + 2] | m_Dirty[slot + 3]) & DirtyLocal)
+                    {
+                        composeLocal(slot);
+                    }
+                }
+            });
+
+            //------------------------------------------------------------
+            // Propagate from parent to child, one depth level at a time
+
+            const uint32_t numLevels = m_LevelOffsets.empty() ? 0 : (static_cast<uint32_t>(m_LevelOffsets.size()) - 1);
+
+            for(uint32_t level = 0; level < numLevels; level++)
+            {
+                updateLevel(m_LevelOffsets[level], m_LevelOffsets[level + 1]);
+            }
+
+            // Entries created since the last sort are roots appended after the deepest level
+
+            const uint32_t numSorted = m_LevelOffsets.empty() ? 0 : m_LevelOffsets.back();
+
+            if(numSorted < m_NumSlots)
+            {
+                updateLevel(numSorted, m_NumSlots);
+            }
+
+            //------------------------------------------------------------
+            // Skipped entries remain dirty, everything else is now up to date.
+            //
+            // The first build of an entry is not reported. New entries are dirty, so any retrieval of their
+            // bounds (such as by a SceneTree) forces that build. Nothing can hold their bounds from before it.
+
+            std::vector<std::vector<uint32_t>> batchUpdated(OcularThreads->getNumBatches(m_NumSlots, UpdateBatchSize));
+
+            OcularThreads->parallelFor(m_NumSlots, UpdateBatchSize, [&](uint32_t const batch, uint32_t const first, uint32_t const last)
+            {
+                for(uint32_t slot = first; slot < last; slot++)
+                {
+                    const uint8_t flags = m_Dirty[slot];
+
+                    if((flags & (Updated | Rebuilt)) && !(flags & FirstBuild))
+                    {
+                        batchUpdated[batch].push_back(m_SlotHandles[slot]);
+                    }
+
+                    m_Dirty[slot] = (flags & Skipped) ? (flags & (DirtyLocal | DirtyWorld | Created)) : 0;
+                }
+            });
+
+            m_UpdatedHandles.clear();
+
+            for(auto const& updated : batchUpdated)
+            {
+                m_UpdatedHandles.insert(m_UpdatedHandles.end(), updated.begin(), updated.end());
+            }
+        }
+
+        std::vector<uint32_t> const& TransformSystem::getUpdatedHandles() const
+        {
+            return m_UpdatedHandles;
+        }
+
+        uint32_t TransformSystem::getNumTransforms() const
+        {
+            return m_NumTransforms;
+        }
+
+        //----------------------------------------------------------------------------------
+        // PROTECTED METHODS
+        //----------------------------------------------------------------------------------
+
+        void TransformSystem::sort()
+        {
+            //------------------------------------------------------------
+            // Find the depth of every live entry
+
+            const uint32_t numHandles = static_cast<uint32_t>(m_HandleSlots.size());
+
+            std::vector<uint32_t> depths(numHandles, InvalidHandle);
+            std::vector<uint32_t> chain;
+
+            uint32_t maxDepth = 0;
+
+            for(uint32_t slot = 0; slot < m_NumSlots; slot++)
+            {
+                uint32_t handle = m_SlotHandles[slot];
+
+                if(handle == InvalidHandle)
+                {
+                    continue;
+                }
+
+                // Walk up until an ancestor of known depth (or a root) is found
+
+                chain.clear();
+
+                while((handle != InvalidHandle) && (depths[handle] == InvalidHandle))
+                {
+                    chain.push_back(handle);
+
+                    const uint32_t parent = m_ParentHandles[m_HandleSlots[handle]];
+                    handle = ((parent < numHandles) && (m_HandleSlots[parent] != InvalidHandle)) ? parent : InvalidHandle;
+                }
+
+                uint32_t depth = (handle == InvalidHandle) ? 0 : (depths[handle] + 1);
+
+                for(auto iter = chain.rbegin(); iter != chain.rend(); ++iter)
+                {
+                    depths[(*iter)] = depth++;
+                }
+
+                maxDepth = std::max(maxDepth, depth - 1);
+            }
+
+            //------------------------------------------------------------
+            // Counting sort of the live slots by depth (stable, so siblings keep their relative order)
+
+            std::vector<uint32_t> offsets(maxDepth + 2, 0);
+
+            for(uint32_t slot = 0; slot < m_NumSlots; slot++)
+            {
+                const uint32_t handle = m_SlotHandles[slot];
+
+                if(handle != InvalidHandle)
+                {
+                    offsets[depths[handle] + 1]++;
+                }
+            }
+
+            for(uint32_t i = 1; i < static_cast<uint32_t>(offsets.size()); i++)
+            {
+                offsets[i] += offsets[i - 1];
+            }
+
+            m_LevelOffsets = offsets;
+
+            std::vector<uint32_t> order(m_NumTransforms);
+
+            for(uint32_t slot = 0; slot < m_NumSlots; slot++)
+            {
+                const uint32_t handle = m_SlotHandles[slot];
+
+                if(handle != InvalidHandle)
+                {
+                    order[offsets[depths[handle]]++] = slot;
+                }
+            }
+
+            //------------------------------------------------------------
+            // Reorder every per-slot array
+
+            const uint32_t padded = PadCount(m_NumTransforms);
+
+            const float zero = 0.0f;
+            const float one  = 1.0f;
+            const uint8_t clean = 0;
+            const uint32_t invalid = InvalidHandle;
+
+            Reorder(m_PositionX, order, 1, padded, &zero);
+            Reorder(m_PositionY, order, 1, padded, &zero);
+            Reorder(m_PositionZ, order, 1, padded, &zero);
+            Reorder(m_RotationW, order, 1, padded, &one);
+            Reorder(m_RotationX, order, 1, padded, &zero);
+            Reorder(m_RotationY, order, 1, padded, &zero);
+            Reorder(m_RotationZ, order, 1, padded, &zero);
+            Reorder(m_ScaleX,    order, 1, padded, &one);
+            Reorder(m_ScaleY,    order, 1, padded, &one);
+            Reorder(m_ScaleZ,    order, 1, padded, &one);
+            Reorder(m_Local,     order, 16, padded, Identity);
+            Reorder(m_World,     order, 16, padded, Identity);
+
+            const Math::BoundsOBB obb;
+
+            ReorderBounds(m_BoundsSphereLocal, order, padded);
+            ReorderBounds(m_BoundsAABBLocal,   order, padded);
+            Reorder(m_BoundsOBBLocal,          order, 1, padded, &obb);
+            ReorderBounds(m_BoundsSphereWorld, order, padded);
+            ReorderBounds(m_BoundsAABBWorld,   order, padded);
+            Reorder(m_BoundsOBBWorld,          order, 1, padded, &obb);
+            Reorder(m_Dirty,     order, 1, padded, &clean);
+            Reorder(m_Detached,  order, 1, padded, &clean);
+            Reorder(m_ParentHandles, order, 1, padded, &invalid);
+            Reorder(m_SlotHandles,   order, 1, padded, &invalid);
+
+            m_NumSlots = m_NumTransforms;
+            m_ParentSlots.assign(padded, InvalidHandle);
+
+            for(uint32_t slot = 0; slot < m_NumSlots; slot++)
+            {
+                m_HandleSlots[m_SlotHandles[slot]] = slot;
+            }
+
+            for(uint32_t slot = 0; slot < m_NumSlots; slot++)
+            {
+                const uint32_t parent = m_ParentHandles[slot];
+
+                if((parent < numHandles) && (m_HandleSlots[parent] != InvalidHandle))
+                {
+                    m_ParentSlots[slot] = m_HandleSlots[parent];
+                }
+                else if(parent != InvalidHandle)
+                {
+                    // Parent was destroyed
+                    m_ParentHandles[slot] = InvalidHandle;
+                    m_Dirty[slot] |= DirtyWorld;
+                }
+            }
+
+            m_IsSorted = true;
+        }
+
+        void TransformSystem::resize(uint32_t const count)
+        {
+            const uint32_t padded = PadCount(count);
+
+            if(padded > static_cast<uint32_t>(m_Dirty.size()))
+            {
+                const uint32_t previous = static_cast<uint32_t>(m_Dirty.size());
+
+                m_PositionX.resize(padded, 0.0f);
+                m_PositionY.resize(padded, 0.0f);
+                m_PositionZ.resize(padded, 0.0f);
+                m_RotationW.resize(padded, 1.0f);
+                m_RotationX.resize(padded, 0.0f);
+                m_RotationY.resize(padded, 0.0f);
+                m_RotationZ.resize(padded, 0.0f);
+                m_ScaleX.resize(padded, 1.0f);
+                m_ScaleY.resize(padded, 1.0f);
+                m_ScaleZ.resize(padded, 1.0f);
+
+                m_Local.resize(padded * 16);
+                m_World.resize(padded * 16);
+
+                for(uint32_t i = previous; i < padded; i++)
+                {
+                    std::copy(Identity, Identity + 16, m_Local.begin() + (i * 16));
+                    std::copy(Identity, Identity + 16, m_World.begin() + (i * 16));
+                }
+
+                m_BoundsSphereLocal.resize(padded);
+                m_BoundsAABBLocal.resize(padded);
+                m_BoundsOBBLocal.resize(padded);
+                m_BoundsSphereWorld.resize(padded);
+                m_BoundsAABBWorld.resize(padded);
+                m_BoundsOBBWorld.resize(padded);
+
+                m_Dirty.resize(padded, 0);
+                m_Detached.resize(padded, 0);
+                m_ParentSlots.resize(padded, InvalidHandle);
+                m_ParentHandles.resize(padded, InvalidHandle);
+                m_SlotHandles.resize(padded, InvalidHandle);
+            }
+
+            m_NumSlots = std::max(m_NumSlots, count);
+        }
+
+        void TransformSystem::composeLocal(uint32_t const first)
+        {
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 two = _mm_set1_ps(2.0f);
+            const __m128 zero = _mm_setzero_ps();
+
+            const __m128 qw = _mm_loadu_ps(&m_RotationW[first]);
+            const __m128 qx = _mm_loadu_ps(&m_RotationX[first]);
+            const __m128 qy = _mm_loadu_ps(&m_RotationY[first]);
+            const __m128 qz = _mm_loadu_ps(&m_RotationZ[first]);
+
+            const __m128 sx = _mm_loadu_ps(&m_ScaleX[first]);
+            const __m128 sy = _mm_loadu_ps(&m_ScaleY[first]);
+            const __m128 sz = _mm_loadu_ps(&m_ScaleZ[first]);
+
+            const __m128 xx = _mm_mul_ps(qx, qx);
+            const __m128 yy = _mm_mul_ps(qy, qy);
+            const __m128 zz = _mm_mul_ps(qz, qz);
+            const __m128 xy = _mm_mul_ps(qx, qy);
+            const __m128 xz = _mm_mul_ps(qx, qz);
+            const __m128 yz = _mm_mul_ps(qy, qz);
+            const __m128 wx = _mm_mul_ps(qw, qx);
+            const __m128 wy = _mm_mul_ps(qw, qy);
+            const __m128 wz = _mm_mul_ps(qw, qz);
+
+            // Rotation matrix (as in glm::mat3_cast) with each column multiplied by the scale
+
+            const __m128 m00 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+            const __m128 m01 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+            const __m128 m02 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+
+            const __m128 m10 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+            const __m128 m11 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+            const __m128 m12 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+
+            const __m128 m20 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+            const __m128 m21 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+            const __m128 m22 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+
+            float* local = &m_Local[first * 16];
+
+            StoreColumn(m00, m01, m02, zero, local, 0);
+            StoreColumn(m10, m11, m12, zero, local, 1);
+            StoreColumn(m20, m21, m22, zero, local, 2);
+            StoreColumn(_mm_loadu_ps(&m_PositionX[first]), _mm_loadu_ps(&m_PositionY[first]), _mm_loadu_ps(&m_PositionZ[first]), one, local, 3);
+
+            for(uint32_t i = first; i < (first + 4); i++)
+            {
+                m_Dirty[i] &= ~DirtyLocal;
+            }
+        }
+
+        void TransformSystem::updateLevel(uint32_t const first, uint32_t const last)
+        {
+            float* world = m_World.data();
+            float const* local = m_Local.data();
+
+            OcularThreads->parallelFor((last - first), UpdateBatchSize, [&](uint32_t const batch, uint32_t const batchFirst, uint32_t const batchLast)
+            {
+                // The bounds of every updated slot in the batch are transformed together once the matrices are done
+
+                std::vector<uint32_t> updated;
+                updated.reserve(batchLast - batchFirst);
+
+                // As parents are always in a shallower level, a parent's flags for this pass are already known
+
+                for(uint32_t slot = (first + batchFirst); slot < (first + batchLast); slot++)
+                {
+                    const uint32_t parent = m_ParentSlots[slot];
+                    const uint8_t parentFlags = (parent != InvalidHandle) ? m_Dirty[parent] : 0;
+
+                    if(m_Detached[slot] || (parentFlags & Skipped))
+                    {
+                        m_Dirty[slot] |= Skipped;
+                    }
+                    else if((m_Dirty[slot] & (DirtyLocal | DirtyWorld)) || (parentFlags & Updated))
+                    {
+                        if(parent != InvalidHandle)
+                        {
+                            Math::SIMD::MultiplyAffineMatrix(world + (parent * 16), local + (slot * 16), world + (slot * 16));
+                        }
+                        else
+                        {
+                            std::memcpy(world + (slot * 16), local + (slot * 16), sizeof(float) * 16);
+                        }
+
+                        updated.push_back(slot);
+                        m_Dirty[slot] = BuiltFlags(m_Dirty[slot], Updated);
+                    }
+                }
+
+                if(!updated.empty())
+                {
+                    updateBounds(updated.data(), static_cast<uint32_t>(updated.size()));
+                }
+            });
+        }
+
+        void TransformSystem::updateBounds(uint32_t const* slots, uint32_t const count)
+        {
+            float const* matrices = m_World.data();
+
+            // The OBB axes are rotated along with the object, and their lengths scale the extents
+
+            for(uint32_t i = 0; i < count; i++)
+            {
+                const uint32_t slot = slots[i];
+                float const* matrix = matrices + (slot * 16);
+
+                const __m128 columns[4] = { _mm_loadu_ps(matrix), _mm_loadu_ps(matrix + 4), _mm_loadu_ps(matrix + 8), _mm_loadu_ps(matrix + 12) };
+
+                Math::BoundsOBB const& localOBB = m_BoundsOBBLocal[slot];
+                Math::BoundsOBB& worldOBB = m_BoundsOBBWorld[slot];
+
+                Math::Vector3f dirX = ToVector(TransformDirection(columns, localOBB.getDirectionX()));
+                Math::Vector3f dirY = ToVector(TransformDirection(columns, localOBB.getDirectionY()));
+                Math::Vector3f dirZ = ToVector(TransformDirection(columns, localOBB.getDirectionZ()));
+
+                const Math::Vector3f lengths(dirX.getLength(), dirY.getLength(), dirZ.getLength());
+
+                dirX.normalize();
+                dirY.normalize();
+                dirZ.normalize();
+
+                worldOBB.setCenter(ToVector(TransformPoint(columns, localOBB.getCenter())));
+                worldOBB.setExtents(localOBB.getExtents() * lengths);
+                worldOBB.setDirectionX(dirX);
+                worldOBB.setDirectionY(dirY);
+                worldOBB.setDirectionZ(dirZ);
+            }
+
+            // Spheres and AABBs are transformed four slots at a time
+
+            m_BoundsSphereLocal.transform(matrices, slots, count, m_BoundsSphereWorld);
+            m_BoundsAABBLocal.transform(matrices, slots, count, m_BoundsAABBWorld);
+        }
+
+        //----------------------------------------------------------------------------------
+        // PRIVATE METHODS
+        //----------------------------------------------------------------------------------
+    }
+}
\ No newline at end of file
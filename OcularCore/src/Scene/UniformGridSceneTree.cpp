@@ -0,0 +1,686 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Scene/UniformGridSceneTree.hpp"
+#include "Math/MathCommon.hpp"
+
+#include "OcularEngine.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    const int32_t  CoordBias = (1 << 20);    ///< Offset applied to each cell coordinate so that it may be packed into 21 unsigned bits
+    const uint64_t CoordMask = 0x1FFFFF;     ///< Mask of a single packed cell coordinate
+    const uint32_t AllFrustumPlanes = 0x3F;  ///< Plane mask in which all six frustum planes are active
+
+    /**
+     * Packs the cell coordinates, each of which must be within [-2^20, 2^20), into a single cell code.
+     */
+    inline uint64_t PackCell(int32_t const coords[3])
+    {
+        return  static_cast<uint64_t>(coords[0] + CoordBias) | 
+               (static_cast<uint64_t>(coords[1] + CoordBias) << 21) | 
+               (static_cast<uint64_t>(coords[2] + CoordBias) << 42);
+    }
+
+    /**
+     * Unpacks the cell coordinates from a cell code created by PackCell.
+     */
+    inline void UnpackCell(uint64_t const cell, int32_t coords[3])
+    {
+        coords[0] = static_cast<int32_t>(cell & CoordMask) - CoordBias;
+        coords[1] = static_cast<int32_t>((cell >> 21) & CoordMask) - CoordBias;
+        coords[2] = static_cast<int32_t>((cell >> 42) & CoordMask) - CoordBias;
+    }
+
+    /**
+     * Clips the ray segment [tMin, tMax] against the bounds.
+     * \return FALSE if the segment lies entirely outside of the bounds.
+     */
+    bool ClipRay(float const origin[3], float const invDir[3], bool const parallel[3], float const boundsMin[3], float const boundsMax[3], float& tMin, float& tMax)
+    {
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            if(parallel[i])
+            {
+                if((origin[i] < boundsMin[i]) || (origin[i] > boundsMax[i]))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                const float t0 = (boundsMin[i] - origin[i]) * invDir[i];
+                const float t1 = (boundsMax[i] - origin[i]) * invDir[i];
+
+                tMin = fmaxf(tMin, fminf(t0, t1));
+                tMax = fminf(tMax, fmaxf(t0, t1));
+
+                if(tMin > tMax)
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+
+namespace Ocular
+{
+    namespace Core
+    {
+        //----------------------------------------------------------------------------------
+        // CONSTRUCTORS
+        //----------------------------------------------------------------------------------
+
+        UniformGridSceneTree::UniformGridSceneTree(float const cellSize)
+            : m_CellSize(cellSize),
+              m_InvCellSize(1.0f / cellSize)
+        {
+            destroy();
+        }
+
+        UniformGridSceneTree::~UniformGridSceneTree()
+        {
+            destroy();
+        }
+
+        //----------------------------------------------------------------------------------
+        // PUBLIC METHODS
+        //----------------------------------------------------------------------------------
+
+        void UniformGridSceneTree::destroy()
+        {
+            ACellSceneTree::destroy();
+
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                m_OccupiedMin[i] = std::numeric_limits<int32_t>::max();
+                m_OccupiedMax[i] = std::numeric_limits<int32_t>::min();
+            }
+        }
+
+        SceneTreeType UniformGridSceneTree::getType() const
+        {
+            return SceneTreeType::UniformGridCPU;
+        }
+
+        //----------------------------------------------------------------------------------
+        // PROTECTED METHODS
+        //----------------------------------------------------------------------------------
+
+        uint64_t UniformGridSceneTree::getCell(float const boundsMin[3], float const boundsMax[3]) const
+        {
+            uint64_t result = OversizedCell;
+
+            int32_t coords[3];
+            bool fits = true;
+
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                const float center = (boundsMin[i] + boundsMax[i]) * 0.5f;
+                const float coord  = floorf(center * m_InvCellSize);
+
+                // The loose bounds of a cell extend half of a cell beyond it on each side
+                fits = fits && (((boundsMax[i] - boundsMin[i]) * 0.5f) <= (m_CellSize * 0.5f)) && 
+                               (coord >= static_cast<float>(-CoordBias)) && (coord < static_cast<float>(CoordBias));
+
+                coords[i] = fits ? static_cast<int32_t>(coord) : 0;
+            }
+
+            if(fits)
+            {
+                result = PackCell(coords);
+            }
+
+            return result;
+        }
+
+        void UniformGridSceneTree::onCellCreated(uint64_t const cell)
+        {
+            if(cell != OversizedCell)
+            {
+                int32_t coords[3];
+                UnpackCell(cell, coords);
+
+                for(uint32_t i = 0; i < 3; i++)
+                {
+                    m_OccupiedMin[i] = std::min(m_OccupiedMin[i], coords[i]);
+                    m_OccupiedMax[i] = std::max(m_OccupiedMax[i], coords[i]);
+                }
+            }
+        }
+
+        void UniformGridSceneTree::onCellDestroyed(uint64_t const cell)
+        {
+            // The occupied region only ever grows, until the grid is completely empty
+
+            if(m_Cells.empty())
+            {
+                for(uint32_t i = 0; i < 3; i++)
+                {
+                    m_OccupiedMin[i] = std::numeric_limits<int32_t>::max();
+                    m_OccupiedMax[i] = std::numeric_limits<int32_t>::min();
+                }
+            }
+        }
+
+        void UniformGridSceneTree::getLooseBounds(int32_t const coords[3], float boundsMin[3], float boundsMax[3]) const
+        {
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                boundsMin[i] = (static_cast<float>(coords[i]) - 0.5f) * m_CellSize;
+                boundsMax[i] = (static_cast<float>(coords[i]) + 1.5f) * m_CellSize;
+            }
+        }
+
+        bool UniformGridSceneTree::getOccupiedBounds(float boundsMin[3], float boundsMax[3]) const
+        {
+            const bool result = (m_OccupiedMin[0] <= m_OccupiedMax[0]);
+
+            if(result)
+            {
+                float unused[3];
+
+                getLooseBounds(m_OccupiedMin, boundsMin, unused);
+                getLooseBounds(m_OccupiedMax, unused, boundsMax);
+            }
+
+            return result;
+        }
+
+        template<typename Visit>
+        void UniformGridSceneTree::forEachCell(float const regionMin[3], float const regionMax[3], Visit const& visit) const
+        {
+            int32_t first[3];
+            int32_t last[3];
+            uint64_t volume = 1;
+
+            bool overlaps = (m_OccupiedMin[0] <= m_OccupiedMax[0]);
+
+            for(uint32_t i = 0; (i < 3) && overlaps; i++)
+            {
+                // The loose bounds of cell c are [(c - 0.5) * size, (c + 1.5) * size].
+                // Clamp to the occupied cells before converting, as the region may be unbounded.
+
+                const float lower = fmaxf(((regionMin[i] * m_InvCellSize) - 1.5f), static_cast<float>(m_OccupiedMin[i]));
+                const float upper = fminf(((regionMax[i] * m_InvCellSize) + 0.5f), static_cast<float>(m_OccupiedMax[i]));
+
+                overlaps = (lower <= upper);
+
+                if(overlaps)
+                {
+                    first[i] = static_cast<int32_t>(ceilf(lower));
+                    last[i]  = static_cast<int32_t>(floorf(upper));
+
+                    overlaps = (first[i] <= last[i]);
+                    volume *= static_cast<uint64_t>(last[i] - first[i] + 1);
+                }
+            }
+
+            if(overlaps)
+            {
+                if(volume <= static_cast<uint64_t>(m_Cells.size()))
+                {
+                    // Look up every cell in the region
+
+                    int32_t coords[3];
+
+                    for(coords[2] = first[2]; coords[2] <= last[2]; coords[2]++)
+                    {
+                        for(coords[1] = first[1]; coords[1] <= last[1]; coords[1]++)
+                        {
+                            for(coords[0] = first[0]; coords[0] <= last[0]; coords[0]++)
+                            {
+                                auto findCell = m_Cells.find(PackCell(coords));
+
+                                if(findCell != m_Cells.end())
+                                {
+                                    visit(coords, findCell->second);
+                                }
+                            }
+                        }
+                    }
+                }
+                else
+                {
+                    // The region is larger than the number of occupied cells, so iterate those instead
+
+                    for(auto const& cell : m_Cells)
+                    {
+                        if(cell.first != OversizedCell)
+                        {
+                            int32_t coords[3];
+                            UnpackCell(cell.first, coords);
+
+                            if((coords[0] >= first[0]) && (coords[0] <= last[0]) &&
+                               (coords[1] >= first[1]) && (coords[1] <= last[1]) &&
+                               (coords[2] >= first[2]) && (coords[2] <= last[2]))
+                            {
+                                visit(coords, cell.second);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        //----------------------------------------------------------------------
+        // Traversal Methods
+        //----------------------------------------------------------------------
+
+        void UniformGridSceneTree::findVisible(Math::Frustum const& frustum, std::vector<SceneObject*>& objects) const
+        {
+            float planes[6][4];
+            ExtractFrustumPlanes(frustum, planes);
+
+            auto visitObjects = [&](std::vector<CellObject> const& cellObjects, uint32_t const mask)
+            {
+                for(auto const& entry : cellObjects)
+                {
+                    uint32_t objectMask = mask;
+
+                    if((mask != 0) && (ClassifyFrustum(planes, entry.boundsMin, entry.boundsMax, objectMask) == Math::IntersectionType::Outside))
+                    {
+                        entry.object->setVisible(false);
+                    }
+                    else if(entry.object->isActive())
+                    {
+                        entry.object->setVisible(true);
+                        objects.emplace_back(entry.object);
+                    }
+                }
+            };
+
+            //------------------------------------------------------------
+            // Only the cells within the bounds of the frustum are candidates
+
+            float regionMin[3] = {  FLT_MAX,  FLT_MAX,  FLT_MAX };
+            float regionMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+            for(auto const& corners : { frustum.getNearClipCorners(), frustum.getFarClipCorners() })
+            {
+                for(auto const& corner : corners)
+                {
+                    for(uint32_t i = 0; i < 3; i++)
+                    {
+                        regionMin[i] = fminf(regionMin[i], corner[i]);
+                        regionMax[i] = fmaxf(regionMax[i], corner[i]);
+                    }
+                }
+            }
+
+            forEachCell(regionMin, regionMax, [&](int32_t const coords[3], std::vector<CellObject> const& cellObjects)
+            {
+                float boundsMin[3];
+                float boundsMax[3];
+                uint32_t mask = AllFrustumPlanes;
+
+                getLooseBounds(coords, boundsMin, boundsMax);
+
+                if(ClassifyFrustum(planes, boundsMin, boundsMax, mask) == Math::IntersectionType::Outside)
+                {
+                    for(auto const& entry : cellObjects)
+                    {
+                        entry.object->setVisible(false);
+                    }
+                }
+                else
+                {
+                    // An empty mask indicates the cell is entirely inside of the frustum
+                    visitObjects(cellObjects, mask);
+                }
+            });
+
+            auto findOversized = m_Cells.find(OversizedCell);
+
+            if(findOversized != m_Cells.end())
+            {
+                visitObjects(findOversized->second, AllFrustumPlanes);
+            }
+        }
+
+        void UniformGridSceneTree::findIntersections(Math::Ray const& ray, std::vector<std::pair<SceneObject*, float>>& objects) const
+        {
+            float origin[3];
+            float invDir[3];
+            bool  parallel[3];
+
+            PrepareRay(ray, origin, invDir, parallel);
+
+            auto visitObjects = [&](std::vector<CellObject> const& cellObjects)
+            {
+                for(auto const& entry : cellObjects)
+                {
+                    float distance = 0.0f;
+
+                    if(IntersectsRay(origin, invDir, parallel, entry.boundsMin, entry.boundsMax, distance))
+                    {
+                        objects.emplace_back(std::make_pair(entry.object, distance));
+                    }
+                }
+            };
+
+            float regionMin[3];
+            float regionMax[3];
+
+            if(getRayRegion(ray, FLT_MAX, regionMin, regionMax))
+            {
+                forEachCell(regionMin, regionMax, [&](int32_t const coords[3], std::vector<CellObject> const& cellObjects)
+                {
+                    float boundsMin[3];
+                    float boundsMax[3];
+                    float distance = 0.0f;
+
+                    getLooseBounds(coords, boundsMin, boundsMax);
+
+                    if(IntersectsRay(origin, invDir, parallel, boundsMin, boundsMax, distance))
+                    {
+                        visitObjects(cellObjects);
+                    }
+                });
+            }
+
+            auto findOversized = m_Cells.find(OversizedCell);
+
+            if(findOversized != m_Cells.end())
+            {
+                visitObjects(findOversized->second);
+            }
+        }
+
+        bool UniformGridSceneTree::findIntersection(Math::Ray const& ray, RayQueryMode const mode, float const maxDistance, std::pair<SceneObject*, float>& result) const
+        {
+            bool found = false;
+
+            float origin[3];
+            float invDir[3];
+            bool  parallel[3];
+
+            PrepareRay(ray, origin, invDir, parallel);
+
+            float nearest = maxDistance;
+
+            auto visitObjects = [&](std::vector<CellObject> const& cellObjects)
+            {
+                for(auto const& entry : cellObjects)
+                {
+                    float distance = 0.0f;
+
+                    if(IntersectsRay(origin, invDir, parallel, entry.boundsMin, entry.boundsMax, distance) && (distance <= nearest))
+                    {
+                        result = std::make_pair(entry.object, distance);
+                        nearest = distance;
+                        found = true;
+
+                        if(mode == RayQueryMode::Any)
+                        {
+                            break;
+                        }
+                    }
+                }
+            };
+
+            //------------------------------------------------------------
+            // Oversized objects are not ordered, so test them first to tighten the nearest distance
+
+            auto findOversized = m_Cells.find(OversizedCell);
+
+            if(findOversized != m_Cells.end())
+            {
+                visitObjects(findOversized->second);
+            }
+
+            //------------------------------------------------------------
+            // Visit the cells along the ray in the order that the ray enters them. 
+            // Each candidate is the distance at which the ray enters the cell and the cell objects.
+
+            float regionMin[3];
+            float regionMax[3];
+
+            if(!(found && (mode == RayQueryMode::Any)) && getRayRegion(ray, nearest, regionMin, regionMax))
+            {
+                std::vector<std::pair<float, std::vector<CellObject> const*>> candidates;
+
+                forEachCell(regionMin, regionMax, [&](int32_t const coords[3], std::vector<CellObject> const& cellObjects)
+                {
+                    float boundsMin[3];
+                    float boundsMax[3];
+                    float distance = 0.0f;
+
+                    getLooseBounds(coords, boundsMin, boundsMax);
+
+                    if(IntersectsRay(origin, invDir, parallel, boundsMin, boundsMax, distance) && (distance <= nearest))
+                    {
+                        candidates.emplace_back(std::make_pair(distance, &cellObjects));
+                    }
+                });
+
+                std::sort(candidates.begin(), candidates.end(), [](std::pair<float, std::vector<CellObject> const*> const& a, std::pair<float, std::vector<CellObject> const*> const& b)->bool
+                {
+                    return (a.first < b.first);
+                });
+
+                for(auto const& candidate : candidates)
+                {
+                    if((candidate.first > nearest) || (found && (mode == RayQueryMode::Any)))
+                    {
+                        // As the cells overlap, a cell entered before the nearest intersection may
+                        // still contain a nearer object. Any cell entered beyond it can not.
+                        break;
+                    }
+
+                    visitObjects(*candidate.second);
+                }
+            }
+
+            return found;
+        }
+
+        void UniformGridSceneTree::findNearestObjects(Math::Vector3f const& point, uint32_t const count, float const maxDistance, std::vector<std::pair<SceneObject*, float>>& objects) const
+        {
+            // Objects are gathered from a cube centered on the point. Any object that was not gathered
+            // is further away than the half-size of the cube, so the query is complete once the (count)
+            // nearest objects are all within that distance. Otherwise the cube is doubled in size.
+
+            const float origin[3] = { point.x, point.y, point.z };
+            const float maxDistanceSq = (maxDistance < FLT_MAX) ? (maxDistance * maxDistance) : FLT_MAX;
+
+            float occupiedMin[3];
+            float occupiedMax[3];
+
+            const bool occupied = getOccupiedBounds(occupiedMin, occupiedMax);
+            auto findOversized = m_Cells.find(OversizedCell);
+
+            float halfSize = (count == std::numeric_limits<uint32_t>::max()) ? maxDistance : fminf(m_CellSize, maxDistance);
+            bool complete = (count == 0);
+
+            while(!complete)
+            {
+                objects.clear();
+
+                float regionMin[3];
+                float regionMax[3];
+                bool coversGrid = true;
+
+                for(uint32_t i = 0; i < 3; i++)
+                {
+                    regionMin[i] = origin[i] - halfSize;
+                    regionMax[i] = origin[i] + halfSize;
+
+                    coversGrid = coversGrid && (!occupied || ((regionMin[i] <= occupiedMin[i]) && (regionMax[i] >= occupiedMax[i])));
+                }
+
+                auto visitObjects = [&](std::vector<CellObject> const& cellObjects)
+                {
+                    for(auto const& entry : cellObjects)
+                    {
+                        const float distanceSq = DistanceSquared(origin, entry.boundsMin, entry.boundsMax);
+
+                        if(distanceSq <= maxDistanceSq)
+                        {
+                            InsertNearest(objects, count, entry.object, distanceSq);
+                        }
+                    }
+                };
+
+                forEachCell(regionMin, regionMax, [&](int32_t const coords[3], std::vector<CellObject> const& cellObjects)
+                {
+                    visitObjects(cellObjects);
+                });
+
+                if(findOversized != m_Cells.end())
+                {
+                    visitObjects(findOversized->second);
+                }
+
+                complete = coversGrid || (halfSize >= maxDistance) || ((objects.size() == count) && (objects.front().second <= (halfSize * halfSize)));
+                halfSize *= 2.0f;
+            }
+
+            SortNearest(objects);
+        }
+
+        void UniformGridSceneTree::findIntersections(Math::BoundsSphere const& bounds, std::vector<SceneObject*>& objects) const
+        {
+            const Math::Vector3f center = bounds.getCenter();
+            const float radius = bounds.getRadius();
+            const float point[3] = { center.x, center.y, center.z };
+            const float regionMin[3] = { center.x - radius, center.y - radius, center.z - radius };
+            const float regionMax[3] = { center.x + radius, center.y + radius, center.z + radius };
+
+            findIntersecting(regionMin, regionMax, [&](float const boundsMin[3], float const boundsMax[3])->bool
+            {
+                return (DistanceSquared(point, boundsMin, boundsMax) <= (radius * radius));
+            }, objects);
+        }
+
+        void UniformGridSceneTree::findIntersections(Math::BoundsAABB const& bounds, std::vector<SceneObject*>& objects) const
+        {
+            const Math::Vector3f queryMin = bounds.getMinPoint();
+            const Math::Vector3f queryMax = bounds.getMaxPoint();
+            const float regionMin[3] = { queryMin.x, queryMin.y, queryMin.z };
+            const float regionMax[3] = { queryMax.x, queryMax.y, queryMax.z };
+
+            findIntersecting(regionMin, regionMax, [&](float const boundsMin[3], float const boundsMax[3])->bool
+            {
+                // Identical to BoundsAABB::intersects(BoundsAABB)
+
+                return !((boundsMin[0] > queryMax.x) || (queryMin.x > boundsMax[0]) ||
+                         (boundsMin[1] > queryMax.y) || (queryMin.y > boundsMax[1]) ||
+                         (boundsMin[2] > queryMax.z) || (queryMin.z > boundsMax[2]));
+            }, objects);
+        }
+
+        void UniformGridSceneTree::findIntersections(Math::BoundsOBB const& bounds, std::vector<SceneObject*>& objects) const
+        {
+            // The bounding sphere of the OBB is used to find the candidate cells
+
+            const Math::Vector3f center = bounds.getCenter();
+            const float radius = bounds.getExtents().getMagnitude();
+            const float regionMin[3] = { center.x - radius, center.y - radius, center.z - radius };
+            const float regionMax[3] = { center.x + radius, center.y + radius, center.z + radius };
+
+            findIntersecting(regionMin, regionMax, [&](float const boundsMin[3], float const boundsMax[3])->bool
+            {
+                return bounds.intersects(ToBounds(boundsMin, boundsMax));
+            }, objects);
+        }
+
+        bool UniformGridSceneTree::getRayRegion(Math::Ray const& ray, float const maxDistance, float regionMin[3], float regionMax[3]) const
+        {
+            float occupiedMin[3];
+            float occupiedMax[3];
+
+            bool result = getOccupiedBounds(occupiedMin, occupiedMax);
+
+            if(result)
+            {
+                float origin[3];
+                float invDir[3];
+                bool  parallel[3];
+
+                PrepareRay(ray, origin, invDir, parallel);
+
+                float tMin = 0.0f;
+                float tMax = maxDistance;
+
+                result = ClipRay(origin, invDir, parallel, occupiedMin, occupiedMax, tMin, tMax);
+
+                if(result)
+                {
+                    const Math::Vector3f direction = ray.getDirection();
+
+                    for(uint32_t i = 0; i < 3; i++)
+                    {
+                        const float entry = parallel[i] ? origin[i] : (origin[i] + (direction[i] * tMin));
+                        const float exit  = parallel[i] ? origin[i] : (origin[i] + (direction[i] * tMax));
+
+                        regionMin[i] = fminf(entry, exit);
+                        regionMax[i] = fmaxf(entry, exit);
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        template<typename Test>
+        void UniformGridSceneTree::findIntersecting(float const regionMin[3], float const regionMax[3], Test const& test, std::vector<SceneObject*>& objects) const
+        {
+            auto visitObjects = [&](std::vector<CellObject> const& cellObjects)
+            {
+                for(auto const& entry : cellObjects)
+                {
+                    if(test(entry.boundsMin, entry.boundsMax))
+                    {
+                        objects.emplace_back(entry.object);
+                    }
+                }
+            };
+
+            forEachCell(regionMin, regionMax, [&](int32_t const coords[3], std::vector<CellObject> const& cellObjects)
+            {
+                float boundsMin[3];
+                float boundsMax[3];
+
+                getLooseBounds(coords, boundsMin, boundsMax);
+
+                if(test(boundsMin, boundsMax))
+                {
+                    visitObjects(cellObjects);
+                }
+            });
+
+            auto findOversized = m_Cells.find(OversizedCell);
+
+            if(findOversized != m_Cells.end())
+            {
+                visitObjects(findOversized->second);
+            }
+        }
+
+        //----------------------------------------------------------------------------------
+        // PRIVATE METHODS
+        //----------------------------------------------------------------------------------
+    }
+}
\ No newline at end of file
@@ -12,7 +12,7 @@ namespace Ocular
 
         ThreadManager::ThreadManager()
         {
-
+            m_NumThreads = std::max(1u, std::thread::hardware_concurrency());
         }
 
         ThreadManager::~ThreadManager()
@@ -24,6 +24,22 @@ namespace Ocular
         // PUBLIC METHODS
         //----------------------------------------------------------------------------------
 
+        uint32_t ThreadManager::getNumThreads() const
+        {
+            return m_NumThreads;
+        }
+
+        uint32_t ThreadManager::getNumBatches(uint32_t const count, uint32_t const minBatchSize) const
+        {
+            const uint32_t batchSize  = std::max(1u, minBatchSize);
+            const uint32_t numBatches = (count / batchSize) + (((count % batchSize) != 0) ? 1 : 0);
+
+            // Batches are made as even as possible. Never more batches than elements or threads.
+            const uint32_t result = std::min(m_NumThreads, numBatches);
+
+            return std::max(1u, result);
+        }
+
         //----------------------------------------------------------------------------------
         // PROTECTED METHODS
         //----------------------------------------------------------------------------------
@@ -35,6 +35,10 @@ namespace Ocular
               m_ClearCount(0)
         {
             addRoutine(new AxisGizmoRoutine());
+
+            // getModelMatrix is overridden, so the batched world matrix updates can not be used for this object or the components.
+            // Instead the overridden matrix is passed to the TransformSystem whenever it is built.
+            OcularScene->getTransformSystem().setDetached(m_TransformHandle, true);
             
             m_AxisX = new AxisComponentGizmo(this, Axis::X);
             m_AxisY = new AxisComponentGizmo(this, Axis::Y);
@@ -98,6 +102,15 @@ namespace Ocular
                 result = transform.getModelMatrix();
             }
 
+            if(!local)
+            {
+                // Keeps the entry clean, so that moving the parent continues to invalidate the components
+                float data[16];
+                result.getData(data);
+
+                OcularScene->getTransformSystem().setWorldMatrix(m_TransformHandle, data);
+            }
+
             return result;
         }
 
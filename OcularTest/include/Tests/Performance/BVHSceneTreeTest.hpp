@@ -34,6 +34,11 @@ namespace Ocular
         class BVHSceneTree;
     }
 
+    namespace Math
+    {
+        class Frustum;
+    }
+
     /**
      * \addtogroup Tests
      * @{
@@ -44,11 +49,22 @@ namespace Ocular
          * \class BVHSceneTreeTest
          *
          * This test is used to evalualte the runtime efficiency of the BVH SceneTree.
+         * It only reports timings; the correctness of the queries is covered by the
+         * BVHSceneTree and CellSceneTree unit tests.
          *
          * The following features are tested:
          *
          *     - Tree Construction
          *     - Intersection Testing
+         *     - Visibility Testing (compared against a brute-force test of every object)
+         *     - Incremental Updating (compared against a full rebuild)
+         *     - Tree Quality (Morton-ordered compared against SAH construction)
+         *     - 4-wide (QBVH) Queries (compared against the binary tree)
+         *     - Multi-View Visibility (compared against a separate query per view)
+         *     - Closest-Hit Ray Queries (compared against sorting every intersection)
+         *     - Nearest Object Queries (compared against a brute-force sort of every object)
+         *     - Object Removal
+         *     - Cell-Based Trees (loose octree and uniform grid compared against the BVH)
          *
          * With the following number of objects:
          *
@@ -56,6 +72,7 @@ namespace Ocular
          *     - 100
          *     - 1000
          *     - 10000
+         *     - 50000 (visibility only)
          *
          * Since this is a performance test, it may take a non-trivial amount
          * of time to complete, and thus should not be run as part of the 
@@ -75,6 +92,112 @@ namespace Ocular
 
             void buildTree(uint32_t numObjects, double& elapsed);
             void buildObjects(uint32_t numObjects, std::vector<Core::SceneObject*>& objects);
+            void buildFrustum(Math::Frustum& frustum);
+
+            /**
+             * Times the retrieval of all visible objects via the tree and via a brute-force
+             * test of every object.
+             *
+             * \param[in]  numObjects
+             * \param[out] elapsedTree   Average time (ms) of BVHSceneTree::getAllVisibleObjects
+             * \param[out] elapsedBrute  Average time (ms) of testing every object against the frustum
+             */
+            void testVisibility(uint32_t numObjects, double& elapsedTree, double& elapsedBrute);
+
+            /**
+             * Times the incremental update of a tree in which only a subset of the objects move each frame.
+             *
+             * \param[in]  numObjects
+             * \param[in]  numMoved       Number of objects moved each frame
+             * \param[out] elapsedUpdate  Average time (ms) of restructuring the tree after the objects are moved
+             * \param[out] elapsedRebuild Time (ms) of the initial full build of the tree
+             */
+            void testUpdate(uint32_t numObjects, uint32_t numMoved, double& elapsedUpdate, double& elapsedRebuild);
+
+            /**
+             * Compares the build time and cost of the Morton-ordered (LBVH) and Surface Area Heuristic (SAH) trees
+             * for partially clustered objects.
+             *
+             * \param[in] numObjects
+             */
+            void testSAH(uint32_t numObjects);
+
+            /**
+             * Compares the visibility and ray query times of the binary (BVHSceneTree) and 4-wide (QBVHSceneTree) trees.
+             *
+             * \param[in] numObjects
+             */
+            void testQBVH(uint32_t numObjects);
+
+            /**
+             * Compares the time to find the visible objects of several views with a single multi-view query
+             * and with a separate query per view.
+             *
+             * \param[in] numObjects
+             * \param[in] numViews
+             */
+            void testMultiView(uint32_t numObjects, uint32_t numViews);
+
+            /**
+             * Compares the time to find the nearest object along many rays using the closest-hit query (individually
+             * and as a batch) and by taking the first of all sorted intersections.
+             *
+             * \param[in] numObjects
+             * \param[in] numRays
+             */
+            void testClosestHit(uint32_t numObjects, uint32_t numRays);
+
+            /**
+             * Compares the time to find the (count) objects nearest to many points using the batched nearest object
+             * query and a brute-force sort of every object.
+             *
+             * \param[in] numObjects
+             * \param[in] numPoints
+             * \param[in] count
+             */
+            void testNearest(uint32_t numObjects, uint32_t numPoints, uint32_t count);
+
+            /**
+             * Times the removal of a subset of the objects from a built tree, followed by the restructure.
+             *
+             * \param[in] numObjects
+             * \param[in] numRemoved
+             */
+            void testRemove(uint32_t numObjects, uint32_t numRemoved);
+
+            /**
+             * Compares the update and query times of the BVH, loose octree and uniform grid trees when
+             * a large portion of the objects move every frame.
+             *
+             * \param[in] numObjects
+             * \param[in] numMoved   Number of objects moved each frame
+             */
+            void testCellTrees(uint32_t numObjects, uint32_t numMoved);
+
+            /**
+             * Compares the time to load a saved SAH tree against the time to build it.
+             *
+             * \param[in] numObjects
+             */
+            void testSaveLoad(uint32_t numObjects);
+
+            /**
+             * Compares the time to find all overlapping pairs with a pair query against querying the bounds of
+             * each object individually. Objects are placed on a coarse lattice so that many of them coincide.
+             * Every tree type is timed both within a single tree and against every other tree type.
+             *
+             * \param[in] numObjects
+             */
+            void testPairs(uint32_t numObjects);
+
+            /**
+             * Rasterizes a single occluder that covers the entire view, halfway through the object volume, and
+             * compares the time of a combined frustum and occlusion query against the frustum query alone
+             * for every tree type.
+             *
+             * \param[in] numObjects
+             */
+            void testOcclusion(uint32_t numObjects);
 
             void cleanTree(Core::BVHSceneTree* tree);
             void cleanObjects(std::vector<Core::SceneObject*>& objects);
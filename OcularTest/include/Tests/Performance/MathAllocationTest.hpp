@@ -0,0 +1,108 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef __H__OCULAR_TEST_MATH_ALLOCATION__H__
+#define __H__OCULAR_TEST_MATH_ALLOCATION__H__
+
+#include "Tests/ATest.hpp"
+
+//------------------------------------------------------------------------------------------
+
+/**
+ * \addtogroup Ocular
+ * @{
+ */
+namespace Ocular
+{
+    /**
+     * \addtogroup Tests
+     * @{
+     */
+    namespace Tests
+    {
+        /**
+         * \class MathAllocationTest
+         *
+         * This test is used to evaluate the runtime efficiency of the math hot paths, and to
+         * verify that none of them perform a heap allocation.
+         *
+         * The following features are tested:
+         *
+         *     - Matrix4x4 (construction, multiplication, inversion, vector transformation)
+         *     - Matrix3x3 (construction from a Quaternion, multiplication, inversion)
+         *     - Quaternion (multiplication, slerp, vector rotation, conversion to a matrix)
+         *
+         * Allocations are counted by replacing the global operator new, so the counts reported
+         * are only those made on the calling thread while the timed loop is running.
+         *
+         * Since this is a performance test, it may take a non-trivial amount
+         * of time to complete, and thus should not be run as part of the 
+         * normal testing package.
+         *
+         */
+        class MathAllocationTest : public ATest 
+        {
+        public:
+
+            MathAllocationTest();
+            ~MathAllocationTest();
+
+            virtual void run() override;
+
+        protected:
+
+            /**
+             * \param[in] iterations Number of times each operation is performed
+             */
+            void testMatrix4x4(uint32_t iterations);
+
+            /**
+             * \param[in] iterations Number of times each operation is performed
+             */
+            void testMatrix3x3(uint32_t iterations);
+
+            /**
+             * \param[in] iterations Number of times each operation is performed
+             */
+            void testQuaternion(uint32_t iterations);
+
+            /**
+             * Logs the timing and allocation count of a single operation, and fails the current
+             * test if any allocation was made.
+             *
+             * \param[in] name
+             * \param[in] iterations
+             * \param[in] elapsedNS
+             * \param[in] allocations
+             * \param[in] line        Line to report on failure
+             */
+            void report(char const* name, uint32_t iterations, uint64_t elapsedNS, uint64_t allocations, unsigned line);
+
+        private:
+        };
+    }
+    /**
+     * @} End of Doxygen Groups
+     */
+}
+/**
+ * @} End of Doxygen Groups
+ */
+
+//------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
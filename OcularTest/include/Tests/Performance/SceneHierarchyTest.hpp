@@ -0,0 +1,127 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#ifndef __H__OCULAR_TEST_SCENE_HIERARCHY__H__
+#define __H__OCULAR_TEST_SCENE_HIERARCHY__H__
+
+#include "Tests/ATest.hpp"
+
+#include <vector>
+
+//------------------------------------------------------------------------------------------
+
+/**
+ * \addtogroup Ocular
+ * @{
+ */
+namespace Ocular
+{
+    namespace Core
+    {
+        class SceneObject;
+    }
+
+    /**
+     * \addtogroup Tests
+     * @{
+     */
+    namespace Tests
+    {
+        /**
+         * \class SceneHierarchyTest
+         *
+         * This test is used to evaluate the runtime efficiency of deep SceneObject hierarchies.
+         *
+         * The following features are tested:
+         *
+         *     - World Matrices (cached compared against multiplying the full parent chain)
+         *     - TransformSystem (batched update compared against composing each matrix individually)
+         *     - Parallel Update (every object of a large hierarchy moving each frame)
+         *
+         * Since this is a performance test, it may take a non-trivial amount
+         * of time to complete, and thus should not be run as part of the 
+         * normal testing package.
+         *
+         */
+        class SceneHierarchyTest : public ATest 
+        {
+        public:
+
+            SceneHierarchyTest();
+            ~SceneHierarchyTest();
+
+            virtual void run() override;
+
+        protected:
+
+            /**
+             * Builds a hierarchy of the specified depth with an equal number of objects at each level.
+             * The parent of each object is randomly selected from the level above it.
+             *
+             * \param[in]  numObjects
+             * \param[in]  depth
+             * \param[out] objects    All created objects, ordered from the top level to the bottom
+             */
+            void buildHierarchy(uint32_t numObjects, uint32_t depth, std::vector<Core::SceneObject*>& objects);
+
+            /**
+             * Times the retrieval of the world matrix of every object in a hierarchy in which a subset of the
+             * objects move each frame. The cached matrices must be identical to those built from the parent chain.
+             *
+             * \param[in] numObjects
+             * \param[in] depth
+             * \param[in] numMoved   Number of objects moved each frame
+             */
+            void testWorldMatrices(uint32_t numObjects, uint32_t depth, uint32_t numMoved);
+
+            /**
+             * Times the batched update of every world matrix within a standalone TransformSystem, and of
+             * partial updates in which a subset of the entries move each frame. The resulting matrices
+             * must match those composed individually.
+             *
+             * \param[in] numObjects
+             * \param[in] depth
+             * \param[in] numMoved   Number of entries moved each frame
+             */
+            void testTransformSystem(uint32_t numObjects, uint32_t depth, uint32_t numMoved);
+
+            /**
+             * Times the update of the world matrices and bounds of a TransformSystem in which every
+             * entry moves each frame. Each depth level is split across all available threads.
+             *
+             * \param[in] numObjects
+             * \param[in] depth
+             */
+            void testParallelUpdate(uint32_t numObjects, uint32_t depth);
+
+            void cleanObjects(std::vector<Core::SceneObject*>& objects);
+
+        private:
+        };
+    }
+    /**
+     * @} End of Doxygen Groups
+     */
+}
+/**
+ * @} End of Doxygen Groups
+ */
+
+//------------------------------------------------------------------------------------------
+
+#endif
\ No newline at end of file
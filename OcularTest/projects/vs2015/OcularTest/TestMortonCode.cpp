@@ -49,4 +49,76 @@ TEST(MortonCode, Proximity)
     EXPECT_TRUE(mortonD < mortonE);
     EXPECT_TRUE(mortonE < mortonF);
     EXPECT_TRUE(mortonF < mortonG);
+}
+
+TEST(MortonCode, Decode)
+{
+    // Components using all 21 bits must survive a round trip.
+
+    const uint32_t components[][3] =
+    {
+        { 0, 0, 0 },
+        { 2097151, 0, 0 },
+        { 0, 2097151, 0 },
+        { 0, 0, 2097151 },
+        { 2097151, 2097151, 2097151 },
+        { 1048576, 65536, 256 },
+        { 123456, 654321, 1999999 }
+    };
+
+    for(auto const& component : components)
+    {
+        uint32_t x = 0;
+        uint32_t y = 0;
+        uint32_t z = 0;
+
+        MortonCode::decode(MortonCode::calculate(component[0], component[1], component[2]), x, y, z);
+
+        EXPECT_EQ(component[0], x);
+        EXPECT_EQ(component[1], y);
+        EXPECT_EQ(component[2], z);
+    }
+
+    EXPECT_EQ(0x7FFFFFFFFFFFFFFFull, MortonCode::calculate(2097151u, 2097151u, 2097151u));
+}
+
+TEST(MortonCode, BatchSort)
+{
+    // Large enough to be split across multiple threads
+
+    const uint32_t count = 20000;
+
+    std::vector<float> x(count);
+    std::vector<float> y(count);
+    std::vector<float> z(count);
+
+    for(uint32_t i = 0; i < count; i++)
+    {
+        x[i] = static_cast<float>((i * 7919) % 1000) - 500.0f;
+        y[i] = static_cast<float>((i * 104729) % 1000) * 0.5f;
+        z[i] = static_cast<float>(i % 97) * 3.0f;
+    }
+
+    std::vector<uint64_t> codes;
+    std::vector<uint32_t> order;
+
+    MortonCode::calculate(x.data(), y.data(), z.data(), count, codes, order);
+
+    ASSERT_EQ(count, static_cast<uint32_t>(codes.size()));
+    ASSERT_EQ(count, static_cast<uint32_t>(order.size()));
+
+    std::vector<bool> seen(count, false);
+
+    for(uint32_t i = 0; i < count; i++)
+    {
+        ASSERT_LT(order[i], count);
+        EXPECT_FALSE(seen[order[i]]);
+
+        seen[order[i]] = true;
+
+        if(i > 0)
+        {
+            EXPECT_LE(codes[i - 1], codes[i]);
+        }
+    }
 }
\ No newline at end of file
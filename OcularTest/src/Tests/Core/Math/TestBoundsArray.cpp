@@ -0,0 +1,266 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Math/Bounds/BoundsAABB.hpp"
+#include "Math/Bounds/BoundsSphere.hpp"
+#include "Math/Bounds/BoundsAABBArray.hpp"
+#include "Math/Bounds/BoundsSphereArray.hpp"
+#include "Math/Matrix4x4.hpp"
+#include "Math/Random/MersenneTwister19937.hpp"
+
+#ifdef _DEBUG
+
+#include "gtest/gtest.h"
+
+#include <list>
+#include <cmath>
+#include <algorithm>
+
+using namespace Ocular::Math;
+using namespace Ocular::Math::Random;
+
+//------------------------------------------------------------------------------------------
+
+namespace
+{
+    // Not a multiple of four, so that the scalar remainder of the SSE paths is also tested
+    const uint32_t NumBounds = 103;
+
+    /**
+     * Builds one random affine matrix per bounds, stored column-major as expected by the array
+     * transforms. Every third matrix is given a negative scale along one axis so that the
+     * absolute values taken in the extent calculations are exercised.
+     */
+    void BuildMatrices(MersenneTwister19937& rng, std::vector<Matrix4x4>& matrices, std::vector<float>& data)
+    {
+        matrices.resize(NumBounds);
+        data.resize(NumBounds * 16);
+
+        for(uint32_t i = 0; i < NumBounds; i++)
+        {
+            Matrix4x4 matrix;
+
+            for(uint32_t column = 0; column < 3; column++)
+            {
+                for(uint32_t row = 0; row < 3; row++)
+                {
+                    matrix.setElement(((row * 4) + column), rng.nextf(-2.0f, 2.0f));
+                }
+            }
+
+            matrix = Matrix4x4::CreateTranslationMatrix(Vector3f(rng.nextf(-100.0f, 100.0f), rng.nextf(-100.0f, 100.0f), rng.nextf(-100.0f, 100.0f))) * matrix;
+
+            if((i % 3) == 0)
+            {
+                Vector3f scale(1.0f, 1.0f, 1.0f);
+                scale[(i / 3) % 3] = -rng.nextf(0.5f, 3.0f);
+
+                matrix = matrix * Matrix4x4::CreateScaleMatrix(scale);
+            }
+
+            matrices[i] = matrix;
+            matrix.getData(&data[i * 16]);
+        }
+    }
+
+    /**
+     * Indices of every other bounds plus a shuffled run, so that the SSE paths gather from
+     * scattered slots rather than only from consecutive ones.
+     */
+    void BuildIndices(MersenneTwister19937& rng, std::vector<uint32_t>& indices)
+    {
+        indices.clear();
+
+        for(uint32_t i = 0; i < NumBounds; i++)
+        {
+            if(((i % 2) == 0) || (i > (NumBounds / 2)))
+            {
+                indices.push_back(i);
+            }
+        }
+
+        for(uint32_t i = static_cast<uint32_t>(indices.size()) - 1; i > 0; i--)
+        {
+            std::swap(indices[i], indices[rng.next() % (i + 1)]);
+        }
+    }
+
+    float Tolerance(float const expected)
+    {
+        return 0.0005f * std::max(1.0f, fabsf(expected));
+    }
+
+    void ExpectNear(Vector3f const& expected, Vector3f const& actual)
+    {
+        EXPECT_NEAR(expected.x, actual.x, Tolerance(expected.x));
+        EXPECT_NEAR(expected.y, actual.y, Tolerance(expected.y));
+        EXPECT_NEAR(expected.z, actual.z, Tolerance(expected.z));
+    }
+}
+
+//------------------------------------------------------------------------------------------
+
+TEST(BoundsArray, TransformAABBMatchesScalar)
+{
+    MersenneTwister19937 rng;
+    rng.seed(17);
+
+    std::vector<Matrix4x4> matrices;
+    std::vector<float> data;
+    std::vector<uint32_t> indices;
+
+    BuildMatrices(rng, matrices, data);
+    BuildIndices(rng, indices);
+
+    BoundsAABBArray local(NumBounds);
+    BoundsAABBArray world(NumBounds);
+
+    for(uint32_t i = 0; i < NumBounds; i++)
+    {
+        const Vector3f center(rng.nextf(-50.0f, 50.0f), rng.nextf(-50.0f, 50.0f), rng.nextf(-50.0f, 50.0f));
+        const Vector3f extents(rng.nextf(0.1f, 10.0f), rng.nextf(0.1f, 10.0f), rng.nextf(0.1f, 10.0f));
+
+        local.set(i, BoundsAABB(center, extents));
+        world.set(i, BoundsAABB(Vector3f(-1.0f, -1.0f, -1.0f), Vector3f(1.0f, 1.0f, 1.0f)));
+    }
+
+    local.transform(data.data(), indices.data(), static_cast<uint32_t>(indices.size()), world);
+
+    std::vector<bool> transformed(NumBounds, false);
+
+    for(auto index : indices)
+    {
+        transformed[index] = true;
+    }
+
+    for(uint32_t i = 0; i < NumBounds; i++)
+    {
+        if(transformed[i])
+        {
+            // The scalar path transforms all eight corners and bounds them, which Arvo's method must match exactly
+
+            const BoundsAABB bounds = local.get(i);
+            const Vector3f minPoint = bounds.getMinPoint();
+            const Vector3f maxPoint = bounds.getMaxPoint();
+
+            std::list<Point3f> corners;
+
+            for(uint32_t corner = 0; corner < 8; corner++)
+            {
+                corners.emplace_back(Point3f(((corner & 1) ? maxPoint.x : minPoint.x), ((corner & 2) ? maxPoint.y : minPoint.y), ((corner & 4) ? maxPoint.z : minPoint.z)));
+            }
+
+            const BoundsAABB expected(corners, matrices[i]);
+            const BoundsAABB actual = world.get(i);
+
+            ExpectNear(expected.getCenter(), actual.getCenter());
+            ExpectNear(expected.getExtents(), actual.getExtents());
+        }
+        else
+        {
+            // Bounds that were not listed must be left untouched
+
+            EXPECT_EQ(Vector3f(-1.0f, -1.0f, -1.0f), world.get(i).getCenter());
+            EXPECT_EQ(Vector3f(1.0f, 1.0f, 1.0f), world.get(i).getExtents());
+        }
+    }
+
+    // Transforming in place must produce the same result
+
+    BoundsAABBArray inPlace = local;
+    inPlace.transform(data.data(), indices.data(), static_cast<uint32_t>(indices.size()), inPlace);
+
+    for(auto index : indices)
+    {
+        EXPECT_EQ(world.get(index).getCenter(), inPlace.get(index).getCenter());
+        EXPECT_EQ(world.get(index).getExtents(), inPlace.get(index).getExtents());
+    }
+}
+
+TEST(BoundsArray, TransformSphereMatchesScalar)
+{
+    MersenneTwister19937 rng;
+    rng.seed(19);
+
+    std::vector<Matrix4x4> matrices;
+    std::vector<float> data;
+    std::vector<uint32_t> indices;
+
+    BuildMatrices(rng, matrices, data);
+    BuildIndices(rng, indices);
+
+    BoundsSphereArray local(NumBounds);
+    BoundsSphereArray world(NumBounds);
+
+    for(uint32_t i = 0; i < NumBounds; i++)
+    {
+        const Vector3f center(rng.nextf(-50.0f, 50.0f), rng.nextf(-50.0f, 50.0f), rng.nextf(-50.0f, 50.0f));
+
+        local.set(i, BoundsSphere(center, rng.nextf(0.1f, 10.0f)));
+        world.set(i, BoundsSphere(Vector3f(-1.0f, -1.0f, -1.0f), 1.0f));
+    }
+
+    local.transform(data.data(), indices.data(), static_cast<uint32_t>(indices.size()), world);
+
+    std::vector<bool> transformed(NumBounds, false);
+
+    for(auto index : indices)
+    {
+        transformed[index] = true;
+    }
+
+    for(uint32_t i = 0; i < NumBounds; i++)
+    {
+        if(transformed[i])
+        {
+            // The center is transformed as a point and the radius scaled by the longest basis axis,
+            // regardless of the sign of that axis' scale
+
+            const BoundsSphere bounds = local.get(i);
+            float scale = 0.0f;
+
+            for(uint32_t column = 0; column < 3; column++)
+            {
+                const Vector4f axis = matrices[i].getCol(column);
+                scale = std::max(scale, Vector3f(axis.x, axis.y, axis.z).getLength());
+            }
+
+            const Vector3f expectedCenter = matrices[i] * bounds.getCenter();
+            const float expectedRadius = bounds.getRadius() * scale;
+
+            const BoundsSphere actual = world.get(i);
+
+            ExpectNear(expectedCenter, actual.getCenter());
+            EXPECT_NEAR(expectedRadius, actual.getRadius(), Tolerance(expectedRadius));
+        }
+        else
+        {
+            EXPECT_EQ(Vector3f(-1.0f, -1.0f, -1.0f), world.get(i).getCenter());
+            EXPECT_EQ(1.0f, world.get(i).getRadius());
+        }
+    }
+
+    BoundsSphereArray inPlace = local;
+    inPlace.transform(data.data(), indices.data(), static_cast<uint32_t>(indices.size()), inPlace);
+
+    for(auto index : indices)
+    {
+        EXPECT_EQ(world.get(index).getCenter(), inPlace.get(index).getCenter());
+        EXPECT_EQ(world.get(index).getRadius(), inPlace.get(index).getRadius());
+    }
+}
+
+#endif
@@ -15,6 +15,9 @@
  */
 
 #include "Math/Geometry/Frustum.hpp"
+#include "Math/Bounds/BoundsAABB.hpp"
+#include "Math/Bounds/BoundsAABBArray.hpp"
+#include "Math/Bounds/BoundsSphereArray.hpp"
 
 #ifdef _DEBUG
 
@@ -107,4 +110,116 @@ TEST(Frustum, ContainsPoint)
     EXPECT_TRUE(frustum.contains(farMidpoint));
 }
 
+TEST(Frustum, ContainsAABB)
+{
+    Frustum frustum;
+
+    frustum.setViewMatrix(Matrix4x4::CreateLookAtMatrix(Vector3f(0.0f, 0.0f, 0.0f), Vector3f(0.0f, 0.0f, -1.0f), Vector3f::Up()));
+    frustum.setProjectionMatrix(Matrix4x4::CreatePerspectiveMatrix(60.0f, (1024.0f / 768.0f), 10.0f, 100.0f));
+    frustum.rebuild();
+
+    auto nearCorners = frustum.getNearClipCorners();
+    auto farCorners = frustum.getFarClipCorners();
+
+    const Point3f nearMidpoint = Vector3f::Midpoint(nearCorners[0], nearCorners[2]);
+    const Point3f farMidpoint  = Vector3f::Midpoint(farCorners[0], farCorners[2]);
+    const Point3f center       = Vector3f::Midpoint(nearMidpoint, farMidpoint);
+    const Vector3f forward     = (farMidpoint - nearMidpoint).getNormalized();
+
+    const BoundsAABB inside(center, Vector3f(1.0f, 1.0f, 1.0f));
+    const BoundsAABB intersects(farCorners[0], Vector3f(1.0f, 1.0f, 1.0f));
+    const BoundsAABB outside((farMidpoint + (forward * 50.0f)), Vector3f(1.0f, 1.0f, 1.0f));
+
+    IntersectionType result = IntersectionType::Outside;
+
+    EXPECT_TRUE(frustum.contains(inside, &result));
+    EXPECT_EQ(IntersectionType::Inside, result);
+
+    EXPECT_TRUE(frustum.contains(intersects, &result));
+    EXPECT_EQ(IntersectionType::Intersects, result);
+
+    EXPECT_FALSE(frustum.contains(outside, &result));
+    EXPECT_EQ(IntersectionType::Outside, result);
+}
+
+TEST(Frustum, ContainsAABBArray)
+{
+    Frustum frustum;
+
+    frustum.setViewMatrix(Matrix4x4::CreateLookAtMatrix(Vector3f(0.0f, 0.0f, 0.0f), Vector3f(0.0f, 0.0f, -1.0f), Vector3f::Up()));
+    frustum.setProjectionMatrix(Matrix4x4::CreatePerspectiveMatrix(60.0f, (1024.0f / 768.0f), 10.0f, 100.0f));
+    frustum.rebuild();
+
+    // Not a multiple of four, so that the scalar remainder is also tested
+
+    const uint32_t count = 103;
+    BoundsAABBArray bounds(count);
+
+    for(uint32_t i = 0; i < count; i++)
+    {
+        const Vector3f center((static_cast<float>(i % 9) * 15.0f) - 60.0f, (static_cast<float>(i % 7) * 15.0f) - 45.0f, 5.0f - (static_cast<float>(i) * 1.2f));
+        const Vector3f extents(1.0f + static_cast<float>(i % 3), 2.0f, 1.0f + static_cast<float>(i % 5));
+
+        bounds.set(i, BoundsAABB(center, extents));
+    }
+
+    std::vector<uint32_t> visible;
+    std::vector<uint32_t> inside;
+
+    const uint32_t numVisible = frustum.contains(bounds, visible, &inside);
+
+    uint32_t expectedVisible = 0;
+
+    for(uint32_t i = 0; i < count; i++)
+    {
+        IntersectionType result = IntersectionType::Outside;
+        const bool expected = frustum.contains(bounds.get(i), &result);
+
+        EXPECT_EQ(expected, ((visible[i / 32] >> (i % 32)) & 1) != 0);
+        EXPECT_EQ((result == IntersectionType::Inside), ((inside[i / 32] >> (i % 32)) & 1) != 0);
+
+        expectedVisible += (expected ? 1 : 0);
+    }
+
+    EXPECT_EQ(expectedVisible, numVisible);
+}
+
+TEST(Frustum, ContainsSphereArray)
+{
+    Frustum frustum;
+
+    frustum.setViewMatrix(Matrix4x4::CreateLookAtMatrix(Vector3f(0.0f, 0.0f, 0.0f), Vector3f(0.0f, 0.0f, -1.0f), Vector3f::Up()));
+    frustum.setProjectionMatrix(Matrix4x4::CreatePerspectiveMatrix(60.0f, (1024.0f / 768.0f), 10.0f, 100.0f));
+    frustum.rebuild();
+
+    const uint32_t count = 103;
+    BoundsSphereArray bounds(count);
+
+    for(uint32_t i = 0; i < count; i++)
+    {
+        const Vector3f center((static_cast<float>(i % 9) * 15.0f) - 60.0f, (static_cast<float>(i % 7) * 15.0f) - 45.0f, 5.0f - (static_cast<float>(i) * 1.2f));
+        bounds.set(i, BoundsSphere(center, 1.0f + static_cast<float>(i % 4)));
+    }
+
+    std::vector<uint32_t> visible;
+    std::vector<uint32_t> inside;
+
+    const uint32_t numVisible = frustum.contains(bounds, visible, &inside);
+
+    uint32_t expectedVisible = 0;
+
+    for(uint32_t i = 0; i < count; i++)
+    {
+        IntersectionType result = IntersectionType::Outside;
+        const bool expected = frustum.contains(bounds.get(i), &result);
+
+        EXPECT_EQ(expected, ((visible[i / 32] >> (i % 32)) & 1) != 0);
+        EXPECT_EQ((result == IntersectionType::Inside), ((inside[i / 32] >> (i % 32)) & 1) != 0);
+
+        expectedVisible += (expected ? 1 : 0);
+    }
+
+    EXPECT_EQ(expectedVisible, numVisible);
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,233 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Math/MathBatch.hpp"
+#include "Math/Matrix4x4.hpp"
+#include "Math/Quaternion.hpp"
+
+#ifdef _DEBUG
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <vector>
+
+using namespace Ocular::Math;
+
+//------------------------------------------------------------------------------------------
+
+namespace
+{
+    // Counts are chosen so that both the 4-wide batches and the scalar remainders are exercised
+
+    const uint32_t NumBatchElements = 11;
+
+    const Matrix4x4 batchMatrix(Vector3f(1.0f, -2.0f, 3.0f), Quaternion(45.0f, Vector3f(0.0f, 1.0f, 0.0f)), Vector3f(2.0f, 1.0f, 0.5f));
+
+    Vector4f BatchVector(uint32_t const index)
+    {
+        const float value = static_cast<float>(index);
+        return Vector4f(value, 1.0f - value, (value * 0.5f) - 2.0f, 1.0f);
+    }
+
+    void ExpectNear(Vector3f const& expected, Vector3f const& result)
+    {
+        EXPECT_NEAR(expected.x, result.x, EPSILON_FLOAT);
+        EXPECT_NEAR(expected.y, result.y, EPSILON_FLOAT);
+        EXPECT_NEAR(expected.z, result.z, EPSILON_FLOAT);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+
+TEST(MathBatch, TransformPoints)
+{
+    std::vector<Vector3f> points(NumBatchElements);
+    std::vector<Vector3f> results(NumBatchElements);
+
+    for(uint32_t i = 0; i < NumBatchElements; i++)
+    {
+        points[i] = BatchVector(i).xyz();
+    }
+
+    TransformPoints(batchMatrix, &points[0], &results[0], NumBatchElements);
+
+    for(uint32_t i = 0; i < NumBatchElements; i++)
+    {
+        ExpectNear((batchMatrix * points[i]), results[i]);
+    }
+
+    // Transforming in-place should give the same result
+
+    TransformPoints(batchMatrix, &points[0], &points[0], NumBatchElements);
+
+    for(uint32_t i = 0; i < NumBatchElements; i++)
+    {
+        ExpectNear(results[i], points[i]);
+    }
+}
+
+TEST(MathBatch, TransformDirections)
+{
+    std::vector<Vector3f> directions(NumBatchElements);
+    std::vector<Vector3f> results(NumBatchElements);
+
+    for(uint32_t i = 0; i < NumBatchElements; i++)
+    {
+        directions[i] = BatchVector(i).xyz();
+    }
+
+    TransformDirections(batchMatrix, &directions[0], &results[0], NumBatchElements);
+
+    for(uint32_t i = 0; i < NumBatchElements; i++)
+    {
+        ExpectNear((batchMatrix * Vector4f(directions[i], 0.0f)).xyz(), results[i]);
+    }
+}
+
+TEST(MathBatch, TransformVectors)
+{
+    std::vector<Vector4f> vectors(NumBatchElements);
+    std::vector<Vector4f> results(NumBatchElements);
+
+    for(uint32_t i = 0; i < NumBatchElements; i++)
+    {
+        vectors[i] = BatchVector(i);
+    }
+
+    TransformVectors(batchMatrix, &vectors[0], &results[0], NumBatchElements);
+
+    for(uint32_t i = 0; i < NumBatchElements; i++)
+    {
+        const Vector4f expected = batchMatrix * vectors[i];
+
+        ExpectNear(expected.xyz(), results[i].xyz());
+        EXPECT_NEAR(expected.w, results[i].w, EPSILON_FLOAT);
+    }
+}
+
+TEST(MathBatch, MultiplyMatrices)
+{
+    std::vector<Matrix4x4> lhs(NumBatchElements);
+    std::vector<Matrix4x4> rhs(NumBatchElements);
+    std::vector<Matrix4x4> results(NumBatchElements);
+
+    for(uint32_t i = 0; i < NumBatchElements; i++)
+    {
+        lhs[i] = Matrix4x4(BatchVector(i).xyz(), Quaternion(static_cast<float>(i) * 10.0f, Vector3f(0.0f, 0.0f, 1.0f)));
+        rhs[i] = Matrix4x4(BatchVector(i + 1).xyz(), Quaternion(static_cast<float>(i) * 5.0f, Vector3f(1.0f, 0.0f, 0.0f)));
+    }
+
+    MultiplyMatrices(&lhs[0], &rhs[0], &results[0], NumBatchElements);
+
+    for(uint32_t i = 0; i < NumBatchElements; i++)
+    {
+        const Matrix4x4 expected = lhs[i] * rhs[i];
+
+        for(uint32_t j = 0; j < 16; j++)
+        {
+            EXPECT_NEAR(expected.getElement(j), results[i].getElement(j), EPSILON_FLOAT);
+        }
+    }
+
+    MultiplyMatrices(batchMatrix, &rhs[0], &results[0], NumBatchElements);
+
+    for(uint32_t i = 0; i < NumBatchElements; i++)
+    {
+        const Matrix4x4 expected = batchMatrix * rhs[i];
+
+        for(uint32_t j = 0; j < 16; j++)
+        {
+            EXPECT_NEAR(expected.getElement(j), results[i].getElement(j), EPSILON_FLOAT);
+        }
+    }
+}
+
+TEST(MathBatch, NormalizeQuaternions)
+{
+    std::vector<Quaternion> quaternions(NumBatchElements);
+
+    for(uint32_t i = 0; i < NumBatchElements; i++)
+    {
+        const Vector4f values = BatchVector(i);
+        quaternions[i] = Quaternion(values.w, values.x, values.y, values.z);
+    }
+
+    quaternions[2] = Quaternion(0.0f, 0.0f, 0.0f, 0.0f);    // Zero-length quaternions become the identity
+
+    std::vector<Quaternion> results = quaternions;
+    NormalizeQuaternions(&results[0], NumBatchElements);
+
+    for(uint32_t i = 0; i < NumBatchElements; i++)
+    {
+        Quaternion expected = quaternions[i].getNormalized();
+
+        EXPECT_NEAR(expected.w(), results[i].w(), EPSILON_FLOAT);
+        EXPECT_NEAR(expected.x(), results[i].x(), EPSILON_FLOAT);
+        EXPECT_NEAR(expected.y(), results[i].y(), EPSILON_FLOAT);
+        EXPECT_NEAR(expected.z(), results[i].z(), EPSILON_FLOAT);
+    }
+}
+
+TEST(MathBatch, CalculateMinMax)
+{
+    std::vector<Vector4f> points(NumBatchElements);
+
+    Vector3f expectedMin(FLT_MAX, FLT_MAX, FLT_MAX);
+    Vector3f expectedMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+    Vector3f expectedTransformedMin = expectedMin;
+    Vector3f expectedTransformedMax = expectedMax;
+
+    for(uint32_t i = 0; i < NumBatchElements; i++)
+    {
+        points[i] = BatchVector(i);
+
+        const Vector4f transformed = batchMatrix * points[i];
+
+        expectedMin.x = std::min(expectedMin.x, points[i].x);
+        expectedMin.y = std::min(expectedMin.y, points[i].y);
+        expectedMin.z = std::min(expectedMin.z, points[i].z);
+
+        expectedMax.x = std::max(expectedMax.x, points[i].x);
+        expectedMax.y = std::max(expectedMax.y, points[i].y);
+        expectedMax.z = std::max(expectedMax.z, points[i].z);
+
+        expectedTransformedMin.x = std::min(expectedTransformedMin.x, transformed.x);
+        expectedTransformedMin.y = std::min(expectedTransformedMin.y, transformed.y);
+        expectedTransformedMin.z = std::min(expectedTransformedMin.z, transformed.z);
+
+        expectedTransformedMax.x = std::max(expectedTransformedMax.x, transformed.x);
+        expectedTransformedMax.y = std::max(expectedTransformedMax.y, transformed.y);
+        expectedTransformedMax.z = std::max(expectedTransformedMax.z, transformed.z);
+    }
+
+    Vector3f min;
+    Vector3f max;
+
+    CalculateMinMax(&points[0], NumBatchElements, 0, min, max);
+
+    ExpectNear(expectedMin, min);
+    ExpectNear(expectedMax, max);
+
+    CalculateMinMax(batchMatrix, &points[0], NumBatchElements, 0, min, max);
+
+    ExpectNear(expectedTransformedMin, min);
+    ExpectNear(expectedTransformedMax, max);
+}
+
+#endif
\ No newline at end of file
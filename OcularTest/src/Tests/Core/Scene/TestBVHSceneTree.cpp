@@ -16,13 +16,24 @@
 
 #include "OcularEngine.hpp"
 #include "Scene/BVHSceneTree.hpp"
+#include "Scene/BVHSAHSceneTree.hpp"
+#include "Scene/QBVHSceneTree.hpp"
+#include "Scene/TransformSystem.hpp"
+#include "Scene/OcclusionBuffer.hpp"
+#include "Math/Random/MersenneTwister19937.hpp"
+#include "FileIO/File.hpp"
 
 #ifdef _DEBUG
 
 #include "gtest/gtest.h"
 
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+
 using namespace Ocular::Core;
 using namespace Ocular::Math;
+using namespace Ocular::Math::Random;
 
 //------------------------------------------------------------------------------------------
 // Statics
@@ -31,12 +42,45 @@ using namespace Ocular::Math;
 static std::vector<SceneObject*> g_Objects;
 static std::shared_ptr<BVHSceneTree> g_SceneTree = std::make_shared<BVHSceneTree>();
 
+static const uint32_t g_NumTreeTypes = 3;    ///< BVHSceneTree, BVHSAHSceneTree and QBVHSceneTree (see createTree)
+
+/**
+ * Counts the number of times that the tree is built from scratch.
+ */
+class CountingBVHSceneTree : public BVHSceneTree
+{
+public:
+
+    CountingBVHSceneTree() : numBuilds(0) { }
+
+    uint32_t numBuilds;
+
+protected:
+
+    virtual void build() override
+    {
+        numBuilds++;
+        BVHSceneTree::build();
+    }
+};
+
 //------------------------------------------------------------------------------------------
 // Forward Declarations
 //------------------------------------------------------------------------------------------
 
 void populateObjects();
 bool contains(std::vector<SceneObject*> const& vector, SceneObject const* obj);
+void updateBounds(BVHSceneTree& tree);
+
+BVHSceneTree* createTree(uint32_t type, std::vector<SceneObject*> const& objects);
+void destroyTree(BVHSceneTree* tree);
+void buildRandomObjects(uint32_t numObjects, std::vector<SceneObject*>& objects);
+void buildRandomRays(uint32_t numRays, std::vector<Ray>& rays);
+void buildViewFrustum(float x, Frustum& frustum);
+void destroyObjects(std::vector<SceneObject*>& objects);
+float closestHitDistance(Ray const& ray, std::vector<SceneObject*> const& objects);
+float distanceToObject(Vector3f const& point, SceneObject* object);
+std::vector<SceneObject*> sortedObjects(std::vector<SceneObject*> objects);
 
 //------------------------------------------------------------------------------------------
 // Test Methods
@@ -201,6 +245,709 @@ TEST(BVHSceneTree, GetIntersectionsAABB)
     EXPECT_TRUE(contains(hitsC, g_Objects[4]));
 }
 
+TEST(BVHSceneTree, LoadWithoutRebuild)
+{
+    const File file("TestBVHSceneTree.obvh");
+    const uint32_t numObjects = 16;
+
+    //--------------------------------------------------------------------
+    // Build and save a tree, and then destroy it's objects as if the Scene was unloaded
+
+    std::vector<SceneObject*> savedObjects;
+    std::vector<std::string> uuids;
+    std::vector<Vector3f> positions;
+
+    for(uint32_t i = 0; i < numObjects; i++)
+    {
+        positions.push_back(Vector3f(static_cast<float>(i * 3), static_cast<float>((i % 4) * 3), 0.0f));
+
+        SceneObject* object = new SceneObject();
+        object->setPosition(positions[i]);
+
+        savedObjects.push_back(object);
+        uuids.push_back(object->getUUID().toString());
+    }
+
+    BVHSceneTree savedTree;
+    savedTree.addObjects(savedObjects);
+    savedTree.restructure();
+
+    EXPECT_TRUE(savedTree.save(file));
+
+    savedTree.destroy();
+
+    for(auto object : savedObjects)
+    {
+        delete object;
+    }
+
+    //--------------------------------------------------------------------
+    // Recreate the objects and load the saved tree in place of building it
+
+    std::vector<SceneObject*> objects;
+
+    for(uint32_t i = 0; i < numObjects; i++)
+    {
+        SceneObject* object = new SceneObject();
+        object->setUUID(uuids[i]);
+        object->setPosition(positions[i]);
+
+        objects.push_back(object);
+    }
+
+    CountingBVHSceneTree loadedTree;
+    loadedTree.addObjects(objects);
+
+    EXPECT_TRUE(loadedTree.load(file));
+
+    //--------------------------------------------------------------------
+    // The first update must not rebuild (or even dirty) the loaded tree
+
+    updateBounds(loadedTree);
+    loadedTree.restructure();
+
+    EXPECT_EQ(loadedTree.numBuilds, 0);
+
+    //--------------------------------------------------------------------
+    // Moving an object refits the loaded tree instead of rebuilding it
+
+    objects[0]->setPosition(positions[0] + Vector3f(0.0f, 0.0f, 1.0f));
+
+    updateBounds(loadedTree);
+    loadedTree.restructure();
+
+    std::vector<SceneObject*> hits;
+    loadedTree.getIntersections(BoundsAABB(positions[0] + Vector3f(0.0f, 0.0f, 1.0f), Vector3f(0.5f, 0.5f, 0.5f)), hits);
+
+    EXPECT_EQ(loadedTree.numBuilds, 0);
+    EXPECT_TRUE(contains(hits, objects[0]));
+
+    //--------------------------------------------------------------------
+    // Clean up
+
+    loadedTree.destroy();
+
+    for(auto object : objects)
+    {
+        delete object;
+    }
+
+    std::remove(file.getFullPath().c_str());
+}
+
+TEST(BVHSceneTree, ClosestHitRay)
+{
+    std::vector<SceneObject*> objects;
+    buildRandomObjects(500, objects);
+
+    std::vector<Ray> rays;
+    buildRandomRays(64, rays);
+
+    for(uint32_t type = 0; type < g_NumTreeTypes; type++)
+    {
+        BVHSceneTree* tree = createTree(type, objects);
+
+        std::vector<std::pair<SceneObject*, float>> batched;
+        tree->getIntersections(rays, RayQueryMode::Closest, batched);
+
+        ASSERT_EQ(batched.size(), rays.size());
+
+        for(uint32_t i = 0; i < static_cast<uint32_t>(rays.size()); i++)
+        {
+            const float expected = closestHitDistance(rays[i], objects);
+
+            std::pair<SceneObject*, float> hit;
+            const bool found = tree->getIntersection(rays[i], RayQueryMode::Closest, hit);
+
+            EXPECT_EQ(found, (expected < FLT_MAX));
+            EXPECT_EQ(batched[i].first, hit.first);
+
+            if(found)
+            {
+                EXPECT_NEAR(hit.second, expected, 0.01f);
+                EXPECT_NEAR(batched[i].second, expected, 0.01f);
+
+                // Nothing may be found before the closest intersection
+
+                EXPECT_FALSE(tree->getIntersection(rays[i], RayQueryMode::Closest, hit, (expected * 0.5f)));
+                EXPECT_EQ(hit.first, nullptr);
+            }
+        }
+
+        destroyTree(tree);
+    }
+
+    destroyObjects(objects);
+}
+
+TEST(BVHSceneTree, AnyHitRay)
+{
+    std::vector<SceneObject*> objects;
+    buildRandomObjects(500, objects);
+
+    std::vector<Ray> rays;
+    buildRandomRays(64, rays);
+
+    for(uint32_t type = 0; type < g_NumTreeTypes; type++)
+    {
+        BVHSceneTree* tree = createTree(type, objects);
+
+        for(uint32_t i = 0; i < static_cast<uint32_t>(rays.size()); i++)
+        {
+            const float expected = closestHitDistance(rays[i], objects);
+
+            std::pair<SceneObject*, float> hit;
+            const bool found = tree->getIntersection(rays[i], RayQueryMode::Any, hit);
+
+            EXPECT_EQ(found, (expected < FLT_MAX));
+
+            if(found)
+            {
+                // Any intersection may be returned, but it must be a real one and no closer than the closest
+
+                Point3f point;
+                float distance = 0.0f;
+
+                ASSERT_NE(hit.first, nullptr);
+                EXPECT_TRUE(rays[i].intersects(hit.first->getBoundsAABB(false), point, distance));
+                EXPECT_NEAR(hit.second, distance, 0.01f);
+                EXPECT_GE(hit.second, (expected - 0.01f));
+
+                // And it must respect the maximum distance
+
+                EXPECT_FALSE(tree->getIntersection(rays[i], RayQueryMode::Any, hit, (expected * 0.5f)));
+                EXPECT_TRUE(tree->getIntersection(rays[i], RayQueryMode::Any, hit, (expected + 1.0f)));
+                EXPECT_LE(hit.second, (expected + 1.0f));
+            }
+        }
+
+        destroyTree(tree);
+    }
+
+    destroyObjects(objects);
+}
+
+TEST(BVHSceneTree, NearestOrderingAndTies)
+{
+    // Objects are placed symmetrically about the origin, so that each pair is equally distant from it
+
+    const Vector3f positions[5] = 
+    {
+        Vector3f( 3.0f, 0.0f,  0.0f), Vector3f(-3.0f, 0.0f, 0.0f),    // Tied nearest
+        Vector3f( 0.0f, 8.0f,  0.0f), Vector3f( 0.0f, 0.0f, 8.0f),    // Tied second nearest
+        Vector3f(20.0f, 0.0f,  0.0f)                                  // Furthest
+    };
+
+    std::vector<SceneObject*> objects;
+
+    for(uint32_t i = 0; i < 5; i++)
+    {
+        objects.push_back(new SceneObject());
+        objects[i]->setPosition(positions[i]);
+    }
+
+    const Vector3f origin(0.0f, 0.0f, 0.0f);
+
+    for(uint32_t type = 0; type < g_NumTreeTypes; type++)
+    {
+        BVHSceneTree* tree = createTree(type, objects);
+
+        std::vector<std::pair<SceneObject*, float>> nearest;
+
+        //----------------------------------------------------------------
+        // A tie at the cut-off returns either of the tied objects
+
+        tree->getNearestObjects(origin, 1, nearest);
+
+        ASSERT_EQ(nearest.size(), 1);
+        EXPECT_TRUE((nearest[0].first == objects[0]) || (nearest[0].first == objects[1]));
+        EXPECT_NEAR(nearest[0].second, distanceToObject(origin, objects[0]), 0.001f);
+
+        tree->getNearestObjects(origin, 3, nearest);
+
+        ASSERT_EQ(nearest.size(), 3);
+        EXPECT_TRUE((nearest[2].first == objects[2]) || (nearest[2].first == objects[3]));
+        EXPECT_NEAR(nearest[2].second, distanceToObject(origin, objects[2]), 0.001f);
+
+        //----------------------------------------------------------------
+        // Otherwise all objects are returned, nearest first, with tied objects together
+
+        tree->getNearestObjects(origin, 10, nearest);
+
+        ASSERT_EQ(nearest.size(), 5);
+
+        EXPECT_TRUE(contains({ nearest[0].first, nearest[1].first }, objects[0]));
+        EXPECT_TRUE(contains({ nearest[0].first, nearest[1].first }, objects[1]));
+        EXPECT_TRUE(contains({ nearest[2].first, nearest[3].first }, objects[2]));
+        EXPECT_TRUE(contains({ nearest[2].first, nearest[3].first }, objects[3]));
+        EXPECT_EQ(nearest[4].first, objects[4]);
+
+        for(uint32_t i = 0; i < 5; i++)
+        {
+            EXPECT_NEAR(nearest[i].second, distanceToObject(origin, nearest[i].first), 0.001f);
+
+            if(i > 0)
+            {
+                EXPECT_LE(nearest[i - 1].second, nearest[i].second);
+            }
+        }
+
+        //----------------------------------------------------------------
+        // Objects beyond the maximum distance are ignored
+
+        tree->getNearestObjects(origin, 10, nearest, (distanceToObject(origin, objects[2]) + 0.5f));
+
+        EXPECT_EQ(nearest.size(), 4);
+
+        destroyTree(tree);
+    }
+
+    destroyObjects(objects);
+}
+
+TEST(BVHSceneTree, NearestMatchesBruteForce)
+{
+    std::vector<SceneObject*> objects;
+    buildRandomObjects(500, objects);
+
+    MersenneTwister19937 rng;
+    rng.seed(7);
+
+    std::vector<Vector3f> points;
+
+    for(uint32_t i = 0; i < 32; i++)
+    {
+        points.emplace_back(Vector3f(rng.nextf(0.0f, 1000.0f), rng.nextf(0.0f, 1000.0f), rng.nextf(0.0f, 1000.0f)));
+    }
+
+    const uint32_t count = 8;
+
+    for(uint32_t type = 0; type < g_NumTreeTypes; type++)
+    {
+        BVHSceneTree* tree = createTree(type, objects);
+
+        std::vector<std::vector<std::pair<SceneObject*, float>>> batched;
+        tree->getNearestObjects(points, count, batched);
+
+        ASSERT_EQ(batched.size(), points.size());
+
+        for(uint32_t i = 0; i < static_cast<uint32_t>(points.size()); i++)
+        {
+            std::vector<float> distances;
+
+            for(auto object : objects)
+            {
+                distances.push_back(distanceToObject(points[i], object));
+            }
+
+            std::partial_sort(distances.begin(), (distances.begin() + count), distances.end());
+
+            ASSERT_EQ(batched[i].size(), count);
+
+            for(uint32_t j = 0; j < count; j++)
+            {
+                EXPECT_NEAR(batched[i][j].second, distances[j], 0.001f);
+            }
+        }
+
+        destroyTree(tree);
+    }
+
+    destroyObjects(objects);
+}
+
+TEST(BVHSceneTree, MultiViewMatchesSingleView)
+{
+    std::vector<SceneObject*> objects;
+    buildRandomObjects(1000, objects);
+
+    // Overlapping views across the object volume, and one that sees none of it
+
+    std::vector<Frustum> frustums(5);
+
+    for(uint32_t i = 0; i < 4; i++)
+    {
+        buildViewFrustum((250.0f + (150.0f * static_cast<float>(i))), frustums[i]);
+    }
+
+    buildViewFrustum(-5000.0f, frustums[4]);
+
+    for(uint32_t type = 0; type < g_NumTreeTypes; type++)
+    {
+        BVHSceneTree* tree = createTree(type, objects);
+
+        // Results are appended, so anything already in the lists must be kept
+
+        std::vector<std::vector<SceneObject*>> combined(1, std::vector<SceneObject*>(1, objects[0]));
+        tree->getAllVisibleObjects(frustums, combined);
+
+        ASSERT_EQ(combined.size(), frustums.size());
+        ASSERT_FALSE(combined[0].empty());
+        EXPECT_EQ(combined[0][0], objects[0]);
+
+        combined[0].erase(combined[0].begin());
+
+        for(uint32_t i = 0; i < static_cast<uint32_t>(frustums.size()); i++)
+        {
+            std::vector<SceneObject*> separate;
+            tree->getAllVisibleObjects(frustums[i], separate);
+
+            EXPECT_EQ(sortedObjects(combined[i]), sortedObjects(separate));
+        }
+
+        EXPECT_FALSE(combined[0].empty());
+        EXPECT_TRUE(combined[4].empty());
+
+        destroyTree(tree);
+    }
+
+    destroyObjects(objects);
+}
+
+TEST(BVHSceneTree, RefitMatchesRebuild)
+{
+    MersenneTwister19937 rng;
+    rng.seed(11);
+
+    std::vector<SceneObject*> objects;
+    buildRandomObjects(1000, objects);
+
+    std::vector<Ray> rays;
+    buildRandomRays(32, rays);
+
+    Frustum frustum;
+    buildViewFrustum(500.0f, frustum);
+
+    const BoundsAABB box(Vector3f(500.0f, 500.0f, 500.0f), Vector3f(150.0f, 150.0f, 150.0f));
+
+    for(uint32_t type = 0; type < g_NumTreeTypes; type++)
+    {
+        BVHSceneTree* tree = createTree(type, objects);
+
+        //----------------------------------------------------------------
+        // Move a subset of the objects over several frames. Small moves are refit in place,
+        // while the large moves unbalance the tree enough to require rotations.
+
+        for(uint32_t frame = 0; frame < 5; frame++)
+        {
+            for(uint32_t i = 0; i < 100; i++)
+            {
+                const float range = (i < 10) ? 400.0f : 5.0f;
+                SceneObject* object = objects[(frame * 100) + i];
+
+                object->translate(Vector3f(rng.nextf(-range, range), rng.nextf(-range, range), rng.nextf(-range, range)));
+                tree->setDirty(object->getUUID());
+            }
+
+            tree->restructure();
+        }
+
+        //----------------------------------------------------------------
+        // The updated tree must answer every query exactly as a newly built one
+
+        BVHSceneTree* rebuilt = createTree(type, objects);
+
+        std::vector<SceneObject*> updatedVisible;
+        std::vector<SceneObject*> rebuiltVisible;
+
+        tree->getAllVisibleObjects(frustum, updatedVisible);
+        rebuilt->getAllVisibleObjects(frustum, rebuiltVisible);
+
+        EXPECT_EQ(sortedObjects(updatedVisible), sortedObjects(rebuiltVisible));
+
+        std::vector<SceneObject*> updatedInBox;
+        std::vector<SceneObject*> rebuiltInBox;
+
+        tree->getIntersections(box, updatedInBox);
+        rebuilt->getIntersections(box, rebuiltInBox);
+
+        EXPECT_EQ(sortedObjects(updatedInBox), sortedObjects(rebuiltInBox));
+
+        for(auto const& ray : rays)
+        {
+            std::pair<SceneObject*, float> updatedHit;
+            std::pair<SceneObject*, float> rebuiltHit;
+
+            EXPECT_EQ(tree->getIntersection(ray, RayQueryMode::Closest, updatedHit), rebuilt->getIntersection(ray, RayQueryMode::Closest, rebuiltHit));
+            EXPECT_NEAR(updatedHit.second, rebuiltHit.second, 0.001f);
+        }
+
+        for(auto object : objects)
+        {
+            std::vector<SceneObject*> found;
+            tree->getIntersections(object->getBoundsAABB(false), found);
+
+            EXPECT_TRUE(contains(found, object));
+        }
+
+        destroyTree(rebuilt);
+        destroyTree(tree);
+    }
+
+    destroyObjects(objects);
+}
+
+TEST(BVHSceneTree, RemoveObjects)
+{
+    std::vector<SceneObject*> objects;
+    buildRandomObjects(200, objects);
+
+    for(uint32_t type = 0; type < g_NumTreeTypes; type++)
+    {
+        BVHSceneTree* tree = createTree(type, objects);
+
+        for(uint32_t i = 0; i < static_cast<uint32_t>(objects.size()); i += 2)
+        {
+            EXPECT_TRUE(tree->removeObject(objects[i]));
+        }
+
+        tree->restructure();
+
+        // Removed objects must be gone, and all others must remain
+
+        for(uint32_t i = 0; i < static_cast<uint32_t>(objects.size()); i++)
+        {
+            const bool removed = ((i % 2) == 0);
+
+            std::vector<SceneObject*> found;
+            tree->getIntersections(objects[i]->getBoundsAABB(false), found);
+
+            EXPECT_EQ(tree->containsObject(objects[i], true), !removed);
+            EXPECT_EQ(contains(found, objects[i]), !removed);
+        }
+
+        EXPECT_FALSE(tree->removeObject(objects[0]));
+
+        destroyTree(tree);
+    }
+
+    destroyObjects(objects);
+}
+
+TEST(BVHSceneTree, SaveLoadMatchesBuild)
+{
+    const File file("TestBVHSceneTreeMatches.obvh");
+
+    std::vector<SceneObject*> objects;
+    buildRandomObjects(500, objects);
+
+    Frustum frustum;
+    buildViewFrustum(500.0f, frustum);
+
+    BVHSceneTree* builtTree = createTree(1, objects);
+    EXPECT_TRUE(builtTree->save(file));
+
+    BVHSceneTree* loadedTree = new BVHSAHSceneTree();
+    loadedTree->addObjects(objects);
+
+    EXPECT_TRUE(loadedTree->load(file));
+    loadedTree->restructure();
+
+    EXPECT_EQ(loadedTree->getCost(), builtTree->getCost());
+
+    //--------------------------------------------------------------------
+    // Both trees must discover the same objects, before and after modifying the loaded tree
+
+    std::vector<SceneObject*> builtVisible;
+    std::vector<SceneObject*> loadedVisible;
+
+    builtTree->getAllVisibleObjects(frustum, builtVisible);
+    loadedTree->getAllVisibleObjects(frustum, loadedVisible);
+
+    EXPECT_EQ(sortedObjects(builtVisible), sortedObjects(loadedVisible));
+
+    builtTree->removeObject(objects[0]);
+    loadedTree->removeObject(objects[0]);
+
+    builtTree->restructure();
+    loadedTree->restructure();
+
+    builtVisible.clear();
+    loadedVisible.clear();
+
+    builtTree->getAllVisibleObjects(frustum, builtVisible);
+    loadedTree->getAllVisibleObjects(frustum, loadedVisible);
+
+    EXPECT_EQ(sortedObjects(builtVisible), sortedObjects(loadedVisible));
+    EXPECT_FALSE(loadedTree->containsObject(objects[0], true));
+
+    //--------------------------------------------------------------------
+    // A saved tree must not be loaded for a different set of objects
+
+    BVHSceneTree* mismatchedTree = new BVHSAHSceneTree();
+    mismatchedTree->addObjects(std::vector<SceneObject*>(objects.begin() + 1, objects.end()));
+
+    EXPECT_FALSE(mismatchedTree->load(file));
+
+    //--------------------------------------------------------------------
+    // Clean up
+
+    std::remove(file.getFullPath().c_str());
+
+    destroyTree(builtTree);
+    destroyTree(loadedTree);
+    destroyTree(mismatchedTree);
+    destroyObjects(objects);
+}
+
+TEST(BVHSceneTree, OverlappingPairs)
+{
+    // Objects on a coarse lattice only overlap with the other objects at the same point of it,
+    // so the expected number of pairs can be counted directly. The two halves form separate trees.
+
+    MersenneTwister19937 rng;
+    rng.seed(13);
+
+    const uint32_t numObjects = 400;
+    const uint32_t side = 5;
+    const uint32_t half = numObjects / 2;
+
+    std::vector<SceneObject*> objects;
+    std::vector<uint32_t> counts[2] = { std::vector<uint32_t>(side * side * side, 0), std::vector<uint32_t>(side * side * side, 0) };
+
+    for(uint32_t i = 0; i < numObjects; i++)
+    {
+        const uint32_t x = rng.next() % side;
+        const uint32_t y = rng.next() % side;
+        const uint32_t z = rng.next() % side;
+
+        objects.push_back(new SceneObject());
+        objects[i]->setPosition(Vector3f(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)) * 10.0f);
+
+        counts[(i < half) ? 0 : 1][(((x * side) + y) * side) + z]++;
+    }
+
+    uint64_t expectedFirst = 0;
+    uint64_t expectedSecond = 0;
+    uint64_t expectedCross = 0;
+
+    for(uint32_t i = 0; i < (side * side * side); i++)
+    {
+        const uint64_t countA = counts[0][i];
+        const uint64_t countB = counts[1][i];
+
+        expectedFirst  += (countA * (countA - 1)) / 2;
+        expectedSecond += (countB * (countB - 1)) / 2;
+        expectedCross  += (countA * countB);
+    }
+
+    const std::vector<SceneObject*> first(objects.begin(), (objects.begin() + half));
+    const std::vector<SceneObject*> second((objects.begin() + half), objects.end());
+
+    for(uint32_t type = 0; type < g_NumTreeTypes; type++)
+    {
+        BVHSceneTree* treeA = createTree(type, first);
+        BVHSceneTree* treeB = createTree(type, second);
+        BVHSceneTree* treeAll = createTree(type, objects);
+
+        std::vector<std::pair<SceneObject*, SceneObject*>> pairs;
+
+        treeA->getOverlappingPairs(pairs);
+        EXPECT_EQ(pairs.size(), expectedFirst);
+
+        treeB->getOverlappingPairs(pairs);
+        EXPECT_EQ(pairs.size(), expectedSecond);
+
+        treeAll->getOverlappingPairs(pairs);
+        EXPECT_EQ(pairs.size(), (expectedFirst + expectedSecond + expectedCross));
+
+        // The first object of each pair is from the queried tree
+
+        treeA->getOverlappingPairs(treeB, pairs);
+        EXPECT_EQ(pairs.size(), expectedCross);
+
+        for(auto const& pair : pairs)
+        {
+            EXPECT_TRUE(treeA->containsObject(pair.first, false));
+            EXPECT_TRUE(treeB->containsObject(pair.second, false));
+        }
+
+        destroyTree(treeAll);
+        destroyTree(treeB);
+        destroyTree(treeA);
+    }
+
+    destroyObjects(objects);
+}
+
+TEST(BVHSceneTree, OcclusionCulling)
+{
+    const float occluderZ = 700.0f;    // The view looks down -z from z = 1200, so objects below this are behind the occluder
+    const float margin = 10.0f;        // Objects this close to the occluder are not required to be culled
+
+    std::vector<SceneObject*> objects;
+    buildRandomObjects(1000, objects);
+
+    Frustum frustum;
+    buildViewFrustum(500.0f, frustum);
+
+    //--------------------------------------------------------------------
+    // Rasterize a quad that covers the entire view
+
+    const std::vector<Vector3f> vertices = 
+    {
+        Vector3f(-500.0f, -500.0f, occluderZ), Vector3f(1500.0f, -500.0f, occluderZ),
+        Vector3f(1500.0f, 1500.0f, occluderZ), Vector3f(-500.0f, 1500.0f, occluderZ)
+    };
+
+    const std::vector<uint32_t> indices = { 0, 1, 2, 0, 2, 3 };
+
+    OcclusionBuffer occlusion;
+    occlusion.clear(frustum.getProjectionMatrix() * frustum.getViewMatrix());
+    occlusion.addOccluder(vertices, indices, Matrix4x4());
+    occlusion.rasterize();
+
+    EXPECT_EQ(occlusion.getNumTriangles(), 2);
+
+    OcclusionBuffer empty;
+    empty.clear(frustum.getProjectionMatrix() * frustum.getViewMatrix());
+    empty.rasterize();
+
+    for(uint32_t type = 0; type < g_NumTreeTypes; type++)
+    {
+        BVHSceneTree* tree = createTree(type, objects);
+
+        std::vector<SceneObject*> visible;
+        std::vector<SceneObject*> unoccluded;
+
+        tree->getAllVisibleObjects(frustum, visible);
+        tree->getAllVisibleObjects(frustum, occlusion, unoccluded);
+
+        // Nothing in front of the occluder may be culled, and everything sufficiently far behind it must be
+
+        uint32_t numBehind = 0;
+
+        for(auto object : visible)
+        {
+            const float z = object->getPosition(false).z;
+
+            if(z > occluderZ)
+            {
+                EXPECT_TRUE(contains(unoccluded, object));
+            }
+            else if(z < (occluderZ - margin))
+            {
+                EXPECT_FALSE(contains(unoccluded, object));
+                numBehind++;
+            }
+        }
+
+        EXPECT_GT(numBehind, 0);
+        EXPECT_LE(unoccluded.size(), visible.size());
+
+        // Without any occluders, nothing may be culled
+
+        unoccluded.clear();
+        tree->getAllVisibleObjects(frustum, empty, unoccluded);
+
+        EXPECT_EQ(sortedObjects(unoccluded), sortedObjects(visible));
+
+        destroyTree(tree);
+    }
+
+    destroyObjects(objects);
+}
+
 //------------------------------------------------------------------------------------------
 // Other Methods
 //------------------------------------------------------------------------------------------
@@ -241,4 +988,144 @@ bool contains(std::vector<SceneObject*> const& vector, SceneObject const* obj)
     return result;
 }
 
+void updateBounds(BVHSceneTree& tree)
+{
+    // Equivalent to SceneManager::updateBounds (which is only run by the engine) for a single tree
+
+    TransformSystem& transforms = OcularScene->getTransformSystem();
+    transforms.update();
+
+    for(auto handle : transforms.getUpdatedHandles())
+    {
+        SceneObject* object = transforms.getOwner(handle);
+
+        if(object)
+        {
+            object->getBoundsAABB(false);
+            tree.setDirty(object->getUUID());
+        }
+    }
+}
+
+BVHSceneTree* createTree(uint32_t const type, std::vector<SceneObject*> const& objects)
+{
+    BVHSceneTree* result = nullptr;
+
+    switch(type)
+    {
+    case 0:
+        result = new BVHSceneTree();
+        break;
+
+    case 1:
+        result = new BVHSAHSceneTree();
+        break;
+
+    default:
+        result = new QBVHSceneTree();
+        break;
+    }
+
+    result->addObjects(objects);
+    result->restructure();
+
+    return result;
+}
+
+void destroyTree(BVHSceneTree* tree)
+{
+    tree->destroy();
+    delete tree;
+}
+
+void buildRandomObjects(uint32_t const numObjects, std::vector<SceneObject*>& objects)
+{
+    MersenneTwister19937 rng;
+    rng.seed(3);
+
+    for(uint32_t i = 0; i < numObjects; i++)
+    {
+        SceneObject* object = new SceneObject();
+        object->setPosition(Vector3f(rng.nextf(0.0f, 1000.0f), rng.nextf(0.0f, 1000.0f), rng.nextf(0.0f, 1000.0f)));
+
+        objects.push_back(object);
+    }
+}
+
+void buildRandomRays(uint32_t const numRays, std::vector<Ray>& rays)
+{
+    // Cast from in front of the object volume into it
+
+    MersenneTwister19937 rng;
+    rng.seed(5);
+
+    for(uint32_t i = 0; i < numRays; i++)
+    {
+        const Vector3f origin(rng.nextf(0.0f, 1000.0f), rng.nextf(0.0f, 1000.0f), 1200.0f);
+        const Vector3f target(rng.nextf(0.0f, 1000.0f), rng.nextf(0.0f, 1000.0f), 0.0f);
+
+        rays.emplace_back(Ray(origin, (target - origin).getNormalized()));
+    }
+}
+
+void buildViewFrustum(float const x, Frustum& frustum)
+{
+    frustum.setViewMatrix(Matrix4x4::CreateLookAtMatrix(Vector3f(x, 500.0f, 1200.0f), Vector3f(x, 500.0f, 0.0f), Vector3f::Up()));
+    frustum.setProjectionMatrix(Matrix4x4::CreatePerspectiveMatrix(45.0f, 1.33f, 0.1f, 1000.0f));
+    frustum.rebuild();
+}
+
+void destroyObjects(std::vector<SceneObject*>& objects)
+{
+    for(auto object : objects)
+    {
+        delete object;
+    }
+
+    objects.clear();
+}
+
+float closestHitDistance(Ray const& ray, std::vector<SceneObject*> const& objects)
+{
+    float result = FLT_MAX;
+
+    for(auto object : objects)
+    {
+        Point3f point;
+        float distance = 0.0f;
+
+        if(ray.intersects(object->getBoundsAABB(false), point, distance))
+        {
+            result = std::min(result, distance);
+        }
+    }
+
+    return result;
+}
+
+float distanceToObject(Vector3f const& point, SceneObject* object)
+{
+    // Distance to the nearest point of the bounds, as used by getNearestObjects
+
+    const BoundsAABB bounds = object->getBoundsAABB(false);
+    const Vector3f minPoint = bounds.getMinPoint();
+    const Vector3f maxPoint = bounds.getMaxPoint();
+
+    float distanceSq = 0.0f;
+
+    for(uint32_t axis = 0; axis < 3; axis++)
+    {
+        const float delta = fmaxf(fmaxf((minPoint[axis] - point[axis]), (point[axis] - maxPoint[axis])), 0.0f);
+        distanceSq += delta * delta;
+    }
+
+    return sqrtf(distanceSq);
+}
+
+std::vector<SceneObject*> sortedObjects(std::vector<SceneObject*> objects)
+{
+    std::sort(objects.begin(), objects.end());
+    return objects;
+}
+
 #endif
\ No newline at end of file
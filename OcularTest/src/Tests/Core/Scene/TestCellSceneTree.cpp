@@ -0,0 +1,495 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "OcularEngine.hpp"
+#include "Scene/LooseOctreeSceneTree.hpp"
+#include "Scene/UniformGridSceneTree.hpp"
+#include "Scene/OcclusionBuffer.hpp"
+#include "Math/Random/MersenneTwister19937.hpp"
+
+#ifdef _DEBUG
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <algorithm>
+
+using namespace Ocular::Core;
+using namespace Ocular::Math;
+using namespace Ocular::Math::Random;
+
+//------------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------------
+
+namespace
+{
+    const uint32_t NumCellTreeTypes = 2;    ///< LooseOctreeSceneTree and UniformGridSceneTree (see CreateCellTree)
+
+    ISceneTree* CreateCellTree(uint32_t const type, std::vector<SceneObject*> const& objects)
+    {
+        ISceneTree* result = nullptr;
+
+        if(type == 0)
+        {
+            result = new LooseOctreeSceneTree();
+        }
+        else
+        {
+            result = new UniformGridSceneTree();
+        }
+
+        result->addObjects(objects);
+        result->restructure();
+
+        return result;
+    }
+
+    void DestroyCellTree(ISceneTree* tree)
+    {
+        tree->destroy();
+        delete tree;
+    }
+
+    void BuildObjects(uint32_t const numObjects, std::vector<SceneObject*>& objects)
+    {
+        MersenneTwister19937 rng;
+        rng.seed(3);
+
+        for(uint32_t i = 0; i < numObjects; i++)
+        {
+            SceneObject* object = new SceneObject();
+            object->setPosition(Vector3f(rng.nextf(0.0f, 1000.0f), rng.nextf(0.0f, 1000.0f), rng.nextf(0.0f, 1000.0f)));
+
+            objects.push_back(object);
+        }
+    }
+
+    void DestroyObjects(std::vector<SceneObject*>& objects)
+    {
+        for(auto object : objects)
+        {
+            delete object;
+        }
+
+        objects.clear();
+    }
+
+    void BuildRays(uint32_t const numRays, std::vector<Ray>& rays)
+    {
+        // Cast from in front of the object volume into it
+
+        MersenneTwister19937 rng;
+        rng.seed(5);
+
+        for(uint32_t i = 0; i < numRays; i++)
+        {
+            const Vector3f origin(rng.nextf(0.0f, 1000.0f), rng.nextf(0.0f, 1000.0f), 1200.0f);
+            const Vector3f target(rng.nextf(0.0f, 1000.0f), rng.nextf(0.0f, 1000.0f), 0.0f);
+
+            rays.emplace_back(Ray(origin, (target - origin).getNormalized()));
+        }
+    }
+
+    void BuildFrustum(float const x, Frustum& frustum)
+    {
+        frustum.setViewMatrix(Matrix4x4::CreateLookAtMatrix(Vector3f(x, 500.0f, 1200.0f), Vector3f(x, 500.0f, 0.0f), Vector3f::Up()));
+        frustum.setProjectionMatrix(Matrix4x4::CreatePerspectiveMatrix(45.0f, 1.33f, 0.1f, 1000.0f));
+        frustum.rebuild();
+    }
+
+    float ClosestHitDistance(Ray const& ray, std::vector<SceneObject*> const& objects)
+    {
+        float result = FLT_MAX;
+
+        for(auto object : objects)
+        {
+            Point3f point;
+            float distance = 0.0f;
+
+            if(ray.intersects(object->getBoundsAABB(false), point, distance))
+            {
+                result = std::min(result, distance);
+            }
+        }
+
+        return result;
+    }
+
+    float DistanceToObject(Vector3f const& point, SceneObject* object)
+    {
+        const BoundsAABB bounds = object->getBoundsAABB(false);
+        const Vector3f minPoint = bounds.getMinPoint();
+        const Vector3f maxPoint = bounds.getMaxPoint();
+
+        float distanceSq = 0.0f;
+
+        for(uint32_t axis = 0; axis < 3; axis++)
+        {
+            const float delta = fmaxf(fmaxf((minPoint[axis] - point[axis]), (point[axis] - maxPoint[axis])), 0.0f);
+            distanceSq += delta * delta;
+        }
+
+        return sqrtf(distanceSq);
+    }
+
+    std::vector<SceneObject*> Sorted(std::vector<SceneObject*> objects)
+    {
+        std::sort(objects.begin(), objects.end());
+        return objects;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Test Methods
+//------------------------------------------------------------------------------------------
+
+TEST(CellSceneTree, ClosestAndAnyHitRay)
+{
+    std::vector<SceneObject*> objects;
+    BuildObjects(500, objects);
+
+    std::vector<Ray> rays;
+    BuildRays(64, rays);
+
+    for(uint32_t type = 0; type < NumCellTreeTypes; type++)
+    {
+        ISceneTree* tree = CreateCellTree(type, objects);
+
+        std::vector<std::pair<SceneObject*, float>> batched;
+        tree->getIntersections(rays, RayQueryMode::Closest, batched);
+
+        ASSERT_EQ(batched.size(), rays.size());
+
+        for(uint32_t i = 0; i < static_cast<uint32_t>(rays.size()); i++)
+        {
+            const float expected = ClosestHitDistance(rays[i], objects);
+
+            std::pair<SceneObject*, float> closest;
+            std::pair<SceneObject*, float> any;
+
+            EXPECT_EQ(tree->getIntersection(rays[i], RayQueryMode::Closest, closest), (expected < FLT_MAX));
+            EXPECT_EQ(tree->getIntersection(rays[i], RayQueryMode::Any, any), (expected < FLT_MAX));
+            EXPECT_EQ(batched[i].first, closest.first);
+
+            if(closest.first)
+            {
+                EXPECT_NEAR(closest.second, expected, 0.01f);
+                EXPECT_NEAR(batched[i].second, expected, 0.01f);
+                EXPECT_GE(any.second, (expected - 0.01f));
+
+                EXPECT_FALSE(tree->getIntersection(rays[i], RayQueryMode::Closest, closest, (expected * 0.5f)));
+                EXPECT_FALSE(tree->getIntersection(rays[i], RayQueryMode::Any, any, (expected * 0.5f)));
+            }
+        }
+
+        DestroyCellTree(tree);
+    }
+
+    DestroyObjects(objects);
+}
+
+TEST(CellSceneTree, NearestOrderingAndTies)
+{
+    // Objects are placed symmetrically about the origin, so that each pair is equally distant from it
+
+    const Vector3f positions[5] = 
+    {
+        Vector3f( 3.0f, 0.0f,  0.0f), Vector3f(-3.0f, 0.0f, 0.0f),    // Tied nearest
+        Vector3f( 0.0f, 8.0f,  0.0f), Vector3f( 0.0f, 0.0f, 8.0f),    // Tied second nearest
+        Vector3f(20.0f, 0.0f,  0.0f)                                  // Furthest
+    };
+
+    std::vector<SceneObject*> objects;
+
+    for(uint32_t i = 0; i < 5; i++)
+    {
+        objects.push_back(new SceneObject());
+        objects[i]->setPosition(positions[i]);
+    }
+
+    const Vector3f origin(0.0f, 0.0f, 0.0f);
+
+    for(uint32_t type = 0; type < NumCellTreeTypes; type++)
+    {
+        ISceneTree* tree = CreateCellTree(type, objects);
+
+        std::vector<std::pair<SceneObject*, float>> nearest;
+        tree->getNearestObjects(origin, 3, nearest);
+
+        ASSERT_EQ(nearest.size(), 3);
+        EXPECT_EQ(Sorted({ nearest[0].first, nearest[1].first }), Sorted({ objects[0], objects[1] }));
+        EXPECT_TRUE((nearest[2].first == objects[2]) || (nearest[2].first == objects[3]));
+
+        tree->getNearestObjects(origin, 10, nearest);
+
+        ASSERT_EQ(nearest.size(), 5);
+        EXPECT_EQ(Sorted({ nearest[2].first, nearest[3].first }), Sorted({ objects[2], objects[3] }));
+        EXPECT_EQ(nearest[4].first, objects[4]);
+
+        for(uint32_t i = 0; i < 5; i++)
+        {
+            EXPECT_NEAR(nearest[i].second, DistanceToObject(origin, nearest[i].first), 0.001f);
+
+            if(i > 0)
+            {
+                EXPECT_LE(nearest[i - 1].second, nearest[i].second);
+            }
+        }
+
+        DestroyCellTree(tree);
+    }
+
+    DestroyObjects(objects);
+}
+
+TEST(CellSceneTree, MultiViewMatchesSingleView)
+{
+    std::vector<SceneObject*> objects;
+    BuildObjects(1000, objects);
+
+    std::vector<Frustum> frustums(4);
+
+    for(uint32_t i = 0; i < 4; i++)
+    {
+        BuildFrustum((250.0f + (150.0f * static_cast<float>(i))), frustums[i]);
+    }
+
+    for(uint32_t type = 0; type < NumCellTreeTypes; type++)
+    {
+        ISceneTree* tree = CreateCellTree(type, objects);
+
+        std::vector<std::vector<SceneObject*>> combined;
+        tree->getAllVisibleObjects(frustums, combined);
+
+        ASSERT_EQ(combined.size(), frustums.size());
+
+        for(uint32_t i = 0; i < static_cast<uint32_t>(frustums.size()); i++)
+        {
+            std::vector<SceneObject*> separate;
+            tree->getAllVisibleObjects(frustums[i], separate);
+
+            EXPECT_EQ(Sorted(combined[i]), Sorted(separate));
+        }
+
+        DestroyCellTree(tree);
+    }
+
+    DestroyObjects(objects);
+}
+
+TEST(CellSceneTree, MovedObjectsMatchRebuild)
+{
+    MersenneTwister19937 rng;
+    rng.seed(11);
+
+    std::vector<SceneObject*> objects;
+    BuildObjects(1000, objects);
+
+    Frustum frustum;
+    BuildFrustum(500.0f, frustum);
+
+    const BoundsAABB box(Vector3f(500.0f, 500.0f, 500.0f), Vector3f(150.0f, 150.0f, 150.0f));
+
+    for(uint32_t type = 0; type < NumCellTreeTypes; type++)
+    {
+        ISceneTree* tree = CreateCellTree(type, objects);
+
+        // Small moves stay within (or next to) their cells, while large moves cross many of them
+
+        for(uint32_t frame = 0; frame < 5; frame++)
+        {
+            for(uint32_t i = 0; i < 100; i++)
+            {
+                const float range = (i < 10) ? 400.0f : 5.0f;
+                SceneObject* object = objects[(frame * 100) + i];
+
+                object->translate(Vector3f(rng.nextf(-range, range), rng.nextf(-range, range), rng.nextf(-range, range)));
+                tree->setDirty(object->getUUID());
+            }
+
+            tree->restructure();
+        }
+
+        ISceneTree* rebuilt = CreateCellTree(type, objects);
+
+        std::vector<SceneObject*> updatedVisible;
+        std::vector<SceneObject*> rebuiltVisible;
+
+        tree->getAllVisibleObjects(frustum, updatedVisible);
+        rebuilt->getAllVisibleObjects(frustum, rebuiltVisible);
+
+        EXPECT_EQ(Sorted(updatedVisible), Sorted(rebuiltVisible));
+
+        std::vector<SceneObject*> updatedInBox;
+        std::vector<SceneObject*> rebuiltInBox;
+
+        tree->getIntersections(box, updatedInBox);
+        rebuilt->getIntersections(box, rebuiltInBox);
+
+        EXPECT_EQ(Sorted(updatedInBox), Sorted(rebuiltInBox));
+
+        DestroyCellTree(rebuilt);
+        DestroyCellTree(tree);
+    }
+
+    DestroyObjects(objects);
+}
+
+TEST(CellSceneTree, OverlappingPairs)
+{
+    // Objects on a coarse lattice only overlap with the other objects at the same point of it,
+    // so the expected number of pairs can be counted directly. The two halves form separate trees.
+
+    MersenneTwister19937 rng;
+    rng.seed(13);
+
+    const uint32_t numObjects = 400;
+    const uint32_t side = 5;
+    const uint32_t half = numObjects / 2;
+
+    std::vector<SceneObject*> objects;
+    std::vector<uint32_t> counts[2] = { std::vector<uint32_t>(side * side * side, 0), std::vector<uint32_t>(side * side * side, 0) };
+
+    for(uint32_t i = 0; i < numObjects; i++)
+    {
+        const uint32_t x = rng.next() % side;
+        const uint32_t y = rng.next() % side;
+        const uint32_t z = rng.next() % side;
+
+        objects.push_back(new SceneObject());
+        objects[i]->setPosition(Vector3f(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)) * 10.0f);
+
+        counts[(i < half) ? 0 : 1][(((x * side) + y) * side) + z]++;
+    }
+
+    uint64_t expectedFirst = 0;
+    uint64_t expectedCross = 0;
+
+    for(uint32_t i = 0; i < (side * side * side); i++)
+    {
+        const uint64_t countA = counts[0][i];
+        const uint64_t countB = counts[1][i];
+
+        expectedFirst += (countA * (countA - 1)) / 2;
+        expectedCross += (countA * countB);
+    }
+
+    const std::vector<SceneObject*> first(objects.begin(), (objects.begin() + half));
+    const std::vector<SceneObject*> second((objects.begin() + half), objects.end());
+
+    ISceneTree* treesA[NumCellTreeTypes];
+    ISceneTree* treesB[NumCellTreeTypes];
+
+    for(uint32_t type = 0; type < NumCellTreeTypes; type++)
+    {
+        treesA[type] = CreateCellTree(type, first);
+        treesB[type] = CreateCellTree(type, second);
+    }
+
+    for(uint32_t i = 0; i < NumCellTreeTypes; i++)
+    {
+        std::vector<std::pair<SceneObject*, SceneObject*>> pairs;
+
+        treesA[i]->getOverlappingPairs(pairs);
+        EXPECT_EQ(pairs.size(), expectedFirst);
+
+        // Including against a tree of the other type
+
+        for(uint32_t j = 0; j < NumCellTreeTypes; j++)
+        {
+            treesA[i]->getOverlappingPairs(treesB[j], pairs);
+            EXPECT_EQ(pairs.size(), expectedCross);
+
+            for(auto const& pair : pairs)
+            {
+                EXPECT_TRUE(treesA[i]->containsObject(pair.first, false));
+                EXPECT_TRUE(treesB[j]->containsObject(pair.second, false));
+            }
+        }
+    }
+
+    for(uint32_t type = 0; type < NumCellTreeTypes; type++)
+    {
+        DestroyCellTree(treesA[type]);
+        DestroyCellTree(treesB[type]);
+    }
+
+    DestroyObjects(objects);
+}
+
+TEST(CellSceneTree, OcclusionCulling)
+{
+    const float occluderZ = 700.0f;    // The view looks down -z from z = 1200, so objects below this are behind the occluder
+    const float margin = 10.0f;        // Objects this close to the occluder are not required to be culled
+
+    std::vector<SceneObject*> objects;
+    BuildObjects(1000, objects);
+
+    Frustum frustum;
+    BuildFrustum(500.0f, frustum);
+
+    const std::vector<Vector3f> vertices = 
+    {
+        Vector3f(-500.0f, -500.0f, occluderZ), Vector3f(1500.0f, -500.0f, occluderZ),
+        Vector3f(1500.0f, 1500.0f, occluderZ), Vector3f(-500.0f, 1500.0f, occluderZ)
+    };
+
+    const std::vector<uint32_t> indices = { 0, 1, 2, 0, 2, 3 };
+
+    OcclusionBuffer occlusion;
+    occlusion.clear(frustum.getProjectionMatrix() * frustum.getViewMatrix());
+    occlusion.addOccluder(vertices, indices, Matrix4x4());
+    occlusion.rasterize();
+
+    for(uint32_t type = 0; type < NumCellTreeTypes; type++)
+    {
+        ISceneTree* tree = CreateCellTree(type, objects);
+
+        std::vector<SceneObject*> visible;
+        std::vector<SceneObject*> unoccluded;
+
+        tree->getAllVisibleObjects(frustum, visible);
+        tree->getAllVisibleObjects(frustum, occlusion, unoccluded);
+
+        const std::vector<SceneObject*> sortedUnoccluded = Sorted(unoccluded);
+        uint32_t numBehind = 0;
+
+        for(auto object : visible)
+        {
+            const float z = object->getPosition(false).z;
+            const bool found = std::binary_search(sortedUnoccluded.begin(), sortedUnoccluded.end(), object);
+
+            if(z > occluderZ)
+            {
+                EXPECT_TRUE(found);
+            }
+            else if(z < (occluderZ - margin))
+            {
+                EXPECT_FALSE(found);
+                numBehind++;
+            }
+        }
+
+        EXPECT_GT(numBehind, 0);
+
+        DestroyCellTree(tree);
+    }
+
+    DestroyObjects(objects);
+}
+
+#endif
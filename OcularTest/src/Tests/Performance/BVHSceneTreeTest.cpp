@@ -16,13 +16,30 @@
 
 #include "Tests/Performance/BVHSceneTreeTest.hpp"
 #include "Scene/BVHSceneTree.hpp"
+#include "Scene/BVHSAHSceneTree.hpp"
+#include "Scene/QBVHSceneTree.hpp"
+#include "Scene/LooseOctreeSceneTree.hpp"
+#include "Scene/UniformGridSceneTree.hpp"
+#include "Scene/OcclusionBuffer.hpp"
 #include "Math/Random/MersenneTwister19937.hpp"
+#include "Math/Geometry/Frustum.hpp"
+#include "Math/Bounds/Ray.hpp"
+#include "FileIO/File.hpp"
 #include "OcularEngine.hpp"
 
+#include <cstdio>
+#include <cmath>
+
 using namespace Ocular::Core;
 using namespace Ocular::Math;
 using namespace Ocular::Math::Random;
 
+namespace
+{
+    const uint32_t NumVisibilityQueries = 100;    ///< Number of queries averaged for each visibility timing
+    const uint32_t NumUpdateFrames      = 10;     ///< Number of incremental updates averaged for each update timing
+}
+
 //------------------------------------------------------------------------------------------
 
 namespace Ocular
@@ -67,6 +84,79 @@ namespace Ocular
             //buildTree(10000, elapsedConstruction10000);
             //OcularLogger->info("BVH[10000]: ", elapsedConstruction10000, "ms");
 
+            const uint32_t visibilityCounts[3] = { 1000, 10000, 50000 };
+
+            m_CurrentTest = "Visibility";
+            m_NumTests++;
+
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                double elapsedTree  = 0.0;
+                double elapsedBrute = 0.0;
+
+                testVisibility(visibilityCounts[i], elapsedTree, elapsedBrute);
+                OcularLogger->info("BVH Visibility[", visibilityCounts[i], "]: ", elapsedTree, "ms (brute force: ", elapsedBrute, "ms)");
+            }
+
+            m_CurrentTest = "Update";
+            m_NumTests++;
+
+            double elapsedUpdate  = 0.0;
+            double elapsedRebuild = 0.0;
+
+            testUpdate(20000, 300, elapsedUpdate, elapsedRebuild);
+            OcularLogger->info("BVH Update[20000, 300 moved]: ", elapsedUpdate, "ms (full rebuild: ", elapsedRebuild, "ms)");
+
+            m_CurrentTest = "SAH";
+            m_NumTests++;
+
+            testSAH(20000);
+
+            m_CurrentTest = "QBVH";
+            m_NumTests++;
+
+            testQBVH(50000);
+
+            m_CurrentTest = "MultiView";
+            m_NumTests++;
+
+            testMultiView(50000, 4);
+
+            m_CurrentTest = "ClosestHit";
+            m_NumTests++;
+
+            testClosestHit(50000, 1000);
+
+            m_CurrentTest = "Nearest";
+            m_NumTests++;
+
+            testNearest(50000, 100, 8);
+
+            m_CurrentTest = "Remove";
+            m_NumTests++;
+
+            testRemove(50000, 5000);
+
+            m_CurrentTest = "CellTrees";
+            m_NumTests++;
+
+            testCellTrees(50000, 50000);
+
+            m_CurrentTest = "SaveLoad";
+            m_NumTests++;
+
+            testSaveLoad(50000);
+
+            m_CurrentTest = "Pairs";
+            m_NumTests++;
+
+            testPairs(100000);
+
+            m_CurrentTest = "Occlusion";
+            m_NumTests++;
+
+            testOcclusion(50000);
+
             ATest::run();
         }
 
@@ -99,6 +189,652 @@ namespace Ocular
             cleanObjects(objects);
         }
 
+        void BVHSceneTreeTest::testUpdate(uint32_t const numObjects, uint32_t const numMoved, double& elapsedUpdate, double& elapsedRebuild)
+        {
+            MersenneTwister19937 rng;
+
+            std::vector<SceneObject*> objects;
+            buildObjects(numObjects, objects);
+
+            BVHSceneTree* tree = new BVHSceneTree();
+            tree->addObjects(objects);
+
+            uint64_t start = OcularEngine.Clock()->getElapsedNS();
+            tree->restructure();
+            uint64_t end = OcularEngine.Clock()->getElapsedNS();
+
+            elapsedRebuild = static_cast<double>((end - start)) * 1e-6;
+
+            //------------------------------------------------------------
+            // Move a small subset of the objects each frame and time the update.
+            // The objects are not part of a scene, so the tree must be notified directly.
+
+            elapsedUpdate = 0.0;
+
+            for(uint32_t frame = 0; frame < NumUpdateFrames; frame++)
+            {
+                for(uint32_t i = 0; i < numMoved; i++)
+                {
+                    SceneObject* object = objects[i];
+
+                    object->translate(Vector3f(rng.nextf(-5.0f, 5.0f), rng.nextf(-5.0f, 5.0f), rng.nextf(-5.0f, 5.0f)));
+                    tree->setDirty(object->getUUID());
+                }
+
+                start = OcularEngine.Clock()->getElapsedNS();
+                tree->restructure();
+                end = OcularEngine.Clock()->getElapsedNS();
+
+                elapsedUpdate += static_cast<double>((end - start)) * 1e-6;
+            }
+
+            elapsedUpdate /= static_cast<double>(NumUpdateFrames);
+
+            //------------------------------------------------------------
+            // Clean up the tree and objects
+
+            cleanTree(tree);
+            cleanObjects(objects);
+        }
+
+        void BVHSceneTreeTest::testSAH(uint32_t const numObjects)
+        {
+            std::vector<SceneObject*> objects;
+            buildObjects(numObjects, objects);
+
+            // Pack half of the objects into a few small clusters, which Morton-ordered construction handles poorly
+
+            MersenneTwister19937 rng;
+
+            for(uint32_t i = 0; i < numObjects; i += 2)
+            {
+                const float clusterOffset = static_cast<float>(i % 4) * 250.0f;
+                objects[i]->setPosition(Vector3f((clusterOffset + rng.nextf(0.0f, 5.0f)), (clusterOffset + rng.nextf(0.0f, 5.0f)), rng.nextf(0.0f, 5.0f)));
+            }
+
+            BVHSceneTree* trees[2] = { new BVHSceneTree(), new BVHSAHSceneTree() };
+            const char* names[2] = { "LBVH", "SAH" };
+
+            for(uint32_t i = 0; i < 2; i++)
+            {
+                trees[i]->addObjects(objects);
+
+                uint64_t start = OcularEngine.Clock()->getElapsedNS();
+                trees[i]->restructure();
+                uint64_t end = OcularEngine.Clock()->getElapsedNS();
+
+                const double elapsed = static_cast<double>((end - start)) * 1e-6;
+                OcularLogger->info("BVH ", names[i], "[", numObjects, "]: ", elapsed, "ms (cost: ", trees[i]->getCost(), ")");
+            }
+
+            //------------------------------------------------------------
+            // Clean up the trees and objects
+
+            cleanTree(trees[0]);
+            cleanTree(trees[1]);
+            cleanObjects(objects);
+        }
+
+        void BVHSceneTreeTest::testQBVH(uint32_t const numObjects)
+        {
+            std::vector<SceneObject*> objects;
+            buildObjects(numObjects, objects);
+
+            Frustum frustum;
+            buildFrustum(frustum);
+
+            const Ray ray(Vector3f(0.0f, 0.0f, 0.0f), Vector3f(1.0f, 1.0f, 1.0f).getNormalized());
+
+            BVHSceneTree* trees[2] = { new BVHSceneTree(), new QBVHSceneTree() };
+            const char* names[2] = { "BVH2", "QBVH" };
+
+            std::vector<SceneObject*> visible[2];
+            std::vector<std::pair<SceneObject*, float>> hits[2];
+
+            for(uint32_t i = 0; i < 2; i++)
+            {
+                trees[i]->addObjects(objects);
+                trees[i]->restructure();
+
+                visible[i].reserve(numObjects);
+
+                //--------------------------------------------------------
+                // Time the visibility queries
+
+                uint64_t start = OcularEngine.Clock()->getElapsedNS();
+
+                for(uint32_t j = 0; j < NumVisibilityQueries; j++)
+                {
+                    visible[i].clear();
+                    trees[i]->getAllVisibleObjects(frustum, visible[i]);
+                }
+
+                uint64_t end = OcularEngine.Clock()->getElapsedNS();
+
+                const double elapsedVisible = (static_cast<double>((end - start)) * 1e-6) / static_cast<double>(NumVisibilityQueries);
+
+                //--------------------------------------------------------
+                // Time the ray queries
+
+                start = OcularEngine.Clock()->getElapsedNS();
+
+                for(uint32_t j = 0; j < NumVisibilityQueries; j++)
+                {
+                    hits[i].clear();
+                    trees[i]->getIntersections(ray, hits[i]);
+                }
+
+                end = OcularEngine.Clock()->getElapsedNS();
+
+                const double elapsedRay = (static_cast<double>((end - start)) * 1e-6) / static_cast<double>(NumVisibilityQueries);
+
+                OcularLogger->info("BVH ", names[i], "[", numObjects, "]: ", elapsedVisible, "ms visibility, ", elapsedRay, "ms ray");
+            }
+
+            //------------------------------------------------------------
+            // Clean up the trees and objects
+
+            cleanTree(trees[0]);
+            cleanTree(trees[1]);
+            cleanObjects(objects);
+        }
+
+        void BVHSceneTreeTest::testMultiView(uint32_t const numObjects, uint32_t const numViews)
+        {
+            std::vector<SceneObject*> objects;
+            buildObjects(numObjects, objects);
+
+            BVHSceneTree* tree = new BVHSceneTree();
+            tree->addObjects(objects);
+            tree->restructure();
+
+            // Each view looks into the object volume from a different position along the x-axis
+
+            std::vector<Frustum> frustums(numViews);
+
+            for(uint32_t i = 0; i < numViews; i++)
+            {
+                const float x = 250.0f + ((500.0f / static_cast<float>(numViews)) * static_cast<float>(i));
+
+                frustums[i].setViewMatrix(Matrix4x4::CreateLookAtMatrix(Vector3f(x, 500.0f, 1200.0f), Vector3f(x, 500.0f, 0.0f), Vector3f::Up()));
+                frustums[i].setProjectionMatrix(Matrix4x4::CreatePerspectiveMatrix(45.0f, 1.33f, 0.1f, 1000.0f));
+                frustums[i].rebuild();
+            }
+
+            //------------------------------------------------------------
+            // Time a separate query for each view
+
+            std::vector<std::vector<SceneObject*>> separate(numViews);
+
+            uint64_t start = OcularEngine.Clock()->getElapsedNS();
+
+            for(uint32_t i = 0; i < NumVisibilityQueries; i++)
+            {
+                for(uint32_t j = 0; j < numViews; j++)
+                {
+                    separate[j].clear();
+                    tree->getAllVisibleObjects(frustums[j], separate[j]);
+                }
+            }
+
+            uint64_t end = OcularEngine.Clock()->getElapsedNS();
+
+            const double elapsedSeparate = (static_cast<double>((end - start)) * 1e-6) / static_cast<double>(NumVisibilityQueries);
+
+            //------------------------------------------------------------
+            // Time the single multi-view query
+
+            std::vector<std::vector<SceneObject*>> combined;
+
+            start = OcularEngine.Clock()->getElapsedNS();
+
+            for(uint32_t i = 0; i < NumVisibilityQueries; i++)
+            {
+                combined.clear();
+                tree->getAllVisibleObjects(frustums, combined);
+            }
+
+            end = OcularEngine.Clock()->getElapsedNS();
+
+            const double elapsedCombined = (static_cast<double>((end - start)) * 1e-6) / static_cast<double>(NumVisibilityQueries);
+
+            OcularLogger->info("BVH MultiView[", numObjects, ", ", numViews, " views]: ", elapsedCombined, "ms (separate: ", elapsedSeparate, "ms)");
+
+            //------------------------------------------------------------
+            // Clean up the tree and objects
+
+            cleanTree(tree);
+            cleanObjects(objects);
+        }
+
+        void BVHSceneTreeTest::testClosestHit(uint32_t const numObjects, uint32_t const numRays)
+        {
+            MersenneTwister19937 rng;
+
+            std::vector<SceneObject*> objects;
+            buildObjects(numObjects, objects);
+
+            BVHSceneTree* tree = new BVHSceneTree();
+            tree->addObjects(objects);
+            tree->restructure();
+
+            // Rays are cast from in front of the object volume into it
+
+            std::vector<Ray> rays;
+            rays.reserve(numRays);
+
+            for(uint32_t i = 0; i < numRays; i++)
+            {
+                const Vector3f origin(rng.nextf(0.0f, 1000.0f), rng.nextf(0.0f, 1000.0f), 1200.0f);
+                const Vector3f target(rng.nextf(0.0f, 1000.0f), rng.nextf(0.0f, 1000.0f), 0.0f);
+
+                rays.emplace_back(Ray(origin, (target - origin).getNormalized()));
+            }
+
+            //------------------------------------------------------------
+            // Time the nearest of all sorted intersections
+
+            std::vector<std::pair<SceneObject*, float>> hits;
+
+            uint64_t start = OcularEngine.Clock()->getElapsedNS();
+
+            for(uint32_t i = 0; i < numRays; i++)
+            {
+                tree->getIntersections(rays[i], hits);
+            }
+
+            uint64_t end = OcularEngine.Clock()->getElapsedNS();
+
+            const double elapsedSorted = static_cast<double>((end - start)) * 1e-6;
+
+            //------------------------------------------------------------
+            // Time the individual closest-hit queries
+
+            std::pair<SceneObject*, float> closest;
+
+            start = OcularEngine.Clock()->getElapsedNS();
+
+            for(uint32_t i = 0; i < numRays; i++)
+            {
+                tree->getIntersection(rays[i], RayQueryMode::Closest, closest);
+            }
+
+            end = OcularEngine.Clock()->getElapsedNS();
+
+            const double elapsedClosest = static_cast<double>((end - start)) * 1e-6;
+
+            //------------------------------------------------------------
+            // Time the batched closest-hit query
+
+            std::vector<std::pair<SceneObject*, float>> batched;
+
+            start = OcularEngine.Clock()->getElapsedNS();
+            tree->getIntersections(rays, RayQueryMode::Closest, batched);
+            end = OcularEngine.Clock()->getElapsedNS();
+
+            const double elapsedBatched = static_cast<double>((end - start)) * 1e-6;
+
+            OcularLogger->info("BVH ClosestHit[", numObjects, ", ", numRays, " rays]: ", elapsedClosest, "ms (batched: ", elapsedBatched, "ms, sorted: ", elapsedSorted, "ms)");
+
+            //------------------------------------------------------------
+            // Clean up the tree and objects
+
+            cleanTree(tree);
+            cleanObjects(objects);
+        }
+
+        void BVHSceneTreeTest::testNearest(uint32_t const numObjects, uint32_t const numPoints, uint32_t const count)
+        {
+            MersenneTwister19937 rng;
+
+            std::vector<SceneObject*> objects;
+            buildObjects(numObjects, objects);
+
+            BVHSceneTree* tree = new BVHSceneTree();
+            tree->addObjects(objects);
+            tree->restructure();
+
+            std::vector<Vector3f> points;
+            points.reserve(numPoints);
+
+            for(uint32_t i = 0; i < numPoints; i++)
+            {
+                points.emplace_back(Vector3f(rng.nextf(0.0f, 1000.0f), rng.nextf(0.0f, 1000.0f), rng.nextf(0.0f, 1000.0f)));
+            }
+
+            //------------------------------------------------------------
+            // Time the batched tree query
+
+            std::vector<std::vector<std::pair<SceneObject*, float>>> nearest;
+
+            uint64_t start = OcularEngine.Clock()->getElapsedNS();
+            tree->getNearestObjects(points, count, nearest);
+            uint64_t end = OcularEngine.Clock()->getElapsedNS();
+
+            const double elapsedTree = static_cast<double>((end - start)) * 1e-6;
+
+            //------------------------------------------------------------
+            // Time the brute-force sort of the distance to every object
+
+            std::vector<float> distances(numObjects);
+
+            start = OcularEngine.Clock()->getElapsedNS();
+
+            for(uint32_t i = 0; i < numPoints; i++)
+            {
+                for(uint32_t j = 0; j < numObjects; j++)
+                {
+                    const BoundsAABB bounds = objects[j]->getBoundsAABB(false);
+                    const Vector3f minPoint = bounds.getMinPoint();
+                    const Vector3f maxPoint = bounds.getMaxPoint();
+
+                    float distanceSq = 0.0f;
+
+                    for(uint32_t axis = 0; axis < 3; axis++)
+                    {
+                        const float delta = fmaxf(fmaxf((minPoint[axis] - points[i][axis]), (points[i][axis] - maxPoint[axis])), 0.0f);
+                        distanceSq += delta * delta;
+                    }
+
+                    distances[j] = sqrtf(distanceSq);
+                }
+
+                std::partial_sort(distances.begin(), (distances.begin() + count), distances.end());
+            }
+
+            end = OcularEngine.Clock()->getElapsedNS();
+
+            const double elapsedBrute = static_cast<double>((end - start)) * 1e-6;
+
+            OcularLogger->info("BVH Nearest[", numObjects, ", ", numPoints, " points, k = ", count, "]: ", elapsedTree, "ms (brute force: ", elapsedBrute, "ms)");
+
+            //------------------------------------------------------------
+            // Clean up the tree and objects
+
+            cleanTree(tree);
+            cleanObjects(objects);
+        }
+
+        void BVHSceneTreeTest::testRemove(uint32_t const numObjects, uint32_t const numRemoved)
+        {
+            std::vector<SceneObject*> objects;
+            buildObjects(numObjects, objects);
+
+            BVHSceneTree* tree = new BVHSceneTree();
+            tree->addObjects(objects);
+            tree->restructure();
+
+            //------------------------------------------------------------
+            // Remove every other object up to numRemoved and time it
+
+            uint64_t start = OcularEngine.Clock()->getElapsedNS();
+
+            for(uint32_t i = 0; i < (numRemoved * 2); i += 2)
+            {
+                tree->removeObject(objects[i]);
+            }
+
+            uint64_t end = OcularEngine.Clock()->getElapsedNS();
+
+            const double elapsedRemove = static_cast<double>((end - start)) * 1e-6;
+
+            start = OcularEngine.Clock()->getElapsedNS();
+            tree->restructure();
+            end = OcularEngine.Clock()->getElapsedNS();
+
+            const double elapsedRestructure = static_cast<double>((end - start)) * 1e-6;
+
+            OcularLogger->info("BVH Remove[", numObjects, ", ", numRemoved, " removed]: ", elapsedRemove, "ms (restructure: ", elapsedRestructure, "ms)");
+
+            //------------------------------------------------------------
+            // Clean up the tree and objects
+
+            cleanTree(tree);
+            cleanObjects(objects);
+        }
+
+        void BVHSceneTreeTest::testSaveLoad(uint32_t const numObjects)
+        {
+            std::vector<SceneObject*> objects;
+            buildObjects(numObjects, objects);
+
+            const File file("BVHSceneTreeTest.obvh");
+
+            //------------------------------------------------------------
+            // Time the build and save the result
+
+            BVHSceneTree* builtTree = new BVHSAHSceneTree();
+            builtTree->addObjects(objects);
+
+            uint64_t start = OcularEngine.Clock()->getElapsedNS();
+            builtTree->restructure();
+            uint64_t end = OcularEngine.Clock()->getElapsedNS();
+
+            const double elapsedBuild = static_cast<double>((end - start)) * 1e-6;
+
+            builtTree->save(file);
+
+            //------------------------------------------------------------
+            // Time the load, including the restructure that follows it
+
+            BVHSceneTree* loadedTree = new BVHSAHSceneTree();
+            loadedTree->addObjects(objects);
+
+            start = OcularEngine.Clock()->getElapsedNS();
+            loadedTree->load(file);
+            loadedTree->restructure();
+            end = OcularEngine.Clock()->getElapsedNS();
+
+            const double elapsedLoad = static_cast<double>((end - start)) * 1e-6;
+
+            OcularLogger->info("BVH SaveLoad[", numObjects, "]: ", elapsedLoad, "ms (build: ", elapsedBuild, "ms)");
+
+            //------------------------------------------------------------
+            // Clean up the trees, objects and file
+
+            std::remove(file.getFullPath().c_str());
+
+            cleanTree(builtTree);
+            cleanTree(loadedTree);
+            cleanObjects(objects);
+        }
+
+        void BVHSceneTreeTest::testPairs(uint32_t const numObjects)
+        {
+            MersenneTwister19937 rng;
+
+            std::vector<SceneObject*> objects;
+            buildObjects(numObjects, objects);
+
+            //------------------------------------------------------------
+            // Place the objects on a lattice with an average of four objects per point.
+            // Objects are split evenly between two sets, for the tree-vs-tree queries.
+
+            const uint32_t side = static_cast<uint32_t>(std::cbrt(static_cast<double>(numObjects) / 4.0)) + 1;
+            const uint32_t half = numObjects / 2;
+
+            for(uint32_t i = 0; i < numObjects; i++)
+            {
+                const uint32_t x = std::min(side - 1, static_cast<uint32_t>(rng.nextf(0.0f, static_cast<float>(side))));
+                const uint32_t y = std::min(side - 1, static_cast<uint32_t>(rng.nextf(0.0f, static_cast<float>(side))));
+                const uint32_t z = std::min(side - 1, static_cast<uint32_t>(rng.nextf(0.0f, static_cast<float>(side))));
+
+                objects[i]->setPosition(Vector3f(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)) * 10.0f);
+            }
+
+            const std::vector<SceneObject*> first(objects.begin(), objects.begin() + half);
+            const std::vector<SceneObject*> second(objects.begin() + half, objects.end());
+
+            //------------------------------------------------------------
+            // Time the BVH pair queries against individual bounds queries
+
+            BVHSceneTree* tree = new BVHSceneTree();
+            tree->addObjects(objects);
+            tree->restructure();
+
+            std::vector<std::pair<SceneObject*, SceneObject*>> pairs;
+            std::vector<SceneObject*> found;
+
+            uint64_t start = OcularEngine.Clock()->getElapsedNS();
+            tree->getOverlappingPairs(pairs);
+            uint64_t end = OcularEngine.Clock()->getElapsedNS();
+
+            const double elapsedPairs = static_cast<double>((end - start)) * 1e-6;
+
+            start = OcularEngine.Clock()->getElapsedNS();
+
+            for(auto object : objects)
+            {
+                tree->getIntersections(object->getBoundsAABB(false), found);
+            }
+
+            end = OcularEngine.Clock()->getElapsedNS();
+
+            const double elapsedQueries = static_cast<double>((end - start)) * 1e-6;
+
+            OcularLogger->info("BVH Pairs[", numObjects, ", ", pairs.size(), " pairs]: ", elapsedPairs, "ms (individual queries: ", elapsedQueries, "ms)");
+
+            cleanTree(tree);
+
+            //------------------------------------------------------------
+            // Time each tree type, both within itself and against every other tree type
+
+            ISceneTree* treesA[4] = { new BVHSceneTree(), new QBVHSceneTree(), new LooseOctreeSceneTree(), new UniformGridSceneTree() };
+            ISceneTree* treesB[4] = { new BVHSceneTree(), new QBVHSceneTree(), new LooseOctreeSceneTree(), new UniformGridSceneTree() };
+            const char* names[4]  = { "BVH", "QBVH", "Octree", "Grid" };
+
+            for(uint32_t i = 0; i < 4; i++)
+            {
+                treesA[i]->addObjects(first);
+                treesA[i]->restructure();
+
+                treesB[i]->addObjects(second);
+                treesB[i]->restructure();
+            }
+
+            for(uint32_t i = 0; i < 4; i++)
+            {
+                start = OcularEngine.Clock()->getElapsedNS();
+                treesA[i]->getOverlappingPairs(pairs);
+                end = OcularEngine.Clock()->getElapsedNS();
+
+                const double elapsedSelf = static_cast<double>((end - start)) * 1e-6;
+
+                for(uint32_t j = 0; j < 4; j++)
+                {
+                    start = OcularEngine.Clock()->getElapsedNS();
+                    treesA[i]->getOverlappingPairs(treesB[j], pairs);
+                    end = OcularEngine.Clock()->getElapsedNS();
+
+                    const double elapsedCross = static_cast<double>((end - start)) * 1e-6;
+
+                    OcularLogger->info("BVH Pairs ", names[i], "[", half, "]: ", elapsedSelf, "ms self, ", elapsedCross, "ms against ", names[j]);
+                }
+            }
+
+            //------------------------------------------------------------
+            // Clean up the trees and objects
+
+            for(uint32_t i = 0; i < 4; i++)
+            {
+                treesA[i]->destroy();
+                treesB[i]->destroy();
+
+                delete treesA[i];
+                delete treesB[i];
+            }
+
+            cleanObjects(objects);
+        }
+
+        void BVHSceneTreeTest::testOcclusion(uint32_t const numObjects)
+        {
+            const float occluderZ = 700.0f;    // The view looks down -z from z = 1200, so objects below this are behind the occluder
+
+            std::vector<SceneObject*> objects;
+            buildObjects(numObjects, objects);
+
+            Frustum frustum;
+            buildFrustum(frustum);
+
+            //------------------------------------------------------------
+            // Rasterize a quad that covers the entire view
+
+            const std::vector<Vector3f> vertices = 
+            {
+                Vector3f(-500.0f, -500.0f, occluderZ), Vector3f(1500.0f, -500.0f, occluderZ),
+                Vector3f(1500.0f, 1500.0f, occluderZ), Vector3f(-500.0f, 1500.0f, occluderZ)
+            };
+
+            const std::vector<uint32_t> indices = { 0, 1, 2, 0, 2, 3 };
+
+            OcclusionBuffer occlusion;
+
+            uint64_t start = OcularEngine.Clock()->getElapsedNS();
+
+            occlusion.clear(frustum.getProjectionMatrix() * frustum.getViewMatrix());
+            occlusion.addOccluder(vertices, indices, Matrix4x4());
+            occlusion.rasterize();
+
+            uint64_t end = OcularEngine.Clock()->getElapsedNS();
+
+            const double elapsedRasterize = static_cast<double>((end - start)) * 1e-6;
+
+            //------------------------------------------------------------
+            // Compare each tree type against it's frustum-only query
+
+            ISceneTree* trees[4] = { new BVHSceneTree(), new QBVHSceneTree(), new LooseOctreeSceneTree(), new UniformGridSceneTree() };
+            const char* names[4] = { "BVH", "QBVH", "Octree", "Grid" };
+
+            std::vector<SceneObject*> visible;
+            std::vector<SceneObject*> unoccluded;
+
+            for(uint32_t i = 0; i < 4; i++)
+            {
+                trees[i]->addObjects(objects);
+                trees[i]->restructure();
+
+                start = OcularEngine.Clock()->getElapsedNS();
+
+                for(uint32_t j = 0; j < NumVisibilityQueries; j++)
+                {
+                    visible.clear();
+                    trees[i]->getAllVisibleObjects(frustum, visible);
+                }
+
+                end = OcularEngine.Clock()->getElapsedNS();
+
+                const double elapsedFrustum = (static_cast<double>((end - start)) * 1e-6) / static_cast<double>(NumVisibilityQueries);
+
+                start = OcularEngine.Clock()->getElapsedNS();
+
+                for(uint32_t j = 0; j < NumVisibilityQueries; j++)
+                {
+                    unoccluded.clear();
+                    trees[i]->getAllVisibleObjects(frustum, occlusion, unoccluded);
+                }
+
+                end = OcularEngine.Clock()->getElapsedNS();
+
+                const double elapsedOcclusion = (static_cast<double>((end - start)) * 1e-6) / static_cast<double>(NumVisibilityQueries);
+
+                OcularLogger->info("BVH Occlusion ", names[i], "[", numObjects, "]: ", elapsedOcclusion, "ms (frustum only: ", elapsedFrustum, "ms, rasterize: ", elapsedRasterize, "ms), ", 
+                    unoccluded.size(), " of ", visible.size(), " visible objects remain");
+            }
+
+            //------------------------------------------------------------
+            // Clean up the trees and objects
+
+            for(uint32_t i = 0; i < 4; i++)
+            {
+                trees[i]->destroy();
+                delete trees[i];
+                trees[i] = nullptr;
+            }
+
+            cleanObjects(objects);
+        }
+
         void BVHSceneTreeTest::buildObjects(uint32_t numObjects, std::vector<SceneObject*>& objects)
         {
             MersenneTwister19937 rng;
@@ -108,13 +844,182 @@ namespace Ocular
             for(uint32_t i = 0; i < numObjects; i++)
             {
                 SceneObject* object = new SceneObject();
-                object->boundsAABB.setCenter(Vector3f(rng.nextf(0.0f, 1000.0f), rng.nextf(0.0f, 1000.0f), rng.nextf(0.0f, 1000.0f)));
-                object->boundsAABB.setExtents(Vector3f(rng.nextf(1.0f, 10.0f), rng.nextf(1.0f, 10.0f), rng.nextf(1.0f, 10.0f)));
+                object->setPosition(Vector3f(rng.nextf(0.0f, 1000.0f), rng.nextf(0.0f, 1000.0f), rng.nextf(0.0f, 1000.0f)));
 
                 objects.push_back(object);
             }
         }
 
+        void BVHSceneTreeTest::buildFrustum(Frustum& frustum)
+        {
+            // Positioned in front of the object volume, looking into it. Only a portion of the objects are visible.
+
+            frustum.setViewMatrix(Matrix4x4::CreateLookAtMatrix(Vector3f(500.0f, 500.0f, 1200.0f), Vector3f(500.0f, 500.0f, 0.0f), Vector3f::Up()));
+            frustum.setProjectionMatrix(Matrix4x4::CreatePerspectiveMatrix(45.0f, 1.33f, 0.1f, 1000.0f));
+            frustum.rebuild();
+        }
+
+        void BVHSceneTreeTest::testVisibility(uint32_t const numObjects, double& elapsedTree, double& elapsedBrute)
+        {
+            std::vector<SceneObject*> objects;
+            buildObjects(numObjects, objects);
+
+            BVHSceneTree* tree = new BVHSceneTree();
+            tree->addObjects(objects);
+            tree->restructure();
+
+            Frustum frustum;
+            buildFrustum(frustum);
+
+            std::vector<SceneObject*> visible;
+            visible.reserve(numObjects);
+
+            //------------------------------------------------------------
+            // Time the tree query
+
+            uint64_t start = OcularEngine.Clock()->getElapsedNS();
+
+            for(uint32_t i = 0; i < NumVisibilityQueries; i++)
+            {
+                visible.clear();
+                tree->getAllVisibleObjects(frustum, visible);
+            }
+
+            uint64_t end = OcularEngine.Clock()->getElapsedNS();
+
+            elapsedTree = (static_cast<double>((end - start)) * 1e-6) / static_cast<double>(NumVisibilityQueries);
+
+            //------------------------------------------------------------
+            // Time the brute-force query
+
+            start = OcularEngine.Clock()->getElapsedNS();
+
+            for(uint32_t i = 0; i < NumVisibilityQueries; i++)
+            {
+                visible.clear();
+
+                for(auto object : objects)
+                {
+                    if(frustum.contains(object->getBoundsAABB(false)))
+                    {
+                        visible.push_back(object);
+                    }
+                }
+            }
+
+            end = OcularEngine.Clock()->getElapsedNS();
+
+            elapsedBrute = (static_cast<double>((end - start)) * 1e-6) / static_cast<double>(NumVisibilityQueries);
+
+            //------------------------------------------------------------
+            // Clean up the tree and objects
+
+            cleanTree(tree);
+            cleanObjects(objects);
+        }
+
+        void BVHSceneTreeTest::testCellTrees(uint32_t const numObjects, uint32_t const numMoved)
+        {
+            MersenneTwister19937 rng;
+
+            std::vector<SceneObject*> objects;
+            buildObjects(numObjects, objects);
+
+            Frustum frustum;
+            buildFrustum(frustum);
+
+            const Ray ray(Vector3f(0.0f, 0.0f, 0.0f), Vector3f(1.0f, 1.0f, 1.0f).getNormalized());
+            const BoundsAABB box(Vector3f(500.0f, 500.0f, 500.0f), Vector3f(100.0f, 100.0f, 100.0f));
+            const Vector3f point(500.0f, 500.0f, 500.0f);
+
+            ISceneTree* trees[3] = { new BVHSceneTree(), new LooseOctreeSceneTree(), new UniformGridSceneTree() };
+            const char* names[3] = { "BVH", "Octree", "Grid" };
+
+            double elapsedUpdate[3] = { 0.0, 0.0, 0.0 };
+
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                trees[i]->addObjects(objects);
+                trees[i]->restructure();
+            }
+
+            //------------------------------------------------------------
+            // Move the objects each frame and time the update of each tree
+
+            for(uint32_t frame = 0; frame < NumUpdateFrames; frame++)
+            {
+                for(uint32_t j = 0; j < numMoved; j++)
+                {
+                    objects[j]->translate(Vector3f(rng.nextf(-5.0f, 5.0f), rng.nextf(-5.0f, 5.0f), rng.nextf(-5.0f, 5.0f)));
+                }
+
+                for(uint32_t i = 0; i < 3; i++)
+                {
+                    for(uint32_t j = 0; j < numMoved; j++)
+                    {
+                        trees[i]->setDirty(objects[j]->getUUID());
+                    }
+
+                    uint64_t start = OcularEngine.Clock()->getElapsedNS();
+                    trees[i]->restructure();
+                    uint64_t end = OcularEngine.Clock()->getElapsedNS();
+
+                    elapsedUpdate[i] += static_cast<double>((end - start)) * 1e-6;
+                }
+            }
+
+            //------------------------------------------------------------
+            // Time the queries of each tree
+
+            std::vector<SceneObject*> visible[3];
+            std::vector<SceneObject*> inBox[3];
+            std::vector<std::pair<SceneObject*, float>> hits[3];
+            std::vector<std::pair<SceneObject*, float>> nearest[3];
+
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                uint64_t start = OcularEngine.Clock()->getElapsedNS();
+
+                for(uint32_t j = 0; j < NumVisibilityQueries; j++)
+                {
+                    visible[i].clear();
+                    trees[i]->getAllVisibleObjects(frustum, visible[i]);
+                }
+
+                uint64_t end = OcularEngine.Clock()->getElapsedNS();
+
+                const double elapsedVisible = (static_cast<double>((end - start)) * 1e-6) / static_cast<double>(NumVisibilityQueries);
+
+                start = OcularEngine.Clock()->getElapsedNS();
+
+                for(uint32_t j = 0; j < NumVisibilityQueries; j++)
+                {
+                    trees[i]->getIntersections(ray, hits[i]);
+                    trees[i]->getIntersections(box, inBox[i]);
+                    trees[i]->getNearestObjects(point, 8, nearest[i]);
+                }
+
+                end = OcularEngine.Clock()->getElapsedNS();
+
+                const double elapsedQueries = (static_cast<double>((end - start)) * 1e-6) / static_cast<double>(NumVisibilityQueries);
+
+                OcularLogger->info("BVH CellTrees ", names[i], "[", numObjects, ", ", numMoved, " moved]: ", (elapsedUpdate[i] / static_cast<double>(NumUpdateFrames)), "ms update, ", 
+                                   elapsedVisible, "ms visibility, ", elapsedQueries, "ms ray/box/nearest");
+            }
+
+            //------------------------------------------------------------
+            // Clean up the trees and objects
+
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                trees[i]->destroy();
+                delete trees[i];
+                trees[i] = nullptr;
+            }
+
+            cleanObjects(objects);
+        }
+
         void BVHSceneTreeTest::cleanTree(BVHSceneTree* tree)
         {
             tree->destroy();
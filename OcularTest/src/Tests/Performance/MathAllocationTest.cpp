@@ -0,0 +1,295 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Tests/Performance/MathAllocationTest.hpp"
+#include "Math/Matrix4x4.hpp"
+#include "Math/Matrix3x3.hpp"
+#include "Math/Quaternion.hpp"
+#include "Math/Random/MersenneTwister19937.hpp"
+#include "OcularEngine.hpp"
+
+#include <cstdlib>
+#include <new>
+
+using namespace Ocular::Math;
+using namespace Ocular::Math::Random;
+
+namespace
+{
+    thread_local uint64_t g_NumAllocations = 0;    ///< Number of allocations made on the current thread
+
+    /**
+     * Performs the operation the specified number of times, recording the elapsed time and
+     * the number of allocations made.
+     */
+    template<typename Operation>
+    void Measure(uint32_t const iterations, Operation operation, uint64_t& elapsedNS, uint64_t& allocations)
+    {
+        const uint64_t startAllocations = g_NumAllocations;
+        const uint64_t start = OcularEngine.Clock()->getElapsedNS();
+
+        for(uint32_t i = 0; i < iterations; i++)
+        {
+            operation(i);
+        }
+
+        elapsedNS   = OcularEngine.Clock()->getElapsedNS() - start;
+        allocations = g_NumAllocations - startAllocations;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Global operator new/delete are replaced so that the allocations of the timed loops may be counted.
+
+void* operator new(std::size_t size)
+{
+    g_NumAllocations++;
+
+    void* result = std::malloc((size > 0) ? size : 1);
+
+    if(result == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return result;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+//------------------------------------------------------------------------------------------
+
+namespace Ocular
+{
+    namespace Tests
+    {
+        //----------------------------------------------------------------------------------
+        // CONSTRUCTORS
+        //----------------------------------------------------------------------------------
+
+        MathAllocationTest::MathAllocationTest()
+            : ATest("MathAllocationTest")
+        {
+        
+        }
+
+        MathAllocationTest::~MathAllocationTest()
+        {
+        
+        }
+
+        //----------------------------------------------------------------------------------
+        // PUBLIC METHODS
+        //----------------------------------------------------------------------------------
+
+        void MathAllocationTest::run()
+        {
+            m_CurrentTest = "Matrix4x4";
+            m_NumTests++;
+
+            testMatrix4x4(1000000);
+
+            m_CurrentTest = "Matrix3x3";
+            m_NumTests++;
+
+            testMatrix3x3(1000000);
+
+            m_CurrentTest = "Quaternion";
+            m_NumTests++;
+
+            testQuaternion(1000000);
+
+            ATest::run();
+        }
+
+        //----------------------------------------------------------------------------------
+        // PROTECTED METHODS
+        //----------------------------------------------------------------------------------
+
+        void MathAllocationTest::testMatrix4x4(uint32_t const iterations)
+        {
+            MersenneTwister19937 rng;
+
+            const Vector3f   position(rng.nextf(-10.0f, 10.0f), rng.nextf(-10.0f, 10.0f), rng.nextf(-10.0f, 10.0f));
+            const Quaternion rotation(rng.nextf(0.0f, 90.0f), Vector3f::Up());
+            const Vector3f   scale(rng.nextf(0.5f, 2.0f), rng.nextf(0.5f, 2.0f), rng.nextf(0.5f, 2.0f));
+
+            const Matrix4x4 lhs(position, rotation, scale);
+            const Matrix4x4 rhs(scale, rotation, position);
+
+            uint64_t elapsedNS   = 0;
+            uint64_t allocations = 0;
+
+            float checksum = 0.0f;     // Prevents the operations from being optimized out
+
+            Measure(iterations, [&](uint32_t const)
+            {
+                Matrix4x4 matrix(position, rotation, scale);
+                checksum += matrix.getElement(3);
+            }, elapsedNS, allocations);
+
+            report("Matrix4x4 TRS Construct", iterations, elapsedNS, allocations, __LINE__);
+
+            Measure(iterations, [&](uint32_t const)
+            {
+                Matrix4x4 matrix = lhs;
+                checksum += matrix.getElement(7);
+            }, elapsedNS, allocations);
+
+            report("Matrix4x4 Copy", iterations, elapsedNS, allocations, __LINE__);
+
+            Measure(iterations, [&](uint32_t const)
+            {
+                checksum += (lhs * rhs).getElement(3);
+            }, elapsedNS, allocations);
+
+            report("Matrix4x4 Multiply", iterations, elapsedNS, allocations, __LINE__);
+
+            Measure(iterations, [&](uint32_t const)
+            {
+                checksum += lhs.getInverse().getElement(3);
+            }, elapsedNS, allocations);
+
+            report("Matrix4x4 Inverse", iterations, elapsedNS, allocations, __LINE__);
+
+            Measure(iterations, [&](uint32_t const i)
+            {
+                checksum += (lhs * Vector4f(static_cast<float>(i), 1.0f, 1.0f, 1.0f)).x;
+            }, elapsedNS, allocations);
+
+            report("Matrix4x4 Transform", iterations, elapsedNS, allocations, __LINE__);
+
+            OcularLogger->info("Matrix4x4 checksum: ", checksum);
+        }
+
+        void MathAllocationTest::testMatrix3x3(uint32_t const iterations)
+        {
+            MersenneTwister19937 rng;
+
+            const Quaternion rotation(rng.nextf(0.0f, 90.0f), Vector3f::Up());
+            const Matrix3x3 lhs(rotation);
+            const Matrix3x3 rhs(Quaternion(rng.nextf(0.0f, 90.0f), Vector3f::Right()));
+
+            uint64_t elapsedNS   = 0;
+            uint64_t allocations = 0;
+
+            float checksum = 0.0f;
+
+            Measure(iterations, [&](uint32_t const)
+            {
+                Matrix3x3 matrix(rotation);
+                checksum += matrix.getElement(2);
+            }, elapsedNS, allocations);
+
+            report("Matrix3x3 Quaternion Construct", iterations, elapsedNS, allocations, __LINE__);
+
+            Measure(iterations, [&](uint32_t const)
+            {
+                checksum += (lhs * rhs).getElement(2);
+            }, elapsedNS, allocations);
+
+            report("Matrix3x3 Multiply", iterations, elapsedNS, allocations, __LINE__);
+
+            Measure(iterations, [&](uint32_t const)
+            {
+                checksum += lhs.getInverse().getElement(2);
+            }, elapsedNS, allocations);
+
+            report("Matrix3x3 Inverse", iterations, elapsedNS, allocations, __LINE__);
+
+            OcularLogger->info("Matrix3x3 checksum: ", checksum);
+        }
+
+        void MathAllocationTest::testQuaternion(uint32_t const iterations)
+        {
+            MersenneTwister19937 rng;
+
+            const Quaternion lhs(rng.nextf(0.0f, 90.0f), Vector3f::Up());
+            const Quaternion rhs(rng.nextf(0.0f, 90.0f), Vector3f::Right());
+
+            uint64_t elapsedNS   = 0;
+            uint64_t allocations = 0;
+
+            float checksum = 0.0f;
+
+            Measure(iterations, [&](uint32_t const)
+            {
+                checksum += (lhs * rhs).w();
+            }, elapsedNS, allocations);
+
+            report("Quaternion Multiply", iterations, elapsedNS, allocations, __LINE__);
+
+            Measure(iterations, [&](uint32_t const i)
+            {
+                checksum += Quaternion::Slerp(lhs, rhs, static_cast<float>(i % 100) * 0.01f).w();
+            }, elapsedNS, allocations);
+
+            report("Quaternion Slerp", iterations, elapsedNS, allocations, __LINE__);
+
+            Measure(iterations, [&](uint32_t const i)
+            {
+                checksum += (lhs * Vector3f(static_cast<float>(i), 1.0f, 1.0f)).x;
+            }, elapsedNS, allocations);
+
+            report("Quaternion Rotate", iterations, elapsedNS, allocations, __LINE__);
+
+            Measure(iterations, [&](uint32_t const)
+            {
+                checksum += lhs.getInverse().w();
+            }, elapsedNS, allocations);
+
+            report("Quaternion Inverse", iterations, elapsedNS, allocations, __LINE__);
+
+            Measure(iterations, [&](uint32_t const)
+            {
+                checksum += Matrix4x4(Vector3f::Identity(), lhs).getElement(0);
+            }, elapsedNS, allocations);
+
+            report("Quaternion To Matrix4x4", iterations, elapsedNS, allocations, __LINE__);
+
+            OcularLogger->info("Quaternion checksum: ", checksum);
+        }
+
+        void MathAllocationTest::report(char const* name, uint32_t const iterations, uint64_t const elapsedNS, uint64_t const allocations, unsigned const line)
+        {
+            const double perOperation = static_cast<double>(elapsedNS) / static_cast<double>(iterations);
+
+            OcularLogger->info(name, "[", iterations, "]: ", static_cast<double>(elapsedNS) * 1e-6, "ms (", perOperation, "ns each) with ", allocations, " allocations");
+
+            if(allocations > 0)
+            {
+                fail(line);
+            }
+        }
+
+        //----------------------------------------------------------------------------------
+        // PRIVATE METHODS
+        //----------------------------------------------------------------------------------
+    }
+}
\ No newline at end of file
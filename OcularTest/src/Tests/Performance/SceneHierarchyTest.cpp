@@ -0,0 +1,456 @@
+/**
+ * Copyright 2014-2017 Steven T Sell (ssell@vertexfragment.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Tests/Performance/SceneHierarchyTest.hpp"
+#include "Scene/SceneObject.hpp"
+#include "Scene/TransformSystem.hpp"
+#include "Math/Random/MersenneTwister19937.hpp"
+#include "Math/Equality.hpp"
+#include "OcularEngine.hpp"
+
+#include <cmath>
+
+using namespace Ocular::Core;
+using namespace Ocular::Math;
+using namespace Ocular::Math::Random;
+
+namespace
+{
+    const uint32_t NumHierarchyFrames = 10;    ///< Number of frames averaged for each hierarchy timing
+
+    /**
+     * Builds the world matrix by multiplying the full parent chain, as is done without caching.
+     */
+    Matrix4x4 BuildWorldMatrix(SceneObject const* object)
+    {
+        Matrix4x4 result = object->getModelMatrix(true);
+
+        if(object->getParent())
+        {
+            result = BuildWorldMatrix(object->getParent()) * result;
+        }
+
+        return result;
+    }
+
+    /**
+     * The cached matrices are built with SSE instead of glm, so may differ in the last bits.
+     */
+    bool IsNearlyEqual(Matrix4x4 const& lhs, Matrix4x4 const& rhs)
+    {
+        bool result = true;
+
+        float lhsData[16];
+        float rhsData[16];
+
+        lhs.getData(lhsData);
+        rhs.getData(rhsData);
+
+        for(uint32_t i = 0; (i < 16) && result; i++)
+        {
+            result = IsEqual<float>(lhsData[i], rhsData[i], 0.0001f * fmaxf(1.0f, fabsf(rhsData[i])));
+        }
+
+        return result;
+    }
+}
+
+//------------------------------------------------------------------------------------------
+
+namespace Ocular
+{
+    namespace Tests
+    {
+        //----------------------------------------------------------------------------------
+        // CONSTRUCTORS
+        //----------------------------------------------------------------------------------
+
+        SceneHierarchyTest::SceneHierarchyTest()
+            : ATest("SceneHierarchyTest")
+        {
+        
+        }
+
+        SceneHierarchyTest::~SceneHierarchyTest()
+        {
+        
+        }
+
+        //----------------------------------------------------------------------------------
+        // PUBLIC METHODS
+        //----------------------------------------------------------------------------------
+
+        void SceneHierarchyTest::run()
+        {
+            m_CurrentTest = "WorldMatrices";
+            m_NumTests++;
+
+            testWorldMatrices(100000, 10, 1000);
+
+            m_CurrentTest = "TransformSystem";
+            m_NumTests++;
+
+            testTransformSystem(100000, 10, 1000);
+
+            m_CurrentTest = "ParallelUpdate";
+            m_NumTests++;
+
+            testParallelUpdate(200000, 8);
+
+            ATest::run();
+        }
+
+        //----------------------------------------------------------------------------------
+        // PROTECTED METHODS
+        //----------------------------------------------------------------------------------
+
+        void SceneHierarchyTest::buildHierarchy(uint32_t const numObjects, uint32_t const depth, std::vector<SceneObject*>& objects)
+        {
+            MersenneTwister19937 rng;
+
+            const uint32_t perLevel = numObjects / depth;
+
+            objects.reserve(perLevel * depth);
+
+            for(uint32_t level = 0; level < depth; level++)
+            {
+                for(uint32_t i = 0; i < perLevel; i++)
+                {
+                    SceneObject* parent = nullptr;
+
+                    if(level > 0)
+                    {
+                        parent = objects[((level - 1) * perLevel) + (rng.next() % perLevel)];
+                    }
+
+                    SceneObject* object = new SceneObject("Node", parent);
+
+                    object->setPosition(Vector3f(rng.nextf(-10.0f, 10.0f), rng.nextf(-10.0f, 10.0f), rng.nextf(-10.0f, 10.0f)));
+                    object->rotate(rng.nextf(0.0f, 90.0f), Vector3f::Up());
+
+                    objects.push_back(object);
+                }
+            }
+        }
+
+        void SceneHierarchyTest::testWorldMatrices(uint32_t const numObjects, uint32_t const depth, uint32_t const numMoved)
+        {
+            MersenneTwister19937 rng;
+
+            std::vector<SceneObject*> objects;
+            buildHierarchy(numObjects, depth, objects);
+
+            const uint32_t count = static_cast<uint32_t>(objects.size());
+
+            double elapsedMove     = 0.0;
+            double elapsedCached   = 0.0;
+            double elapsedUncached = 0.0;
+
+            float checksum = 0.0f;     // Prevents the retrievals from being optimized out
+
+            for(uint32_t frame = 0; frame < NumHierarchyFrames; frame++)
+            {
+                //--------------------------------------------------------
+                // Move a subset of the objects (and so their descendants)
+
+                uint64_t start = OcularEngine.Clock()->getElapsedNS();
+
+                for(uint32_t i = 0; i < numMoved; i++)
+                {
+                    objects[(rng.next() % count)]->translate(Vector3f(rng.nextf(-1.0f, 1.0f), 0.0f, rng.nextf(-1.0f, 1.0f)));
+                }
+
+                uint64_t end = OcularEngine.Clock()->getElapsedNS();
+
+                elapsedMove += static_cast<double>(end - start) * 1e-6;
+
+                //--------------------------------------------------------
+                // Time the cached world matrices
+
+                start = OcularEngine.Clock()->getElapsedNS();
+
+                for(auto object : objects)
+                {
+                    checksum += object->getModelMatrix(false).getElement(3);
+                }
+
+                end = OcularEngine.Clock()->getElapsedNS();
+
+                elapsedCached += static_cast<double>(end - start) * 1e-6;
+
+                //--------------------------------------------------------
+                // Time the full parent chain
+
+                start = OcularEngine.Clock()->getElapsedNS();
+
+                for(auto object : objects)
+                {
+                    checksum -= BuildWorldMatrix(object).getElement(3);
+                }
+
+                end = OcularEngine.Clock()->getElapsedNS();
+
+                elapsedUncached += static_cast<double>(end - start) * 1e-6;
+
+                //--------------------------------------------------------
+                // Verify
+
+                for(auto object : objects)
+                {
+                    if(!IsNearlyEqual(object->getModelMatrix(false), BuildWorldMatrix(object)))
+                    {
+                        fail(__LINE__);
+                        break;
+                    }
+                }
+            }
+
+            elapsedMove     /= static_cast<double>(NumHierarchyFrames);
+            elapsedCached   /= static_cast<double>(NumHierarchyFrames);
+            elapsedUncached /= static_cast<double>(NumHierarchyFrames);
+
+            OcularLogger->info("World Matrices[", count, ", depth ", depth, "]: ", elapsedCached, "ms (uncached: ", elapsedUncached, "ms) with ", numMoved, " moved in ", elapsedMove, "ms (checksum ", checksum, ")");
+
+            cleanObjects(objects);
+        }
+
+        void SceneHierarchyTest::testTransformSystem(uint32_t const numObjects, uint32_t const depth, uint32_t const numMoved)
+        {
+            MersenneTwister19937 rng;
+
+            TransformSystem transforms;
+
+            const uint32_t perLevel = numObjects / depth;
+            const uint32_t count = perLevel * depth;
+
+            std::vector<uint32_t> handles(count);
+            std::vector<uint32_t> parents(count, TransformSystem::InvalidHandle);     // Index of the parent within handles
+            std::vector<Vector3f> positions(count);
+            std::vector<Quaternion> rotations(count);
+            std::vector<Vector3f> scales(count, Vector3f(1.0f, 1.0f, 1.0f));
+            std::vector<Matrix4x4> worlds(count);
+
+            //------------------------------------------------------------
+            // Build the same shape of hierarchy as buildHierarchy
+
+            for(uint32_t i = 0; i < count; i++)
+            {
+                const uint32_t level = i / perLevel;
+
+                handles[i] = transforms.create();
+                positions[i] = Vector3f(rng.nextf(-10.0f, 10.0f), rng.nextf(-10.0f, 10.0f), rng.nextf(-10.0f, 10.0f));
+                rotations[i] = Quaternion(rng.nextf(0.0f, 90.0f), Vector3f::Up());
+
+                if(level > 0)
+                {
+                    parents[i] = ((level - 1) * perLevel) + (rng.next() % perLevel);
+                    transforms.setParent(handles[i], handles[parents[i]]);
+                }
+
+                transforms.setLocal(handles[i], positions[i], rotations[i], scales[i]);
+            }
+
+            // Initial sort by depth
+            transforms.update();
+
+            //------------------------------------------------------------
+            // Time a full update of every entry
+
+            for(uint32_t i = 0; i < count; i++)
+            {
+                transforms.invalidate(handles[i]);
+            }
+
+            uint64_t start = OcularEngine.Clock()->getElapsedNS();
+
+            transforms.update();
+
+            uint64_t end = OcularEngine.Clock()->getElapsedNS();
+
+            const double elapsedBatch = static_cast<double>(end - start) * 1e-6;
+
+            //------------------------------------------------------------
+            // Time the same update one object at a time (as with Math::Transform)
+
+            start = OcularEngine.Clock()->getElapsedNS();
+
+            for(uint32_t i = 0; i < count; i++)
+            {
+                const Matrix4x4 local(positions[i], rotations[i], scales[i]);
+                worlds[i] = (parents[i] != TransformSystem::InvalidHandle) ? (worlds[parents[i]] * local) : local;
+            }
+
+            end = OcularEngine.Clock()->getElapsedNS();
+
+            const double elapsedSingle = static_cast<double>(end - start) * 1e-6;
+
+            //------------------------------------------------------------
+            // Time partial updates in which only a subset of entries (and their descendants) move
+
+            double elapsedPartial = 0.0;
+
+            for(uint32_t frame = 0; frame < NumHierarchyFrames; frame++)
+            {
+                for(uint32_t i = 0; i < numMoved; i++)
+                {
+                    const uint32_t index = rng.next() % count;
+
+                    positions[index] += Vector3f(rng.nextf(-1.0f, 1.0f), 0.0f, rng.nextf(-1.0f, 1.0f));
+                    transforms.setLocal(handles[index], positions[index], rotations[index], scales[index]);
+                }
+
+                start = OcularEngine.Clock()->getElapsedNS();
+
+                transforms.update();
+
+                end = OcularEngine.Clock()->getElapsedNS();
+
+                elapsedPartial += static_cast<double>(end - start) * 1e-6;
+            }
+
+            elapsedPartial /= static_cast<double>(NumHierarchyFrames);
+
+            //------------------------------------------------------------
+            // Verify
+
+            Matrix4x4 world;
+
+            for(uint32_t i = 0; i < count; i++)
+            {
+                const Matrix4x4 local(positions[i], rotations[i], scales[i]);
+                worlds[i] = (parents[i] != TransformSystem::InvalidHandle) ? (worlds[parents[i]] * local) : local;
+
+                transforms.getWorldMatrix(handles[i], world);
+
+                if(!IsNearlyEqual(world, worlds[i]))
+                {
+                    fail(__LINE__);
+                    break;
+                }
+            }
+
+            OcularLogger->info("TransformSystem[", count, ", depth ", depth, "]: ", elapsedBatch, "ms (one at a time: ", elapsedSingle, "ms), ", numMoved, " moved: ", elapsedPartial, "ms");
+        }
+
+        void SceneHierarchyTest::testParallelUpdate(uint32_t const numObjects, uint32_t const depth)
+        {
+            MersenneTwister19937 rng;
+
+            TransformSystem transforms;
+
+            const uint32_t perLevel = numObjects / depth;
+            const uint32_t count = perLevel * depth;
+
+            std::vector<uint32_t> handles(count);
+            std::vector<Vector3f> positions(count);
+            std::vector<Quaternion> rotations(count);
+
+            const Vector3f scale(1.0f, 1.0f, 1.0f);
+            const BoundsSphere sphere(Vector3f(), 1.0f);
+            const BoundsAABB aabb(Vector3f(), Vector3f(1.0f, 1.0f, 1.0f));
+            const BoundsOBB obb(Vector3f(), Vector3f(1.0f, 1.0f, 1.0f), Vector3f(1.0f, 0.0f, 0.0f), Vector3f(0.0f, 1.0f, 0.0f), Vector3f(0.0f, 0.0f, 1.0f));
+
+            for(uint32_t i = 0; i < count; i++)
+            {
+                const uint32_t level = i / perLevel;
+
+                handles[i] = transforms.create();
+                positions[i] = Vector3f(rng.nextf(-10.0f, 10.0f), rng.nextf(-10.0f, 10.0f), rng.nextf(-10.0f, 10.0f));
+                rotations[i] = Quaternion(rng.nextf(0.0f, 90.0f), Vector3f::Up());
+
+                if(level > 0)
+                {
+                    transforms.setParent(handles[i], handles[((level - 1) * perLevel) + (rng.next() % perLevel)]);
+                }
+
+                transforms.setLocal(handles[i], positions[i], rotations[i], scale);
+                transforms.setLocalBounds(handles[i], sphere, aabb, obb);
+            }
+
+            transforms.update();
+
+            //------------------------------------------------------------
+            // Every object is dynamic, and moves every frame
+
+            double elapsed = 0.0;
+
+            for(uint32_t frame = 0; frame < NumHierarchyFrames; frame++)
+            {
+                for(uint32_t i = 0; i < count; i++)
+                {
+                    positions[i] += Vector3f(rng.nextf(-1.0f, 1.0f), 0.0f, rng.nextf(-1.0f, 1.0f));
+                    transforms.setLocal(handles[i], positions[i], rotations[i], scale);
+                }
+
+                const uint64_t start = OcularEngine.Clock()->getElapsedNS();
+
+                transforms.update();
+
+                const uint64_t end = OcularEngine.Clock()->getElapsedNS();
+
+                elapsed += static_cast<double>(end - start) * 1e-6;
+            }
+
+            elapsed /= static_cast<double>(NumHierarchyFrames);
+
+            //------------------------------------------------------------
+            // Verify that every object was reported, and that the bounds follow the world matrices
+
+            if(static_cast<uint32_t>(transforms.getUpdatedHandles().size()) != count)
+            {
+                fail(__LINE__);
+            }
+
+            BoundsSphere worldSphere;
+            Matrix4x4 world;
+
+            for(uint32_t i = 0; i < count; i++)
+            {
+                transforms.getWorldMatrix(handles[i], world);
+                transforms.getWorldBounds(handles[i], &worldSphere, nullptr, nullptr);
+
+                const Vector3f center = world * Vector3f();
+
+                if(!IsEqual<float>(center.x, worldSphere.getCenter().x, 0.001f) ||
+                   !IsEqual<float>(center.y, worldSphere.getCenter().y, 0.001f) ||
+                   !IsEqual<float>(center.z, worldSphere.getCenter().z, 0.001f))
+                {
+                    fail(__LINE__);
+                    break;
+                }
+            }
+
+            OcularLogger->info("ParallelUpdate[", count, ", depth ", depth, ", ", OcularThreads->getNumThreads(), " threads]: ", elapsed, "ms");
+        }
+
+        void SceneHierarchyTest::cleanObjects(std::vector<SceneObject*>& objects)
+        {
+            // Destroy from the bottom level up so that no child outlives it's parent
+
+            for(auto iter = objects.rbegin(); iter != objects.rend(); ++iter)
+            {
+                delete (*iter);
+            }
+
+            objects.clear();
+        }
+
+        //----------------------------------------------------------------------------------
+        // PRIVATE METHODS
+        //----------------------------------------------------------------------------------
+    }
+}
\ No newline at end of file